@@ -0,0 +1,769 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bench/bench_driver.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "bthread/mutex.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "proto/store.pb.h"
+#include "vector/codec.h"
+
+DECLARE_uint64(kv_record_count);
+DECLARE_double(kv_read_proportion);
+DECLARE_double(kv_update_proportion);
+DECLARE_double(kv_scan_proportion);
+DECLARE_double(kv_insert_proportion);
+DECLARE_string(kv_key_distribution);
+DECLARE_double(kv_zipfian_theta);
+DECLARE_string(kv_key_prefix);
+DECLARE_uint32(kv_value_size);
+DECLARE_uint32(kv_scan_length);
+DECLARE_uint32(kv_batch_size);
+DECLARE_bool(kv_load);
+
+DECLARE_uint32(vector_dimension);
+DECLARE_uint64(vector_count);
+DECLARE_uint64(vector_start_id);
+DECLARE_uint32(vector_batch_size);
+DECLARE_uint32(vector_topn);
+DECLARE_int32(vector_ef_search);
+DECLARE_double(vector_target_recall);
+DECLARE_uint32(vector_query_count);
+DECLARE_string(vector_metric_type);
+DECLARE_uint32(vector_filter_tag_count);
+DECLARE_bool(vector_filter_post);
+
+DECLARE_uint64(bench_seed);
+DECLARE_uint32(bench_report_interval_s);
+
+namespace bench {
+
+static const std::string kVectorTagKey = "bench_tag";
+static const int32_t kMaxEfSearch = 4096;
+
+const char* OpTypeName(OpType op_type) {
+  switch (op_type) {
+    case OpType::kRead:
+      return "READ";
+    case OpType::kUpdate:
+      return "UPDATE";
+    case OpType::kScan:
+      return "SCAN";
+    case OpType::kInsert:
+      return "INSERT";
+    case OpType::kVectorInsert:
+      return "VECTOR_INSERT";
+    case OpType::kVectorSearch:
+      return "VECTOR_SEARCH";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+bool BenchClient::Init(const std::vector<uint64_t>& region_ids) {
+  for (auto region_id : region_ids) {
+    auto region_entry = client::RegionRouter::GetInstance().QueryRegionEntry(region_id);
+    if (region_entry == nullptr) {
+      DINGO_LOG(ERROR) << fmt::format("[bench] not found region {}", region_id);
+      return false;
+    }
+
+    region_entries_.push_back(region_entry);
+  }
+
+  return !region_entries_.empty();
+}
+
+client::RegionEntryPtr BenchClient::Route(const std::string& key) {
+  return client::RegionRouter::GetInstance().QueryRegionEntry(key);
+}
+
+WorkerStats::WorkerStats()
+    : histograms_(static_cast<size_t>(OpType::kMax)), errors_(static_cast<size_t>(OpType::kMax), 0) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+WorkerStats::~WorkerStats() { bthread_mutex_destroy(&mutex_); }
+
+void WorkerStats::Record(OpType op_type, uint64_t latency_us, bool success) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (success) {
+    histograms_[static_cast<size_t>(op_type)].Record(latency_us);
+  } else {
+    ++errors_[static_cast<size_t>(op_type)];
+  }
+}
+
+void WorkerStats::Collect(std::vector<LatencyHistogram>& histograms, std::vector<uint64_t>& errors) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  for (size_t i = 0; i < histograms_.size(); ++i) {
+    histograms[i].Merge(histograms_[i]);
+    histograms_[i].Reset();
+    errors[i] += errors_[i];
+    errors_[i] = 0;
+  }
+}
+
+Reporter::~Reporter() {
+  if (out_.is_open()) {
+    out_.close();
+  }
+}
+
+bool Reporter::Init(const std::string& file, const std::string& format) {
+  if (format != "csv" && format != "json") {
+    DINGO_LOG(ERROR) << fmt::format("[bench] not support report format {}, only csv or json", format);
+    return false;
+  }
+  format_ = format;
+
+  if (file.empty()) {
+    return true;
+  }
+
+  out_.open(file, std::ios::out | std::ios::trunc);
+  if (!out_.is_open()) {
+    DINGO_LOG(ERROR) << fmt::format("[bench] open report file {} failed", file);
+    return false;
+  }
+
+  if (format_ == "csv") {
+    out_ << "phase,elapsed_s,op,count,errors,qps,avg_us,p50_us,p95_us,p99_us,p999_us,max_us\n";
+  }
+
+  return true;
+}
+
+void Reporter::Write(const std::string& phase, uint64_t elapsed_s, OpType op_type, uint64_t duration_ms,
+                     const LatencyHistogram& histogram, uint64_t error_count) {
+  double qps = duration_ms == 0 ? 0 : static_cast<double>(histogram.Count()) * 1000 / duration_ms;
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[bench] {} {}s {} count: {} errors: {} qps: {:.1f} avg: {:.1f}us p50: {}us p95: {}us p99: {}us p999: {}us "
+      "max: {}us",
+      phase, elapsed_s, OpTypeName(op_type), histogram.Count(), error_count, qps, histogram.Mean(),
+      histogram.Percentile(50), histogram.Percentile(95), histogram.Percentile(99), histogram.Percentile(99.9),
+      histogram.Max());
+
+  if (!out_.is_open()) {
+    return;
+  }
+
+  if (format_ == "csv") {
+    out_ << fmt::format("{},{},{},{},{},{:.1f},{:.1f},{},{},{},{},{}\n", phase, elapsed_s, OpTypeName(op_type),
+                        histogram.Count(), error_count, qps, histogram.Mean(), histogram.Percentile(50),
+                        histogram.Percentile(95), histogram.Percentile(99), histogram.Percentile(99.9),
+                        histogram.Max());
+  } else {
+    // json lines, one object per line
+    out_ << fmt::format(
+        R"({{"phase":"{}","elapsed_s":{},"op":"{}","count":{},"errors":{},"qps":{:.1f},"avg_us":{:.1f},)"
+        R"("p50_us":{},"p95_us":{},"p99_us":{},"p999_us":{},"max_us":{}}})"
+        "\n",
+        phase, elapsed_s, OpTypeName(op_type), histogram.Count(), error_count, qps, histogram.Mean(),
+        histogram.Percentile(50), histogram.Percentile(95), histogram.Percentile(99), histogram.Percentile(99.9),
+        histogram.Max());
+  }
+  out_.flush();
+}
+
+void Reporter::Report(uint64_t elapsed_s, const std::vector<WorkerStatsPtr>& worker_stats, uint64_t interval_ms) {
+  std::vector<LatencyHistogram> histograms(static_cast<size_t>(OpType::kMax));
+  std::vector<uint64_t> errors(static_cast<size_t>(OpType::kMax), 0);
+  for (const auto& stats : worker_stats) {
+    stats->Collect(histograms, errors);
+  }
+
+  for (size_t i = 0; i < histograms.size(); ++i) {
+    if (histograms[i].Count() == 0 && errors[i] == 0) {
+      continue;
+    }
+
+    Write("interval", elapsed_s, static_cast<OpType>(i), interval_ms, histograms[i], errors[i]);
+    total_histograms_[i].Merge(histograms[i]);
+    total_errors_[i] += errors[i];
+  }
+}
+
+void Reporter::Summary(uint64_t elapsed_ms) {
+  for (size_t i = 0; i < total_histograms_.size(); ++i) {
+    if (total_histograms_[i].Count() == 0 && total_errors_[i] == 0) {
+      continue;
+    }
+
+    Write("total", elapsed_ms / 1000, static_cast<OpType>(i), elapsed_ms, total_histograms_[i], total_errors_[i]);
+  }
+}
+
+KvWorkload::KvWorkload(std::shared_ptr<BenchClient> client) : Workload(client), insert_record_no_(0) {}
+
+std::string KvWorkload::GenKey(uint64_t record_no) const {
+  return fmt::format("{}{:016}", FLAGS_kv_key_prefix, record_no);
+}
+
+std::string KvWorkload::GenValue(std::mt19937_64& engine) const {
+  static const char kAlphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+  std::uniform_int_distribution<int> distrib(0, sizeof(kAlphabet) - 2);
+
+  std::string value(FLAGS_kv_value_size, 0);
+  for (auto& c : value) {
+    c = kAlphabet[distrib(engine)];
+  }
+
+  return value;
+}
+
+uint64_t KvWorkload::NextRecordNo(std::mt19937_64& engine) {
+  // inserted record is visible for read/update/scan, load phase only has [0, kv_record_count)
+  uint64_t record_count = FLAGS_kv_record_count;
+  if (!FLAGS_kv_load) {
+    record_count += insert_record_no_.load(std::memory_order_relaxed);
+  }
+  if (zipfian_generator_ != nullptr) {
+    return zipfian_generator_->NextScrambled(engine, record_count);
+  }
+
+  std::uniform_int_distribution<uint64_t> distrib(0, record_count - 1);
+  return distrib(engine);
+}
+
+bool KvWorkload::Prepare() {
+  if (FLAGS_kv_record_count == 0) {
+    DINGO_LOG(ERROR) << "[bench] kv_record_count must be greater than 0";
+    return false;
+  }
+
+  if (FLAGS_kv_key_distribution == "zipfian") {
+    zipfian_generator_ = std::make_unique<ZipfianGenerator>(FLAGS_kv_record_count, FLAGS_kv_zipfian_theta);
+  } else if (FLAGS_kv_key_distribution != "uniform") {
+    DINGO_LOG(ERROR) << fmt::format("[bench] not support key distribution {}, only zipfian or uniform",
+                                    FLAGS_kv_key_distribution);
+    return false;
+  }
+
+  // every key must be routable
+  for (uint64_t record_no : {static_cast<uint64_t>(0), FLAGS_kv_record_count - 1}) {
+    if (client_->Route(GenKey(record_no)) == nullptr) {
+      DINGO_LOG(ERROR) << fmt::format("[bench] key {} not belong to any region, please check kv_key_prefix",
+                                      GenKey(record_no));
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool KvWorkload::Execute(uint32_t /*thread_no*/, std::mt19937_64& engine, WorkerStats& stats) {
+  if (FLAGS_kv_load) {
+    return Insert(engine, stats);
+  }
+
+  std::uniform_real_distribution<double> distrib(
+      0.0, FLAGS_kv_read_proportion + FLAGS_kv_update_proportion + FLAGS_kv_scan_proportion + FLAGS_kv_insert_proportion);
+  double op = distrib(engine);
+  if (op < FLAGS_kv_read_proportion) {
+    return Read(engine, stats);
+  }
+  op -= FLAGS_kv_read_proportion;
+  if (op < FLAGS_kv_update_proportion) {
+    return Update(engine, stats);
+  }
+  op -= FLAGS_kv_update_proportion;
+  if (op < FLAGS_kv_scan_proportion) {
+    return Scan(engine, stats);
+  }
+
+  return Insert(engine, stats);
+}
+
+bool KvWorkload::Read(std::mt19937_64& engine, WorkerStats& stats) {
+  dingodb::pb::store::KvGetRequest request;
+  dingodb::pb::store::KvGetResponse response;
+
+  request.set_key(GenKey(NextRecordNo(engine)));
+  auto region_entry = client_->Route(request.key());
+  if (region_entry == nullptr) {
+    stats.Record(OpType::kRead, 0, false);
+    return true;
+  }
+
+  uint64_t start_time = butil::gettimeofday_us();
+  auto status = client_->SendRequest("StoreService", "KvGet", region_entry, request, response);
+  stats.Record(OpType::kRead, butil::gettimeofday_us() - start_time, status.ok());
+
+  return true;
+}
+
+bool KvWorkload::Update(std::mt19937_64& engine, WorkerStats& stats) {
+  dingodb::pb::store::KvPutRequest request;
+  dingodb::pb::store::KvPutResponse response;
+
+  auto* kv = request.mutable_kv();
+  kv->set_key(GenKey(NextRecordNo(engine)));
+  kv->set_value(GenValue(engine));
+  auto region_entry = client_->Route(kv->key());
+  if (region_entry == nullptr) {
+    stats.Record(OpType::kUpdate, 0, false);
+    return true;
+  }
+
+  uint64_t start_time = butil::gettimeofday_us();
+  auto status = client_->SendRequest("StoreService", "KvPut", region_entry, request, response);
+  stats.Record(OpType::kUpdate, butil::gettimeofday_us() - start_time, status.ok());
+
+  return true;
+}
+
+bool KvWorkload::Scan(std::mt19937_64& engine, WorkerStats& stats) {
+  std::string start_key = GenKey(NextRecordNo(engine));
+  auto region_entry = client_->Route(start_key);
+  if (region_entry == nullptr) {
+    stats.Record(OpType::kScan, 0, false);
+    return true;
+  }
+
+  uint64_t start_time = butil::gettimeofday_us();
+
+  dingodb::pb::store::KvScanBeginRequest request;
+  dingodb::pb::store::KvScanBeginResponse response;
+  request.mutable_range()->mutable_range()->set_start_key(start_key);
+  request.mutable_range()->mutable_range()->set_end_key(region_entry->Range().end_key());
+  request.mutable_range()->set_with_start(true);
+  request.mutable_range()->set_with_end(false);
+  request.set_max_fetch_cnt(FLAGS_kv_scan_length);
+
+  auto status = client_->SendRequest("StoreService", "KvScanBegin", region_entry, request, response);
+  if (status.ok() && !response.scan_id().empty()) {
+    dingodb::pb::store::KvScanReleaseRequest release_request;
+    dingodb::pb::store::KvScanReleaseResponse release_response;
+    release_request.set_scan_id(response.scan_id());
+    status = client_->SendRequest("StoreService", "KvScanRelease", region_entry, release_request, release_response);
+  }
+
+  stats.Record(OpType::kScan, butil::gettimeofday_us() - start_time, status.ok());
+
+  return true;
+}
+
+bool KvWorkload::Insert(std::mt19937_64& engine, WorkerStats& stats) {
+  // load phase insert record [0, kv_record_count), run phase insert after kv_record_count
+  uint32_t batch_size = FLAGS_kv_load ? std::max(FLAGS_kv_batch_size, static_cast<uint32_t>(1)) : 1;
+  uint64_t start_record_no = insert_record_no_.fetch_add(batch_size);
+  if (FLAGS_kv_load) {
+    if (start_record_no >= FLAGS_kv_record_count) {
+      return false;
+    }
+  } else {
+    start_record_no += FLAGS_kv_record_count;
+  }
+  uint64_t end_record_no = start_record_no + batch_size;
+  if (FLAGS_kv_load) {
+    end_record_no = std::min(end_record_no, FLAGS_kv_record_count);
+  }
+
+  // group by region
+  std::map<uint64_t, std::pair<client::RegionEntryPtr, dingodb::pb::store::KvBatchPutRequest>> requests;
+  for (uint64_t record_no = start_record_no; record_no < end_record_no; ++record_no) {
+    std::string key = GenKey(record_no);
+    auto region_entry = client_->Route(key);
+    if (region_entry == nullptr) {
+      stats.Record(OpType::kInsert, 0, false);
+      continue;
+    }
+
+    auto& [entry, request] = requests[region_entry->RegionId()];
+    entry = region_entry;
+    auto* kv = request.add_kvs();
+    kv->set_key(key);
+    kv->set_value(GenValue(engine));
+  }
+
+  for (auto& [region_id, entry_request] : requests) {
+    auto& [region_entry, request] = entry_request;
+    dingodb::pb::store::KvBatchPutResponse response;
+
+    uint64_t start_time = butil::gettimeofday_us();
+    auto status = client_->SendRequest("StoreService", "KvBatchPut", region_entry, request, response);
+    stats.Record(OpType::kInsert, butil::gettimeofday_us() - start_time, status.ok());
+  }
+
+  return true;
+}
+
+VectorWorkload::VectorWorkload(std::shared_ptr<BenchClient> client, bool is_search)
+    : Workload(client),
+      is_search_(is_search),
+      dimension_(FLAGS_vector_dimension),
+      partition_id_(0),
+      insert_offset_(0),
+      ef_search_(FLAGS_vector_ef_search) {}
+
+std::string VectorWorkload::GenTag(uint64_t vector_id) const {
+  return fmt::format("tag{}", vector_id % FLAGS_vector_filter_tag_count);
+}
+
+client::RegionEntryPtr VectorWorkload::RouteVector(uint64_t vector_id) {
+  std::string key;
+  dingodb::VectorCodec::EncodeVectorKey(partition_id_, vector_id, key);
+  return client_->Route(key);
+}
+
+static float Distance(const float* left, const float* right, uint32_t dimension) {
+  float result = 0;
+  if (FLAGS_vector_metric_type == "IP") {
+    for (uint32_t i = 0; i < dimension; ++i) {
+      result += left[i] * right[i];
+    }
+    // bigger inner product is closer
+    return 1.0f - result;
+  }
+
+  for (uint32_t i = 0; i < dimension; ++i) {
+    float diff = left[i] - right[i];
+    result += diff * diff;
+  }
+  return result;
+}
+
+bool VectorWorkload::Prepare() {
+  if (dimension_ == 0 || FLAGS_vector_count == 0) {
+    DINGO_LOG(ERROR) << "[bench] vector_dimension and vector_count must be greater than 0";
+    return false;
+  }
+  if (FLAGS_vector_metric_type != "L2" && FLAGS_vector_metric_type != "IP") {
+    DINGO_LOG(ERROR) << fmt::format("[bench] not support metric type {}, only L2 or IP", FLAGS_vector_metric_type);
+    return false;
+  }
+
+  auto region_entries = client_->GetRegionEntries();
+  partition_id_ = dingodb::VectorCodec::DecodePartitionId(region_entries[0]->Range().start_key());
+
+  // same seed generate same dataset, so search phase can verify the data of insert phase
+  std::mt19937_64 engine(FLAGS_bench_seed);
+  std::uniform_real_distribution<float> distrib(0.0, 1.0);
+  dataset_.resize(FLAGS_vector_count * dimension_);
+  for (auto& value : dataset_) {
+    value = distrib(engine);
+  }
+  DINGO_LOG(INFO) << fmt::format("[bench] generate vector dataset count {} dimension {}", FLAGS_vector_count,
+                                 dimension_);
+
+  if (!is_search_) {
+    return true;
+  }
+
+  queries_.resize(std::max(FLAGS_vector_query_count, static_cast<uint32_t>(1)));
+  for (auto& query : queries_) {
+    query.resize(dimension_);
+    for (auto& value : query) {
+      value = distrib(engine);
+    }
+  }
+
+  if (FLAGS_vector_target_recall <= 0) {
+    return true;
+  }
+
+  // find the minimal ef_search which reach the target recall
+  ef_search_ = std::max(FLAGS_vector_ef_search, static_cast<int32_t>(FLAGS_vector_topn));
+  for (;;) {
+    double recall = MeasureRecall(ef_search_);
+    DINGO_LOG(INFO) << fmt::format("[bench] ef_search {} recall {:.4f} target recall {:.4f}", ef_search_, recall,
+                                   FLAGS_vector_target_recall);
+    if (recall >= FLAGS_vector_target_recall) {
+      break;
+    }
+    if (ef_search_ >= kMaxEfSearch) {
+      DINGO_LOG(WARNING) << fmt::format("[bench] can not reach target recall {:.4f}, use ef_search {}",
+                                        FLAGS_vector_target_recall, ef_search_);
+      break;
+    }
+    ef_search_ = std::min(ef_search_ * 2, kMaxEfSearch);
+  }
+
+  return true;
+}
+
+bool VectorWorkload::Execute(uint32_t /*thread_no*/, std::mt19937_64& engine, WorkerStats& stats) {
+  return is_search_ ? Search(engine, stats) : Insert(stats);
+}
+
+bool VectorWorkload::Insert(WorkerStats& stats) {
+  uint32_t batch_size = std::max(FLAGS_vector_batch_size, static_cast<uint32_t>(1));
+  uint64_t start_offset = insert_offset_.fetch_add(batch_size);
+  if (start_offset >= FLAGS_vector_count) {
+    return false;
+  }
+  uint64_t end_offset = std::min(start_offset + batch_size, FLAGS_vector_count);
+
+  // group by region
+  std::map<uint64_t, std::pair<client::RegionEntryPtr, dingodb::pb::index::VectorAddRequest>> requests;
+  for (uint64_t offset = start_offset; offset < end_offset; ++offset) {
+    uint64_t vector_id = FLAGS_vector_start_id + offset;
+    auto region_entry = RouteVector(vector_id);
+    if (region_entry == nullptr) {
+      stats.Record(OpType::kVectorInsert, 0, false);
+      continue;
+    }
+
+    auto& [entry, request] = requests[region_entry->RegionId()];
+    entry = region_entry;
+    auto* vector_with_id = request.add_vectors();
+    vector_with_id->set_id(vector_id);
+    auto* vector = vector_with_id->mutable_vector();
+    vector->set_dimension(dimension_);
+    vector->set_value_type(dingodb::pb::common::ValueType::FLOAT);
+    const float* data = GetVector(offset);
+    vector->mutable_float_values()->Add(data, data + dimension_);
+
+    if (FLAGS_vector_filter_tag_count > 0) {
+      dingodb::pb::common::ScalarValue scalar_value;
+      scalar_value.set_field_type(dingodb::pb::common::ScalarFieldType::STRING);
+      scalar_value.add_fields()->set_string_data(GenTag(vector_id));
+      vector_with_id->mutable_scalar_data()->mutable_scalar_data()->insert({kVectorTagKey, scalar_value});
+    }
+  }
+
+  for (auto& [region_id, entry_request] : requests) {
+    auto& [region_entry, request] = entry_request;
+    dingodb::pb::index::VectorAddResponse response;
+
+    uint64_t start_time = butil::gettimeofday_us();
+    auto status = client_->SendRequest("IndexService", "VectorAdd", region_entry, request, response);
+    stats.Record(OpType::kVectorInsert, butil::gettimeofday_us() - start_time, status.ok());
+  }
+
+  return true;
+}
+
+bool VectorWorkload::SearchAllRegions(const std::vector<float>& query, const std::string& tag, int32_t ef_search,
+                                      std::vector<uint64_t>& vector_ids) {
+  dingodb::pb::index::VectorSearchRequest request;
+  auto* parameter = request.mutable_parameter();
+  parameter->set_top_n(FLAGS_vector_topn);
+  parameter->set_without_vector_data(true);
+  parameter->set_without_scalar_data(true);
+  parameter->set_without_table_data(true);
+  if (ef_search > 0) {
+    parameter->mutable_hnsw()->set_efsearch(ef_search);
+  }
+
+  auto* vector_with_id = request.add_vector_with_ids();
+  vector_with_id->mutable_vector()->set_dimension(dimension_);
+  vector_with_id->mutable_vector()->set_value_type(dingodb::pb::common::ValueType::FLOAT);
+  vector_with_id->mutable_vector()->mutable_float_values()->Add(query.begin(), query.end());
+
+  if (!tag.empty()) {
+    parameter->set_vector_filter(dingodb::pb::common::VectorFilter::SCALAR_FILTER);
+    parameter->set_vector_filter_type(FLAGS_vector_filter_post ? dingodb::pb::common::VectorFilterType::QUERY_POST
+                                                               : dingodb::pb::common::VectorFilterType::QUERY_PRE);
+    dingodb::pb::common::ScalarValue scalar_value;
+    scalar_value.set_field_type(dingodb::pb::common::ScalarFieldType::STRING);
+    scalar_value.add_fields()->set_string_data(tag);
+    vector_with_id->mutable_scalar_data()->mutable_scalar_data()->insert({kVectorTagKey, scalar_value});
+  }
+
+  // vector index is partitioned by region, merge top n of all regions
+  std::vector<std::pair<float, uint64_t>> results;
+  for (const auto& region_entry : client_->GetRegionEntries()) {
+    dingodb::pb::index::VectorSearchResponse response;
+    auto status = client_->SendRequest("IndexService", "VectorSearch", region_entry, request, response);
+    if (!status.ok()) {
+      return false;
+    }
+
+    for (const auto& batch_result : response.batch_results()) {
+      for (const auto& vector_with_distance : batch_result.vector_with_distances()) {
+        results.emplace_back(vector_with_distance.distance(), vector_with_distance.vector_with_id().id());
+      }
+    }
+  }
+
+  size_t topn = std::min(results.size(), static_cast<size_t>(FLAGS_vector_topn));
+  std::partial_sort(results.begin(), results.begin() + topn, results.end());
+  vector_ids.clear();
+  for (size_t i = 0; i < topn; ++i) {
+    vector_ids.push_back(results[i].second);
+  }
+
+  return true;
+}
+
+std::vector<uint64_t> VectorWorkload::BruteForceSearch(const std::vector<float>& query, const std::string& tag) {
+  std::vector<std::pair<float, uint64_t>> results;
+  results.reserve(FLAGS_vector_count);
+  for (uint64_t offset = 0; offset < FLAGS_vector_count; ++offset) {
+    uint64_t vector_id = FLAGS_vector_start_id + offset;
+    if (!tag.empty() && GenTag(vector_id) != tag) {
+      continue;
+    }
+    results.emplace_back(Distance(query.data(), GetVector(offset), dimension_), vector_id);
+  }
+
+  size_t topn = std::min(results.size(), static_cast<size_t>(FLAGS_vector_topn));
+  std::partial_sort(results.begin(), results.begin() + topn, results.end());
+
+  std::vector<uint64_t> vector_ids;
+  for (size_t i = 0; i < topn; ++i) {
+    vector_ids.push_back(results[i].second);
+  }
+  return vector_ids;
+}
+
+double VectorWorkload::MeasureRecall(int32_t ef_search) {
+  uint64_t hit_count = 0;
+  uint64_t total_count = 0;
+  for (size_t i = 0; i < queries_.size(); ++i) {
+    std::string tag = FLAGS_vector_filter_tag_count > 0 ? GenTag(i) : "";
+
+    std::vector<uint64_t> vector_ids;
+    if (!SearchAllRegions(queries_[i], tag, ef_search, vector_ids)) {
+      continue;
+    }
+
+    auto expect_vector_ids = BruteForceSearch(queries_[i], tag);
+    std::sort(vector_ids.begin(), vector_ids.end());
+    for (auto vector_id : expect_vector_ids) {
+      if (std::binary_search(vector_ids.begin(), vector_ids.end(), vector_id)) {
+        ++hit_count;
+      }
+    }
+    total_count += expect_vector_ids.size();
+  }
+
+  return total_count == 0 ? 0 : static_cast<double>(hit_count) / total_count;
+}
+
+bool VectorWorkload::Search(std::mt19937_64& engine, WorkerStats& stats) {
+  std::uniform_int_distribution<size_t> distrib(0, queries_.size() - 1);
+  size_t query_no = distrib(engine);
+  std::string tag = FLAGS_vector_filter_tag_count > 0 ? GenTag(query_no) : "";
+
+  std::vector<uint64_t> vector_ids;
+  uint64_t start_time = butil::gettimeofday_us();
+  bool success = SearchAllRegions(queries_[query_no], tag, ef_search_, vector_ids);
+  stats.Record(OpType::kVectorSearch, butil::gettimeofday_us() - start_time, success);
+
+  return true;
+}
+
+struct WorkerParam {
+  BenchDriver* driver;
+  uint32_t thread_no;
+  WorkerStatsPtr stats;
+  bool has_operation_limit;
+};
+
+void* BenchDriver::WorkerRoutine(void* arg) {
+  std::unique_ptr<WorkerParam> param(static_cast<WorkerParam*>(arg));
+  auto* driver = param->driver;
+
+  std::mt19937_64 engine(FLAGS_bench_seed + param->thread_no + 1);
+  while (!driver->stop_.load(std::memory_order_relaxed)) {
+    if (param->has_operation_limit) {
+      uint64_t remain = driver->remain_operation_count_.load(std::memory_order_relaxed);
+      do {
+        if (remain == 0) {
+          driver->running_worker_count_.fetch_sub(1);
+          return nullptr;
+        }
+      } while (!driver->remain_operation_count_.compare_exchange_weak(remain, remain - 1));
+    }
+
+    if (!driver->workload_->Execute(param->thread_no, engine, *param->stats)) {
+      break;
+    }
+  }
+
+  driver->running_worker_count_.fetch_sub(1);
+  return nullptr;
+}
+
+bool BenchDriver::Run(uint32_t thread_num, uint64_t duration_s, uint64_t operation_count, Reporter& reporter) {
+  if (!workload_->Prepare()) {
+    DINGO_LOG(ERROR) << fmt::format("[bench] prepare workload {} failed", workload_->Name());
+    return false;
+  }
+
+  remain_operation_count_.store(operation_count);
+
+  std::vector<bthread_t> tids(thread_num);
+  std::vector<bool> started(thread_num, false);
+  for (uint32_t i = 0; i < thread_num; ++i) {
+    auto stats = std::make_shared<WorkerStats>();
+    worker_stats_.push_back(stats);
+
+    auto* param = new WorkerParam{this, i, stats, operation_count > 0};
+    running_worker_count_.fetch_add(1);
+    if (bthread_start_background(&tids[i], nullptr, BenchDriver::WorkerRoutine, param) != 0) {
+      DINGO_LOG(ERROR) << "[bench] fail to create bthread";
+      running_worker_count_.fetch_sub(1);
+      delete param;
+      continue;
+    }
+    started[i] = true;
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[bench] start workload {} thread_num {} duration {}s operation_count {}",
+                                 workload_->Name(), thread_num, duration_s, operation_count);
+
+  // worker will exit when no more operation, so check whether all worker finished every interval
+  uint64_t interval_ms = std::max(FLAGS_bench_report_interval_s, static_cast<uint32_t>(1)) * 1000;
+  uint64_t start_time = butil::gettimeofday_ms();
+  uint64_t last_report_time = start_time;
+  for (;;) {
+    bthread_usleep(interval_ms * 1000);
+
+    uint64_t now = butil::gettimeofday_ms();
+    reporter.Report((now - start_time) / 1000, worker_stats_, now - last_report_time);
+    last_report_time = now;
+
+    if (duration_s > 0 && now - start_time >= duration_s * 1000) {
+      stop_.store(true);
+      break;
+    }
+
+    if (running_worker_count_.load() == 0) {
+      break;
+    }
+  }
+
+  for (uint32_t i = 0; i < thread_num; ++i) {
+    if (started[i]) {
+      bthread_join(tids[i], nullptr);
+    }
+  }
+
+  uint64_t now = butil::gettimeofday_ms();
+  reporter.Report((now - start_time) / 1000, worker_stats_, now - last_report_time);
+  reporter.Summary(now - start_time);
+
+  return true;
+}
+
+}  // namespace bench
@@ -0,0 +1,214 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_BENCH_DRIVER_H_
+#define DINGODB_BENCH_DRIVER_H_
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench/bench_histogram.h"
+#include "bthread/types.h"
+#include "butil/status.h"
+#include "butil/time.h"
+#include "client/client_interation.h"
+#include "client/client_router.h"
+#include "proto/error.pb.h"
+
+namespace bench {
+
+enum class OpType {
+  kRead = 0,
+  kUpdate = 1,
+  kScan = 2,
+  kInsert = 3,
+  kVectorInsert = 4,
+  kVectorSearch = 5,
+  kMax = 6,
+};
+
+const char* OpTypeName(OpType op_type);
+
+// Route request to region leader through client::RegionRouter,
+// every region has its own ServerInteraction, so requests of different regions go to different stores.
+class BenchClient {
+ public:
+  BenchClient() = default;
+  ~BenchClient() = default;
+
+  // Load region route from coordinator.
+  bool Init(const std::vector<uint64_t>& region_ids);
+
+  std::vector<client::RegionEntryPtr> GetRegionEntries() const { return region_entries_; }
+
+  client::RegionEntryPtr Route(const std::string& key);
+
+  template <typename Request, typename Response>
+  butil::Status SendRequest(const std::string& service_name, const std::string& api_name,
+                            client::RegionEntryPtr region_entry, Request& request, Response& response) {
+    request.mutable_context()->set_region_id(region_entry->RegionId());
+    return client::InteractionManager::GetInstance().SendRequestWithRegion(service_name, api_name, request,
+                                                                           response);
+  }
+
+ private:
+  std::vector<client::RegionEntryPtr> region_entries_;
+};
+
+// Statistics of one worker, record by worker and collect by reporter every interval.
+class WorkerStats {
+ public:
+  WorkerStats();
+  ~WorkerStats();
+
+  void Record(OpType op_type, uint64_t latency_us, bool success);
+
+  // move interval statistics into histograms and reset
+  void Collect(std::vector<LatencyHistogram>& histograms, std::vector<uint64_t>& errors);
+
+ private:
+  bthread_mutex_t mutex_;
+  std::vector<LatencyHistogram> histograms_;
+  std::vector<uint64_t> errors_;
+};
+
+using WorkerStatsPtr = std::shared_ptr<WorkerStats>;
+
+// Print per interval throughput and latency, and write to report file with csv or json lines format.
+class Reporter {
+ public:
+  Reporter() = default;
+  ~Reporter();
+
+  bool Init(const std::string& file, const std::string& format);
+
+  void Report(uint64_t elapsed_s, const std::vector<WorkerStatsPtr>& worker_stats, uint64_t interval_ms);
+  void Summary(uint64_t elapsed_ms);
+
+ private:
+  void Write(const std::string& phase, uint64_t elapsed_s, OpType op_type, uint64_t duration_ms,
+             const LatencyHistogram& histogram, uint64_t error_count);
+
+  std::string format_;
+  std::ofstream out_;
+
+  std::vector<LatencyHistogram> total_histograms_ = std::vector<LatencyHistogram>(static_cast<size_t>(OpType::kMax));
+  std::vector<uint64_t> total_errors_ = std::vector<uint64_t>(static_cast<size_t>(OpType::kMax), 0);
+};
+
+class Workload {
+ public:
+  Workload(std::shared_ptr<BenchClient> client) : client_(client) {}
+  virtual ~Workload() = default;
+
+  virtual std::string Name() = 0;
+  // run before benchmark, e.g. load data
+  virtual bool Prepare() = 0;
+  // execute one operation, return false if no more operation
+  virtual bool Execute(uint32_t thread_no, std::mt19937_64& engine, WorkerStats& stats) = 0;
+
+ protected:
+  std::shared_ptr<BenchClient> client_;
+};
+
+using WorkloadPtr = std::shared_ptr<Workload>;
+
+// YCSB style kv workload, mix of read/update/scan/insert on record [0, record_count).
+class KvWorkload : public Workload {
+ public:
+  KvWorkload(std::shared_ptr<BenchClient> client);
+  ~KvWorkload() override = default;
+
+  std::string Name() override { return "kv"; }
+  bool Prepare() override;
+  bool Execute(uint32_t thread_no, std::mt19937_64& engine, WorkerStats& stats) override;
+
+  std::string GenKey(uint64_t record_no) const;
+
+ private:
+  uint64_t NextRecordNo(std::mt19937_64& engine);
+  std::string GenValue(std::mt19937_64& engine) const;
+
+  bool Read(std::mt19937_64& engine, WorkerStats& stats);
+  bool Update(std::mt19937_64& engine, WorkerStats& stats);
+  bool Scan(std::mt19937_64& engine, WorkerStats& stats);
+  bool Insert(std::mt19937_64& engine, WorkerStats& stats);
+
+  std::unique_ptr<ZipfianGenerator> zipfian_generator_;
+  std::atomic<uint64_t> insert_record_no_;
+};
+
+// ANN vector workload, insert throughput or search qps at a target recall, support scalar filter.
+// Dataset is generated by fixed seed, so the search phase can run in other process after the insert phase.
+class VectorWorkload : public Workload {
+ public:
+  VectorWorkload(std::shared_ptr<BenchClient> client, bool is_search);
+  ~VectorWorkload() override = default;
+
+  std::string Name() override { return is_search_ ? "vector_search" : "vector_insert"; }
+  bool Prepare() override;
+  bool Execute(uint32_t thread_no, std::mt19937_64& engine, WorkerStats& stats) override;
+
+ private:
+  const float* GetVector(uint64_t offset) const { return dataset_.data() + offset * dimension_; }
+  std::string GenTag(uint64_t vector_id) const;
+  client::RegionEntryPtr RouteVector(uint64_t vector_id);
+
+  bool Insert(WorkerStats& stats);
+  bool Search(std::mt19937_64& engine, WorkerStats& stats);
+
+  // search with ef_search and return the recall against brute force ground truth
+  double MeasureRecall(int32_t ef_search);
+  bool SearchAllRegions(const std::vector<float>& query, const std::string& tag, int32_t ef_search,
+                        std::vector<uint64_t>& vector_ids);
+  std::vector<uint64_t> BruteForceSearch(const std::vector<float>& query, const std::string& tag);
+
+  bool is_search_;
+  uint32_t dimension_;
+  uint64_t partition_id_;
+  std::vector<float> dataset_;
+  std::vector<std::vector<float>> queries_;
+
+  std::atomic<uint64_t> insert_offset_;
+  int32_t ef_search_;
+};
+
+// Drive workers to execute workload until duration or operation count reached.
+class BenchDriver {
+ public:
+  BenchDriver(WorkloadPtr workload) : workload_(workload) {}
+  ~BenchDriver() = default;
+
+  bool Run(uint32_t thread_num, uint64_t duration_s, uint64_t operation_count, Reporter& reporter);
+
+ private:
+  static void* WorkerRoutine(void* arg);
+
+  WorkloadPtr workload_;
+  std::vector<WorkerStatsPtr> worker_stats_;
+
+  std::atomic<bool> stop_{false};
+  std::atomic<uint64_t> remain_operation_count_{0};
+  std::atomic<uint32_t> running_worker_count_{0};
+};
+
+}  // namespace bench
+
+#endif  // DINGODB_BENCH_DRIVER_H_
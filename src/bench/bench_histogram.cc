@@ -0,0 +1,146 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "bench/bench_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace bench {
+
+LatencyHistogram::LatencyHistogram()
+    : buckets_(kBucketCount, 0), count_(0), sum_(0), min_(std::numeric_limits<uint64_t>::max()), max_(0) {}
+
+uint32_t LatencyHistogram::BucketIndex(uint64_t value) {
+  if (value < kSubBucketCount) {
+    return static_cast<uint32_t>(value);
+  }
+
+  uint32_t msb = 63 - __builtin_clzll(value);
+  uint32_t shift = msb - kSubBucketBits + 1;
+  uint64_t sub_bucket = value >> shift;  // in [kSubBucketHalfCount, kSubBucketCount)
+
+  return kSubBucketCount + (shift - 1) * kSubBucketHalfCount + (sub_bucket - kSubBucketHalfCount);
+}
+
+uint64_t LatencyHistogram::BucketHighestValue(uint32_t index) {
+  if (index < kSubBucketCount) {
+    return index;
+  }
+
+  uint32_t shift = (index - kSubBucketCount) / kSubBucketHalfCount + 1;
+  uint64_t sub_bucket = (index - kSubBucketCount) % kSubBucketHalfCount + kSubBucketHalfCount;
+
+  return ((sub_bucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value) {
+  ++buckets_[BucketIndex(value)];
+  ++count_;
+  sum_ += value;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  if (other.count_ == 0) {
+    return;
+  }
+
+  for (uint32_t i = 0; i < kBucketCount; ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  sum_ += other.sum_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+}
+
+void LatencyHistogram::Reset() {
+  std::fill(buckets_.begin(), buckets_.end(), 0);
+  count_ = 0;
+  sum_ = 0;
+  min_ = std::numeric_limits<uint64_t>::max();
+  max_ = 0;
+}
+
+uint64_t LatencyHistogram::Percentile(double percentile) const {
+  if (count_ == 0) {
+    return 0;
+  }
+
+  percentile = std::clamp(percentile, 0.0, 100.0);
+  uint64_t target = std::max(static_cast<uint64_t>(std::ceil(percentile / 100.0 * count_)), static_cast<uint64_t>(1));
+
+  uint64_t accumulated = 0;
+  for (uint32_t i = 0; i < kBucketCount; ++i) {
+    accumulated += buckets_[i];
+    if (accumulated >= target) {
+      return std::clamp(BucketHighestValue(i), Min(), max_);
+    }
+  }
+
+  return max_;
+}
+
+ZipfianGenerator::ZipfianGenerator(uint64_t item_count, double theta)
+    : item_count_(std::max(item_count, static_cast<uint64_t>(1))), theta_(theta) {
+  double zeta2 = Zeta(2, theta_);
+  alpha_ = 1.0 / (1.0 - theta_);
+  zetan_ = Zeta(item_count_, theta_);
+  eta_ = (1 - std::pow(2.0 / item_count_, 1 - theta_)) / (1 - zeta2 / zetan_);
+  half_pow_theta_ = 1.0 + std::pow(0.5, theta_);
+}
+
+double ZipfianGenerator::Zeta(uint64_t n, double theta) {
+  double sum = 0;
+  for (uint64_t i = 1; i <= n; ++i) {
+    sum += 1.0 / std::pow(static_cast<double>(i), theta);
+  }
+
+  return sum;
+}
+
+uint64_t ZipfianGenerator::Next(std::mt19937_64& engine) const {
+  std::uniform_real_distribution<double> distrib(0.0, 1.0);
+  double u = distrib(engine);
+  double uz = u * zetan_;
+
+  if (uz < 1.0) {
+    return 0;
+  }
+  if (uz < half_pow_theta_) {
+    return std::min(static_cast<uint64_t>(1), item_count_ - 1);
+  }
+
+  auto item = static_cast<uint64_t>(item_count_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+  return std::min(item, item_count_ - 1);
+}
+
+uint64_t ZipfianGenerator::NextScrambled(std::mt19937_64& engine, uint64_t item_count) const {
+  // FNV-1a 64 bit hash
+  uint64_t value = Next(engine);
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (int i = 0; i < 8; ++i) {
+    hash ^= (value & 0xff);
+    hash *= 0x100000001b3ULL;
+    value >>= 8;
+  }
+
+  return hash % (item_count == 0 ? item_count_ : item_count);
+}
+
+}  // namespace bench
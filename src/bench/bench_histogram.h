@@ -0,0 +1,89 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_BENCH_HISTOGRAM_H_
+#define DINGODB_BENCH_HISTOGRAM_H_
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace bench {
+
+// Log-linear latency histogram in the spirit of HdrHistogram.
+// Values below 2^kSubBucketBits are recorded exactly, larger values are grouped by power of two,
+// and every group is split into 2^(kSubBucketBits-1) linear sub buckets, so the relative error is below 1/64.
+// Not thread safe, every worker own its histogram and merge by reporter.
+class LatencyHistogram {
+ public:
+  LatencyHistogram();
+  ~LatencyHistogram() = default;
+
+  void Record(uint64_t value);
+  void Merge(const LatencyHistogram& other);
+  void Reset();
+
+  uint64_t Count() const { return count_; }
+  uint64_t Min() const { return count_ == 0 ? 0 : min_; }
+  uint64_t Max() const { return max_; }
+  double Mean() const { return count_ == 0 ? 0 : static_cast<double>(sum_) / count_; }
+
+  // percentile in [0, 100]
+  uint64_t Percentile(double percentile) const;
+
+ private:
+  static constexpr uint32_t kSubBucketBits = 7;
+  static constexpr uint32_t kSubBucketCount = 1 << kSubBucketBits;
+  static constexpr uint32_t kSubBucketHalfCount = kSubBucketCount / 2;
+  static constexpr uint32_t kBucketCount = kSubBucketCount + (64 - kSubBucketBits) * kSubBucketHalfCount;
+
+  static uint32_t BucketIndex(uint64_t value);
+  // the highest value which is equivalent to the bucket
+  static uint64_t BucketHighestValue(uint32_t index);
+
+  std::vector<uint64_t> buckets_;
+  uint64_t count_;
+  uint64_t sum_;
+  uint64_t min_;
+  uint64_t max_;
+};
+
+// YCSB zipfian generator, generate item in [0, item_count), item 0 is the most popular one.
+// Gray et al, "Quickly Generating Billion-Record Synthetic Databases", SIGMOD 1994.
+// Read only after construct, so it can be shared between threads, every thread use its own random engine.
+class ZipfianGenerator {
+ public:
+  ZipfianGenerator(uint64_t item_count, double theta);
+  ~ZipfianGenerator() = default;
+
+  uint64_t Next(std::mt19937_64& engine) const;
+
+  // scatter the popular items over [0, item_count), like YCSB ScrambledZipfianGenerator.
+  // item_count may grow beyond the constructed one when record is inserted, 0 means the constructed one.
+  uint64_t NextScrambled(std::mt19937_64& engine, uint64_t item_count = 0) const;
+
+ private:
+  static double Zeta(uint64_t n, double theta);
+
+  uint64_t item_count_;
+  double theta_;
+  double alpha_;
+  double zetan_;
+  double eta_;
+  double half_pow_theta_;
+};
+
+}  // namespace bench
+
+#endif  // DINGODB_BENCH_HISTOGRAM_H_
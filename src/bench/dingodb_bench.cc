@@ -0,0 +1,158 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bench/bench_driver.h"
+#include "butil/strings/string_split.h"
+#include "client/client_helper.h"
+#include "client/client_interation.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "common/version.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "glog/logging.h"
+
+// used by client interaction
+DEFINE_bool(log_each_request, false, "Print log for each request");
+DEFINE_uint64(timeout_ms, 5000, "Timeout for each request");
+
+DEFINE_string(coor_url, "file://./coor_list", "coordinator url");
+DEFINE_string(workload, "kv", "bench workload: kv, vector_insert, vector_search");
+DEFINE_string(region_ids, "", "region ids of bench data, splited by ,");
+DEFINE_uint32(thread_num, 8, "Number of worker bthreads");
+DEFINE_uint64(duration_s, 60, "Bench duration seconds, 0 means run until operation_count or workload finished");
+DEFINE_uint64(operation_count, 0, "Total operation count of all workers, 0 means no limit");
+DEFINE_uint64(bench_seed, 1, "Random seed of generated data");
+DEFINE_uint32(bench_report_interval_s, 1, "Report interval seconds");
+DEFINE_string(report_file, "", "Report file, empty means only print log");
+DEFINE_string(report_format, "csv", "Report file format: csv or json, json is json lines");
+
+// kv workload
+DEFINE_bool(kv_load, false, "Load records [0, kv_record_count) by batch put instead of running mixed operations");
+DEFINE_uint64(kv_record_count, 100000, "Record count of kv workload");
+DEFINE_double(kv_read_proportion, 0.95, "Proportion of read operation");
+DEFINE_double(kv_update_proportion, 0.05, "Proportion of update operation");
+DEFINE_double(kv_scan_proportion, 0, "Proportion of scan operation");
+DEFINE_double(kv_insert_proportion, 0, "Proportion of insert operation");
+DEFINE_string(kv_key_distribution, "zipfian", "Key distribution: zipfian or uniform");
+DEFINE_double(kv_zipfian_theta, 0.99, "Theta of zipfian distribution");
+DEFINE_string(kv_key_prefix, "bench", "Key prefix, key must be in the range of region_ids");
+DEFINE_uint32(kv_value_size, 100, "Value size");
+DEFINE_uint32(kv_scan_length, 100, "Max record count of scan operation");
+DEFINE_uint32(kv_batch_size, 100, "Batch size of load");
+
+// vector workload
+DEFINE_uint32(vector_dimension, 128, "Vector dimension");
+DEFINE_uint64(vector_count, 100000, "Vector count of dataset");
+DEFINE_uint64(vector_start_id, 1, "Vector id of the first vector in dataset");
+DEFINE_uint32(vector_batch_size, 256, "Batch size of vector insert");
+DEFINE_uint32(vector_topn, 10, "Top n of vector search");
+DEFINE_int32(vector_ef_search, 0, "HNSW ef search, 0 means use server default");
+DEFINE_double(vector_target_recall, 0, "Find the minimal ef search which reach this recall before search, 0 disable");
+DEFINE_uint32(vector_query_count, 100, "Query count, also used to measure recall");
+DEFINE_string(vector_metric_type, "L2", "Metric type of vector index for ground truth: L2 or IP");
+DEFINE_uint32(vector_filter_tag_count, 0, "Tag vectors with tag{id % count} and search with scalar filter, 0 disable");
+DEFINE_bool(vector_filter_post, false, "Use post filter instead of pre filter");
+
+static std::vector<uint64_t> ParseRegionIds(const std::string& str) {
+  std::vector<std::string> strs;
+  butil::SplitString(str, ',', &strs);
+
+  std::vector<uint64_t> region_ids;
+  for (const auto& s : strs) {
+    if (!s.empty()) {
+      region_ids.push_back(std::stoull(s));
+    }
+  }
+
+  return region_ids;
+}
+
+int main(int argc, char* argv[]) {
+  FLAGS_minloglevel = google::GLOG_INFO;
+  FLAGS_logtostdout = true;
+  FLAGS_colorlogtostdout = true;
+  FLAGS_logbufsecs = 0;
+  google::InitGoogleLogging(argv[0]);
+
+  if (argc > 1 && dingodb::Helper::IsExistPath(argv[1])) {
+    google::SetCommandLineOption("flagfile", argv[1]);
+  }
+
+  google::ParseCommandLineFlags(&argc, &argv, true);
+
+  if (dingodb::FLAGS_show_version) {
+    dingodb::DingoShowVerion();
+    printf("Usage: %s [flagfile] --workload=kv --region_ids=1,2 [paramters]\n", argv[0]);
+    exit(-1);
+  }
+
+  auto region_ids = ParseRegionIds(FLAGS_region_ids);
+  if (region_ids.empty()) {
+    DINGO_LOG(ERROR) << "region_ids is empty, please set --region_ids";
+    return -1;
+  }
+
+  std::string path = FLAGS_coor_url;
+  if (path.find("file://") == 0) {
+    path = path.replace(0, 7, "");
+  }
+  auto addrs = client::Helper::GetAddrsFromFile(path);
+  if (addrs.empty()) {
+    DINGO_LOG(ERROR) << "url not find addr, path=" << path;
+    return -1;
+  }
+
+  auto coordinator_interaction = std::make_shared<client::ServerInteraction>();
+  if (!coordinator_interaction->Init(addrs)) {
+    DINGO_LOG(ERROR) << "Fail to init coordinator_interaction, please check parameter --coor_url=" << FLAGS_coor_url;
+    return -1;
+  }
+  client::InteractionManager::GetInstance().SetCoorinatorInteraction(coordinator_interaction);
+
+  auto bench_client = std::make_shared<bench::BenchClient>();
+  if (!bench_client->Init(region_ids)) {
+    DINGO_LOG(ERROR) << "Fail to init bench client, please check parameter --region_ids=" << FLAGS_region_ids;
+    return -1;
+  }
+
+  bench::WorkloadPtr workload;
+  if (FLAGS_workload == "kv") {
+    workload = std::make_shared<bench::KvWorkload>(bench_client);
+  } else if (FLAGS_workload == "vector_insert") {
+    workload = std::make_shared<bench::VectorWorkload>(bench_client, false);
+  } else if (FLAGS_workload == "vector_search") {
+    workload = std::make_shared<bench::VectorWorkload>(bench_client, true);
+  } else {
+    DINGO_LOG(ERROR) << "Unknown workload: " << FLAGS_workload;
+    return -1;
+  }
+
+  bench::Reporter reporter;
+  if (!reporter.Init(FLAGS_report_file, FLAGS_report_format)) {
+    return -1;
+  }
+
+  bench::BenchDriver driver(workload);
+  if (!driver.Run(FLAGS_thread_num, FLAGS_duration_s, FLAGS_operation_count, reporter)) {
+    return -1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,224 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "client/client_batch.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include "client/client_interation.h"
+#include "client/client_router.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "proto/index.pb.h"
+#include "proto/store.pb.h"
+#include "vector/codec.h"
+
+namespace client {
+
+// Split items by the region of keys[i], send requests in parallel and merge results,
+// re-split the items of stale region by the refreshed route and retry.
+template <typename Request, typename Response>
+static butil::Status SendBatchByRegion(const std::string& service_name, const std::string& api_name,
+                                       const std::vector<std::string>& keys,
+                                       std::function<void(Request&, size_t)> add_item,
+                                       std::function<void(const Response&, const std::vector<size_t>&)> merge_result) {
+  std::vector<size_t> pending_indexes(keys.size());
+  std::iota(pending_indexes.begin(), pending_indexes.end(), 0);
+
+  Backoff backoff;
+  for (;;) {
+    std::vector<std::string> pending_keys;
+    pending_keys.reserve(pending_indexes.size());
+    for (auto index : pending_indexes) {
+      pending_keys.push_back(keys[index]);
+    }
+
+    std::map<uint64_t, std::vector<size_t>> region_key_indexes;
+    auto status = RegionRouter::GetInstance().GroupKeysByRegion(pending_keys, region_key_indexes);
+    if (!status.ok()) {
+      return status;
+    }
+
+    std::vector<Request> requests;
+    std::vector<std::vector<size_t>> request_indexes;
+    for (auto& [region_id, indexes] : region_key_indexes) {
+      auto& request = requests.emplace_back();
+      request.mutable_context()->set_region_id(region_id);
+
+      auto& item_indexes = request_indexes.emplace_back();
+      for (auto index : indexes) {
+        item_indexes.push_back(pending_indexes[index]);
+        add_item(request, pending_indexes[index]);
+      }
+    }
+
+    std::vector<Response> responses;
+    std::vector<butil::Status> statuses;
+    InteractionManager::GetInstance().SendRequestByRegions(service_name, api_name, requests, responses, statuses);
+
+    pending_indexes.clear();
+    for (size_t i = 0; i < requests.size(); ++i) {
+      if (statuses[i].ok()) {
+        merge_result(responses[i], request_indexes[i]);
+      } else if (InteractionManager::IsRegionStaleError(responses[i].error().errcode())) {
+        pending_indexes.insert(pending_indexes.end(), request_indexes[i].begin(), request_indexes[i].end());
+        status = statuses[i];
+      } else {
+        return statuses[i];
+      }
+    }
+
+    if (pending_indexes.empty()) {
+      return butil::Status();
+    }
+
+    DINGO_LOG(INFO) << fmt::format("{} region stale, retry {} items, error: {}", api_name, pending_indexes.size(),
+                                   status.error_str());
+    if (!backoff.Sleep()) {
+      return status;
+    }
+  }
+}
+
+butil::Status KvBatchGet(const std::vector<std::string>& keys, std::vector<dingodb::pb::common::KeyValue>& kvs) {
+  kvs.clear();
+  kvs.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    kvs[i].set_key(keys[i]);
+  }
+
+  return SendBatchByRegion<dingodb::pb::store::KvBatchGetRequest, dingodb::pb::store::KvBatchGetResponse>(
+      "StoreService", "KvBatchGet", keys,
+      [&](dingodb::pb::store::KvBatchGetRequest& request, size_t index) { request.add_keys(keys[index]); },
+      [&](const dingodb::pb::store::KvBatchGetResponse& response, const std::vector<size_t>& indexes) {
+        // response only contains the exist keys
+        std::map<std::string, const std::string*> values;
+        for (const auto& kv : response.kvs()) {
+          values[kv.key()] = &kv.value();
+        }
+        for (auto index : indexes) {
+          auto it = values.find(keys[index]);
+          if (it != values.end()) {
+            kvs[index].set_value(*it->second);
+          }
+        }
+      });
+}
+
+butil::Status KvBatchPut(const std::vector<dingodb::pb::common::KeyValue>& kvs) {
+  std::vector<std::string> keys;
+  keys.reserve(kvs.size());
+  for (const auto& kv : kvs) {
+    keys.push_back(kv.key());
+  }
+
+  return SendBatchByRegion<dingodb::pb::store::KvBatchPutRequest, dingodb::pb::store::KvBatchPutResponse>(
+      "StoreService", "KvBatchPut", keys,
+      [&](dingodb::pb::store::KvBatchPutRequest& request, size_t index) { *request.add_kvs() = kvs[index]; },
+      [](const dingodb::pb::store::KvBatchPutResponse&, const std::vector<size_t>&) {});
+}
+
+butil::Status KvBatchDelete(const std::vector<std::string>& keys) {
+  return SendBatchByRegion<dingodb::pb::store::KvBatchDeleteRequest, dingodb::pb::store::KvBatchDeleteResponse>(
+      "StoreService", "KvBatchDelete", keys,
+      [&](dingodb::pb::store::KvBatchDeleteRequest& request, size_t index) { request.add_keys(keys[index]); },
+      [](const dingodb::pb::store::KvBatchDeleteResponse&, const std::vector<size_t>&) {});
+}
+
+butil::Status VectorAdd(uint64_t partition_id, const std::vector<dingodb::pb::common::VectorWithId>& vectors) {
+  std::vector<std::string> keys(vectors.size());
+  for (size_t i = 0; i < vectors.size(); ++i) {
+    dingodb::VectorCodec::EncodeVectorKey(partition_id, vectors[i].id(), keys[i]);
+  }
+
+  return SendBatchByRegion<dingodb::pb::index::VectorAddRequest, dingodb::pb::index::VectorAddResponse>(
+      "IndexService", "VectorAdd", keys,
+      [&](dingodb::pb::index::VectorAddRequest& request, size_t index) { *request.add_vectors() = vectors[index]; },
+      [](const dingodb::pb::index::VectorAddResponse&, const std::vector<size_t>&) {});
+}
+
+butil::Status VectorSearch(uint64_t partition_id, const std::vector<dingodb::pb::common::VectorWithId>& vectors,
+                           const dingodb::pb::common::VectorSearchParameter& parameter,
+                           std::vector<std::vector<dingodb::pb::common::VectorWithDistance>>& results) {
+  std::vector<dingodb::pb::index::VectorSearchResponse> responses;
+  // region maybe split/merge, the route is refreshed by the failed request, search all regions of partition again once
+  for (int retry = 0;; ++retry) {
+    auto region_entries = RegionRouter::GetInstance().QueryRegionEntryByPartition(partition_id);
+    if (region_entries.empty()) {
+      return butil::Status(dingodb::pb::error::EREGION_NOT_FOUND, "Not found region of partition %lu", partition_id);
+    }
+
+    std::vector<dingodb::pb::index::VectorSearchRequest> requests(region_entries.size());
+    for (size_t i = 0; i < region_entries.size(); ++i) {
+      auto& request = requests[i];
+      request.mutable_context()->set_region_id(region_entries[i]->RegionId());
+      *request.mutable_parameter() = parameter;
+      for (const auto& vector : vectors) {
+        *request.add_vector_with_ids() = vector;
+      }
+    }
+
+    std::vector<butil::Status> statuses;
+    auto status = InteractionManager::GetInstance().SendRequestByRegions("IndexService", "VectorSearch", requests,
+                                                                         responses, statuses);
+    if (status.ok()) {
+      break;
+    }
+
+    bool is_stale = true;
+    for (size_t i = 0; i < statuses.size(); ++i) {
+      if (!statuses[i].ok() && !InteractionManager::IsRegionStaleError(responses[i].error().errcode())) {
+        is_stale = false;
+      }
+    }
+    if (!is_stale || retry > 0) {
+      return status;
+    }
+
+    DINGO_LOG(INFO) << fmt::format("VectorSearch partition {} region stale, retry, error: {}", partition_id,
+                                   status.error_str());
+    // the new regions of split are not in route cache yet
+    RegionRouter::GetInstance().ReloadRegionMap();
+  }
+
+  // merge top n of every region, smaller distance is nearer
+  results.clear();
+  results.resize(vectors.size());
+  for (const auto& response : responses) {
+    for (size_t i = 0; i < static_cast<size_t>(response.batch_results_size()) && i < results.size(); ++i) {
+      const auto& vector_with_distances = response.batch_results(i).vector_with_distances();
+      results[i].insert(results[i].end(), vector_with_distances.begin(), vector_with_distances.end());
+    }
+  }
+
+  for (auto& result : results) {
+    std::sort(result.begin(), result.end(),
+              [](const dingodb::pb::common::VectorWithDistance& a, const dingodb::pb::common::VectorWithDistance& b) {
+                return a.distance() < b.distance();
+              });
+    if (result.size() > parameter.top_n()) {
+      result.resize(parameter.top_n());
+    }
+  }
+
+  return butil::Status();
+}
+
+}  // namespace client
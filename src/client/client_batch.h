@@ -0,0 +1,47 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_CLIENT_BATCH_H_
+#define DINGODB_CLIENT_BATCH_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "butil/status.h"
+#include "proto/common.pb.h"
+
+namespace client {
+
+// Batch operations across regions.
+// Items are split by region route, requests of different regions are sent in parallel,
+// the items of stale region(split/merge) are re-split by the refreshed route and retried with backoff.
+
+// kvs is in the order of keys, the value is empty if key not exist.
+butil::Status KvBatchGet(const std::vector<std::string>& keys, std::vector<dingodb::pb::common::KeyValue>& kvs);
+
+butil::Status KvBatchPut(const std::vector<dingodb::pb::common::KeyValue>& kvs);
+
+butil::Status KvBatchDelete(const std::vector<std::string>& keys);
+
+butil::Status VectorAdd(uint64_t partition_id, const std::vector<dingodb::pb::common::VectorWithId>& vectors);
+
+// Search all regions of partition and merge the top n nearest results.
+butil::Status VectorSearch(uint64_t partition_id, const std::vector<dingodb::pb::common::VectorWithId>& vectors,
+                           const dingodb::pb::common::VectorSearchParameter& parameter,
+                           std::vector<std::vector<dingodb::pb::common::VectorWithDistance>>& results);
+
+}  // namespace client
+
+#endif  // DINGODB_CLIENT_BATCH_H_
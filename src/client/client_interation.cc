@@ -14,6 +14,7 @@
 
 #include "client/client_interation.h"
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -73,29 +74,44 @@ void ServerInteraction::NextLeader(int leader_index) {
   leader_index_.compare_exchange_weak(leader_index, next_leader_index);
 }
 
-void ServerInteraction::NextLeader(const dingodb::pb::common::Location& location) {
+bool ServerInteraction::NextLeader(const dingodb::pb::common::Location& location) {
   // DINGO_LOG(INFO) << fmt::format("redirect leader {}:{}", location.host(), location.port());
   if (location.port() == 0) {
-    bthread_usleep(500 * 1000L);
-    return;
+    return false;
   }
 
-  for (int i = 0; i < endpoints_.size(); ++i) {
-    auto endpoints = Helper::StrToEndpoints(location.host() + ":" + std::to_string(location.port()));
-    if (endpoints.empty()) {
-      bthread_usleep(500 * 1000L);
-      return;
-    }
+  auto endpoints = Helper::StrToEndpoints(location.host() + ":" + std::to_string(location.port()));
+  if (endpoints.empty()) {
+    return false;
+  }
 
+  for (size_t i = 0; i < endpoints_.size(); ++i) {
     if (endpoints[0].ip == endpoints_[i].ip && endpoints[0].port == endpoints_[i].port) {
       leader_index_.store(i);
-      return;
+      return true;
     }
   }
 
   if (AddAddr(fmt::format("{}:{}", location.host(), location.port()))) {
     leader_index_.store(endpoints_.size() - 1);
+    return true;
+  }
+
+  return false;
+}
+
+bool Backoff::Sleep() {
+  if (retry_count_ >= max_retry_) {
+    return false;
   }
+
+  // equal jitter, sleep random in [delay/2, delay]
+  int64_t delay_ms = std::min(base_ms_ << std::min(retry_count_, 30), max_ms_);
+  delay_ms = delay_ms / 2 + static_cast<int64_t>(butil::fast_rand_less_than(delay_ms / 2 + 1));
+  ++retry_count_;
+
+  bthread_usleep(delay_ms * 1000L);
+  return true;
 }
 
 InteractionManager::InteractionManager() { bthread_mutex_init(&mutex_, nullptr); }
@@ -143,6 +159,38 @@ butil::Status InteractionManager::CreateStoreInteraction(uint64_t region_id) {
 
   return butil::Status();
 }
+
+ServerInteractionPtr InteractionManager::GetRegionInteraction(RegionEntryPtr region_entry) {
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    auto it = region_interactions_.find(region_entry->RegionId());
+    // region entry is copy on write, same entry means same peers
+    if (it != region_interactions_.end() && it->second.first == region_entry) {
+      return it->second.second;
+    }
+  }
+
+  auto interaction = std::make_shared<ServerInteraction>();
+  if (!interaction->Init(region_entry->GetAddrs())) {
+    DINGO_LOG(ERROR) << fmt::format("init region interaction failed, region {}", region_entry->RegionId());
+    return nullptr;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  region_interactions_[region_entry->RegionId()] = {region_entry, interaction};
+  return interaction;
+}
+
+RegionEntryPtr InteractionManager::RefreshRegionEntry(uint64_t region_id, const dingodb::pb::error::Error& error) {
+  if (error.has_store_region_info() && error.store_region_info().region_id() == region_id) {
+    RegionRouter::GetInstance().UpdateRegionEntry(error.store_region_info());
+  } else {
+    RegionRouter::GetInstance().InvalidateRegionEntry(region_id);
+  }
+
+  return RegionRouter::GetInstance().QueryRegionEntry(region_id);
+}
+
 uint64_t InteractionManager::GetLatency() const {
   if (store_interaction_ == nullptr) {
     return 0;
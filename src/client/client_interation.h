@@ -47,6 +47,27 @@ DECLARE_uint64(timeout_ms);
 namespace client {
 
 const int kMaxRetry = 5;
+const int64_t kBackoffBaseMs = 10;
+const int64_t kBackoffMaxMs = 1000;
+
+// Exponential backoff with jitter for retry, sleep base, 2*base, 4*base ... up to max.
+class Backoff {
+ public:
+  Backoff(int64_t base_ms = kBackoffBaseMs, int64_t max_ms = kBackoffMaxMs, int max_retry = kMaxRetry)
+      : base_ms_(base_ms), max_ms_(max_ms), max_retry_(max_retry), retry_count_(0) {}
+  ~Backoff() = default;
+
+  // Return false if reach max retry, not sleep.
+  bool Sleep();
+
+  int RetryCount() const { return retry_count_; }
+
+ private:
+  int64_t base_ms_;
+  int64_t max_ms_;
+  int max_retry_;
+  int retry_count_;
+};
 
 class ServerInteraction {
  public:
@@ -63,7 +84,8 @@ class ServerInteraction {
 
   int GetLeader();
   void NextLeader(int leader_index);
-  void NextLeader(const dingodb::pb::common::Location& location);
+  // Return false if the location is not a valid leader.
+  bool NextLeader(const dingodb::pb::common::Location& location);
 
   template <typename Request, typename Response>
   butil::Status SendRequest(const std::string& service_name, const std::string& api_name, const Request& request,
@@ -110,6 +132,7 @@ butil::Status ServerInteraction::SendRequest(const std::string& service_name, co
   }
 
   int retry_count = 0;
+  Backoff backoff(kBackoffBaseMs, kBackoffMaxMs, kMaxRetry);
   do {
     brpc::Controller cntl;
     cntl.set_timeout_ms(FLAGS_timeout_ms);
@@ -136,7 +159,11 @@ butil::Status ServerInteraction::SendRequest(const std::string& service_name, co
       if (response.error().errcode() == dingodb::pb::error::ERAFT_NOTLEADER ||
           response.error().errcode() == dingodb::pb::error::EREGION_NOT_FOUND) {
         ++retry_count;
-        NextLeader(response.error().leader_location());
+        // redirect to the new leader immediately, backoff if the leader is unknown, e.g. electing
+        if (!NextLeader(response.error().leader_location())) {
+          NextLeader(leader_index);
+          backoff.Sleep();
+        }
 
       } else {
         if (!FLAGS_log_each_request) {
@@ -202,14 +229,47 @@ class InteractionManager {
   butil::Status AllSendRequestWithContext(const std::string& service_name, const std::string& api_name,
                                           const Request& request, Response& response);
 
+  // Send request to the stores of its region, context is filled by region route.
+  // If retry_on_stale is false, only refresh region route and return when region is stale, used by batch request
+  // which need to re-split by the new route.
+  template <typename Request, typename Response>
+  butil::Status SendRequestWithRegion(const std::string& service_name, const std::string& api_name,
+                                      Request& request, Response& response, bool retry_on_stale = true);
+
+  // Send requests of different regions in parallel, responses[i] is the response of requests[i].
+  // Return the first failed status, the region of the failed request need to be re-split by caller
+  // if the error is region stale.
+  template <typename Request, typename Response>
+  butil::Status SendRequestByRegions(const std::string& service_name, const std::string& api_name,
+                                     std::vector<Request>& requests, std::vector<Response>& responses,
+                                     std::vector<butil::Status>& statuses);
+
+  static bool IsRegionStaleError(dingodb::pb::error::Errno errcode) {
+    return errcode == dingodb::pb::error::EREGION_VERSION || errcode == dingodb::pb::error::EREGION_REDIRECT ||
+           errcode == dingodb::pb::error::EKEY_OUT_OF_RANGE;
+  }
+
+  // The keys of request moved to other region by split or merge, retrying the same region never succeeds,
+  // the caller must route the keys again by the refreshed region route.
+  static bool IsKeyMovedError(dingodb::pb::error::Errno errcode) {
+    return errcode == dingodb::pb::error::EKEY_OUT_OF_RANGE;
+  }
+
+  // Update or invalidate region route by error, and reload region.
+  RegionEntryPtr RefreshRegionEntry(uint64_t region_id, const dingodb::pb::error::Error& error);
+
  private:
   InteractionManager();
   ~InteractionManager();
 
+  ServerInteractionPtr GetRegionInteraction(RegionEntryPtr region_entry);
+
   ServerInteractionPtr coordinator_interaction_;
   ServerInteractionPtr store_interaction_;
 
   bthread_mutex_t mutex_;
+  // key: region id, value: interaction of region peers, rebuild when region peers changed
+  std::map<uint64_t, std::pair<RegionEntryPtr, ServerInteractionPtr>> region_interactions_;
 };
 
 template <typename Request, typename Response>
@@ -235,24 +295,22 @@ butil::Status InteractionManager::SendRequestWithContext(const std::string& serv
     }
   }
 
+  Backoff backoff;
   for (;;) {
     auto status = store_interaction_->SendRequest(service_name, api_name, request, response);
-    if (status.ok()) {
+    if (status.ok() || !IsRegionStaleError(response.error().errcode())) {
       return status;
     }
 
-    if (response.error().errcode() == dingodb::pb::error::EREGION_VERSION) {
-      RegionRouter::GetInstance().UpdateRegionEntry(response.error().store_region_info());
-      auto region_entry = RegionRouter::GetInstance().QueryRegionEntry(request.context().region_id());
-      if (region_entry == nullptr) {
-        return butil::Status(dingodb::pb::error::EREGION_NOT_FOUND, "Not found region %lu",
-                             request.context().region_id());
-      }
-      *request.mutable_context() = region_entry->GenConext();
-    } else {
+    auto region_entry = RefreshRegionEntry(request.context().region_id(), response.error());
+    if (IsKeyMovedError(response.error().errcode()) || !backoff.Sleep()) {
       return status;
     }
-    bthread_usleep(1000 * 500);
+    if (region_entry == nullptr) {
+      return butil::Status(dingodb::pb::error::EREGION_NOT_FOUND, "Not found region %lu",
+                           request.context().region_id());
+    }
+    *request.mutable_context() = region_entry->GenConext();
   }
 }
 
@@ -278,27 +336,114 @@ butil::Status InteractionManager::AllSendRequestWithContext(const std::string& s
     }
   }
 
+  Backoff backoff;
   for (;;) {
     auto status = store_interaction_->AllSendRequest(service_name, api_name, request, response);
-    if (status.ok()) {
+    if (status.ok() || !IsRegionStaleError(response.error().errcode())) {
       return status;
     }
 
-    if (response.error().errcode() == dingodb::pb::error::EREGION_VERSION) {
-      RegionRouter::GetInstance().UpdateRegionEntry(response.error().store_region_info());
-      auto region_entry = RegionRouter::GetInstance().QueryRegionEntry(request.context().region_id());
-      if (region_entry == nullptr) {
-        return butil::Status(dingodb::pb::error::EREGION_NOT_FOUND, "Not found region %lu",
-                             request.context().region_id());
-      }
-      *request.mutable_context() = region_entry->GenConext();
-    } else {
+    auto region_entry = RefreshRegionEntry(request.context().region_id(), response.error());
+    if (IsKeyMovedError(response.error().errcode()) || !backoff.Sleep()) {
       return status;
     }
-    bthread_usleep(1000 * 500);
+    if (region_entry == nullptr) {
+      return butil::Status(dingodb::pb::error::EREGION_NOT_FOUND, "Not found region %lu",
+                           request.context().region_id());
+    }
+    *request.mutable_context() = region_entry->GenConext();
   }
 }
 
+template <typename Request, typename Response>
+butil::Status InteractionManager::SendRequestWithRegion(const std::string& service_name,
+                                                        const std::string& api_name, Request& request,
+                                                        Response& response, bool retry_on_stale) {
+  auto region_entry = RegionRouter::GetInstance().QueryRegionEntry(request.context().region_id());
+  Backoff backoff;
+  for (;;) {
+    if (region_entry == nullptr) {
+      return butil::Status(dingodb::pb::error::EREGION_NOT_FOUND, "Not found region %lu",
+                           request.context().region_id());
+    }
+    *request.mutable_context() = region_entry->GenConext();
+
+    auto interaction = GetRegionInteraction(region_entry);
+    if (interaction == nullptr) {
+      return butil::Status(dingodb::pb::error::EINTERNAL, "Init interaction failed, region %lu",
+                           region_entry->RegionId());
+    }
+
+    auto status = interaction->SendRequest(service_name, api_name, request, response);
+    if (status.ok() || !IsRegionStaleError(response.error().errcode())) {
+      return status;
+    }
+
+    region_entry = RefreshRegionEntry(region_entry->RegionId(), response.error());
+    if (!retry_on_stale || IsKeyMovedError(response.error().errcode()) || !backoff.Sleep()) {
+      return status;
+    }
+  }
+}
+
+template <typename Request, typename Response>
+butil::Status InteractionManager::SendRequestByRegions(const std::string& service_name,
+                                                       const std::string& api_name, std::vector<Request>& requests,
+                                                       std::vector<Response>& responses,
+                                                       std::vector<butil::Status>& statuses) {
+  responses.resize(requests.size());
+  statuses.resize(requests.size());
+
+  struct Param {
+    const std::string* service_name;
+    const std::string* api_name;
+    Request* request;
+    Response* response;
+    butil::Status* status;
+  };
+
+  // the first request is sent by current thread
+  std::vector<bthread_t> tids(requests.size(), INVALID_BTHREAD);
+  std::vector<Param> params(requests.size());
+  for (size_t i = 0; i < requests.size(); ++i) {
+    params[i] = {&service_name, &api_name, &requests[i], &responses[i], &statuses[i]};
+    if (i == 0) {
+      continue;
+    }
+
+    if (bthread_start_background(
+            &tids[i], nullptr,
+            [](void* arg) -> void* {
+              auto* param = static_cast<Param*>(arg);
+              *param->status = InteractionManager::GetInstance().SendRequestWithRegion(
+                  *param->service_name, *param->api_name, *param->request, *param->response, false);
+              return nullptr;
+            },
+            &params[i]) != 0) {
+      tids[i] = INVALID_BTHREAD;
+      statuses[i] = SendRequestWithRegion(service_name, api_name, requests[i], responses[i], false);
+    }
+  }
+
+  if (!requests.empty()) {
+    statuses[0] = SendRequestWithRegion(service_name, api_name, requests[0], responses[0], false);
+  }
+
+  for (auto tid : tids) {
+    if (tid != INVALID_BTHREAD) {
+      bthread_join(tid, nullptr);
+    }
+  }
+
+  for (const auto& status : statuses) {
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  return butil::Status();
+}
+
 }  // namespace client
 
 #endif  // DINGODB_CLIENT_INTERATION_H_
\ No newline at end of file
@@ -14,13 +14,21 @@
 
 #include "client/client_router.h"
 
+#include <iterator>
 #include <memory>
 #include <utility>
 
+#include "butil/time.h"
 #include "client/client_interation.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
 
 namespace client {
 
+// min interval of reload whole region map when key miss route
+static const int64_t kReloadRegionMapIntervalMs = 1000;
+
 // Query region
 static dingodb::pb::common::Region SendQueryRegion(uint64_t region_id) {
   dingodb::pb::coordinator::QueryRegionRequest request;
@@ -83,26 +91,59 @@ dingodb::pb::store::Context RegionEntry::GenConext() {
   return ctx;
 }
 
-RegionRouter::RegionRouter() { bthread_mutex_init(&mutex_, nullptr); }
-RegionRouter::~RegionRouter() { bthread_mutex_destroy(&mutex_); }
+RegionRouter::RegionRouter() : last_reload_time_ms_(0) {}
+RegionRouter::~RegionRouter() = default;
 
 RegionRouter& RegionRouter::GetInstance() {
   static RegionRouter instance;
   return instance;
 }
 
-void RegionRouter::AddRegionEntry(const dingodb::pb::common::Region& region) {
-  BAIDU_SCOPED_LOCK(mutex_);
+bool RegionRouter::IsNewerEpoch(const dingodb::pb::common::RegionEpoch& epoch,
+                                const dingodb::pb::common::RegionEpoch& old_epoch) {
+  if (epoch.version() != old_epoch.version()) {
+    return epoch.version() > old_epoch.version();
+  }
+
+  return epoch.conf_version() > old_epoch.conf_version();
+}
 
-  route_map_.insert_or_assign(region.definition().range().start_key(), RegionEntry::New(region));
+size_t RegionRouter::InnerUpsert(RouteTable& table, RegionEntryPtr region_entry) {
+  InnerErase(table, region_entry->RegionId());
+
+  // remove the stale regions which overlap with the new region, e.g. the regions merged into it
+  const auto& range = region_entry->Range();
+  auto it = table.range_map.lower_bound(range.start_key());
+  while (it != table.range_map.end() && it->first < range.end_key()) {
+    table.id_map.erase(it->second->RegionId());
+    it = table.range_map.erase(it);
+  }
+
+  table.range_map.insert({region_entry->Range().start_key(), region_entry});
+  table.id_map.insert({region_entry->RegionId(), region_entry});
+  return 1;
 }
 
-void RegionRouter::AddRegionEntry(RegionEntryPtr region) {
-  BAIDU_SCOPED_LOCK(mutex_);
+size_t RegionRouter::InnerErase(RouteTable& table, uint64_t region_id) {
+  auto it = table.id_map.find(region_id);
+  if (it == table.id_map.end()) {
+    return 0;
+  }
+
+  auto range_it = table.range_map.find(it->second->Range().start_key());
+  if (range_it != table.range_map.end() && range_it->second->RegionId() == region_id) {
+    table.range_map.erase(range_it);
+  }
+  table.id_map.erase(it);
+  return 1;
+}
 
-  route_map_.insert_or_assign(region->Range().start_key(), region);
+void RegionRouter::AddRegionEntry(const dingodb::pb::common::Region& region) {
+  AddRegionEntry(RegionEntry::New(region));
 }
 
+void RegionRouter::AddRegionEntry(RegionEntryPtr region) { route_table_.Modify(InnerUpsert, region); }
+
 RegionEntryPtr RegionRouter::AddRegionEntry(uint64_t region_id) {
   auto region = SendQueryRegion(region_id);
   if (region.id() == 0) {
@@ -115,24 +156,51 @@ RegionEntryPtr RegionRouter::AddRegionEntry(uint64_t region_id) {
 }
 
 void RegionRouter::UpdateRegionEntry(const dingodb::pb::error::StoreRegionInfo& region_info) {
-  auto region_entry = QueryRegionEntry(region_info.region_id());
-  if (region_entry != nullptr) {
-    region_entry->SetPeers(region_info);
-    region_entry->SetRange(region_info.current_range());
-    region_entry->SetEpoch(region_info.current_region_epoch());
+  auto region_entry = QueryRegionEntryFromCache(region_info.region_id());
+  if (region_entry == nullptr) {
+    return;
+  }
+
+  // the info of error has no epoch, we can not judge, reload from coordinator
+  if (!region_info.has_current_region_epoch()) {
+    region_entry->SetDirty(true);
+    return;
+  }
+  if (!IsNewerEpoch(region_info.current_region_epoch(), region_entry->Epoch())) {
+    return;
   }
+
+  // copy on write, the old entry maybe used by other threads
+  auto new_region_entry = RegionEntry::New(region_entry->Region());
+  if (region_info.peers_size() > 0) {
+    new_region_entry->SetPeers(region_info);
+  }
+  new_region_entry->SetRange(region_info.current_range());
+  new_region_entry->SetEpoch(region_info.current_region_epoch());
+
+  region_entry->SetDirty(true);
+  AddRegionEntry(new_region_entry);
 }
 
-RegionEntryPtr RegionRouter::QueryRegionEntry(const std::string& key) {
-  BAIDU_SCOPED_LOCK(mutex_);
+void RegionRouter::InvalidateRegionEntry(uint64_t region_id) {
+  auto region_entry = QueryRegionEntryFromCache(region_id);
+  if (region_entry != nullptr) {
+    region_entry->SetDirty(true);
+  }
+}
 
-  auto it = route_map_.lower_bound(key);
-  if (it == route_map_.end()) {
+RegionEntryPtr RegionRouter::QueryRegionEntryFromCache(const std::string& key) {
+  butil::DoublyBufferedData<RouteTable>::ScopedPtr ptr;
+  if (route_table_.Read(&ptr) != 0) {
     return nullptr;
   }
-  auto region_entry = it->second;
-  if (region_entry->IsDirty()) {
+
+  // the last region which start_key <= key
+  auto it = ptr->range_map.upper_bound(key);
+  if (it == ptr->range_map.begin()) {
+    return nullptr;
   }
+  auto region_entry = std::prev(it)->second;
 
   const auto& range = region_entry->Range();
   if (key.compare(range.start_key()) >= 0 && key.compare(range.end_key()) < 0) {
@@ -142,41 +210,64 @@ RegionEntryPtr RegionRouter::QueryRegionEntry(const std::string& key) {
   return nullptr;
 }
 
-RegionEntryPtr RegionRouter::QueryRegionEntry(uint64_t region_id) {
-  RegionEntryPtr region_entry;
+RegionEntryPtr RegionRouter::QueryRegionEntryFromCache(uint64_t region_id) {
+  butil::DoublyBufferedData<RouteTable>::ScopedPtr ptr;
+  if (route_table_.Read(&ptr) != 0) {
+    return nullptr;
+  }
 
-  {
-    BAIDU_SCOPED_LOCK(mutex_);
+  auto it = ptr->id_map.find(region_id);
+  return it != ptr->id_map.end() ? it->second : nullptr;
+}
 
-    for (auto& [_, temp_region_entry] : route_map_) {
-      if (temp_region_entry->RegionId() == region_id) {
-        region_entry = temp_region_entry;
-        break;
-      }
-    }
+RegionEntryPtr RegionRouter::QueryRegionEntry(const std::string& key) {
+  auto region_entry = QueryRegionEntryFromCache(key);
+  if (region_entry == nullptr) {
+    // maybe region split or not loaded, reload and retry
+    ReloadRegionMap();
+    region_entry = QueryRegionEntryFromCache(key);
+  }
+
+  if (region_entry != nullptr && region_entry->IsDirty()) {
+    UpdateRegion(region_entry);
+    region_entry = QueryRegionEntryFromCache(key);
   }
 
+  return region_entry;
+}
+
+RegionEntryPtr RegionRouter::QueryRegionEntry(uint64_t region_id) {
+  auto region_entry = QueryRegionEntryFromCache(region_id);
   if (region_entry == nullptr) {
     return AddRegionEntry(region_id);
-  } else {
-    if (region_entry->IsDirty()) {
-      UpdateRegion(region_entry);
-    }
+  }
+
+  if (region_entry->IsDirty()) {
+    UpdateRegion(region_entry);
+    region_entry = QueryRegionEntryFromCache(region_id);
   }
 
   return region_entry;
 }
 
 std::vector<RegionEntryPtr> RegionRouter::QueryRegionEntryByTable(uint64_t table_id) {
-  BAIDU_SCOPED_LOCK(mutex_);
-
   std::vector<RegionEntryPtr> region_entries;
-  for (auto& [_, region_entry] : route_map_) {
-    if (region_entry->TableId() == table_id) {
-      if (region_entry->IsDirty()) {
-        UpdateRegion(region_entry);
+  {
+    butil::DoublyBufferedData<RouteTable>::ScopedPtr ptr;
+    if (route_table_.Read(&ptr) != 0) {
+      return region_entries;
+    }
+
+    for (const auto& [_, region_entry] : ptr->range_map) {
+      if (region_entry->TableId() == table_id) {
+        region_entries.push_back(region_entry);
       }
-      region_entries.push_back(region_entry);
+    }
+  }
+
+  for (auto& region_entry : region_entries) {
+    if (region_entry->IsDirty() && UpdateRegion(region_entry)) {
+      region_entry = QueryRegionEntryFromCache(region_entry->RegionId());
     }
   }
 
@@ -184,21 +275,44 @@ std::vector<RegionEntryPtr> RegionRouter::QueryRegionEntryByTable(uint64_t table
 }
 
 std::vector<RegionEntryPtr> RegionRouter::QueryRegionEntryByPartition(uint64_t partition_id) {
-  BAIDU_SCOPED_LOCK(mutex_);
-
   std::vector<RegionEntryPtr> region_entries;
-  for (auto& [_, region_entry] : route_map_) {
-    if (region_entry->PartitionId() == partition_id) {
-      if (region_entry->IsDirty()) {
-        UpdateRegion(region_entry);
+  {
+    butil::DoublyBufferedData<RouteTable>::ScopedPtr ptr;
+    if (route_table_.Read(&ptr) != 0) {
+      return region_entries;
+    }
+
+    for (const auto& [_, region_entry] : ptr->range_map) {
+      if (region_entry->PartitionId() == partition_id) {
+        region_entries.push_back(region_entry);
       }
-      region_entries.push_back(region_entry);
+    }
+  }
+
+  for (auto& region_entry : region_entries) {
+    if (region_entry->IsDirty() && UpdateRegion(region_entry)) {
+      region_entry = QueryRegionEntryFromCache(region_entry->RegionId());
     }
   }
 
   return region_entries;
 }
 
+butil::Status RegionRouter::GroupKeysByRegion(const std::vector<std::string>& keys,
+                                              std::map<uint64_t, std::vector<size_t>>& region_key_indexes) {
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto region_entry = QueryRegionEntry(keys[i]);
+    if (region_entry == nullptr) {
+      return butil::Status(dingodb::pb::error::EREGION_NOT_FOUND, "Not found region of key %s",
+                           dingodb::Helper::StringToHex(keys[i]).c_str());
+    }
+
+    region_key_indexes[region_entry->RegionId()].push_back(i);
+  }
+
+  return butil::Status();
+}
+
 dingodb::pb::store::Context RegionRouter::GenConext(uint64_t region_id) {
   auto region_entry = QueryRegionEntry(region_id);
   if (region_entry != nullptr) {
@@ -214,9 +328,43 @@ bool RegionRouter::UpdateRegion(RegionEntryPtr region_entry) {
     return false;
   }
 
-  region_entry->SetRegion(region);
+  AddRegionEntry(region);
   region_entry->SetDirty(false);
   return true;
 }
 
+void RegionRouter::ReloadRegionMap() {
+  int64_t now_ms = butil::gettimeofday_ms();
+  int64_t last_reload_time_ms = last_reload_time_ms_.load();
+  if (now_ms - last_reload_time_ms < kReloadRegionMapIntervalMs ||
+      !last_reload_time_ms_.compare_exchange_strong(last_reload_time_ms, now_ms)) {
+    return;
+  }
+
+  dingodb::pb::coordinator::GetRegionMapRequest request;
+  dingodb::pb::coordinator::GetRegionMapResponse response;
+
+  request.set_epoch(0);
+  auto status =
+      InteractionManager::GetInstance().SendRequestWithoutContext("CoordinatorService", "GetRegionMap", request, response);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("Reload region map failed, error: {} {}", status.error_code(),
+                                      status.error_str());
+    return;
+  }
+
+  for (const auto& region : response.regionmap().regions()) {
+    if (region.state() == dingodb::pb::common::RegionState::REGION_DELETE ||
+        region.state() == dingodb::pb::common::RegionState::REGION_DELETING ||
+        region.state() == dingodb::pb::common::RegionState::REGION_DELETED) {
+      continue;
+    }
+
+    auto region_entry = QueryRegionEntryFromCache(region.id());
+    if (region_entry == nullptr || IsNewerEpoch(region.definition().epoch(), region_entry->Epoch())) {
+      AddRegionEntry(region);
+    }
+  }
+}
+
 }  // namespace client
\ No newline at end of file
@@ -17,11 +17,13 @@
 
 #include <atomic>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
-#include "bthread/mutex.h"
+#include "butil/containers/doubly_buffered_data.h"
+#include "butil/status.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/store.pb.h"
@@ -63,6 +65,9 @@ class RegionEntry {
 
 using RegionEntryPtr = std::shared_ptr<RegionEntry>;
 
+// Route cache of region, read mostly.
+// Route table is kept in DoublyBufferedData, query never block by update,
+// and RegionEntry is copy on write, update region will replace the entry with a new one.
 class RegionRouter {
  public:
   RegionRouter();
@@ -74,22 +79,51 @@ class RegionRouter {
   void AddRegionEntry(RegionEntryPtr region);
   RegionEntryPtr AddRegionEntry(uint64_t region_id);
 
+  // Update region by the region info of EREGION_VERSION/EREGION_REDIRECT error,
+  // only apply if the epoch is newer than the cached one.
   void UpdateRegionEntry(const dingodb::pb::error::StoreRegionInfo& region_info);
+  // Mark region dirty, the next query of the region reload it from coordinator, the cached entry is kept until then.
+  void InvalidateRegionEntry(uint64_t region_id);
 
   RegionEntryPtr QueryRegionEntry(const std::string& key);
   RegionEntryPtr QueryRegionEntry(uint64_t region_id);
   std::vector<RegionEntryPtr> QueryRegionEntryByTable(uint64_t table_id);
   std::vector<RegionEntryPtr> QueryRegionEntryByPartition(uint64_t partition_id);
 
+  // Group key indexes by region, used to split batch request.
+  butil::Status GroupKeysByRegion(const std::vector<std::string>& keys,
+                                  std::map<uint64_t, std::vector<size_t>>& region_key_indexes);
+
   dingodb::pb::store::Context GenConext(uint64_t region_id);
 
+  // Reload whole route table from coordinator, used when key miss route, e.g. region split.
+  // Throttled to once per kReloadRegionMapIntervalMs.
+  void ReloadRegionMap();
+
+  static bool IsNewerEpoch(const dingodb::pb::common::RegionEpoch& epoch,
+                           const dingodb::pb::common::RegionEpoch& old_epoch);
+
  private:
+  struct RouteTable {
+    // key: the start_key of region range
+    // value: RegionEntry
+    std::map<std::string, RegionEntryPtr> range_map;
+    // key: region id
+    std::map<uint64_t, RegionEntryPtr> id_map;
+  };
+
+  static size_t InnerUpsert(RouteTable& table, RegionEntryPtr region_entry);
+  static size_t InnerErase(RouteTable& table, uint64_t region_id);
+
+  RegionEntryPtr QueryRegionEntryFromCache(const std::string& key);
+  RegionEntryPtr QueryRegionEntryFromCache(uint64_t region_id);
+
   bool UpdateRegion(RegionEntryPtr region_entry);
 
-  // key: the start_key of region range
-  // value: RegionEntry
-  std::map<std::string, RegionEntryPtr> route_map_;
-  bthread_mutex_t mutex_;
+  butil::DoublyBufferedData<RouteTable> route_table_;
+
+  // throttle reload region map
+  std::atomic<int64_t> last_reload_time_ms_;
 };
 
 }  // namespace client
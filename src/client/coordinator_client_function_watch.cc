@@ -38,6 +38,7 @@ DECLARE_bool(no_put);
 DECLARE_bool(no_delete);
 DECLARE_bool(wait_on_not_exist_key);
 DECLARE_uint32(max_watch_count);
+DECLARE_string(range_end);
 DECLARE_string(lock_name);
 DECLARE_string(client_uuid);
 
@@ -57,6 +58,7 @@ void SendOneTimeWatch(std::shared_ptr<dingodb::CoordinatorInteraction> coordinat
   auto* one_time_watch_req = request.mutable_one_time_request();
 
   one_time_watch_req->set_key(FLAGS_key);
+  one_time_watch_req->set_range_end(FLAGS_range_end);
   one_time_watch_req->set_need_prev_kv(FLAGS_need_prev_kv);
   one_time_watch_req->set_wait_on_not_exist_key(FLAGS_wait_on_not_exist_key);
   one_time_watch_req->set_start_revision(FLAGS_revision);
@@ -72,7 +74,7 @@ void SendOneTimeWatch(std::shared_ptr<dingodb::CoordinatorInteraction> coordinat
   DINGO_LOG(INFO) << "wait_on_not_exist_key=" << FLAGS_wait_on_not_exist_key << ", no_put=" << FLAGS_no_put
                   << ", no_delete=" << FLAGS_no_delete << ", need_prev_kv=" << FLAGS_need_prev_kv
                   << ", max_watch_count=" << FLAGS_max_watch_count << ", revision=" << FLAGS_revision
-                  << ", key=" << FLAGS_key;
+                  << ", key=" << FLAGS_key << ", range_end=" << FLAGS_range_end;
 
   for (uint32_t i = 0; i < FLAGS_max_watch_count; i++) {
     // wait 600s for event
@@ -80,6 +82,14 @@ void SendOneTimeWatch(std::shared_ptr<dingodb::CoordinatorInteraction> coordinat
     auto status = coordinator_interaction->SendRequest("Watch", request, response, 600000);
     DINGO_LOG(INFO) << "SendRequest status=" << status << ", watch_count=" << i;
     DINGO_LOG_INFO << response.DebugString();
+
+    // resume from the next revision of the last event, so no event is lost between two watches
+    for (const auto& event : response.events()) {
+      if (static_cast<uint64_t>(event.kv().mod_revision()) >= one_time_watch_req->start_revision()) {
+        one_time_watch_req->set_start_revision(event.kv().mod_revision() + 1);
+      }
+    }
+    response.Clear();
   }
 }
 
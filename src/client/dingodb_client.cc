@@ -290,6 +290,8 @@ void Sender(std::shared_ptr<client::Context> ctx, const std::string& method, int
       client::SendKvPut(FLAGS_region_id, FLAGS_key);
     } else if (method == "KvBatchPut") {
       client::SendKvBatchPut(FLAGS_region_id, FLAGS_prefix, 100);
+    } else if (method == "KvBatchPutGetAcrossRegions") {
+      client::SendKvBatchPutGetAcrossRegions(FLAGS_prefix, FLAGS_req_num);
     } else if (method == "KvPutIfAbsent") {
       client::SendKvPutIfAbsent(FLAGS_region_id, FLAGS_key);
     } else if (method == "KvBatchPutIfAbsent") {
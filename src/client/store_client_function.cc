@@ -29,6 +29,7 @@
 #include <vector>
 
 #include "bthread/bthread.h"
+#include "client/client_batch.h"
 #include "client/client_helper.h"
 #include "client/client_router.h"
 #include "common/helper.h"
@@ -1712,6 +1713,43 @@ void SendKvBatchPut(uint64_t region_id, const std::string& prefix, int count) {
   InteractionManager::GetInstance().SendRequestWithContext("StoreService", "KvBatchPut", request, response);
 }
 
+void SendKvBatchPutGetAcrossRegions(const std::string& prefix, int count) {
+  std::vector<dingodb::pb::common::KeyValue> kvs;
+  std::vector<std::string> keys;
+  for (int i = 0; i < count; ++i) {
+    auto& kv = kvs.emplace_back();
+    kv.set_key(prefix + Helper::GenRandomString(30));
+    kv.set_value(Helper::GenRandomString(64));
+    keys.push_back(kv.key());
+  }
+
+  auto status = client::KvBatchPut(kvs);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("KvBatchPut across regions failed, error: {} {}", status.error_code(),
+                                    status.error_str());
+    return;
+  }
+
+  std::vector<dingodb::pb::common::KeyValue> result_kvs;
+  status = client::KvBatchGet(keys, result_kvs);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("KvBatchGet across regions failed, error: {} {}", status.error_code(),
+                                    status.error_str());
+    return;
+  }
+
+  int not_match_count = 0;
+  for (int i = 0; i < count; ++i) {
+    if (result_kvs[i].value() != kvs[i].value()) {
+      ++not_match_count;
+      DINGO_LOG(INFO) << "Not match: " << kvs[i].key() << " = " << result_kvs[i].value()
+                      << " expected=" << kvs[i].value();
+    }
+  }
+
+  DINGO_LOG(INFO) << fmt::format("KvBatchPutGet across regions count: {} not match: {}", count, not_match_count);
+}
+
 void SendKvPutIfAbsent(uint64_t region_id, const std::string& key) {
   dingodb::pb::store::KvPutIfAbsentRequest request;
   dingodb::pb::store::KvPutIfAbsentResponse response;
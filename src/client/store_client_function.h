@@ -128,6 +128,8 @@ void SendKvDeleteRange(uint64_t region_id, const std::string& prefix);
 void SendKvScan(uint64_t region_id, const std::string& prefix);
 void SendKvCompareAndSet(uint64_t region_id, const std::string& key);
 void SendKvBatchCompareAndSet(uint64_t region_id, const std::string& prefix, int count);
+// split by region route and send to multiple regions in parallel
+void SendKvBatchPutGetAcrossRegions(const std::string& prefix, int count);
 
 // region
 void SendAddRegion(uint64_t region_id, const std::string& raft_group, std::vector<std::string> raft_addrs);
@@ -27,6 +27,7 @@
 
 #include "client/client_helper.h"
 #include "client/store_client_function.h"
+#include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "coprocessor/utils.h"
@@ -57,7 +58,13 @@ class RocksDBOperator {
   bool Init() {
     rocksdb::DBOptions db_options;
 
-    std::vector<std::string> family_names = {"default", "meta"};
+    std::vector<std::string> family_names;
+    rocksdb::Status s = rocksdb::DB::ListColumnFamilies(db_options, db_path_, &family_names);
+    if (!s.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("List column families failed, error: {}", s.ToString());
+      return false;
+    }
+
     std::vector<rocksdb::ColumnFamilyDescriptor> column_families;
     for (const auto& family_name : family_names) {
       rocksdb::ColumnFamilyOptions family_options;
@@ -67,7 +74,7 @@ class RocksDBOperator {
     std::vector<rocksdb::ColumnFamilyHandle*> family_handles;
 
     rocksdb::DB* db;
-    rocksdb::Status s = rocksdb::DB::OpenForReadOnly(db_options, db_path_, column_families, &family_handles, &db);
+    s = rocksdb::DB::OpenForReadOnly(db_options, db_path_, column_families, &family_handles, &db);
     if (!s.ok()) {
       DINGO_LOG(ERROR) << fmt::format("Open db failed, error: {}", s.ToString());
       return false;
@@ -87,8 +94,14 @@ class RocksDBOperator {
     return (it == family_handles_.end()) ? nullptr : it->second;
   }
 
-  void Scan(const std::string& begin_key, const std::string& end_key, int32_t offset, int32_t limit,
-            std::function<void(const std::string&, const std::string&)> handler) {
+  void Scan(const std::string& cf_name, const std::string& begin_key, const std::string& end_key, int32_t offset,
+            int32_t limit, std::function<void(const std::string&, const std::string&)> handler) {
+    auto* family_handle = GetFamilyHandle(cf_name);
+    if (family_handle == nullptr) {
+      DINGO_LOG(ERROR) << fmt::format("Not found column family {}", cf_name);
+      return;
+    }
+
     rocksdb::ReadOptions read_option;
     read_option.auto_prefix_mode = true;
     rocksdb::Slice end_key_slice(end_key);
@@ -98,7 +111,7 @@ class RocksDBOperator {
 
     int count = 0;
     std::string_view end_key_view(end_key);
-    rocksdb::Iterator* it = db_->NewIterator(read_option, GetFamilyHandle("default"));
+    rocksdb::Iterator* it = db_->NewIterator(read_option, family_handle);
     for (it->Seek(begin_key); it->Valid(); it->Next()) {
       if (--offset >= 0) {
         continue;
@@ -382,7 +395,7 @@ void DumpDb(std::shared_ptr<Context> ctx) {
                                    partition.id().parent_entity_id(), partition.id().entity_id(),
                                    dingodb::Helper::StringToHex(begin_key), dingodb::Helper::StringToHex(end_key));
 
-    db->Scan(begin_key, end_key, ctx->offset, ctx->limit, handler);
+    db->Scan(dingodb::Constant::kStoreDataCF, begin_key, end_key, ctx->offset, ctx->limit, handler);
   }
 }
 
@@ -411,7 +424,7 @@ void DumpVectorIndexDb(std::shared_ptr<Context> ctx) {
   auto vector_data_handler = [&](const std::string& key, const std::string& value) {
     if (ctx->show_vector) {
       dingodb::pb::common::Vector data;
-      data.ParseFromString(value);
+      dingodb::VectorCodec::DecodeVectorValue(value, data);
       std::cout << fmt::format("[vector data] vector_id({}) value: dimension({}) {}",
                                dingodb::VectorCodec::DecodeVectorId(key), data.dimension(), FormatVector(data, 10))
                 << std::endl;
@@ -453,7 +466,7 @@ void DumpVectorIndexDb(std::shared_ptr<Context> ctx) {
       std::string begin_key, end_key;
       dingodb::VectorCodec::EncodeVectorData(partition_id, 0, begin_key);
       dingodb::VectorCodec::EncodeVectorData(partition_id, UINT64_MAX, end_key);
-      db->Scan(begin_key, end_key, ctx->offset, ctx->limit, vector_data_handler);
+      db->Scan(dingodb::Constant::kVectorDataCF, begin_key, end_key, ctx->offset, ctx->limit, vector_data_handler);
     }
 
     {
@@ -461,7 +474,7 @@ void DumpVectorIndexDb(std::shared_ptr<Context> ctx) {
       dingodb::VectorCodec::EncodeVectorScalar(partition_id, 0, begin_key);
       dingodb::VectorCodec::EncodeVectorScalar(partition_id, UINT64_MAX, end_key);
 
-      db->Scan(begin_key, end_key, ctx->offset, ctx->limit, scalar_data_handler);
+      db->Scan(dingodb::Constant::kVectorScalarCF, begin_key, end_key, ctx->offset, ctx->limit, scalar_data_handler);
     }
 
     {
@@ -469,7 +482,7 @@ void DumpVectorIndexDb(std::shared_ptr<Context> ctx) {
       dingodb::VectorCodec::EncodeVectorTable(partition_id, 0, begin_key);
       dingodb::VectorCodec::EncodeVectorTable(partition_id, UINT64_MAX, end_key);
 
-      db->Scan(begin_key, end_key, ctx->offset, ctx->limit, table_data_handler);
+      db->Scan(dingodb::Constant::kVectorTableCF, begin_key, end_key, ctx->offset, ctx->limit, table_data_handler);
     }
   }
 }
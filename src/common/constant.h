@@ -44,6 +44,10 @@ class Constant {
   inline static const std::string kStoreDataCF = "default";
   // Define Store meta column family.
   inline static const std::string kStoreMetaCF = "meta";
+  // Define vector index region column family, vector data/scalar data/table data are stored separately.
+  inline static const std::string kVectorDataCF = "vector_data";
+  inline static const std::string kVectorScalarCF = "vector_scalar";
+  inline static const std::string kVectorTableCF = "vector_table";
   // Define store meta prefix.
   inline static const std::string kStoreRegionMetaPrefix = "META_REGION";
   // Define store raft prefix.
@@ -58,7 +62,7 @@ class Constant {
   inline static const std::string kVectorIndexSnapshotLogIdPrefix = "VECTOR_INDEX_SNAPSHOT_LOG";
 
   // Define default raft snapshot policy
-  inline static const std::string kDefaultRaftSnapshotPolicy = "checkpoint";
+  inline static const std::string kDefaultRaftSnapshotPolicy = "scan";
 
   // flat map init capacity
   static const uint64_t kStoreRegionMetaInitCapacity = 1024;
@@ -67,6 +71,7 @@ class Constant {
   inline static const std::string kStorePathConfigName = "store.path";
   inline static const std::string kColumnFamilies = "store.column_families";
   inline static const std::string kBaseColumnFamily = "store.base";
+  inline static const std::string kStoreMemoryLimitConfigName = "store.memory_limit";
 
   inline static const std::string kBlockSize = "block_size";
   inline static const std::string kBlockCache = "block_cache";
@@ -147,11 +152,13 @@ class Constant {
   static const int32_t kRecycleOrphanIntervalS = 60;
   static const int32_t kLeaseIntervalS = 60;
   static const int32_t kCompactionIntervalS = 300;
+  static const int32_t kBalanceIntervalS = 60;
   static const int32_t kScrubVectorIndexIntervalS = 60;
   static const int32_t kApproximateSizeMetricsCollectIntervalS = 50;
   static const int32_t kStoreMetricsCollectIntervalS = 30;
   static const int32_t kRegionMetricsCollectIntervalS = 300;
   static const int32_t kDefaultSplitCheckIntervalS = 120;
+  static const int32_t kFlushRaftMetaIntervalS = 1;
 
   // raft snapshot
   inline static const std::string kRaftSnapshotRegionMetaFileName = "region_meta";
@@ -365,6 +365,22 @@ pb::common::Range Helper::IntersectRange(const pb::common::Range& range1, const
   return range;
 }
 
+std::vector<std::string> Helper::GetColumnFamilyNames(pb::common::RegionType region_type) {
+  if (region_type == pb::common::RegionType::INDEX_REGION) {
+    return {Constant::kStoreDataCF, Constant::kVectorDataCF, Constant::kVectorScalarCF, Constant::kVectorTableCF};
+  }
+
+  return {Constant::kStoreDataCF};
+}
+
+std::vector<std::string> Helper::GetPhysicsRangeColumnFamilyNames(pb::common::RegionType region_type) {
+  if (region_type == pb::common::RegionType::INDEX_REGION) {
+    return {Constant::kVectorDataCF, Constant::kVectorScalarCF, Constant::kVectorTableCF};
+  }
+
+  return {Constant::kStoreDataCF};
+}
+
 std::string Helper::StringToHex(const std::string& str) {
   std::stringstream ss;
   for (const auto& ch : str) {
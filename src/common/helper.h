@@ -133,6 +133,16 @@ class Helper {
     }
   }
 
+  // Move items into repeated field by swap, avoid copy large message.
+  // The rpc response is owned by brpc and not arena allocated, so swap is the cheapest way to fill it.
+  template <typename T>
+  static void VectorToPbRepeated(std::vector<T>&& vec, google::protobuf::RepeatedPtrField<T>* out) {
+    out->Reserve(out->size() + vec.size());
+    for (auto& item : vec) {
+      out->Add()->Swap(&item);
+    }
+  }
+
   static std::string PrefixNext(const std::string& input);
   static std::string PrefixNext(const std::string_view& input);
 
@@ -142,6 +152,12 @@ class Helper {
   // Take range intersection
   static pb::common::Range IntersectRange(const pb::common::Range& range1, const pb::common::Range& range2);
 
+  // Get the column families of region data, vector data/scalar data/table data of index region is in separate column
+  // family.
+  static std::vector<std::string> GetColumnFamilyNames(pb::common::RegionType region_type);
+  // Get the column family of every range of Region::PhysicsRange().
+  static std::vector<std::string> GetPhysicsRangeColumnFamilyNames(pb::common::RegionType region_type);
+
   static std::string StringToHex(const std::string& str);
   static std::string StringToHex(const std::string_view& str);
   static std::string HexToString(const std::string& hex_str);
@@ -254,6 +254,59 @@ class DingoSafeMap {
     return 1;
   }
 
+  // Traverse
+  // visit all key-value pairs in place without copy, stop when handler return false
+  // the handler is called with the read lock held, so it must be light and must not modify this map
+  int Traverse(std::function<bool(const T_KEY &, const T_VALUE &)> handler) {
+    TypeScopedPtr ptr;
+    if (safe_map.Read(&ptr) != 0) {
+      return -1;
+    }
+
+    for (const auto &it : *ptr) {
+      if (!handler(it.first, it.second)) {
+        break;
+      }
+    }
+
+    return 1;
+  }
+
+  // TraverseFilter
+  // visit the key-value pairs accepted by filter in place without copy, stop when handler return false
+  // the filter and handler are called with the read lock held, so they must be light and must not modify this map
+  int TraverseFilter(std::function<bool(const T_KEY &, const T_VALUE &)> filter,
+                     std::function<bool(const T_KEY &, const T_VALUE &)> handler) {
+    TypeScopedPtr ptr;
+    if (safe_map.Read(&ptr) != 0) {
+      return -1;
+    }
+
+    for (const auto &it : *ptr) {
+      if (filter != nullptr && !filter(it.first, it.second)) {
+        continue;
+      }
+      if (!handler(it.first, it.second)) {
+        break;
+      }
+    }
+
+    return 1;
+  }
+
+  // TraverseRange
+  // visit the key-value pairs of [lower_bound, upper_bound) accepted by filter in place without copy,
+  // stop when handler return false, the flat map is unordered so all pairs are checked
+  int TraverseRange(const T_KEY &lower_bound, const T_KEY &upper_bound,
+                    std::function<bool(const T_KEY &, const T_VALUE &)> handler,
+                    std::function<bool(const T_KEY &, const T_VALUE &)> filter = nullptr) {
+    return TraverseFilter(
+        [&lower_bound, &upper_bound, &filter](const T_KEY &key, const T_VALUE &value) {
+          return key >= lower_bound && key < upper_bound && (filter == nullptr || filter(key, value));
+        },
+        handler);
+  }
+
   // Put
   // put key-value pair into map
   int Put(const T_KEY &key, const T_VALUE &value) {
@@ -644,6 +697,32 @@ class DingoSafeStdMap {
     return values.size();
   }
 
+  // TraverseRange
+  // visit keys and values of range accepted by filter in place without copy, stop when handler return false
+  int TraverseRange(const T_KEY &lower_bound, const T_KEY &upper_bound,
+                    std::function<bool(const T_KEY &, const T_VALUE &)> handler,
+                    std::function<bool(const T_KEY &, const T_VALUE &)> filter = nullptr) {
+    TypeScopedPtr ptr;
+    if (safe_map.Read(&ptr) != 0) {
+      return -1;
+    }
+
+    typename TypeRawMap::const_iterator it = ptr->lower_bound(lower_bound);
+    for (; it != ptr->end(); ++it) {
+      if (it->first >= upper_bound) {
+        break;
+      }
+      if (filter != nullptr && !filter(it->first, it->second)) {
+        continue;
+      }
+      if (!handler(it->first, it->second)) {
+        break;
+      }
+    }
+
+    return 1;
+  }
+
   // GetRangeKeyValues
   // get keys and values of range
   int GetRangeKeyValues(std::vector<T_KEY> &keys, std::vector<T_VALUE> &values, T_KEY lower_bound, T_KEY upper_bound,
@@ -733,6 +812,46 @@ class DingoSafeStdMap {
     return 1;
   }
 
+  // Traverse
+  // visit all key-value pairs in place without copy, stop when handler return false
+  // the handler is called with the read lock held, so it must be light and must not modify this map
+  int Traverse(std::function<bool(const T_KEY &, const T_VALUE &)> handler) {
+    TypeScopedPtr ptr;
+    if (safe_map.Read(&ptr) != 0) {
+      return -1;
+    }
+
+    for (const auto &it : *ptr) {
+      if (!handler(it.first, it.second)) {
+        break;
+      }
+    }
+
+    return 1;
+  }
+
+  // TraverseFilter
+  // visit the key-value pairs accepted by filter in place without copy, stop when handler return false
+  // the filter and handler are called with the read lock held, so they must be light and must not modify this map
+  int TraverseFilter(std::function<bool(const T_KEY &, const T_VALUE &)> filter,
+                     std::function<bool(const T_KEY &, const T_VALUE &)> handler) {
+    TypeScopedPtr ptr;
+    if (safe_map.Read(&ptr) != 0) {
+      return -1;
+    }
+
+    for (const auto &it : *ptr) {
+      if (filter != nullptr && !filter(it.first, it.second)) {
+        continue;
+      }
+      if (!handler(it.first, it.second)) {
+        break;
+      }
+    }
+
+    return 1;
+  }
+
   // Put
   // put key-value pair into map
   int Put(const T_KEY &key, const T_VALUE &value) {
@@ -125,6 +125,66 @@ class BthreadCond {
   bthread_mutex_t mutex_;
 };
 
+// Read write lock for bthread, the waiter suspend the bthread instead of block the worker pthread.
+// Writer is preferred, the new reader wait when a writer is waiting, so writer is not starved.
+// Name the methods like std::shared_mutex, so it work with std::shared_lock and std::unique_lock.
+class BthreadRWLock {
+ public:
+  BthreadRWLock() {
+    bthread_mutex_init(&mutex_, nullptr);
+    bthread_cond_init(&cond_, nullptr);
+  }
+  ~BthreadRWLock() {
+    bthread_cond_destroy(&cond_);
+    bthread_mutex_destroy(&mutex_);
+  }
+
+  BthreadRWLock(const BthreadRWLock&) = delete;
+  BthreadRWLock& operator=(const BthreadRWLock&) = delete;
+
+  void lock_shared() {  // NOLINT
+    bthread_mutex_lock(&mutex_);
+    while (is_writing_ || waiting_writer_count_ > 0) {
+      bthread_cond_wait(&cond_, &mutex_);
+    }
+    ++reader_count_;
+    bthread_mutex_unlock(&mutex_);
+  }
+
+  void unlock_shared() {  // NOLINT
+    bthread_mutex_lock(&mutex_);
+    if (--reader_count_ == 0) {
+      bthread_cond_broadcast(&cond_);
+    }
+    bthread_mutex_unlock(&mutex_);
+  }
+
+  void lock() {  // NOLINT
+    bthread_mutex_lock(&mutex_);
+    ++waiting_writer_count_;
+    while (is_writing_ || reader_count_ > 0) {
+      bthread_cond_wait(&cond_, &mutex_);
+    }
+    --waiting_writer_count_;
+    is_writing_ = true;
+    bthread_mutex_unlock(&mutex_);
+  }
+
+  void unlock() {  // NOLINT
+    bthread_mutex_lock(&mutex_);
+    is_writing_ = false;
+    bthread_cond_broadcast(&cond_);
+    bthread_mutex_unlock(&mutex_);
+  }
+
+ private:
+  bthread_mutex_t mutex_;
+  bthread_cond_t cond_;
+  int reader_count_{0};
+  int waiting_writer_count_{0};
+  bool is_writing_{false};
+};
+
 // wrapper bthread functions for c++ style
 class Bthread {
  public:
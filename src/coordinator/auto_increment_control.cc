@@ -14,23 +14,34 @@
 
 #include "coordinator/auto_increment_control.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <fstream>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "brpc/reloadable_flags.h"
 #include "butil/containers/flat_map.h"
 #include "butil/status.h"
+#include "common/constant.h"
+#include "common/context.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
 #include "coordinator/coordinator_interaction.h"
 #include "engine/snapshot.h"
+#include "engine/write_data.h"
+#include "gflags/gflags.h"
 #include "proto/error.pb.h"
 #include "server/server.h"
 
 namespace dingodb {
 
+DEFINE_uint32(auto_increment_prealloc_count, 100000,
+              "auto increment id count preallocated by leader for each table, 0 means generate through raft");
+BRPC_VALIDATE_GFLAG(auto_increment_prealloc_count, brpc::PassValidate);
+
 AutoIncrementControl::AutoIncrementControl() {
   // init bthread mutex
   bthread_mutex_init(&auto_increment_map_mutex_, nullptr);
@@ -64,6 +75,13 @@ butil::Status AutoIncrementControl::GetAutoIncrement(uint64_t table_id, uint64_t
     } else {
       start_id = *start_id_ptr;
       status = butil::Status::OK();
+
+      // the ids in the latest window of leader are not generated yet
+      std::shared_ptr<AutoIncrementWindow> window;
+      if (auto_increment_window_map_.Get(table_id, window) > 0 &&
+          window->end_id.load(std::memory_order_acquire) == start_id) {
+        start_id = std::min(start_id, window->next_id.load(std::memory_order_acquire));
+      }
     }
   }
   return status;
@@ -138,9 +156,7 @@ butil::Status AutoIncrementControl::GenerateAutoIncrement(uint64_t table_id, uin
     return ret;
   }
 
-  if (count == 0 || count > kAutoIncrementGenerateCountMax || auto_increment_increment == 0 ||
-      auto_increment_increment > kAutoIncrementOffsetMax || auto_increment_offset == 0 ||
-      auto_increment_offset > kAutoIncrementOffsetMax) {
+  if (!CheckGenerateParameters(count, auto_increment_increment, auto_increment_offset)) {
     DINGO_LOG(WARNING) << "illegal parameters : " << table_id << " | " << count << " | " << auto_increment_increment
                        << " | " << auto_increment_offset;
     return butil::Status(pb::error::Errno::EILLEGAL_PARAMTETERS, "illegal parameters");
@@ -158,6 +174,138 @@ butil::Status AutoIncrementControl::GenerateAutoIncrement(uint64_t table_id, uin
   return butil::Status::OK();
 }
 
+bool AutoIncrementControl::GenerateAutoIncrementFromWindow(uint64_t table_id, uint32_t count,
+                                                           uint32_t auto_increment_increment,
+                                                           uint32_t auto_increment_offset, uint64_t& start_id,
+                                                           uint64_t& end_id) {
+  if (FLAGS_auto_increment_prealloc_count == 0 || !IsLeader() ||
+      !CheckGenerateParameters(count, auto_increment_increment, auto_increment_offset)) {
+    return false;
+  }
+
+  std::shared_ptr<AutoIncrementWindow> window;
+  if (auto_increment_window_map_.Get(table_id, window) < 0) {
+    {
+      // check table exists under the lock of apply, so the window of a deleted table is not left
+      BAIDU_SCOPED_LOCK(auto_increment_map_mutex_);
+      if (auto_increment_map_.seek(table_id) == nullptr) {
+        return false;
+      }
+
+      // no window yet, the empty window is replaced when the first preallocate is applied
+      auto_increment_window_map_.PutIfAbsent(table_id, std::make_shared<AutoIncrementWindow>());
+      if (auto_increment_window_map_.Get(table_id, window) < 0) {
+        return false;
+      }
+    }
+
+    PreallocateAutoIncrement(table_id, window);
+    return false;
+  }
+
+  bool is_generated = false;
+  uint64_t next_id = window->next_id.load(std::memory_order_acquire);
+  while (true) {
+    uint64_t new_next_id = GetGenerateEndId(next_id, count, auto_increment_increment, auto_increment_offset);
+    if (new_next_id > window->end_id.load(std::memory_order_acquire)) {
+      break;
+    }
+
+    if (window->next_id.compare_exchange_weak(next_id, new_next_id, std::memory_order_acq_rel)) {
+      start_id = next_id;
+      end_id = new_next_id;
+      is_generated = true;
+      break;
+    }
+  }
+
+  // refill before the window is exhausted, so the following requests need not wait for raft
+  uint64_t window_end_id = window->end_id.load(std::memory_order_acquire);
+  next_id = window->next_id.load(std::memory_order_acquire);
+  if (window_end_id <= next_id || window_end_id - next_id < FLAGS_auto_increment_prealloc_count / 2) {
+    PreallocateAutoIncrement(table_id, window);
+  }
+
+  return is_generated;
+}
+
+void AutoIncrementControl::PreallocateAutoIncrement(uint64_t table_id, std::shared_ptr<AutoIncrementWindow> window) {
+  if (engine_ == nullptr) {
+    return;
+  }
+
+  bool expected = false;
+  if (!window->is_preallocating.compare_exchange_strong(expected, true)) {
+    return;
+  }
+
+  pb::coordinator_internal::MetaIncrement meta_increment;
+  auto* auto_increment = meta_increment.add_auto_increment();
+  auto_increment->set_id(table_id);
+  auto* increment = auto_increment->mutable_increment();
+  // applied as a generate of increment 1 and offset 1 by the version without window
+  increment->set_update_type(pb::coordinator_internal::AutoIncrementUpdateType::READ_MODIFY_WRITE);
+  increment->set_generate_count(FLAGS_auto_increment_prealloc_count);
+  increment->set_increment(1);
+  increment->set_offset(1);
+  increment->set_preallocate(true);
+  auto_increment->set_op_type(pb::coordinator_internal::MetaIncrementOpType::UPDATE);
+
+  std::shared_ptr<Context> ctx = std::make_shared<Context>();
+  ctx->SetRegionId(Constant::kAutoIncrementRegionId);
+
+  auto status = engine_->AsyncWrite(ctx, WriteDataBuilder::BuildWrite(ctx->CfName(), meta_increment),
+                                    [window](std::shared_ptr<Context> /*ctx*/, butil::Status status) {
+                                      if (!status.ok()) {
+                                        DINGO_LOG(WARNING) << "preallocate auto increment failed, " << status;
+                                      }
+                                      window->is_preallocating.store(false, std::memory_order_release);
+                                    });
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << "preallocate auto increment failed, table id: " << table_id << ", " << status;
+    window->is_preallocating.store(false, std::memory_order_release);
+  }
+}
+
+// caller must hold auto_increment_map_mutex_
+void AutoIncrementControl::ApplyPreallocateAutoIncrement(uint64_t table_id, uint64_t start_id, uint64_t end_id) {
+  std::shared_ptr<AutoIncrementWindow> window;
+  if (auto_increment_window_map_.Get(table_id, window) > 0 &&
+      window->end_id.load(std::memory_order_acquire) == start_id && start_id > 0) {
+    // continuous with the current window, just extend it
+    window->end_id.store(end_id, std::memory_order_release);
+    return;
+  }
+
+  // the ids between the old window and start_id may be generated through raft, so never reuse the old window
+  if (window != nullptr) {
+    window->end_id.store(0, std::memory_order_release);
+  }
+
+  auto new_window = std::make_shared<AutoIncrementWindow>();
+  new_window->next_id.store(start_id, std::memory_order_release);
+  new_window->end_id.store(end_id, std::memory_order_release);
+  auto_increment_window_map_.Put(table_id, new_window);
+}
+
+// caller must hold auto_increment_map_mutex_
+void AutoIncrementControl::CloseAutoIncrementWindow(uint64_t table_id) {
+  std::shared_ptr<AutoIncrementWindow> window;
+  if (auto_increment_window_map_.Get(table_id, window) > 0) {
+    window->end_id.store(0, std::memory_order_release);
+    auto_increment_window_map_.Erase(table_id);
+  }
+}
+
+void AutoIncrementControl::CloseAllAutoIncrementWindows() {
+  std::vector<std::shared_ptr<AutoIncrementWindow>> windows;
+  auto_increment_window_map_.GetAllValues(windows);
+  for (auto& window : windows) {
+    window->end_id.store(0, std::memory_order_release);
+  }
+  auto_increment_window_map_.Clear();
+}
+
 butil::Status AutoIncrementControl::DeleteAutoIncrement(uint64_t table_id,
                                                         pb::coordinator_internal::MetaIncrement& meta_increment) {
   DINGO_LOG(INFO) << "table id" << table_id;
@@ -226,9 +374,18 @@ bool AutoIncrementControl::IsLeader() { return leader_term_.load(butil::memory_o
 
 void AutoIncrementControl::SetLeaderTerm(int64_t term) { leader_term_.store(term, butil::memory_order_release); }
 
-void AutoIncrementControl::OnLeaderStart(int64_t term) { DINGO_LOG(INFO) << "OnLeaderStart, term=" << term; }
+// the windows of old leader may be generated by other leader, so clear all windows when leader changes
+void AutoIncrementControl::OnLeaderStart(int64_t term) {
+  DINGO_LOG(INFO) << "OnLeaderStart, term=" << term;
+  BAIDU_SCOPED_LOCK(auto_increment_map_mutex_);
+  CloseAllAutoIncrementWindows();
+}
 
-void AutoIncrementControl::OnLeaderStop() { DINGO_LOG(INFO) << "OnLeaderStop"; }
+void AutoIncrementControl::OnLeaderStop() {
+  DINGO_LOG(INFO) << "OnLeaderStop";
+  BAIDU_SCOPED_LOCK(auto_increment_map_mutex_);
+  CloseAllAutoIncrementWindows();
+}
 
 // set raft_node to coordinator_control
 void AutoIncrementControl::SetRaftNode(std::shared_ptr<RaftNode> raft_node) { raft_node_ = raft_node; }
@@ -245,16 +402,27 @@ void AutoIncrementControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncr
       DINGO_LOG(INFO) << "create auto increment, table id: " << table_id
                       << ", start id: " << auto_increment.increment().start_id();
       auto_increment_map_[table_id] = auto_increment.increment().start_id();
+      CloseAutoIncrementWindow(table_id);
     } else if (auto_increment.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
       uint64_t* start_id_ptr = auto_increment_map_.seek(table_id);
       if (start_id_ptr == nullptr) {
         DINGO_LOG(WARNING) << "for update, cannot find table id: " << table_id;
+        CloseAutoIncrementWindow(table_id);
         continue;
       }
 
       uint64_t source_start_id = *start_id_ptr;
-      if (auto_increment.increment().update_type() ==
-          pb::coordinator_internal::AutoIncrementUpdateType::READ_MODIFY_WRITE) {
+      if (auto_increment.increment().preallocate()) {
+        uint64_t end_id = source_start_id + auto_increment.increment().generate_count();
+        // only the proposer leader generates ids from the window
+        if (is_leader) {
+          ApplyPreallocateAutoIncrement(table_id, source_start_id, end_id);
+        }
+        auto_increment_map_[table_id] = end_id;
+        DINGO_LOG(INFO) << "preallocate auto increment, table id: " << table_id << ", [" << source_start_id << ", "
+                        << end_id << ")";
+      } else if (auto_increment.increment().update_type() ==
+                 pb::coordinator_internal::AutoIncrementUpdateType::READ_MODIFY_WRITE) {
         uint64_t end_id = GetGenerateEndId(source_start_id, auto_increment.increment().generate_count(),
                                            auto_increment.increment().increment(), auto_increment.increment().offset());
         // [source_start_id, end_id) has generated, so next start_id is end_id.
@@ -275,6 +443,7 @@ void AutoIncrementControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncr
                              << auto_increment.increment().source_start_id();
         }
         auto_increment_map_[table_id] = auto_increment.increment().start_id();
+        CloseAutoIncrementWindow(table_id);
         DINGO_LOG(INFO) << "update auto increment, table id: " << table_id
                         << ", old start id: " << auto_increment.increment().source_start_id()
                         << ", start id: " << auto_increment.increment().start_id();
@@ -282,6 +451,7 @@ void AutoIncrementControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncr
     } else if (auto_increment.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
       DINGO_LOG(INFO) << "delete auto increment " << auto_increment.ShortDebugString();
       auto_increment_map_.erase(table_id);
+      CloseAutoIncrementWindow(table_id);
     }
   }
 }
@@ -306,6 +476,13 @@ uint64_t AutoIncrementControl::GetGenerateEndId(uint64_t start_id, uint32_t coun
   return real_start_id + count * increment;
 }
 
+bool AutoIncrementControl::CheckGenerateParameters(uint32_t count, uint32_t auto_increment_increment,
+                                                   uint32_t auto_increment_offset) {
+  return count > 0 && count <= kAutoIncrementGenerateCountMax && auto_increment_increment > 0 &&
+         auto_increment_increment <= kAutoIncrementOffsetMax && auto_increment_offset > 0 &&
+         auto_increment_offset <= kAutoIncrementOffsetMax;
+}
+
 uint64_t AutoIncrementControl::GetRealStartId(uint64_t start_id, uint32_t auto_increment_increment,
                                               uint32_t auto_increment_offset) {
   uint64_t remainder = start_id % auto_increment_increment;
@@ -386,6 +563,7 @@ bool AutoIncrementControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Me
 
   BAIDU_SCOPED_LOCK(auto_increment_map_mutex_);
   auto_increment_map_.clear();
+  CloseAllAutoIncrementWindows();
   for (int i = 0; i < storage.elements_size(); i++) {
     const auto& element = storage.elements(i);
     auto_increment_map_[element.table_id()] = element.start_id();
@@ -15,6 +15,7 @@
 #ifndef DINGODB_AUTO_INCREMENT_CONTROL_H_
 #define DINGODB_AUTO_INCREMENT_CONTROL_H_
 
+#include <atomic>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -23,6 +24,8 @@
 
 #include "butil/containers/flat_map.h"
 #include "common/meta_control.h"
+#include "common/safe_map.h"
+#include "engine/engine.h"
 #include "proto/coordinator_internal.pb.h"
 
 namespace dingodb {
@@ -38,6 +41,13 @@ class AutoIncrementSnapshot : public dingodb::Snapshot {
   const butil::FlatMap<uint64_t, uint64_t> *snapshot_;
 };
 
+// The auto increment ids [next_id, end_id) reserved through raft, only used by leader to generate ids locally.
+struct AutoIncrementWindow {
+  std::atomic<uint64_t> next_id{0};
+  std::atomic<uint64_t> end_id{0};
+  std::atomic<bool> is_preallocating{false};
+};
+
 class AutoIncrementControl : public MetaControl {
  public:
   AutoIncrementControl();
@@ -47,6 +57,8 @@ class AutoIncrementControl : public MetaControl {
   static bool Init();
   static bool Recover();
 
+  void SetKvEngine(std::shared_ptr<Engine> engine) { engine_ = engine; };
+
   butil::Status GetAutoIncrements(butil::FlatMap<uint64_t, uint64_t> &auto_increments);
   butil::Status GetAutoIncrement(uint64_t table_id, uint64_t &start_id);
   butil::Status CreateAutoIncrement(uint64_t table_id, uint64_t start_id,
@@ -58,6 +70,11 @@ class AutoIncrementControl : public MetaControl {
                                       pb::coordinator_internal::MetaIncrement &meta_increment);
   butil::Status DeleteAutoIncrement(uint64_t table_id, pb::coordinator_internal::MetaIncrement &meta_increment);
 
+  // Generate ids from the preallocated window of leader without raft, return false if the window is not enough,
+  // then the caller should generate through raft. The window is refilled in background before exhausted.
+  bool GenerateAutoIncrementFromWindow(uint64_t table_id, uint32_t count, uint32_t auto_increment_increment,
+                                       uint32_t auto_increment_offset, uint64_t &start_id, uint64_t &end_id);
+
   // Get raft leader's server location
   void GetLeaderLocation(pb::common::Location &leader_server_location) override;
 
@@ -99,10 +116,23 @@ class AutoIncrementControl : public MetaControl {
  private:
   static uint64_t GetGenerateEndId(uint64_t start_id, uint32_t count, uint32_t increment, uint32_t offset);
   static uint64_t GetRealStartId(uint64_t start_id, uint32_t auto_increment_increment, uint32_t auto_increment_offset);
+  static bool CheckGenerateParameters(uint32_t count, uint32_t auto_increment_increment,
+                                      uint32_t auto_increment_offset);
+
+  // Propose a preallocate generate through raft, the window is extended or replaced when applied.
+  void PreallocateAutoIncrement(uint64_t table_id, std::shared_ptr<AutoIncrementWindow> window);
+  // Must hold auto_increment_map_mutex_.
+  void ApplyPreallocateAutoIncrement(uint64_t table_id, uint64_t start_id, uint64_t end_id);
+  void CloseAutoIncrementWindow(uint64_t table_id);
+  void CloseAllAutoIncrementWindows();
 
   butil::FlatMap<uint64_t, uint64_t> auto_increment_map_;
   bthread_mutex_t auto_increment_map_mutex_;
 
+  // leader local windows of auto increment, read without lock by GenerateAutoIncrementFromWindow,
+  // only modified in apply and leader change.
+  DingoSafeStdMap<uint64_t, std::shared_ptr<AutoIncrementWindow>> auto_increment_window_map_;
+
   // node is leader or not
   butil::atomic<int64_t> leader_term_;
 
@@ -112,6 +142,9 @@ class AutoIncrementControl : public MetaControl {
   // coordinator raft_location to server_location cache
   std::map<std::string, pb::common::Location> auto_increment_location_cache_;
 
+  // raft kv engine
+  std::shared_ptr<Engine> engine_;
+
   inline static const uint32_t kAutoIncrementGenerateCountMax = 100000;
   inline static const uint32_t kAutoIncrementOffsetMax = 65535;
 };
@@ -49,6 +49,7 @@ CoordinatorControl::CoordinatorControl(std::shared_ptr<MetaReader> meta_reader,
   bthread_mutex_init(&store_operation_map_mutex_, nullptr);
   bthread_mutex_init(&lease_to_key_map_temp_mutex_, nullptr);
   bthread_mutex_init(&one_time_watch_map_mutex_, nullptr);
+  bthread_mutex_init(&balance_region_move_map_mutex_, nullptr);
   root_schema_writed_to_raft_ = false;
   is_processing_task_list_.store(false);
   leader_term_.store(-1, butil::memory_order_release);
@@ -87,7 +88,7 @@ CoordinatorControl::CoordinatorControl(std::shared_ptr<MetaReader> meta_reader,
   lease_meta_ = new MetaSafeMapStorage<pb::coordinator_internal::LeaseInternal>(&lease_map_, "lease_map_");
   kv_index_meta_ =
       new MetaSafeStringStdMapStorage<pb::coordinator_internal::KvIndexInternal>(&kv_index_map_, "kv_index_map_");
-  kv_rev_meta_ = new MetaSafeStringStdMapStorage<pb::coordinator_internal::KvRevInternal>(&kv_rev_map_, "kv_rev_map_");
+  kv_rev_storage_ = std::make_shared<KvRevStorage>(meta_reader_, "kv_rev_map_");
 
   // table index
   table_index_meta_ =
@@ -97,6 +98,7 @@ CoordinatorControl::CoordinatorControl(std::shared_ptr<MetaReader> meta_reader,
   store_need_push_.init(100, 80);
   executor_need_push_.init(100, 80);
   store_metrics_map_.init(100, 80);
+  store_region_metrics_version_map_.init(100, 80);
 
   // init SafeMap
   id_epoch_map_.Init(100);                // id_epoch_map_ is a small map
@@ -451,17 +453,7 @@ bool CoordinatorControl::Recover() {
   DINGO_LOG(INFO) << "Recover kv_index_meta, count=" << kvs.size();
   kvs.clear();
 
-  // 16.kv_rev map
-  if (!meta_reader_->Scan(kv_rev_meta_->Prefix(), kvs)) {
-    return false;
-  }
-  {
-    if (!kv_rev_meta_->Recover(kvs)) {
-      return false;
-    }
-  }
-  DINGO_LOG(INFO) << "Recover kv_rev_meta, count=" << kvs.size();
-  kvs.clear();
+  // 16.kv_rev map is read from meta cf on demand, no need to recover
 
   // 50.table_index map
   if (!meta_reader_->Scan(table_index_meta_->Prefix(), kvs)) {
@@ -481,12 +473,6 @@ bool CoordinatorControl::Recover() {
   BuildLeaseToKeyMap();
   DINGO_LOG(INFO) << "Recover lease_to_key_map_temp, count=" << lease_to_key_map_temp_.size();
 
-  std::map<std::string, pb::coordinator_internal::KvRevInternal> kv_rev_map;
-  kv_rev_map_.GetRawMapCopy(kv_rev_map);
-  for (auto& kv : kv_rev_map) {
-    DINGO_LOG(INFO) << "kv_rev_map key=" << Helper::StringToHex(kv.first) << " value=" << kv.second.DebugString();
-  }
-
   return true;
 }
 
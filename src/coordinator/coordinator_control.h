@@ -19,8 +19,10 @@
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <set>
 #include <shared_mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "bthread/types.h"
@@ -28,7 +30,10 @@
 #include "butil/status.h"
 #include "common/meta_control.h"
 #include "common/safe_map.h"
+#include "coordinator/coordinator_meta_index.h"
 #include "coordinator/coordinator_meta_storage.h"
+#include "coordinator/kv_rev_storage.h"
+#include "coordinator/watch_event_ring.h"
 #include "engine/engine.h"
 #include "engine/snapshot.h"
 #include "google/protobuf/stubs/callback.h"
@@ -71,6 +76,37 @@ struct WatchNode {
   bool need_prev_kv;
 };
 
+// region load on one store, collected from store heartbeat
+struct RegionLoad {
+  uint64_t region_id{0};
+  bool is_leader{false};
+  uint64_t region_size{0};
+  uint64_t vector_index_memory{0};
+  uint64_t write_qps{0};
+  std::vector<uint64_t> peer_store_ids;
+};
+
+// store load collected from store heartbeat, used by balance scheduler
+struct StoreLoad {
+  uint64_t store_id{0};
+  pb::common::StoreType store_type{pb::common::StoreType::NODE_TYPE_STORE};
+  uint64_t region_count{0};
+  uint64_t leader_count{0};
+  uint64_t region_size{0};
+  uint64_t vector_index_memory{0};
+  uint64_t write_qps{0};
+  std::map<uint64_t, RegionLoad> regions;  // region_id -> region load
+};
+
+// one operation planned by balance scheduler
+struct BalanceOperation {
+  uint64_t region_id{0};
+  uint64_t source_store_id{0};
+  uint64_t target_store_id{0};
+  // peers of region before move, only for balance region
+  std::vector<uint64_t> peer_store_ids;
+};
+
 class AtomicGuard {
  public:
   AtomicGuard(std::atomic<bool> &flag) : m_flag_(flag) { m_flag_.store(true); }
@@ -439,6 +475,11 @@ class CoordinatorControl : public MetaControl {
   // delete store metrics
   void DeleteStoreMetrics(uint64_t store_id);
 
+  // delta store heartbeat is lost or not in sync, store need to send full region metrics
+  bool NeedFullRegionMetrics(uint64_t store_id);
+  // region is not reported by delta heartbeat because it is unchanged, check its leader store instead
+  bool IsRegionAliveByDeltaHeartbeat(const pb::common::RegionMetrics &region_metrics);
+
   // region metrics
   void GetRegionMetrics(uint64_t region_id, std::vector<pb::common::RegionMetrics> &region_metrics_array);
   void DeleteRegionMetrics(uint64_t region_id);
@@ -732,6 +773,36 @@ class CoordinatorControl : public MetaControl {
   // lease timeout/revoke task
   void CompactionTask();
 
+  // balance leader and region between stores
+  void BalanceTask();
+  uint32_t BalanceLeader(pb::common::StoreType store_type, std::map<uint64_t, StoreLoad> &store_loads,
+                         std::set<uint64_t> &scheduled_region_ids,
+                         pb::coordinator_internal::MetaIncrement &meta_increment);
+  uint32_t BalanceRegion(pb::common::StoreType store_type, std::map<uint64_t, StoreLoad> &store_loads,
+                         std::set<uint64_t> &scheduled_region_ids,
+                         pb::coordinator_internal::MetaIncrement &meta_increment);
+  uint32_t FinishBalanceRegionMove(const std::map<uint64_t, StoreLoad> &store_loads,
+                                   std::set<uint64_t> &scheduled_region_ids,
+                                   pb::coordinator_internal::MetaIncrement &meta_increment);
+  uint32_t GetRegionReplicaNum(const pb::coordinator_internal::RegionInternal &region,
+                               std::map<uint64_t, uint32_t> &replica_nums);
+
+  // collect store load from store_metrics_map_, only normal stores are collected
+  void GetStoreLoads(std::map<uint64_t, StoreLoad> &store_loads);
+
+  // Balance planning, only depends on the input, store_loads is updated as if the planned operations are done.
+  static void CollectStoreLoads(const butil::FlatMap<uint64_t, pb::common::Store> &store_map,
+                                const butil::FlatMap<uint64_t, pb::common::StoreMetrics> &store_metrics_map,
+                                std::map<uint64_t, StoreLoad> &store_loads);
+  static std::vector<BalanceOperation> PlanBalanceLeader(pb::common::StoreType store_type,
+                                                         std::map<uint64_t, StoreLoad> &store_loads,
+                                                         std::set<uint64_t> &scheduled_region_ids, uint32_t max_ops);
+  static std::vector<BalanceOperation> PlanBalanceRegion(pb::common::StoreType store_type,
+                                                         std::map<uint64_t, StoreLoad> &store_loads,
+                                                         std::set<uint64_t> &scheduled_region_ids, uint32_t max_ops);
+  static uint64_t SelectTrimPeerStore(const std::vector<uint64_t> &peer_store_ids, uint64_t leader_store_id,
+                                      uint64_t preferred_store_id, const std::map<uint64_t, StoreLoad> &store_loads);
+
   // lease
   butil::Status LeaseGrant(uint64_t lease_id, int64_t ttl_seconds, uint64_t &granted_id, int64_t &granted_ttl_seconds,
                            pb::coordinator_internal::MetaIncrement &meta_increment);
@@ -752,8 +823,10 @@ class CoordinatorControl : public MetaControl {
   static pb::coordinator_internal::RevisionInternal StringToRevision(const std::string &input_string);
 
   // raw kv functions
-  butil::Status RangeRawKvIndex(const std::string &key, const std::string &range_end,
-                                std::vector<pb::coordinator_internal::KvIndexInternal> &kv_index_values);
+  butil::Status RangeRawKvIndex(const std::string &key, const std::string &range_end, int64_t limit,
+                                std::vector<std::string> *keys,
+                                std::vector<pb::coordinator_internal::RevisionInternal> *mod_revisions,
+                                uint64_t &count, bool &has_more);
   butil::Status GetRawKvIndex(const std::string &key, pb::coordinator_internal::KvIndexInternal &kv_index);
   butil::Status PutRawKvIndex(const std::string &key, const pb::coordinator_internal::KvIndexInternal &kv_index);
   butil::Status DeleteRawKvIndex(const std::string &key, const pb::coordinator_internal::KvIndexInternal &kv_index);
@@ -772,9 +845,12 @@ class CoordinatorControl : public MetaControl {
   // in:  keys_only
   // in:  count_only
   // out: kv
+  // out: total_count_in_range
+  // out: has_more
   // return: errno
   butil::Status KvRange(const std::string &key, const std::string &range_end, int64_t limit, bool keys_only,
-                        bool count_only, std::vector<pb::version::Kv> &kv, uint64_t &total_count_in_range);
+                        bool count_only, std::vector<pb::version::Kv> &kv, uint64_t &total_count_in_range,
+                        bool &has_more);
 
   // kv functions for internal use
   // KvRange is the get function
@@ -829,13 +905,17 @@ class CoordinatorControl : public MetaControl {
                                const pb::coordinator_internal::RevisionInternal &compact_revision);
 
   // watch functions for api
-  butil::Status OneTimeWatch(const std::string &watch_key, uint64_t start_revision, bool no_put_event,
-                             bool no_delete_event, bool need_prev_kv, bool wait_on_not_exist_key,
+  butil::Status OneTimeWatch(const std::string &watch_key, const std::string &range_end, uint64_t start_revision,
+                             bool no_put_event, bool no_delete_event, bool need_prev_kv, bool wait_on_not_exist_key,
                              google::protobuf::Closure *done, pb::version::WatchResponse *response,
                              brpc::Controller *cntl);
 
+  // add the latest kvs in range with mod_revision >= start_revision to response as put events, read by page
+  int CollectLatestKvEvents(const std::string &watch_key, const std::string &range_end, uint64_t start_revision,
+                            int max_count, pb::version::WatchResponse *response);
+
   // add watch to map
-  butil::Status AddOneTimeWatch(const std::string &watch_key, uint64_t start_revision, bool no_put_event,
+  butil::Status AddOneTimeWatch(const WatchRange &watch_range, uint64_t start_revision, bool no_put_event,
                                 bool no_delete_event, bool need_prev_kv, google::protobuf::Closure *done,
                                 pb::version::WatchResponse *response);
   // remove watch from map
@@ -920,6 +1000,9 @@ class CoordinatorControl : public MetaControl {
   butil::FlatMap<uint64_t, pb::common::StoreMetrics> store_metrics_map_;
   MetaMapStorage<pb::common::StoreMetrics> *store_metrics_meta_;
   bthread_mutex_t store_metrics_map_mutex_;
+  // store_id -> last merged region_metrics_version of delta heartbeat, protected by store_metrics_map_mutex_
+  // if a store is not in this map, its region metrics is not in sync, need full heartbeat
+  butil::FlatMap<uint64_t, uint64_t> store_region_metrics_version_map_;
 
   // 8.table_metrics
   DingoSafeMap<uint64_t, pb::coordinator_internal::TableMetricsInternal> table_metrics_map_;
@@ -941,6 +1024,10 @@ class CoordinatorControl : public MetaControl {
   DingoSafeMap<uint64_t, pb::coordinator::TaskList> task_list_map_;  // task_list_id -> task_list
   MetaSafeMapStorage<pb::coordinator::TaskList> *task_list_meta_;    // need construct
 
+  // secondary indexes of region, task_list, region_cmd and store_operation maps, is out of state machine
+  // maintained in ApplyMetaIncrement and rebuilt in BuildTempMaps
+  CoordinatorMetaIndex meta_index_;
+
   // 12.indexes
   DingoSafeMap<uint64_t, pb::coordinator_internal::TableInternal> index_map_;
   MetaSafeMapStorage<pb::coordinator_internal::TableInternal> *index_meta_;
@@ -966,17 +1053,28 @@ class CoordinatorControl : public MetaControl {
   DingoSafeStdMap<std::string, pb::coordinator_internal::KvIndexInternal> kv_index_map_;
   MetaSafeStringStdMapStorage<pb::coordinator_internal::KvIndexInternal> *kv_index_meta_;
 
-  // 16.version kv multi revision
-  DingoSafeStdMap<std::string, pb::coordinator_internal::KvRevInternal> kv_rev_map_;
-  MetaSafeStringStdMapStorage<pb::coordinator_internal::KvRevInternal> *kv_rev_meta_;
+  // 16.version kv multi revision, stored in meta cf and only hot revisions are cached
+  std::shared_ptr<KvRevStorage> kv_rev_storage_;
 
   // one time watch map
   // this map on work on leader, is out of state machine
+  // single key watch, key -> watch nodes
   std::map<std::string, std::map<google::protobuf::Closure *, WatchNode>> one_time_watch_map_;
-  std::map<google::protobuf::Closure *, std::string> one_time_watch_closure_map_;
+  // range and prefix watch, the watches of the same range are grouped, so an event is matched against
+  // the distinct ranges ordered by start key, not all watches
+  std::map<WatchRange, std::map<google::protobuf::Closure *, WatchNode>> one_time_range_watch_map_;
+  std::map<google::protobuf::Closure *, WatchRange> one_time_watch_closure_map_;
+  // recent events for watch to resume from start_revision, protected by one_time_watch_map_mutex_
+  WatchEventRing watch_event_ring_;
   bthread_mutex_t one_time_watch_map_mutex_;
   DingoSafeStdMap<google::protobuf::Closure *, bool> one_time_watch_closure_status_map_;
 
+  // balance region move, region_id -> (source store_id, target store_id)
+  // the region has added a peer on target store, and wait to remove the peer on source store
+  // this map only work on leader, is out of state machine
+  std::map<uint64_t, std::pair<uint64_t, uint64_t>> balance_region_move_map_;
+  bthread_mutex_t balance_region_move_map_mutex_;
+
   // 50. table index
   DingoSafeMap<uint64_t, pb::coordinator_internal::TableIndexInternal> table_index_map_;
   MetaSafeMapStorage<pb::coordinator_internal::TableIndexInternal> *table_index_meta_;
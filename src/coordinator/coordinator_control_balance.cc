@@ -0,0 +1,573 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <set>
+#include <tuple>
+#include <vector>
+
+#include "butil/containers/flat_map.h"
+#include "butil/status.h"
+#include "common/logging.h"
+#include "coordinator/coordinator_control.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/coordinator_internal.pb.h"
+
+namespace dingodb {
+
+DEFINE_bool(enable_balance_leader, false, "enable balance region leader between stores");
+DEFINE_bool(enable_balance_region, false, "enable balance region replica between stores");
+DEFINE_bool(balance_dry_run, false, "balance only log the plan, not really schedule");
+DEFINE_uint32(balance_leader_max_ops_per_round, 4, "max transfer leader operation per balance round");
+DEFINE_uint32(balance_region_max_ops_per_round, 2, "max move region operation per balance round");
+DEFINE_uint32(balance_max_running_task_list, 10, "skip balance if running task list exceed this value");
+DEFINE_double(balance_leader_tolerance_ratio, 0.1,
+              "leader count difference of stores tolerance ratio of average leader count");
+DEFINE_double(balance_region_tolerance_ratio, 0.2, "region load score difference of stores tolerance ratio");
+
+void CoordinatorControl::GetStoreLoads(std::map<uint64_t, StoreLoad>& store_loads) {
+  butil::FlatMap<uint64_t, pb::common::Store> store_map_copy;
+  store_map_copy.init(100);
+  store_map_.GetRawMapCopy(store_map_copy);
+
+  BAIDU_SCOPED_LOCK(store_metrics_map_mutex_);
+  CollectStoreLoads(store_map_copy, store_metrics_map_, store_loads);
+}
+
+void CoordinatorControl::CollectStoreLoads(
+    const butil::FlatMap<uint64_t, pb::common::Store>& store_map,
+    const butil::FlatMap<uint64_t, pb::common::StoreMetrics>& store_metrics_map,
+    std::map<uint64_t, StoreLoad>& store_loads) {
+  for (const auto& it : store_map) {
+    const auto& store = it.second;
+    if (store.state() != pb::common::StoreState::STORE_NORMAL ||
+        store.in_state() != pb::common::StoreInState::STORE_IN) {
+      continue;
+    }
+
+    auto& store_load = store_loads[store.id()];
+    store_load.store_id = store.id();
+    store_load.store_type = store.store_type();
+  }
+
+  for (const auto& it : store_metrics_map) {
+    auto store_load_it = store_loads.find(it.first);
+    if (store_load_it == store_loads.end()) {
+      continue;
+    }
+
+    auto& store_load = store_load_it->second;
+    for (const auto& region_metrics_it : it.second.region_metrics_map()) {
+      const auto& region_metrics = region_metrics_it.second;
+
+      RegionLoad region_load;
+      region_load.region_id = region_metrics.id();
+      region_load.is_leader = region_metrics.leader_store_id() == it.first;
+      region_load.region_size = region_metrics.region_size();
+      region_load.vector_index_memory = region_metrics.vector_index_metrics().memory_bytes();
+      region_load.write_qps = region_metrics.write_qps();
+      for (const auto& peer : region_metrics.region_definition().peers()) {
+        region_load.peer_store_ids.push_back(peer.store_id());
+      }
+
+      store_load.region_count++;
+      store_load.region_size += region_load.region_size;
+      store_load.vector_index_memory += region_load.vector_index_memory;
+      if (region_load.is_leader) {
+        store_load.leader_count++;
+        store_load.write_qps += region_load.write_qps;
+      }
+
+      store_load.regions.insert({region_load.region_id, region_load});
+    }
+  }
+}
+
+static bool HasPeer(const RegionLoad& region_load, uint64_t store_id) {
+  return std::find(region_load.peer_store_ids.begin(), region_load.peer_store_ids.end(), store_id) !=
+         region_load.peer_store_ids.end();
+}
+
+void CoordinatorControl::BalanceTask() {
+  if (!FLAGS_enable_balance_leader && !FLAGS_enable_balance_region) {
+    return;
+  }
+
+  // rate limit, do not pile up task list
+  uint64_t running_task_list_count = task_list_map_.Size();
+  if (running_task_list_count >= FLAGS_balance_max_running_task_list) {
+    DINGO_LOG(INFO) << fmt::format("[balance] skip, running task list count({}) >= max({})", running_task_list_count,
+                                   FLAGS_balance_max_running_task_list);
+    return;
+  }
+
+  std::map<uint64_t, StoreLoad> store_loads;
+  GetStoreLoads(store_loads);
+
+  std::set<pb::common::StoreType> store_types;
+  for (const auto& [store_id, store_load] : store_loads) {
+    store_types.insert(store_load.store_type);
+  }
+
+  std::set<uint64_t> scheduled_region_ids;
+  pb::coordinator_internal::MetaIncrement meta_increment;
+  uint32_t op_count = 0;
+
+  if (FLAGS_enable_balance_region && !FLAGS_balance_dry_run) {
+    op_count += FinishBalanceRegionMove(store_loads, scheduled_region_ids, meta_increment);
+  }
+
+  for (auto store_type : store_types) {
+    if (FLAGS_enable_balance_leader) {
+      op_count += BalanceLeader(store_type, store_loads, scheduled_region_ids, meta_increment);
+    }
+    if (FLAGS_enable_balance_region) {
+      op_count += BalanceRegion(store_type, store_loads, scheduled_region_ids, meta_increment);
+    }
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[balance] finish, store count({}) op count({}) dry_run({})", store_loads.size(),
+                                 op_count, FLAGS_balance_dry_run);
+
+  if (meta_increment.ByteSizeLong() > 0) {
+    SubmitMetaIncrementSync(meta_increment);
+  }
+}
+
+uint32_t CoordinatorControl::BalanceLeader(pb::common::StoreType store_type,
+                                           std::map<uint64_t, StoreLoad>& store_loads,
+                                           std::set<uint64_t>& scheduled_region_ids,
+                                           pb::coordinator_internal::MetaIncrement& meta_increment) {
+  auto operations =
+      PlanBalanceLeader(store_type, store_loads, scheduled_region_ids, FLAGS_balance_leader_max_ops_per_round);
+
+  uint32_t op_count = 0;
+  for (const auto& operation : operations) {
+    DINGO_LOG(INFO) << fmt::format(
+        "[balance.leader] plan transfer leader region({}) from store({}) to store({}) dry_run({})",
+        operation.region_id, operation.source_store_id, operation.target_store_id, FLAGS_balance_dry_run);
+
+    if (!FLAGS_balance_dry_run) {
+      auto status = ValidateTaskListConflict(operation.region_id, operation.region_id);
+      if (status.ok()) {
+        status = TransferLeaderRegionWithTaskList(operation.region_id, operation.target_store_id, meta_increment);
+      }
+      if (!status.ok()) {
+        DINGO_LOG(WARNING) << fmt::format("[balance.leader] transfer leader region({}) failed, error: {}",
+                                          operation.region_id, status.error_str());
+        continue;
+      }
+    }
+
+    ++op_count;
+  }
+
+  return op_count;
+}
+
+std::vector<BalanceOperation> CoordinatorControl::PlanBalanceLeader(pb::common::StoreType store_type,
+                                                                    std::map<uint64_t, StoreLoad>& store_loads,
+                                                                    std::set<uint64_t>& scheduled_region_ids,
+                                                                    uint32_t max_ops) {
+  std::vector<BalanceOperation> operations;
+
+  std::vector<StoreLoad*> candidates;
+  uint64_t total_leader_count = 0;
+  for (auto& [store_id, store_load] : store_loads) {
+    if (store_load.store_type == store_type) {
+      candidates.push_back(&store_load);
+      total_leader_count += store_load.leader_count;
+    }
+  }
+  if (candidates.size() < 2 || total_leader_count == 0) {
+    return operations;
+  }
+
+  double avg_leader_count = static_cast<double>(total_leader_count) / candidates.size();
+  uint64_t tolerance = std::max(static_cast<uint64_t>(avg_leader_count * FLAGS_balance_leader_tolerance_ratio),
+                               static_cast<uint64_t>(1));
+
+  while (operations.size() < max_ops) {
+    auto* target = *std::min_element(
+        candidates.begin(), candidates.end(),
+        [](const StoreLoad* a, const StoreLoad* b) { return a->leader_count < b->leader_count; });
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [](const StoreLoad* a, const StoreLoad* b) { return a->leader_count > b->leader_count; });
+
+    // move the hottest leader which has a follower on target store, from the most loaded store which has one
+    StoreLoad* source = nullptr;
+    RegionLoad* selected = nullptr;
+    for (auto* candidate : candidates) {
+      if (candidate->leader_count <= target->leader_count + tolerance) {
+        break;
+      }
+
+      for (auto& [region_id, region_load] : candidate->regions) {
+        if (!region_load.is_leader || !HasPeer(region_load, target->store_id) ||
+            scheduled_region_ids.count(region_id) > 0) {
+          continue;
+        }
+        if (selected == nullptr || region_load.write_qps > selected->write_qps) {
+          selected = &region_load;
+        }
+      }
+      if (selected != nullptr) {
+        source = candidate;
+        break;
+      }
+    }
+    if (selected == nullptr) {
+      DINGO_LOG(INFO) << fmt::format("[balance.leader] no region can transfer leader to store({}) leader_count({})",
+                                     target->store_id, target->leader_count);
+      break;
+    }
+
+    scheduled_region_ids.insert(selected->region_id);
+    DINGO_LOG(DEBUG) << fmt::format(
+        "[balance.leader] select region({}) store({}) leader_count({}) to store({}) leader_count({}) write_qps({})",
+        selected->region_id, source->store_id, source->leader_count, target->store_id, target->leader_count,
+        selected->write_qps);
+
+    BalanceOperation operation;
+    operation.region_id = selected->region_id;
+    operation.source_store_id = source->store_id;
+    operation.target_store_id = target->store_id;
+    operations.push_back(operation);
+
+    // update load, so next round see the new distribution
+    source->leader_count--;
+    source->write_qps -= std::min(source->write_qps, selected->write_qps);
+    target->leader_count++;
+    target->write_qps += selected->write_qps;
+    selected->is_leader = false;
+    auto target_region_it = target->regions.find(selected->region_id);
+    if (target_region_it != target->regions.end()) {
+      target_region_it->second.is_leader = true;
+    }
+  }
+
+  return operations;
+}
+
+uint32_t CoordinatorControl::BalanceRegion(pb::common::StoreType store_type,
+                                           std::map<uint64_t, StoreLoad>& store_loads,
+                                           std::set<uint64_t>& scheduled_region_ids,
+                                           pb::coordinator_internal::MetaIncrement& meta_increment) {
+  auto operations =
+      PlanBalanceRegion(store_type, store_loads, scheduled_region_ids, FLAGS_balance_region_max_ops_per_round);
+
+  uint32_t op_count = 0;
+  for (const auto& operation : operations) {
+    DINGO_LOG(INFO) << fmt::format("[balance.region] plan move region({}) from store({}) to store({}) dry_run({})",
+                                   operation.region_id, operation.source_store_id, operation.target_store_id,
+                                   FLAGS_balance_dry_run);
+
+    if (!FLAGS_balance_dry_run) {
+      // first add peer on target store, the peer on source store will be removed by FinishBalanceRegionMove
+      std::vector<uint64_t> new_store_ids = operation.peer_store_ids;
+      new_store_ids.push_back(operation.target_store_id);
+      auto status = ChangePeerRegionWithTaskList(operation.region_id, new_store_ids, meta_increment);
+      if (!status.ok()) {
+        DINGO_LOG(WARNING) << fmt::format("[balance.region] add peer region({}) to store({}) failed, error: {}",
+                                          operation.region_id, operation.target_store_id, status.error_str());
+        continue;
+      }
+
+      BAIDU_SCOPED_LOCK(balance_region_move_map_mutex_);
+      balance_region_move_map_[operation.region_id] = {operation.source_store_id, operation.target_store_id};
+    }
+
+    ++op_count;
+  }
+
+  return op_count;
+}
+
+std::vector<BalanceOperation> CoordinatorControl::PlanBalanceRegion(pb::common::StoreType store_type,
+                                                                    std::map<uint64_t, StoreLoad>& store_loads,
+                                                                    std::set<uint64_t>& scheduled_region_ids,
+                                                                    uint32_t max_ops) {
+  std::vector<BalanceOperation> operations;
+
+  std::vector<StoreLoad*> candidates;
+  uint64_t total_region_count = 0;
+  uint64_t total_region_size = 0;
+  uint64_t total_vector_index_memory = 0;
+  for (auto& [store_id, store_load] : store_loads) {
+    if (store_load.store_type == store_type) {
+      candidates.push_back(&store_load);
+      total_region_count += store_load.region_count;
+      total_region_size += store_load.region_size;
+      total_vector_index_memory += store_load.vector_index_memory;
+    }
+  }
+  if (candidates.size() < 2 || total_region_count == 0) {
+    return operations;
+  }
+
+  // score is the sum of each dimension normalized by cluster average, so every dimension has the same weight
+  double avg_region_count = static_cast<double>(total_region_count) / candidates.size();
+  double avg_region_size = static_cast<double>(total_region_size) / candidates.size();
+  double avg_vector_index_memory = static_cast<double>(total_vector_index_memory) / candidates.size();
+  auto score = [&](uint64_t region_count, uint64_t region_size, uint64_t vector_index_memory) -> double {
+    double result = region_count / avg_region_count;
+    if (avg_region_size > 0) {
+      result += region_size / avg_region_size;
+    }
+    if (avg_vector_index_memory > 0) {
+      result += vector_index_memory / avg_vector_index_memory;
+    }
+    return result;
+  };
+  auto store_score = [&](const StoreLoad* store_load) -> double {
+    return score(store_load->region_count, store_load->region_size, store_load->vector_index_memory);
+  };
+
+  while (operations.size() < max_ops) {
+    auto* target = *std::min_element(
+        candidates.begin(), candidates.end(),
+        [&](const StoreLoad* a, const StoreLoad* b) { return store_score(a) < store_score(b); });
+    std::stable_sort(candidates.begin(), candidates.end(),
+                     [&](const StoreLoad* a, const StoreLoad* b) { return store_score(a) > store_score(b); });
+    double target_score = store_score(target);
+
+    // select the biggest follower region which not overshoot the balance point, from the most loaded store which has
+    // one, e.g. the most loaded store may only have leaders
+    StoreLoad* source = nullptr;
+    RegionLoad* selected = nullptr;
+    double source_score = 0;
+    for (auto* candidate : candidates) {
+      double candidate_score = store_score(candidate);
+      if (candidate_score - target_score <= candidate_score * FLAGS_balance_region_tolerance_ratio) {
+        break;
+      }
+
+      double selected_score = 0;
+      double max_region_score = (candidate_score - target_score) / 2;
+      for (auto& [region_id, region_load] : candidate->regions) {
+        if (region_load.is_leader || HasPeer(region_load, target->store_id) ||
+            scheduled_region_ids.count(region_id) > 0) {
+          continue;
+        }
+        double region_score = score(1, region_load.region_size, region_load.vector_index_memory);
+        if (region_score <= max_region_score && region_score > selected_score) {
+          selected = &region_load;
+          selected_score = region_score;
+        }
+      }
+      if (selected != nullptr) {
+        source = candidate;
+        source_score = candidate_score;
+        break;
+      }
+    }
+    if (selected == nullptr) {
+      DINGO_LOG(INFO) << fmt::format("[balance.region] no region can move to store({}) score({:.3f})",
+                                     target->store_id, target_score);
+      break;
+    }
+
+    scheduled_region_ids.insert(selected->region_id);
+    DINGO_LOG(DEBUG) << fmt::format(
+        "[balance.region] select region({}) store({}) score({:.3f}) to store({}) score({:.3f}) size({}) "
+        "vector_index_memory({})",
+        selected->region_id, source->store_id, source_score, target->store_id, target_score, selected->region_size,
+        selected->vector_index_memory);
+
+    BalanceOperation operation;
+    operation.region_id = selected->region_id;
+    operation.source_store_id = source->store_id;
+    operation.target_store_id = target->store_id;
+    operation.peer_store_ids = selected->peer_store_ids;
+    operations.push_back(operation);
+
+    // update load, so next round see the new distribution
+    RegionLoad moved_region = *selected;
+    source->region_count--;
+    source->region_size -= std::min(source->region_size, moved_region.region_size);
+    source->vector_index_memory -= std::min(source->vector_index_memory, moved_region.vector_index_memory);
+    target->region_count++;
+    target->region_size += moved_region.region_size;
+    target->vector_index_memory += moved_region.vector_index_memory;
+    source->regions.erase(moved_region.region_id);
+    target->regions.insert({moved_region.region_id, moved_region});
+  }
+
+  return operations;
+}
+
+// Select the peer to remove from an over replicated region, the leader peer is never selected.
+// The store of the move source is preferred, otherwise the store holding the most regions.
+uint64_t CoordinatorControl::SelectTrimPeerStore(const std::vector<uint64_t>& peer_store_ids, uint64_t leader_store_id,
+                                                 uint64_t preferred_store_id,
+                                                 const std::map<uint64_t, StoreLoad>& store_loads) {
+  if (preferred_store_id != 0 && preferred_store_id != leader_store_id &&
+      std::find(peer_store_ids.begin(), peer_store_ids.end(), preferred_store_id) != peer_store_ids.end()) {
+    return preferred_store_id;
+  }
+
+  uint64_t select_store_id = 0;
+  uint64_t select_region_count = 0;
+  for (auto store_id : peer_store_ids) {
+    if (store_id == leader_store_id) {
+      continue;
+    }
+    auto it = store_loads.find(store_id);
+    uint64_t region_count = it != store_loads.end() ? it->second.region_count : 0;
+    if (select_store_id == 0 || region_count > select_region_count) {
+      select_store_id = store_id;
+      select_region_count = region_count;
+    }
+  }
+
+  return select_store_id;
+}
+
+// replica num of the table or index the region belongs to, 0 means unknown
+uint32_t CoordinatorControl::GetRegionReplicaNum(const pb::coordinator_internal::RegionInternal& region,
+                                                 std::map<uint64_t, uint32_t>& replica_nums) {
+  const auto& definition = region.definition();
+  bool is_index = definition.index_id() > 0;
+  uint64_t id = is_index ? definition.index_id() : definition.table_id();
+  if (id == 0) {
+    return 0;
+  }
+
+  auto it = replica_nums.find(id);
+  if (it != replica_nums.end()) {
+    return it->second;
+  }
+
+  pb::coordinator_internal::TableInternal table_internal;
+  int ret = is_index ? index_map_.Get(id, table_internal) : table_map_.Get(id, table_internal);
+  uint32_t replica_num = 0;
+  if (ret > 0) {
+    replica_num = table_internal.definition().replica() < 1 ? 3 : table_internal.definition().replica();
+  }
+  replica_nums[id] = replica_num;
+
+  return replica_num;
+}
+
+// Remove the extra peer of regions which have more peers than the replica num, it is the second step of a region
+// move. The pending moves in balance_region_move_map_ are only kept in the memory of the coordinator leader, so the
+// regions are found from the peers of the region, and a move interrupted by a leader change is finished as well.
+uint32_t CoordinatorControl::FinishBalanceRegionMove(const std::map<uint64_t, StoreLoad>& store_loads,
+                                                     std::set<uint64_t>& scheduled_region_ids,
+                                                     pb::coordinator_internal::MetaIncrement& meta_increment) {
+  std::map<uint64_t, std::pair<uint64_t, uint64_t>> region_moves;
+  {
+    BAIDU_SCOPED_LOCK(balance_region_move_map_mutex_);
+    region_moves = balance_region_move_map_;
+  }
+
+  // drop the moves whose region is deleted or source peer is gone
+  for (const auto& [region_id, move] : region_moves) {
+    pb::coordinator_internal::RegionInternal region;
+    bool has_source = false;
+    if (region_map_.Get(region_id, region) > 0) {
+      for (const auto& peer : region.definition().peers()) {
+        has_source = has_source || peer.store_id() == move.first;
+      }
+    }
+    if (!has_source) {
+      BAIDU_SCOPED_LOCK(balance_region_move_map_mutex_);
+      balance_region_move_map_.erase(region_id);
+    }
+  }
+
+  std::map<uint64_t, uint32_t> replica_nums;
+  uint32_t op_count = 0;
+  for (const auto& [leader_store_id, store_load] : store_loads) {
+    for (const auto& [region_id, region_load] : store_load.regions) {
+      if (!region_load.is_leader || scheduled_region_ids.count(region_id) > 0) {
+        continue;
+      }
+
+      pb::coordinator_internal::RegionInternal region;
+      if (region_map_.Get(region_id, region) <= 0) {
+        continue;
+      }
+
+      // wait add peer finished
+      uint32_t replica_num = GetRegionReplicaNum(region, replica_nums);
+      if (replica_num == 0 || region.definition().peers_size() <= replica_num ||
+          region.state() != pb::common::RegionState::REGION_NORMAL) {
+        continue;
+      }
+
+      auto status = ValidateTaskListConflict(region_id, region_id);
+      if (!status.ok()) {
+        continue;
+      }
+
+      uint64_t source_store_id = 0;
+      uint64_t target_store_id = 0;
+      auto move_it = region_moves.find(region_id);
+      if (move_it != region_moves.end()) {
+        std::tie(source_store_id, target_store_id) = move_it->second;
+      }
+
+      std::vector<uint64_t> peer_store_ids;
+      for (const auto& peer : region.definition().peers()) {
+        peer_store_ids.push_back(peer.store_id());
+      }
+
+      scheduled_region_ids.insert(region_id);
+      if (source_store_id == leader_store_id &&
+          std::find(peer_store_ids.begin(), peer_store_ids.end(), target_store_id) != peer_store_ids.end()) {
+        // can not remove leader peer, transfer leader to target first, and remove source peer in next round
+        status = TransferLeaderRegionWithTaskList(region_id, target_store_id, meta_increment);
+        DINGO_LOG(INFO) << fmt::format("[balance.region] move region({}) transfer leader from store({}) to store({}) {}",
+                                       region_id, source_store_id, target_store_id, status.error_str());
+        continue;
+      }
+
+      uint64_t remove_store_id = SelectTrimPeerStore(peer_store_ids, leader_store_id, source_store_id, store_loads);
+      if (remove_store_id == 0) {
+        continue;
+      }
+
+      std::vector<uint64_t> new_store_ids;
+      for (auto store_id : peer_store_ids) {
+        if (store_id != remove_store_id) {
+          new_store_ids.push_back(store_id);
+        }
+      }
+
+      status = ChangePeerRegionWithTaskList(region_id, new_store_ids, meta_increment);
+      DINGO_LOG(INFO) << fmt::format("[balance.region] region({}) peers({}) > replica({}), remove peer on store({}) {}",
+                                     region_id, peer_store_ids.size(), replica_num, remove_store_id,
+                                     status.error_str());
+      if (!status.ok()) {
+        continue;
+      }
+
+      // the move is done only after the source peer is removed
+      if (move_it != region_moves.end()) {
+        BAIDU_SCOPED_LOCK(balance_region_move_map_mutex_);
+        balance_region_move_map_.erase(region_id);
+      }
+      ++op_count;
+    }
+  }
+
+  return op_count;
+}
+
+}  // namespace dingodb
@@ -19,7 +19,9 @@
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -127,14 +129,10 @@ void CoordinatorControl::GetStoreMap(pb::common::StoreMap& store_map) {
 
   {
     // BAIDU_SCOPED_LOCK(store_map_mutex_);
-    butil::FlatMap<uint64_t, pb::common::Store> store_map_copy;
-    store_map_copy.init(100);
-    store_map_.GetRawMapCopy(store_map_copy);
-
-    for (auto& element : store_map_copy) {
-      auto* tmp_region = store_map.add_stores();
-      *tmp_region = element.second;
-    }
+    store_map_.Traverse([&store_map](uint64_t /*store_id*/, const pb::common::Store& store) {
+      *store_map.add_stores() = store;
+      return true;
+    });
   }
 }
 
@@ -206,25 +204,59 @@ void CoordinatorControl::DeleteStoreMetrics(uint64_t store_id) {
       coordinator_bvar_metrics_store_.DeleteStoreBvar(it.first);
     }
     store_metrics_map_.clear();
+    store_region_metrics_version_map_.clear();
   } else {
     store_metrics_map_.erase(store_id);
+    store_region_metrics_version_map_.erase(store_id);
     coordinator_bvar_metrics_store_.DeleteStoreBvar(store_id);
   }
 }
 
+bool CoordinatorControl::NeedFullRegionMetrics(uint64_t store_id) {
+  BAIDU_SCOPED_LOCK(store_metrics_map_mutex_);
+  return store_region_metrics_version_map_.seek(store_id) == nullptr;
+}
+
+bool CoordinatorControl::IsRegionAliveByDeltaHeartbeat(const pb::common::RegionMetrics& region_metrics) {
+  auto leader_store_id = region_metrics.leader_store_id();
+  if (leader_store_id == 0) {
+    return false;
+  }
+
+  {
+    BAIDU_SCOPED_LOCK(store_metrics_map_mutex_);
+    if (store_region_metrics_version_map_.seek(leader_store_id) == nullptr) {
+      return false;
+    }
+
+    auto* store_metrics = store_metrics_map_.seek(leader_store_id);
+    if (store_metrics == nullptr ||
+        store_metrics->region_metrics_map().find(region_metrics.id()) == store_metrics->region_metrics_map().end()) {
+      return false;
+    }
+  }
+
+  pb::common::Store store;
+  if (store_map_.Get(leader_store_id, store) < 0) {
+    return false;
+  }
+
+  return store.state() == pb::common::StoreState::STORE_NORMAL &&
+         store.last_seen_timestamp() + (FLAGS_region_heartbeat_timeout * 1000) >= butil::gettimeofday_ms();
+}
+
 void CoordinatorControl::GetRegionMetrics(uint64_t region_id,
                                           std::vector<pb::common::RegionMetrics>& region_metrics_array) {
   if (region_id == 0) {
-    butil::FlatMap<uint64_t, pb::common::RegionMetrics> region_metrics_map_copy;
-    auto ret = region_metrics_map_.GetRawMapCopy(region_metrics_map_copy);
+    auto ret = region_metrics_map_.Traverse([&region_metrics_array](uint64_t /*region_id*/,
+                                                                    const pb::common::RegionMetrics& region_metrics) {
+      region_metrics_array.push_back(region_metrics);
+      return true;
+    });
     if (ret < 0) {
-      DINGO_LOG(INFO) << "GetRegionMetrics region_metrics_map_.GetRawMapCopy failed";
+      DINGO_LOG(INFO) << "GetRegionMetrics region_metrics_map_.Traverse failed";
       return;
     }
-
-    for (const auto& region_metrics : region_metrics_map_copy) {
-      region_metrics_array.push_back(region_metrics.second);
-    }
   } else {
     pb::common::RegionMetrics region_metrics;
     auto ret = region_metrics_map_.Get(region_id, region_metrics);
@@ -646,25 +678,31 @@ void CoordinatorControl::UpdateRegionState() {
   // update region_state by last_update_timestamp
   pb::coordinator_internal::MetaIncrement meta_increment;
 
-  butil::FlatMap<uint64_t, pb::coordinator_internal::RegionInternal> region_map_temp;
-  auto ret = region_map_.GetRawMapCopy(region_map_temp);
+  // only region state is needed, the state change below submits meta increment, so not run in Traverse
+  std::vector<std::pair<uint64_t, pb::common::RegionState>> region_states;
+  region_states.reserve(region_map_.Size());
+  auto ret = region_map_.Traverse(
+      [&region_states](uint64_t region_id, const pb::coordinator_internal::RegionInternal& region_internal) {
+        region_states.emplace_back(region_id, region_internal.state());
+        return true;
+      });
   if (ret < 0) {
-    DINGO_LOG(ERROR) << "UpdateRegionState... GetRawMapCopy failed";
+    DINGO_LOG(ERROR) << "UpdateRegionState... Traverse failed";
     return;
   }
 
-  for (const auto& it : region_map_temp) {
+  for (const auto& it : region_states) {
     pb::common::RegionMetrics region_metrics;
     auto ret = region_metrics_map_.Get(it.first, region_metrics);
     if (ret < 0) {
-      if (it.second.state() != pb::common::RegionState::REGION_NEW) {
+      if (it.second != pb::common::RegionState::REGION_NEW) {
         DINGO_LOG(WARNING) << "UpdateRegionState... Get region_metrics failed, region_id=" << it.first;
       }
       continue;
     }
 
     DINGO_LOG(DEBUG) << "CoordinatorUpdateState... region " << it.first << " state "
-                     << pb::common::RegionState_Name(it.second.state()) << " last_update_timestamp "
+                     << pb::common::RegionState_Name(it.second) << " last_update_timestamp "
                      << region_metrics.region_status().last_update_timestamp() << " now " << butil::gettimeofday_ms();
 
     if (region_metrics.region_status().last_update_timestamp() + (FLAGS_region_heartbeat_timeout * 1000) >=
@@ -676,13 +714,17 @@ void CoordinatorControl::UpdateRegionState() {
       continue;
     }
 
-    if (it.second.state() != pb::common::RegionState::REGION_NEW &&
-        it.second.state() != pb::common::RegionState::REGION_DELETE &&
-        it.second.state() != pb::common::RegionState::REGION_DELETING &&
-        it.second.state() != pb::common::RegionState::REGION_DELETED) {
+    // delta heartbeat does not carry unchanged region, the region is alive as long as its leader store is alive and
+    // its delta heartbeat is in sync
+    if (IsRegionAliveByDeltaHeartbeat(region_metrics)) {
+      continue;
+    }
+
+    if (it.second != pb::common::RegionState::REGION_NEW && it.second != pb::common::RegionState::REGION_DELETE &&
+        it.second != pb::common::RegionState::REGION_DELETING && it.second != pb::common::RegionState::REGION_DELETED) {
       DINGO_LOG(INFO) << "CoordinatorUpdateState... update region " << it.first << " state to offline";
       TrySetRegionToDown(it.first);
-    } else if (it.second.state() == pb::common::RegionState::REGION_DELETED &&
+    } else if (it.second == pb::common::RegionState::REGION_DELETED &&
                region_metrics.region_status().last_update_timestamp() +
                        (FLAGS_region_delete_after_deleted_time * 1000) <
                    butil::gettimeofday_ms()) {
@@ -770,17 +812,11 @@ void CoordinatorControl::GetRegionMap(pb::common::RegionMap& region_map) {
   region_map.set_epoch(GetPresentId(pb::coordinator_internal::IdEpochType::EPOCH_REGION));
   {
     // BAIDU_SCOPED_LOCK(region_map_mutex_);
-    butil::FlatMap<uint64_t, pb::coordinator_internal::RegionInternal> region_internal_map_copy;
-    region_internal_map_copy.init(30000);
-    region_map_.GetRawMapCopy(region_internal_map_copy);
-    butil::FlatMap<uint64_t, pb::common::RegionMetrics> region_metrics_map_copy;
-    region_metrics_map_copy.init(30000);
-    region_metrics_map_.GetRawMapCopy(region_metrics_map_copy);
-
-    for (auto& element : region_internal_map_copy) {
-      auto* tmp_region = region_map.add_regions();
-      GenRegionSlim(element.second, *tmp_region);
-    }
+    region_map_.Traverse(
+        [this, &region_map](uint64_t /*region_id*/, const pb::coordinator_internal::RegionInternal& region_internal) {
+          GenRegionSlim(region_internal, *region_map.add_regions());
+          return true;
+        });
   }
 }
 
@@ -788,26 +824,21 @@ void CoordinatorControl::GetRegionMapFull(pb::common::RegionMap& region_map) {
   region_map.set_epoch(GetPresentId(pb::coordinator_internal::IdEpochType::EPOCH_REGION));
   {
     // BAIDU_SCOPED_LOCK(region_map_mutex_);
-    butil::FlatMap<uint64_t, pb::coordinator_internal::RegionInternal> region_internal_map_copy;
-    region_internal_map_copy.init(30000);
-    region_map_.GetRawMapCopy(region_internal_map_copy);
-
-    for (auto& element : region_internal_map_copy) {
-      auto* tmp_region = region_map.add_regions();
-      GenRegionFull(element.second, *tmp_region);
-    }
+    region_map_.Traverse(
+        [this, &region_map](uint64_t /*region_id*/, const pb::coordinator_internal::RegionInternal& region_internal) {
+          GenRegionFull(region_internal, *region_map.add_regions());
+          return true;
+        });
   }
 }
 
 void CoordinatorControl::GetDeletedRegionMap(pb::common::RegionMap& region_map) {
   // BAIDU_SCOPED_LOCK(region_map_mutex_);
-  butil::FlatMap<uint64_t, pb::coordinator_internal::RegionInternal> region_internal_map_copy;
-  region_internal_map_copy.init(30000);
-  deleted_region_map_.GetRawMapCopy(region_internal_map_copy);
-  for (auto& element : region_internal_map_copy) {
-    auto* tmp_region = region_map.add_regions();
-    GenRegionFull(element.second, *tmp_region);
-  }
+  deleted_region_map_.Traverse(
+      [this, &region_map](uint64_t /*region_id*/, const pb::coordinator_internal::RegionInternal& region_internal) {
+        GenRegionFull(region_internal, *region_map.add_regions());
+        return true;
+      });
 }
 
 butil::Status CoordinatorControl::AddDeletedRegionMap(uint64_t region_id, bool force) {
@@ -838,23 +869,21 @@ butil::Status CoordinatorControl::AddDeletedRegionMap(uint64_t region_id, bool f
 
 butil::Status CoordinatorControl::CleanDeletedRegionMap(uint64_t region_id) {
   if (region_id == 0) {
-    butil::FlatMap<uint64_t, pb::coordinator_internal::RegionInternal> deleted_regions;
-    deleted_regions.init(30000);
-    auto ret = deleted_region_map_.GetRawMapCopy(deleted_regions);
-    if (ret < 0) {
-      DINGO_LOG(WARNING) << "CleanDeletedRegionMap failed, region_id: " << region_id
-                         << " not exists in deleted_region_map_";
-    }
-
     pb::coordinator_internal::MetaIncrement meta_increment;
 
-    for (const auto& element : deleted_regions) {
-      auto* deleted_region_increment = meta_increment.add_deleted_regions();
-      deleted_region_increment->set_id(element.second.id());
-      deleted_region_increment->set_op_type(::dingodb::pb::coordinator_internal::MetaIncrementOpType::DELETE);
+    auto ret = deleted_region_map_.Traverse(
+        [&meta_increment](uint64_t /*region_id*/, const pb::coordinator_internal::RegionInternal& region_internal) {
+          auto* deleted_region_increment = meta_increment.add_deleted_regions();
+          deleted_region_increment->set_id(region_internal.id());
+          deleted_region_increment->set_op_type(::dingodb::pb::coordinator_internal::MetaIncrementOpType::DELETE);
 
-      auto* deleted_region_increment_region = deleted_region_increment->mutable_region();
-      deleted_region_increment_region->set_id(element.second.id());
+          auto* deleted_region_increment_region = deleted_region_increment->mutable_region();
+          deleted_region_increment_region->set_id(region_internal.id());
+          return true;
+        });
+    if (ret < 0) {
+      DINGO_LOG(WARNING) << "CleanDeletedRegionMap failed, region_id: " << region_id
+                         << " not exists in deleted_region_map_";
     }
 
     SubmitMetaIncrementSync(meta_increment);
@@ -891,46 +920,42 @@ void CoordinatorControl::GetRegionIdsInMap(std::vector<uint64_t>& region_ids) {
 void CoordinatorControl::RecycleDeletedTableAndIndex() {
   DINGO_LOG(INFO) << "Start to RecycleOrphanRegionOnStore, timestamp=" << butil::gettimeofday_ms();
 
-  butil::FlatMap<uint64_t, pb::coordinator_internal::TableInternal> delete_tables;
-  butil::FlatMap<uint64_t, pb::coordinator_internal::TableInternal> delete_indexes;
-
-  delete_tables.init(3000);
-  delete_indexes.init(3000);
-
-  deleted_table_map_.GetRawMapCopy(delete_tables);
-  deleted_index_map_.GetRawMapCopy(delete_indexes);
-
   pb::coordinator_internal::MetaIncrement meta_increment;
 
-  for (const auto& table : delete_tables) {
-    if (table.second.definition().delete_timestamp() + (FLAGS_table_delete_after_deleted_time * 1000) <
-        butil::gettimeofday_ms()) {
-      DINGO_LOG(INFO) << "RecycleDeletedTableAndIndex delete obsolete deleted_table table_id:" << table.first
-                      << " deleted_timestamp: " << table.second.definition().delete_timestamp()
-                      << " table_delete_after_deleted_time: " << FLAGS_table_delete_after_deleted_time;
-
-      auto* deleted_table_increment = meta_increment.add_deleted_tables();
-      deleted_table_increment->set_id(table.second.id());
-      deleted_table_increment->set_op_type(::dingodb::pb::coordinator_internal::MetaIncrementOpType::DELETE);
-      auto* deleted_table = deleted_table_increment->mutable_table();
-      deleted_table->set_id(table.second.id());
-    }
-  }
-
-  for (const auto& index : delete_indexes) {
-    if (index.second.definition().delete_timestamp() + (FLAGS_index_delete_after_deleted_time * 1000) <
-        butil::gettimeofday_ms()) {
-      DINGO_LOG(INFO) << "RecycleDeletedTableAndIndex delete obsolete deleted_index index_id:" << index.first
-                      << " deleted_timestamp: " << index.second.definition().delete_timestamp()
-                      << " index_delete_after_deleted_time: " << FLAGS_index_delete_after_deleted_time;
-
-      auto* deleted_index_increment = meta_increment.add_deleted_indexes();
-      deleted_index_increment->set_id(index.second.id());
-      deleted_index_increment->set_op_type(::dingodb::pb::coordinator_internal::MetaIncrementOpType::DELETE);
-      auto* deleted_index = deleted_index_increment->mutable_table();
-      deleted_index->set_id(index.second.id());
-    }
-  }
+  auto now_ms = butil::gettimeofday_ms();
+  deleted_table_map_.TraverseFilter(
+      [now_ms](uint64_t /*table_id*/, const pb::coordinator_internal::TableInternal& table) {
+        return table.definition().delete_timestamp() + (FLAGS_table_delete_after_deleted_time * 1000) < now_ms;
+      },
+      [&meta_increment](uint64_t table_id, const pb::coordinator_internal::TableInternal& table) {
+        DINGO_LOG(INFO) << "RecycleDeletedTableAndIndex delete obsolete deleted_table table_id:" << table_id
+                        << " deleted_timestamp: " << table.definition().delete_timestamp()
+                        << " table_delete_after_deleted_time: " << FLAGS_table_delete_after_deleted_time;
+
+        auto* deleted_table_increment = meta_increment.add_deleted_tables();
+        deleted_table_increment->set_id(table.id());
+        deleted_table_increment->set_op_type(::dingodb::pb::coordinator_internal::MetaIncrementOpType::DELETE);
+        auto* deleted_table = deleted_table_increment->mutable_table();
+        deleted_table->set_id(table.id());
+        return true;
+      });
+
+  deleted_index_map_.TraverseFilter(
+      [now_ms](uint64_t /*index_id*/, const pb::coordinator_internal::TableInternal& index) {
+        return index.definition().delete_timestamp() + (FLAGS_index_delete_after_deleted_time * 1000) < now_ms;
+      },
+      [&meta_increment](uint64_t index_id, const pb::coordinator_internal::TableInternal& index) {
+        DINGO_LOG(INFO) << "RecycleDeletedTableAndIndex delete obsolete deleted_index index_id:" << index_id
+                        << " deleted_timestamp: " << index.definition().delete_timestamp()
+                        << " index_delete_after_deleted_time: " << FLAGS_index_delete_after_deleted_time;
+
+        auto* deleted_index_increment = meta_increment.add_deleted_indexes();
+        deleted_index_increment->set_id(index.id());
+        deleted_index_increment->set_op_type(::dingodb::pb::coordinator_internal::MetaIncrementOpType::DELETE);
+        auto* deleted_index = deleted_index_increment->mutable_table();
+        deleted_index->set_id(index.id());
+        return true;
+      });
 
   if (meta_increment.ByteSizeLong() > 0) {
     SubmitMetaIncrementSync(meta_increment);
@@ -940,9 +965,13 @@ void CoordinatorControl::RecycleDeletedTableAndIndex() {
 void CoordinatorControl::RecycleOrphanRegionOnStore() {
   DINGO_LOG(INFO) << "Start to RecycleOrphanRegionOnStore, timestamp=" << butil::gettimeofday_ms();
 
-  butil::FlatMap<uint64_t, pb::coordinator_internal::RegionInternal> delete_regions;
-  delete_regions.init(3000);
-  deleted_region_map_.GetRawMapCopy(delete_regions);
+  // region_id -> deleted_timestamp, only the deleted timestamp is needed
+  std::map<uint64_t, uint64_t> delete_regions;
+  deleted_region_map_.Traverse(
+      [&delete_regions](uint64_t region_id, const pb::coordinator_internal::RegionInternal& region_internal) {
+        delete_regions.emplace(region_id, region_internal.deleted_timestamp());
+        return true;
+      });
 
   if (delete_regions.empty()) {
     DINGO_LOG(DEBUG) << "No region to recycle";
@@ -974,7 +1003,7 @@ void CoordinatorControl::RecycleOrphanRegionOnStore() {
 
     for (const auto& region_id : ids.second) {
       // if region_id is in delete_region_map, need to delete region on this store
-      if (delete_regions.seek(region_id) != nullptr) {
+      if (delete_regions.find(region_id) != delete_regions.end()) {
         if (!is_store_operation_get) {
           store_operation_map_.Get(ids.first, store_operation);
           is_store_operation_get = true;
@@ -1015,22 +1044,21 @@ void CoordinatorControl::RecycleOrphanRegionOnStore() {
   }
 
   // delete too old delete_region
-  for (const auto& region : delete_regions) {
-    DINGO_LOG(DEBUG) << "RecycleOrphanRegionOnStore meet obsolete deleted_region region_id:" << region.first
-                     << " deleted_timestamp: " << region.second.deleted_timestamp()
+  for (const auto& [region_id, deleted_timestamp] : delete_regions) {
+    DINGO_LOG(DEBUG) << "RecycleOrphanRegionOnStore meet obsolete deleted_region region_id:" << region_id
+                     << " deleted_timestamp: " << deleted_timestamp
                      << " region_delete_after_deleted_time: " << FLAGS_region_delete_after_deleted_time;
 
-    if (region.second.deleted_timestamp() + (FLAGS_region_delete_after_deleted_time * 1000) <
-        butil::gettimeofday_ms()) {
-      DINGO_LOG(INFO) << "RecycleOrphanRegionOnStore delete obsolete deleted_region region_id:" << region.first
-                      << " deleted_timestamp: " << region.second.deleted_timestamp()
+    if (deleted_timestamp + (FLAGS_region_delete_after_deleted_time * 1000) < butil::gettimeofday_ms()) {
+      DINGO_LOG(INFO) << "RecycleOrphanRegionOnStore delete obsolete deleted_region region_id:" << region_id
+                      << " deleted_timestamp: " << deleted_timestamp
                       << " region_delete_after_deleted_time: " << FLAGS_region_delete_after_deleted_time;
 
       auto* deleted_region_increment = meta_increment.add_deleted_regions();
-      deleted_region_increment->set_id(region.second.id());
+      deleted_region_increment->set_id(region_id);
       deleted_region_increment->set_op_type(::dingodb::pb::coordinator_internal::MetaIncrementOpType::DELETE);
       auto* deleted_region = deleted_region_increment->mutable_region();
-      deleted_region->set_id(region.second.id());
+      deleted_region->set_id(region_id);
     }
   }
 
@@ -1042,50 +1070,47 @@ void CoordinatorControl::RecycleOrphanRegionOnStore() {
 void CoordinatorControl::RecycleOrphanRegionOnCoordinator() {
   DINGO_LOG(INFO) << "Start to RecycleOrphanRegionOnStore, timestamp=" << butil::gettimeofday_ms();
 
-  butil::FlatMap<uint64_t, pb::coordinator_internal::RegionInternal> regions;
-  regions.init(3000);
-  region_map_.GetRawMapCopy(regions);
-
-  if (regions.empty()) {
+  if (region_map_.Size() == 0) {
     DINGO_LOG(DEBUG) << "No region to recycle";
     return;
   }
 
-  std::vector<uint64_t> delete_region_ids;
-  for (const auto& it : regions) {
-    const auto& region = it.second;
-    if (region.definition().table_id() > 0) {
-      bool exists = true;
-      auto ret = deleted_table_map_.SafeExists(region.definition().table_id(), exists);
-      if (ret < 0) {
-        DINGO_LOG(WARNING) << "RecycleOrphanRegionOnCoordinator failed, table_id: " << region.definition().table_id()
-                           << " not exists in table_map_";
-        continue;
-      }
-
-      if (exists) {
-        DINGO_LOG(INFO) << "RecycleOrphanRegionOnCoordinator region_id: " << region.id()
-                        << " table_id: " << region.definition().table_id() << " is deleted";
-        delete_region_ids.push_back(region.id());
-      }
-    } else if (region.definition().index_id() > 0) {
-      bool exists;
-      auto ret = deleted_index_map_.SafeExists(region.definition().index_id(), exists);
-      if (ret < 0) {
-        DINGO_LOG(WARNING) << "RecycleOrphanRegionOnCoordinator failed, index_id: " << region.definition().index_id()
-                           << " not exists in index_map_";
+  // the deleted tables and indexes are much less than regions, find their regions by meta_index_
+  // only collect the ids under the read lock of the safe maps, meta_index_ and region_map_ are looked up after it
+  std::vector<uint64_t> deleted_table_ids;
+  deleted_table_map_.Traverse(
+      [&deleted_table_ids](uint64_t table_id, const pb::coordinator_internal::TableInternal& /*table*/) {
+        deleted_table_ids.push_back(table_id);
+        return true;
+      });
+
+  std::vector<uint64_t> deleted_index_ids;
+  deleted_index_map_.Traverse(
+      [&deleted_index_ids](uint64_t index_id, const pb::coordinator_internal::TableInternal& /*index*/) {
+        deleted_index_ids.push_back(index_id);
+        return true;
+      });
+
+  std::set<uint64_t> delete_region_ids;
+  for (auto table_id : deleted_table_ids) {
+    for (auto region_id : meta_index_.GetRegionIdsByTable(table_id)) {
+      DINGO_LOG(INFO) << "RecycleOrphanRegionOnCoordinator region_id: " << region_id << " table_id: " << table_id
+                      << " is deleted";
+      delete_region_ids.insert(region_id);
+    }
+  }
+
+  for (auto index_id : deleted_index_ids) {
+    for (auto region_id : meta_index_.GetRegionIdsByIndex(index_id)) {
+      // the region of table is only recycled with its table
+      pb::coordinator_internal::RegionInternal region;
+      if (region_map_.Get(region_id, region) < 0 || region.definition().table_id() > 0) {
         continue;
       }
 
-      if (exists) {
-        DINGO_LOG(INFO) << "RecycleOrphanRegionOnCoordinator region_id: " << region.id()
-                        << " index_id: " << region.definition().index_id() << " is deleted";
-        delete_region_ids.push_back(region.id());
-      }
-    } else {
-      DINGO_LOG(INFO) << "RecycleOrphanRegionOnCoordinator region_id: " << region.id()
-                      << " table_id: " << region.definition().table_id()
-                      << " index_id: " << region.definition().index_id() << " is not table or index";
+      DINGO_LOG(INFO) << "RecycleOrphanRegionOnCoordinator region_id: " << region_id << " index_id: " << index_id
+                      << " is deleted";
+      delete_region_ids.insert(region_id);
     }
   }
 
@@ -1271,18 +1296,13 @@ butil::Status CoordinatorControl::SelectStore(pb::common::StoreType store_type,
       }
     }
   } else {
-    for (const auto& element : store_map_copy) {
-      const auto& store = element.second;
-      if (store.state() != pb::common::StoreState::STORE_NORMAL) {
+    for (const auto& store_id : store_ids) {
+      auto* store = store_map_copy.seek(store_id);
+      if (store == nullptr || store->state() != pb::common::StoreState::STORE_NORMAL) {
         continue;
       }
 
-      for (const auto& store_id : store_ids) {
-        if (store.id() == store_id) {
-          stores_for_regions.push_back(store);
-          break;
-        }
-      }
+      stores_for_regions.push_back(*store);
     }
   }
 
@@ -1444,6 +1464,9 @@ butil::Status CoordinatorControl::SelectStore(pb::common::StoreType store_type,
   for (const auto& it : stores_for_regions) {
     StoreMore store_more;
     store_more.store = it;
+    // regions placed on this store by coordinator, used if the heartbeat of store has not carried region metrics,
+    // e.g. the store is just restarted, so the store is not taken as empty
+    store_more.region_num = meta_index_.GetRegionCountByStore(it.id());
 
     bool has_metrics = false;
     pb::common::StoreOwnMetrics store_own_metrics;
@@ -1452,7 +1475,9 @@ butil::Status CoordinatorControl::SelectStore(pb::common::StoreType store_type,
       BAIDU_SCOPED_LOCK(store_metrics_map_mutex_);
       auto* ptr = store_metrics_map_.seek(it.id());
       if (ptr != nullptr) {
-        store_more.region_num = ptr->region_metrics_map_size() > 0 ? ptr->region_metrics_map_size() : 0;
+        if (ptr->region_metrics_map_size() > 0) {
+          store_more.region_num = ptr->region_metrics_map_size();
+        }
         store_own_metrics = ptr->store_own_metrics();
       }
     }
@@ -2705,66 +2730,31 @@ butil::Status CoordinatorControl::TransferLeaderRegionWithTaskList(
 
 butil::Status CoordinatorControl::ValidateTaskListConflict(uint64_t region_id, uint64_t second_region_id) {
   // check task_list conflict
-  butil::FlatMap<uint64_t, pb::coordinator::TaskList> task_list_map_temp;
-  task_list_map_temp.init(1000);
-  int ret = task_list_map_.GetRawMapCopy(task_list_map_temp);
-  if (ret < 0) {
-    DINGO_LOG(ERROR) << "ValidateTaskListConflict task_list_map_.GetRawMapCopy "
-                        "failed, region_id = "
-                     << region_id;
-    return butil::Status(pb::error::Errno::EINTERNAL, "ValidateTaskListConflict task_list_map_.GetRawMapCopy failed");
-  }
-
-  for (const auto& task_list : task_list_map_temp) {
-    for (const auto& task : task_list.second.tasks()) {
-      for (const auto& store_operation : task.store_operations()) {
-        for (const auto& region_cmd : store_operation.region_cmds()) {
-          if (region_cmd.region_id() == region_id || region_cmd.region_id() == second_region_id) {
-            DINGO_LOG(ERROR) << "ValidateTaskListConflict task_list "
-                                "conflict, region_id = "
-                             << region_id;
-            return butil::Status(pb::error::Errno::ETASK_LIST_CONFLICT,
-                                 "ValidateTaskListConflict task_list "
-                                 "conflict, region_id = " +
-                                     std::to_string(region_id));
-          }
-        }
-      }
-    }
-  }
+  bool is_conflict = !meta_index_.GetTaskListIdsByRegion(region_id).empty() ||
+                     !meta_index_.GetTaskListIdsByRegion(second_region_id).empty();
 
-  // check store operation conflict
-  butil::FlatMap<uint64_t, pb::coordinator_internal::StoreOperationInternal> store_operation_map_temp;
-  store_operation_map_temp.init(1000);
-  ret = store_operation_map_.GetRawMapCopy(store_operation_map_temp);
-  if (ret < 0) {
-    DINGO_LOG(ERROR) << "ValidateTaskListConflict store_operation_map_.GetRawMapCopy "
-                        "failed, region_id = "
+  if (is_conflict) {
+    DINGO_LOG(ERROR) << "ValidateTaskListConflict task_list "
+                        "conflict, region_id = "
                      << region_id;
-    return butil::Status(pb::error::Errno::EINTERNAL,
-                         "ValidateTaskListConflict store_operation_map_.GetRawMapCopy "
-                         "failed, region_id = " +
+    return butil::Status(pb::error::Errno::ETASK_LIST_CONFLICT,
+                         "ValidateTaskListConflict task_list "
+                         "conflict, region_id = " +
                              std::to_string(region_id));
   }
 
-  for (const auto& store_operation : store_operation_map_temp) {
-    for (auto region_cmd_id : store_operation.second.region_cmd_ids()) {
-      pb::coordinator_internal::RegionCmdInternal region_cmd;
-      auto ret = region_cmd_map_.Get(region_cmd_id, region_cmd);
-      if (ret < 0) {
-        continue;
-      }
+  // check store operation conflict
+  is_conflict = !meta_index_.GetStoreOperationIdsByRegion(region_id).empty() ||
+                !meta_index_.GetStoreOperationIdsByRegion(second_region_id).empty();
 
-      if (region_cmd.region_cmd().region_id() == region_id || region_cmd.region_cmd().region_id() == second_region_id) {
-        DINGO_LOG(ERROR) << "ValidateTaskListConflict store_operation "
-                            "conflict, region_id = "
-                         << region_id;
-        return butil::Status(pb::error::Errno::ESTORE_OPERATION_CONFLICT,
-                             "ValidateTaskListConflict store_operation "
-                             "conflict, region_id = " +
-                                 std::to_string(region_id));
-      }
-    }
+  if (is_conflict) {
+    DINGO_LOG(ERROR) << "ValidateTaskListConflict store_operation "
+                        "conflict, region_id = "
+                     << region_id;
+    return butil::Status(pb::error::Errno::ESTORE_OPERATION_CONFLICT,
+                         "ValidateTaskListConflict store_operation "
+                         "conflict, region_id = " +
+                             std::to_string(region_id));
   }
 
   return butil::Status::OK();
@@ -3769,8 +3759,38 @@ uint64_t CoordinatorControl::UpdateStoreMetrics(const pb::common::StoreMetrics&
           ptr->mutable_region_metrics_map()->insert({region_metrics.first, region_metrics.second});
         }
       }
+    } else if (store_metrics.is_delta_region_metrics()) {
+      // delta heartbeat must follow the last merged version, otherwise wait for a full heartbeat
+      auto* version_ptr = store_region_metrics_version_map_.seek(store_metrics.id());
+      if (version_ptr != nullptr && *version_ptr + 1 == store_metrics.region_metrics_version()) {
+        *version_ptr = store_metrics.region_metrics_version();
+      } else {
+        DINGO_LOG(WARNING) << "UpdateStoreMetrics delta heartbeat version not continuous, store_id="
+                           << store_metrics.id() << " version=" << store_metrics.region_metrics_version()
+                           << " last_version=" << (version_ptr == nullptr ? 0 : *version_ptr);
+        store_region_metrics_version_map_.erase(store_metrics.id());
+      }
+
+      auto* ptr = store_metrics_map_.seek(store_metrics.id());
+      if (ptr == nullptr) {
+        store_metrics_map_.insert(store_metrics.id(), store_metrics);
+      } else {
+        *(ptr->mutable_store_own_metrics()) = store_metrics.store_own_metrics();
+        auto* mut_region_metrics_map = ptr->mutable_region_metrics_map();
+        for (const auto& region_metrics : store_metrics.region_metrics_map()) {
+          (*mut_region_metrics_map)[region_metrics.first] = region_metrics.second;
+        }
+        for (auto region_id : store_metrics.removed_region_ids()) {
+          mut_region_metrics_map->erase(region_id);
+        }
+      }
     } else {
       store_metrics_map_.insert(store_metrics.id(), store_metrics);
+      if (store_metrics.region_metrics_version() > 0) {
+        store_region_metrics_version_map_.insert(store_metrics.id(), store_metrics.region_metrics_version());
+      } else {
+        store_region_metrics_version_map_.erase(store_metrics.id());
+      }
     }
 
     // if (store_metrics_map_.seek(store_metrics.id()) != nullptr) {
@@ -3976,8 +3996,9 @@ void CoordinatorControl::GetMemoryInfo(pb::coordinator::CoordinatorMemoryInfo& m
     memory_info.set_total_size(memory_info.total_size() + memory_info.kv_index_map_size());
   }
   {
-    memory_info.set_kv_rev_map_count(kv_rev_map_.Size());
-    memory_info.set_kv_rev_map_size(kv_rev_map_.MemorySize());
+    // only the cached revisions are in memory
+    memory_info.set_kv_rev_map_count(kv_rev_storage_->CacheSize());
+    memory_info.set_kv_rev_map_size(kv_rev_storage_->CacheMemorySize());
     memory_info.set_total_size(memory_info.total_size() + memory_info.kv_rev_map_size());
   }
 }
@@ -4559,28 +4580,19 @@ butil::Status CoordinatorControl::ProcessTaskList() {
 
 butil::Status CoordinatorControl::CleanTaskList(uint64_t task_list_id,
                                                 pb::coordinator_internal::MetaIncrement& meta_increment) {
-  butil::FlatMap<uint64_t, pb::coordinator::TaskList> task_list_map;
-  task_list_map.init(100);
-  auto ret = task_list_map_.GetRawMapCopy(task_list_map);
-  if (ret < 0) {
-    DINGO_LOG(ERROR) << "task_list_map_.GetRawMapCopy failed";
-    return butil::Status(pb::error::EINTERNAL, "task_list_map_.GetRawMapCopy failed");
-  }
-
-  if (task_list_map.empty()) {
-    DINGO_LOG(INFO) << "task_list_map is empty";
-    return butil::Status::OK();
-  }
-
-  for (const auto& it : task_list_map) {
-    const auto& task_list = it.second;
-
+  auto ret = task_list_map_.Traverse([&meta_increment, task_list_id](uint64_t /*id*/,
+                                                                     const pb::coordinator::TaskList& task_list) {
     if (task_list_id == 0 || task_list.id() == task_list_id) {
       auto* task_list_increment = meta_increment.add_task_lists();
       task_list_increment->set_id(task_list.id());
       task_list_increment->set_op_type(::dingodb::pb::coordinator_internal::MetaIncrementOpType::DELETE);
       *(task_list_increment->mutable_task_list()) = task_list;
     }
+    return true;
+  });
+  if (ret < 0) {
+    DINGO_LOG(ERROR) << "task_list_map_.Traverse failed";
+    return butil::Status(pb::error::EINTERNAL, "task_list_map_.Traverse failed");
   }
 
   return butil::Status::OK();
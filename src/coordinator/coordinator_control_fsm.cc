@@ -108,6 +108,31 @@ void CoordinatorControl::BuildTempMaps() {
     }
   }
   DINGO_LOG(INFO) << "index_name_map_safe_temp_ finished, count=" << index_name_map_safe_temp_.Size();
+
+  // build meta_index_ from region_map_, task_list_map_, region_cmd_map_ and store_operation_map_
+  {
+    meta_index_.Clear();
+    region_map_.Traverse([this](uint64_t /*region_id*/, const pb::coordinator_internal::RegionInternal& region) {
+      meta_index_.PutRegion(region);
+      return true;
+    });
+    task_list_map_.Traverse([this](uint64_t task_list_id, const pb::coordinator::TaskList& task_list) {
+      meta_index_.PutTaskList(task_list_id, task_list);
+      return true;
+    });
+    region_cmd_map_.Traverse(
+        [this](uint64_t region_cmd_id, const pb::coordinator_internal::RegionCmdInternal& region_cmd) {
+          meta_index_.PutRegionCmd(region_cmd_id, region_cmd.region_cmd().region_id());
+          return true;
+        });
+    store_operation_map_.Traverse(
+        [this](uint64_t /*store_id*/, const pb::coordinator_internal::StoreOperationInternal& store_operation) {
+          meta_index_.PutStoreOperation(store_operation);
+          return true;
+        });
+  }
+  DINGO_LOG(INFO) << "meta_index_ finished, region_count=" << region_map_.Size()
+                  << ", task_list_count=" << task_list_map_.Size();
 }
 
 // OnLeaderStart will init id_epoch_map_temp_ from id_epoch_map_ which is in state machine
@@ -122,6 +147,19 @@ void CoordinatorControl::OnLeaderStart(int64_t term) {
   {
     BAIDU_SCOPED_LOCK(one_time_watch_map_mutex_);
     one_time_watch_map_.clear();
+    one_time_range_watch_map_.clear();
+  }
+
+  // new leader has no delta heartbeat history, all stores need to send full region metrics
+  {
+    BAIDU_SCOPED_LOCK(store_metrics_map_mutex_);
+    store_region_metrics_version_map_.clear();
+  }
+
+  // balance region move is in memory, the new leader start from scratch
+  {
+    BAIDU_SCOPED_LOCK(balance_region_move_map_mutex_);
+    balance_region_move_map_.clear();
   }
 
   DINGO_LOG(INFO) << "OnLeaderStart init lease_to_key_map_temp_ finished, term=" << term
@@ -156,8 +194,17 @@ void CoordinatorControl::OnLeaderStop() {
         }
       }
     }
+    for (auto& it : one_time_range_watch_map_) {
+      for (auto& ctrm : it.second) {
+        auto* done = ctrm.first;
+        if (done) {
+          done->Run();
+        }
+      }
+    }
 
     one_time_watch_map_.clear();
+    one_time_range_watch_map_.clear();
     one_time_watch_closure_map_.clear();
   }
 
@@ -416,7 +463,7 @@ bool CoordinatorControl::LoadMetaToSnapshotFile(std::shared_ptr<Snapshot> snapsh
   kvs.clear();
 
   // 16.version_kv_rev_map_
-  if (!meta_reader_->Scan(snapshot, kv_rev_meta_->Prefix(), kvs)) {
+  if (!meta_reader_->Scan(snapshot, kv_rev_storage_->Prefix(), kvs)) {
     return false;
   }
 
@@ -1010,23 +1057,27 @@ bool CoordinatorControl::LoadMetaFromSnapshotFile(pb::coordinator_internal::Meta
     kvs.push_back(meta_snapshot_file.kv_rev_map_kvs(i));
   }
   {
-    if (!kv_rev_meta_->Recover(kvs)) {
-      return false;
+    kv_rev_storage_->Clear();
+
+    // the events before snapshot are unknown
+    {
+      BAIDU_SCOPED_LOCK(one_time_watch_map_mutex_);
+      watch_event_ring_.Clear();
     }
 
     // remove data in rocksdb
-    if (!meta_writer_->DeletePrefix(kv_rev_meta_->internal_prefix)) {
-      DINGO_LOG(ERROR) << "Coordinator delete kv_rev_meta_ range failed in LoadMetaFromSnapshotFile";
+    if (!meta_writer_->DeletePrefix(kv_rev_storage_->Prefix())) {
+      DINGO_LOG(ERROR) << "Coordinator delete kv_rev_storage_ range failed in LoadMetaFromSnapshotFile";
       return false;
     }
-    DINGO_LOG(INFO) << "Coordinator delete range kv_rev_meta_ success in LoadMetaFromSnapshotFile";
+    DINGO_LOG(INFO) << "Coordinator delete range kv_rev_storage_ success in LoadMetaFromSnapshotFile";
 
     // write data to rocksdb
     if (!meta_writer_->Put(kvs)) {
-      DINGO_LOG(ERROR) << "Coordinator write kv_rev_meta_ failed in LoadMetaFromSnapshotFile";
+      DINGO_LOG(ERROR) << "Coordinator write kv_rev_storage_ failed in LoadMetaFromSnapshotFile";
       return false;
     }
-    DINGO_LOG(INFO) << "Coordinator put kv_rev_meta_ success in LoadMetaFromSnapshotFile";
+    DINGO_LOG(INFO) << "Coordinator put kv_rev_storage_ success in LoadMetaFromSnapshotFile";
   }
   DINGO_LOG(INFO) << "LoadSnapshot version_kv_rev_meta, count=" << kvs.size();
   kvs.clear();
@@ -1428,6 +1479,7 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
         // }
         region_id_to_write.push_back(region.id());
         region_internal_to_write.push_back(region.region());
+        meta_index_.PutRegion(region.region());
 
         // meta_write_kv
         meta_write_to_kv.push_back(region_meta_->TransformToKvValue(region.region()));
@@ -1551,6 +1603,7 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
 
         region_id_to_write.push_back(region.id());
         region_internal_to_write.push_back(region.region());
+        meta_index_.PutRegion(region.region());
 
         // meta_write_kv
         meta_write_to_kv.push_back(region_meta_->TransformToKvValue(region.region()));
@@ -1563,6 +1616,7 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
         } else {
           DINGO_LOG(WARNING) << "ApplyMetaIncrement region DELETE, [id=" << region.id() << "] failed";
         }
+        meta_index_.EraseRegion(region.id());
 
         // meta_delete_kv
         meta_delete_to_kv.push_back(region_meta_->TransformToKvValue(region.region()));
@@ -2008,6 +2062,7 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
                           << ", region_cmd_id=" << region_cmd_id;
         }
         int ret = store_operation_map_.Put(store_operation.id(), store_operation_in_map);
+        meta_index_.PutStoreOperation(store_operation_in_map);
         if (ret > 0) {
           DINGO_LOG(INFO) << "ApplyMetaIncrement store_operation CREATE, [id=" << store_operation.id() << "] success";
         } else {
@@ -2053,6 +2108,7 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
         }
 
         int ret = store_operation_map_.Put(store_operation.id(), store_operation_residual);
+        meta_index_.PutStoreOperation(store_operation_residual);
         if (ret > 0) {
           DINGO_LOG(INFO) << "ApplyMetaIncrement store_operation DELETE, [id=" << store_operation.id() << "] success";
         } else {
@@ -2083,6 +2139,7 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
       if (region_cmd.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE) {
         // region_cmd_map_[region_cmd.id()] = region_cmd.region_cmd();
         int ret = region_cmd_map_.Put(region_cmd.id(), region_cmd.region_cmd());
+        meta_index_.PutRegionCmd(region_cmd.id(), region_cmd.region_cmd().region_cmd().region_id());
         if (ret > 0) {
           DINGO_LOG(INFO) << "ApplyMetaIncrement region_cmd CREATE, [id=" << region_cmd.id() << "] success";
         } else {
@@ -2096,6 +2153,7 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
         // auto& update_table = region_cmd_map_[region_cmd.id()];
         int ret = region_cmd_map_.PutIfExists(region_cmd.id(), region_cmd.region_cmd());
         if (ret > 0) {
+          meta_index_.PutRegionCmd(region_cmd.id(), region_cmd.region_cmd().region_cmd().region_id());
           DINGO_LOG(INFO) << "ApplyMetaIncrement region_cmd UPDATE, [id=" << region_cmd.id() << "] success";
         } else {
           DINGO_LOG(WARNING) << "ApplyMetaIncrement region_cmd UPDATE, [id=" << region_cmd.id() << "] failed";
@@ -2106,6 +2164,7 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
 
       } else if (region_cmd.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
         int ret = region_cmd_map_.Erase(region_cmd.id());
+        meta_index_.EraseRegionCmd(region_cmd.id());
         if (ret > 0) {
           DINGO_LOG(INFO) << "ApplyMetaIncrement region_cmd DELETE, [id=" << region_cmd.id() << "] success";
         } else {
@@ -2172,6 +2231,7 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
       const auto& task_list = meta_increment.task_lists(i);
       if (task_list.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE) {
         int ret = task_list_map_.Put(task_list.id(), task_list.task_list());
+        meta_index_.PutTaskList(task_list.id(), task_list.task_list());
         if (ret > 0) {
           DINGO_LOG(INFO) << "ApplyMetaIncrement task_list CREATE, [id=" << task_list.id() << "] success";
         } else {
@@ -2183,6 +2243,7 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
 
       } else if (task_list.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
         int ret = task_list_map_.Put(task_list.id(), task_list.task_list());
+        meta_index_.PutTaskList(task_list.id(), task_list.task_list());
         if (ret > 0) {
           DINGO_LOG(INFO) << "ApplyMetaIncrement task_list UPDATE, [id=" << task_list.id() << "] success";
         } else {
@@ -2194,6 +2255,7 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
 
       } else if (task_list.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
         int ret = task_list_map_.Erase(task_list.id());
+        meta_index_.EraseTaskList(task_list.id());
         if (ret > 0) {
           DINGO_LOG(INFO) << "ApplyMetaIncrement task_list DELETE, [id=" << task_list.id() << "] success";
         } else {
@@ -2533,42 +2595,14 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
       DINGO_LOG(INFO) << "ApplyMetaIncrement kv_revs size=" << meta_increment.kv_revs_size();
     }
 
-    // BAIDU_SCOPED_LOCK(kv_rev_map_mutex_);
     for (int i = 0; i < meta_increment.kv_revs_size(); i++) {
       const auto& kv_rev = meta_increment.kv_revs(i);
-      if (kv_rev.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE) {
-        // kv_rev_map_[kv_rev.id()] = kv_rev.kv_rev();
-        int ret = kv_rev_map_.PutIfAbsent(kv_rev.id(), kv_rev.kv_rev());
-        if (ret > 0) {
-          DINGO_LOG(INFO) << "ApplyMetaIncrement kv_rev CREATE, [id=" << kv_rev.id() << "] success";
-        } else {
-          DINGO_LOG(WARNING) << "ApplyMetaIncrement kv_rev CREATE, [id=" << kv_rev.id() << "] failed";
-        }
-
-        // meta_write_kv
-        meta_write_to_kv.push_back(kv_rev_meta_->TransformToKvValue(kv_rev.kv_rev()));
-
-      } else if (kv_rev.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
-        int ret = kv_rev_map_.PutIfExists(kv_rev.id(), kv_rev.kv_rev());
-        if (ret > 0) {
-          DINGO_LOG(INFO) << "ApplyMetaIncrement kv_rev UPDATE, [id=" << kv_rev.id() << "] success";
-        } else {
-          DINGO_LOG(WARNING) << "ApplyMetaIncrement kv_rev UPDATE, [id=" << kv_rev.id() << "] failed";
-        }
-
-        // meta_write_kv
-        meta_write_to_kv.push_back(kv_rev_meta_->TransformToKvValue(kv_rev.kv_rev()));
-
+      if (kv_rev.op_type() == pb::coordinator_internal::MetaIncrementOpType::CREATE ||
+          kv_rev.op_type() == pb::coordinator_internal::MetaIncrementOpType::UPDATE) {
+        // the write is persisted with pending write of kv_rev_storage_ at the end
+        kv_rev_storage_->Put(kv_rev.kv_rev());
       } else if (kv_rev.op_type() == pb::coordinator_internal::MetaIncrementOpType::DELETE) {
-        int ret = kv_rev_map_.Erase(kv_rev.id());
-        if (ret > 0) {
-          DINGO_LOG(INFO) << "ApplyMetaIncrement kv_rev DELETE, [id=" << kv_rev.id() << "] success";
-        } else {
-          DINGO_LOG(WARNING) << "ApplyMetaIncrement kv_rev DELETE, [id=" << kv_rev.id() << "] failed";
-        }
-
-        // meta_delete_kv
-        meta_delete_to_kv.push_back(kv_rev_meta_->TransformToKvValue(kv_rev.kv_rev()));
+        kv_rev_storage_->Erase(kv_rev.id());
       }
     }
   }
@@ -2617,6 +2651,9 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
     }
   }
 
+  // kv_rev is written with the raft apply index in one write batch
+  kv_rev_storage_->AppendPendingWrite(meta_write_to_kv, meta_delete_to_kv);
+
   // write update to local engine, begin
   if ((!meta_write_to_kv.empty()) || (!meta_delete_to_kv.empty())) {
     if (!meta_writer_->PutAndDelete(meta_write_to_kv, meta_delete_to_kv)) {
@@ -2624,6 +2661,7 @@ void CoordinatorControl::ApplyMetaIncrement(pb::coordinator_internal::MetaIncrem
       exit(-1);
     }
   }
+  kv_rev_storage_->ClearPendingWrite();
   // write update to local engine, end
 }
 
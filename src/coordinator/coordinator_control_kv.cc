@@ -81,9 +81,18 @@ butil::Status CoordinatorControl::GetRawKvIndex(const std::string &key,
   return butil::Status::OK();
 }
 
-butil::Status CoordinatorControl::RangeRawKvIndex(
-    const std::string &key, const std::string &range_end,
-    std::vector<pb::coordinator_internal::KvIndexInternal> &kv_index_values) {
+// RangeRawKvIndex visit kv_index in place, only the key and the latest mod_revision of a legal key is output
+// in:  key
+// in:  range_end, empty means only the key itself
+// in:  limit, the scan stops when limit legal keys are found
+// out: keys, if nullptr, only count
+// out: mod_revisions, if nullptr, not output
+// out: count, the count of legal keys found
+// out: has_more, there are more legal keys after limit
+butil::Status CoordinatorControl::RangeRawKvIndex(const std::string &key, const std::string &range_end, int64_t limit,
+                                                  std::vector<std::string> *keys,
+                                                  std::vector<pb::coordinator_internal::RevisionInternal> *mod_revisions,
+                                                  uint64_t &count, bool &has_more) {
   // scan kv_index for legal keys
   std::string lower_bound = key;
   std::string upper_bound = range_end;
@@ -91,51 +100,42 @@ butil::Status CoordinatorControl::RangeRawKvIndex(
   if (range_end == std::string(1, '\0')) {
     upper_bound = std::string(FLAGS_max_kv_key_size, '\xff');
   } else if (range_end.empty()) {
-    upper_bound = Helper::PrefixNext(key);
+    // the next key of the key is key + '\0'
+    upper_bound = key;
+    upper_bound.push_back('\0');
   }
 
-  auto ret = this->kv_index_map_.GetRangeValues(
-      kv_index_values, lower_bound, upper_bound, nullptr,
-      [&key, &range_end](const pb::coordinator_internal::KvIndexInternal &version_kv) -> bool {
+  count = 0;
+  has_more = false;
+
+  auto ret = this->kv_index_map_.TraverseRange(
+      lower_bound, upper_bound,
+      [&](const std::string &id, const pb::coordinator_internal::KvIndexInternal &version_kv) -> bool {
         auto generation_count = version_kv.generations_size();
         if (generation_count == 0) {
-          return false;
+          return true;
         }
 
         const auto &latest_generation = version_kv.generations(generation_count - 1);
         if (!latest_generation.has_create_revision() || latest_generation.revisions_size() == 0) {
+          return true;
+        }
+
+        if (static_cast<int64_t>(count) >= limit) {
+          has_more = true;
           return false;
         }
 
-        if (range_end.empty()) {
-          return key == version_kv.id();
-        } else if (range_end == std::string(1, '\0')) {
-          return version_kv.id().compare(key) >= 0;
-        } else {
-          return version_kv.id().compare(key) >= 0 && version_kv.id().compare(range_end) < 0;
+        ++count;
+        if (keys != nullptr) {
+          keys->push_back(id);
+        }
+        if (mod_revisions != nullptr) {
+          mod_revisions->push_back(version_kv.mod_revision());
         }
-      });
 
-  // auto ret = this->kv_index_map_.GetAllValues(
-  //     kv_index_values, [&key, &range_end](pb::coordinator_internal::KvIndexInternal version_kv) -> bool {
-  //       auto generation_count = version_kv.generations_size();
-  //       if (generation_count == 0) {
-  //         return false;
-  //       }
-
-  //       const auto &latest_generation = version_kv.generations(generation_count - 1);
-  //       if (!latest_generation.has_create_revision() || latest_generation.revisions_size() == 0) {
-  //         return false;
-  //       }
-
-  //       if (range_end.empty()) {
-  //         return key == version_kv.id();
-  //       } else if (range_end == std::string(1, '\0')) {
-  //         return version_kv.id().compare(key) >= 0;
-  //       } else {
-  //         return version_kv.id().compare(key) >= 0 && version_kv.id().compare(range_end) < 0;
-  //       }
-  //     });
+        return true;
+      });
 
   if (ret < 0) {
     DINGO_LOG(WARNING) << "RangeRawKvIndex failed, key:[" << key << "]";
@@ -174,7 +174,7 @@ butil::Status CoordinatorControl::DeleteRawKvIndex(const std::string &key,
 
 butil::Status CoordinatorControl::GetRawKvRev(const pb::coordinator_internal::RevisionInternal &revision,
                                               pb::coordinator_internal::KvRevInternal &kv_rev) {
-  auto ret = this->kv_rev_map_.Get(RevisionToString(revision), kv_rev);
+  auto ret = this->kv_rev_storage_->Get(RevisionToString(revision), kv_rev);
   if (ret < 0) {
     DINGO_LOG(WARNING) << "GetRawKvRev not found, revision:[" << revision.ShortDebugString() << "]";
     return butil::Status(EINVAL, "GetRawKvRev not found");
@@ -182,33 +182,17 @@ butil::Status CoordinatorControl::GetRawKvRev(const pb::coordinator_internal::Re
   return butil::Status::OK();
 }
 
-butil::Status CoordinatorControl::PutRawKvRev(const pb::coordinator_internal::RevisionInternal &revision,
+// the write of kv_rev is persisted with the raft apply index in ApplyMetaIncrement
+butil::Status CoordinatorControl::PutRawKvRev(const pb::coordinator_internal::RevisionInternal & /*revision*/,
                                               const pb::coordinator_internal::KvRevInternal &kv_rev) {
-  auto ret = this->kv_rev_map_.Put(RevisionToString(revision), kv_rev);
-  if (ret < 0) {
-    DINGO_LOG(WARNING) << "PutRawKvRev failed, revision:[" << revision.ShortDebugString() << "]";
-  }
-
-  DINGO_LOG(INFO) << "PutRawKvRev success, revision:[" << revision.ShortDebugString() << "], kv_rev:["
-                  << kv_rev.ShortDebugString() << "]"
-                  << " kv_rev.id: " << Helper::StringToHex(kv_rev.id())
-                  << ", revision_string: " << Helper::StringToHex(RevisionToString(revision));
-
-  std::vector<pb::common::KeyValue> meta_write_to_kv;
-  meta_write_to_kv.push_back(kv_rev_meta_->TransformToKvValue(kv_rev));
-  meta_writer_->Put(meta_write_to_kv);
+  this->kv_rev_storage_->Put(kv_rev);
 
   return butil::Status::OK();
 }
 
 butil::Status CoordinatorControl::DeleteRawKvRev(const pb::coordinator_internal::RevisionInternal &revision,
-                                                 const pb::coordinator_internal::KvRevInternal &kv_rev) {
-  auto ret = this->kv_rev_map_.Erase(RevisionToString(revision));
-  if (ret < 0) {
-    DINGO_LOG(WARNING) << "DeleteRawKvRev failed, revision:[" << revision.ShortDebugString() << "]";
-  }
-  auto kv_to_delete = kv_rev_meta_->TransformToKvValue(kv_rev);
-  meta_writer_->Delete(kv_to_delete.key());
+                                                 const pb::coordinator_internal::KvRevInternal & /*kv_rev*/) {
+  this->kv_rev_storage_->Erase(RevisionToString(revision));
 
   return butil::Status::OK();
 }
@@ -221,90 +205,69 @@ butil::Status CoordinatorControl::DeleteRawKvRev(const pb::coordinator_internal:
 // in:  keys_only
 // in:  count_only
 // out: kv
+// out: total_count_in_range, if count_only, it's the count of all keys in range, else it's the count of kv
+// out: has_more, there are more keys in range after limit
 // return: errno
 butil::Status CoordinatorControl::KvRange(const std::string &key, const std::string &range_end, int64_t limit,
                                           bool keys_only, bool count_only, std::vector<pb::version::Kv> &kv,
-                                          uint64_t &total_count_in_range) {
-  DINGO_LOG(INFO) << "KvRange, key: " << key << ", range_end: " << range_end << ", limit: " << limit
-                  << ", keys_only: " << keys_only << ", count_only: " << count_only;
-
-  if (limit == 0) {
+                                          uint64_t &total_count_in_range, bool &has_more) {
+  if (limit <= 0 || count_only) {
     limit = INT64_MAX;
   }
 
-  std::vector<pb::coordinator_internal::KvIndexInternal> kv_index_values;
+  std::vector<std::string> keys;
+  std::vector<pb::coordinator_internal::RevisionInternal> mod_revisions;
 
-  if (range_end.empty()) {
-    pb::coordinator_internal::KvIndexInternal kv_index;
-    auto ret = this->GetRawKvIndex(key, kv_index);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << "KvRange GetRawKvIndex not found, key: " << key << ", error: " << ret.error_str();
-      return butil::Status::OK();
-    }
-    kv_index_values.push_back(kv_index);
-  } else {
-    // scan kv_index for legal keys
-    auto ret = RangeRawKvIndex(key, range_end, kv_index_values);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << "KvRange kv_index_map_.RangeRawKvIndex failed";
-      return ret;
-    }
+  // count_only need not output anything, only count
+  auto ret = RangeRawKvIndex(key, range_end, limit, count_only ? nullptr : &keys, count_only ? nullptr : &mod_revisions,
+                             total_count_in_range, has_more);
+  if (!ret.ok()) {
+    DINGO_LOG(ERROR) << "KvRange RangeRawKvIndex failed, key: " << key << ", range_end: " << range_end
+                     << ", error: " << ret.error_str();
+    return ret;
   }
 
-  if (count_only) {
-    DINGO_LOG(INFO) << "KvRange count_only, total_count_in_range: " << total_count_in_range;
+  if (count_only || mod_revisions.empty()) {
     return butil::Status::OK();
   }
 
-  // query kv_rev for values
-  uint32_t limit_count = 0;
-  for (const auto &kv_index_value : kv_index_values) {
-    auto generation_count = kv_index_value.generations_size();
-    if (generation_count == 0) {
-      DINGO_LOG(INFO) << "KvRange generation_count is 0, key: " << key;
-      continue;
-    }
-    const auto &latest_generation = kv_index_value.generations(generation_count - 1);
-    if (!latest_generation.has_create_revision() || latest_generation.revisions_size() == 0) {
-      DINGO_LOG(INFO) << "KvRange latest_generation is empty, key: " << key;
-      continue;
-    }
+  // query kv_rev for values of the latest revision in one read
+  std::vector<std::string> revision_strings;
+  revision_strings.reserve(mod_revisions.size());
+  for (const auto &mod_revision : mod_revisions) {
+    revision_strings.push_back(RevisionToString(mod_revision));
+  }
 
-    limit_count++;
-    if (limit_count > limit) {
-      continue;
-    }
+  std::vector<pb::coordinator_internal::KvRevInternal> kv_revs;
+  std::vector<bool> exists;
+  kv_revs.reserve(revision_strings.size());
+  exists.reserve(revision_strings.size());
+  if (kv_rev_storage_->MultiGet(revision_strings, kv_revs, exists) < 0) {
+    DINGO_LOG(ERROR) << "KvRange kv_rev_storage_.MultiGet failed, key: " << key << ", range_end: " << range_end;
+    return butil::Status(EINVAL, "KvRange kv_rev_storage_.MultiGet failed");
+  }
 
-    pb::coordinator_internal::KvRevInternal kv_rev;
-    auto ret = GetRawKvRev(kv_index_value.mod_revision(), kv_rev);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << "kv_rev_map_.Get failed, revision: " << kv_index_value.mod_revision().ShortDebugString()
-                       << ", error: " << ret.error_str();
+  kv.reserve(kv.size() + kv_revs.size());
+  for (size_t i = 0; i < kv_revs.size(); ++i) {
+    if (!exists[i]) {
+      DINGO_LOG(ERROR) << "KvRange kv_rev not found, key: " << keys[i]
+                       << ", revision: " << mod_revisions[i].ShortDebugString();
       continue;
     }
 
-    const auto &kv_in_rev = kv_rev.kv();
-    pb::version::Kv kv_temp;
-    kv_temp.set_create_revision(kv_in_rev.create_revision().main());
-    kv_temp.set_mod_revision(kv_in_rev.mod_revision().main());
-    kv_temp.set_version(kv_in_rev.version());
-    kv_temp.set_lease(kv_in_rev.lease());
-    kv_temp.mutable_kv()->set_key(kv_in_rev.id());
+    auto *kv_in_rev = kv_revs[i].mutable_kv();
+    auto &kv_temp = kv.emplace_back();
+    kv_temp.set_create_revision(kv_in_rev->create_revision().main());
+    kv_temp.set_mod_revision(kv_in_rev->mod_revision().main());
+    kv_temp.set_version(kv_in_rev->version());
+    kv_temp.set_lease(kv_in_rev->lease());
+    kv_temp.mutable_kv()->set_key(std::move(*kv_in_rev->mutable_id()));
     if (!keys_only) {
-      kv_temp.mutable_kv()->set_value(kv_in_rev.value());
+      kv_temp.mutable_kv()->set_value(std::move(*kv_in_rev->mutable_value()));
     }
-
-    DINGO_LOG(INFO) << "KvRange will return kv: " << kv_temp.ShortDebugString();
-
-    // add to output
-    kv.push_back(kv_temp);
   }
 
-  total_count_in_range = limit_count;
-
-  DINGO_LOG(INFO) << "KvRange finish, key: " << key << ", range_end: " << range_end << ", limit: " << limit
-                  << ", keys_only: " << keys_only << ", count_only: " << count_only << ", kv size: " << kv.size()
-                  << ", total_count_in_range: " << total_count_in_range;
+  total_count_in_range = kv.size();
 
   return butil::Status::OK();
 }
@@ -317,27 +280,13 @@ butil::Status CoordinatorControl::KvRange(const std::string &key, const std::str
 // return: errno
 butil::Status CoordinatorControl::KvRangeRawKeys(const std::string &key, const std::string &range_end,
                                                  std::vector<std::string> &keys) {
-  std::vector<pb::coordinator_internal::KvIndexInternal> kv_index_values;
-
-  if (range_end.empty()) {
-    pb::coordinator_internal::KvIndexInternal kv_index;
-    auto ret = this->GetRawKvIndex(key, kv_index);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << "KvRange GetRawKvIndex not found, key: " << key << ", error: " << ret.error_str();
-      return butil::Status::OK();
-    }
-    keys.push_back(key);
-  } else {
-    // scan kv_index for legal keys
-    auto ret = RangeRawKvIndex(key, range_end, kv_index_values);
-    if (!ret.ok()) {
-      DINGO_LOG(ERROR) << "KvRange kv_index_map_.RangeRawKvIndex failed";
-      return ret;
-    }
-
-    for (const auto &kv_index_value : kv_index_values) {
-      keys.push_back(kv_index_value.id());
-    }
+  uint64_t count = 0;
+  bool has_more = false;
+  auto ret = RangeRawKvIndex(key, range_end, INT64_MAX, &keys, nullptr, count, has_more);
+  if (!ret.ok()) {
+    DINGO_LOG(ERROR) << "KvRangeRawKeys RangeRawKvIndex failed, key: " << key << ", range_end: " << range_end
+                     << ", error: " << ret.error_str();
+    return ret;
   }
 
   DINGO_LOG(INFO) << "KvRangeRawKeys finish, key: " << key << ", range_end: " << range_end
@@ -409,7 +358,8 @@ butil::Status CoordinatorControl::KvPut(const pb::common::KeyValue &key_value_in
   lease_grant_id = lease_id;
 
   uint64_t total_count_in_range = 0;
-  this->KvRange(key_value_in.key(), std::string(), 1, false, false, kvs_temp, total_count_in_range);
+  bool has_more = false;
+  this->KvRange(key_value_in.key(), std::string(), 1, false, false, kvs_temp, total_count_in_range, has_more);
   if (ignore_lease) {
     if (!kvs_temp.empty()) {
       // if ignore_lease, get the lease of the key
@@ -448,7 +398,7 @@ butil::Status CoordinatorControl::KvPut(const pb::common::KeyValue &key_value_in
   if (need_prev_kv) {
     if (kvs_temp.empty()) {
       uint64_t total_count_in_range = 0;
-      this->KvRange(key_value_in.key(), std::string(), 1, false, false, kvs_temp, total_count_in_range);
+      this->KvRange(key_value_in.key(), std::string(), 1, false, false, kvs_temp, total_count_in_range, has_more);
     }
     if (!kvs_temp.empty()) {
       prev_kv = kvs_temp[0];
@@ -503,7 +453,9 @@ butil::Status CoordinatorControl::KvDeleteRange(const std::string &key, const st
 
   bool key_only = !need_prev_kv;
 
-  auto ret = KvRange(key, range_end, INT64_MAX, key_only, false, kvs_to_delete, total_count_in_range);
+  bool has_more = false;
+
+  auto ret = KvRange(key, range_end, INT64_MAX, key_only, false, kvs_to_delete, total_count_in_range, has_more);
   if (!ret.ok()) {
     DINGO_LOG(ERROR) << "KvDeleteRange KvRange failed, key: " << key << ", range_end: " << range_end
                      << ", error: " << ret.error_str();
@@ -681,25 +633,20 @@ butil::Status CoordinatorControl::KvPutApply(const std::string &key,
   DINGO_LOG(INFO) << "KvPutApply PutRawKvRev success, revision: " << op_revision.ShortDebugString()
                   << ", kv_rev: " << kv_rev.ShortDebugString();
 
-  // trigger watch
-  if (!this->one_time_watch_map_.empty()) {
-    DINGO_LOG(INFO) << "KvPutApply one_time_watch_map_ is not empty, will trigger watch, key: " << key
-                    << ", watch size: " << this->one_time_watch_map_.size();
-
-    if (prev_kv.create_revision() > 0) {
-      prev_kv.set_lease(kv_rev_last.kv().lease());
-      prev_kv.mutable_kv()->set_key(key);
-      prev_kv.mutable_kv()->set_value(kv_rev_last.kv().value());
-    }
-    new_kv.set_create_revision(new_create_revision.main());
-    new_kv.set_mod_revision(op_revision.main());
-    new_kv.set_version(new_version);
-    new_kv.set_lease(kv_rev.kv().lease());
-    new_kv.mutable_kv()->set_key(key);
-    new_kv.mutable_kv()->set_value(kv_rev.kv().value());
-
-    TriggerOneWatch(key, pb::version::Event::EventType::Event_EventType_PUT, new_kv, prev_kv);
+  // trigger watch, the event is also kept in watch event ring for watch to resume
+  if (prev_kv.create_revision() > 0) {
+    prev_kv.set_lease(kv_rev_last.kv().lease());
+    prev_kv.mutable_kv()->set_key(key);
+    prev_kv.mutable_kv()->set_value(kv_rev_last.kv().value());
   }
+  new_kv.set_create_revision(new_create_revision.main());
+  new_kv.set_mod_revision(op_revision.main());
+  new_kv.set_version(new_version);
+  new_kv.set_lease(kv_rev.kv().lease());
+  new_kv.mutable_kv()->set_key(key);
+  new_kv.mutable_kv()->set_value(kv_rev.kv().value());
+
+  TriggerOneWatch(key, pb::version::Event::EventType::Event_EventType_PUT, new_kv, prev_kv);
 
   DINGO_LOG(INFO) << "KvPutApply success after trigger watch, key: " << key
                   << ", op_revision: " << op_revision.ShortDebugString() << ", ignore_lease: " << ignore_lease
@@ -808,25 +755,20 @@ butil::Status CoordinatorControl::KvDeleteApply(const std::string &key,
 
   DINGO_LOG(INFO) << "KvDeleteApply success, key: " << key << ", revision: " << op_revision.ShortDebugString();
 
-  // trigger watch
-  if (!this->one_time_watch_map_.empty()) {
-    DINGO_LOG(INFO) << "KvDeleteApply one_time_watch_map_ is not empty, will trigger watch, key: " << key
-                    << ", watch size: " << this->one_time_watch_map_.size();
-
-    if (prev_kv.create_revision() > 0) {
-      prev_kv.set_lease(kv_rev_last.kv().lease());
-      prev_kv.mutable_kv()->set_key(key);
-      prev_kv.mutable_kv()->set_value(kv_rev_last.kv().value());
-    }
-    new_kv.set_create_revision(new_create_revision.main());
-    new_kv.set_mod_revision(op_revision.main());
-    new_kv.set_version(new_version);
-    new_kv.set_lease(kv_rev.kv().lease());
-    new_kv.mutable_kv()->set_key(key);
-    new_kv.mutable_kv()->set_value(kv_rev.kv().value());
-
-    TriggerOneWatch(key, pb::version::Event::EventType::Event_EventType_DELETE, new_kv, prev_kv);
+  // trigger watch, the event is also kept in watch event ring for watch to resume
+  if (prev_kv.create_revision() > 0) {
+    prev_kv.set_lease(kv_rev_last.kv().lease());
+    prev_kv.mutable_kv()->set_key(key);
+    prev_kv.mutable_kv()->set_value(kv_rev_last.kv().value());
   }
+  new_kv.set_create_revision(new_create_revision.main());
+  new_kv.set_mod_revision(op_revision.main());
+  new_kv.set_version(new_version);
+  new_kv.set_lease(kv_rev.kv().lease());
+  new_kv.mutable_kv()->set_key(key);
+  new_kv.mutable_kv()->set_value(kv_rev.kv().value());
+
+  TriggerOneWatch(key, pb::version::Event::EventType::Event_EventType_DELETE, new_kv, prev_kv);
 
   DINGO_LOG(INFO) << "KvDeleteApply success after trigger watch, key: " << key
                   << ", revision: " << op_revision.ShortDebugString();
@@ -1046,7 +988,7 @@ butil::Status CoordinatorControl::KvCompactApply(const std::string &key,
     PutRawKvIndex(key, new_kv_index);
   }
 
-  // delete revisions in kv_rev_map_
+  // delete revisions in kv_rev_storage_
   for (const auto &kv_revision : revisions_to_delete) {
     pb::coordinator_internal::KvRevInternal kv_rev;
     kv_rev.set_id(RevisionToString(kv_revision));
@@ -194,11 +194,10 @@ butil::Status CoordinatorControl::LeaseRevoke(uint64_t lease_id,
 }
 
 butil::Status CoordinatorControl::ListLeases(std::vector<pb::coordinator_internal::LeaseInternal> &leases) {
-  butil::FlatMap<uint64_t, pb::coordinator_internal::LeaseInternal> version_lease_map;
-  lease_map_.GetRawMapCopy(version_lease_map);
-  for (auto &it : version_lease_map) {
-    leases.emplace_back(std::move(it.second));
-  }
+  lease_map_.Traverse([&leases](uint64_t /*lease_id*/, const pb::coordinator_internal::LeaseInternal &lease) {
+    leases.push_back(lease);
+    return true;
+  });
 
   return butil::Status::OK();
 }
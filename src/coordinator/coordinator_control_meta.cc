@@ -2487,12 +2487,16 @@ uint64_t CoordinatorControl::CalculateIndexMetricsSingle(uint64_t index_id, pb::
 void CoordinatorControl::CalculateTableMetrics() {
   // BAIDU_SCOPED_LOCK(table_metrics_map_mutex_);
 
-  butil::FlatMap<uint64_t, pb::coordinator_internal::TableMetricsInternal> temp_table_metrics_map;
-  temp_table_metrics_map.init(10000);
-  table_metrics_map_.GetRawMapCopy(temp_table_metrics_map);
+  // only copy the ids, the map is modified in the loop
+  std::vector<uint64_t> table_ids;
+  table_metrics_map_.GetAllKeys(table_ids);
+
+  for (auto table_id : table_ids) {
+    pb::coordinator_internal::TableMetricsInternal table_metrics_internal;
+    if (table_metrics_map_.Get(table_id, table_metrics_internal) < 0) {
+      continue;
+    }
 
-  for (auto& table_metrics_internal : temp_table_metrics_map) {
-    uint64_t table_id = table_metrics_internal.first;
     pb::meta::TableMetrics table_metrics;
     if (CalculateTableMetricsSingle(table_id, table_metrics) < 0) {
       DINGO_LOG(ERROR) << "ERRROR: CalculateTableMetricsSingle failed, remove metrics from map" << table_id;
@@ -2502,10 +2506,10 @@ void CoordinatorControl::CalculateTableMetrics() {
       coordinator_bvar_metrics_table_.DeleteTableBvar(table_id);
 
     } else {
-      *(table_metrics_internal.second.mutable_table_metrics()) = table_metrics;
+      *(table_metrics_internal.mutable_table_metrics()) = table_metrics;
 
       // update table_metrics_map_ in memory
-      table_metrics_map_.PutIfExists(table_id, table_metrics_internal.second);
+      table_metrics_map_.PutIfExists(table_id, table_metrics_internal);
 
       // mbvar table
       coordinator_bvar_metrics_table_.UpdateTableBvar(table_id, table_metrics.rows_count(), table_metrics.part_count());
@@ -2520,12 +2524,16 @@ void CoordinatorControl::CalculateTableMetrics() {
 void CoordinatorControl::CalculateIndexMetrics() {
   // BAIDU_SCOPED_LOCK(index_metrics_map_mutex_);
 
-  butil::FlatMap<uint64_t, pb::coordinator_internal::IndexMetricsInternal> temp_index_metrics_map;
-  temp_index_metrics_map.init(10000);
-  index_metrics_map_.GetRawMapCopy(temp_index_metrics_map);
+  // only copy the ids, the map is modified in the loop
+  std::vector<uint64_t> index_ids;
+  index_metrics_map_.GetAllKeys(index_ids);
+
+  for (auto index_id : index_ids) {
+    pb::coordinator_internal::IndexMetricsInternal index_metrics_internal;
+    if (index_metrics_map_.Get(index_id, index_metrics_internal) < 0) {
+      continue;
+    }
 
-  for (auto& index_metrics_internal : temp_index_metrics_map) {
-    uint64_t index_id = index_metrics_internal.first;
     pb::meta::IndexMetrics index_metrics;
     if (CalculateIndexMetricsSingle(index_id, index_metrics) < 0) {
       DINGO_LOG(ERROR) << "ERRROR: CalculateIndexMetricsSingle failed, remove metrics from map" << index_id;
@@ -2535,10 +2543,10 @@ void CoordinatorControl::CalculateIndexMetrics() {
       coordinator_bvar_metrics_index_.DeleteIndexBvar(index_id);
 
     } else {
-      *(index_metrics_internal.second.mutable_index_metrics()) = index_metrics;
+      *(index_metrics_internal.mutable_index_metrics()) = index_metrics;
 
       // update index_metrics_map_ in memory
-      index_metrics_map_.PutIfExists(index_id, index_metrics_internal.second);
+      index_metrics_map_.PutIfExists(index_id, index_metrics_internal);
 
       // mbvar index
       coordinator_bvar_metrics_index_.UpdateIndexBvar(index_id, index_metrics.rows_count(), index_metrics.part_count());
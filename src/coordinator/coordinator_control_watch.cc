@@ -26,66 +26,84 @@
 #include <vector>
 
 #include "brpc/closure_guard.h"
+#include "brpc/reloadable_flags.h"
 #include "butil/scoped_lock.h"
 #include "butil/status.h"
 #include "common/logging.h"
 #include "coordinator/coordinator_control.h"
+#include "gflags/gflags.h"
 #include "proto/coordinator_internal.pb.h"
 #include "proto/version.pb.h"
 
 namespace dingodb {
 
+DEFINE_int32(watch_max_events_per_response, 1000, "max event count of one watch response");
+BRPC_VALIDATE_GFLAG(watch_max_events_per_response, brpc::PositiveInteger);
+
 void WatchCancelCallback(CoordinatorControl* coordinator_control, google::protobuf::Closure* done) {
   DINGO_LOG(INFO) << "WatchCancelCallback, done:" << done;
 
   coordinator_control->CancelOneTimeWatchClosure(done);
 }
 
-butil::Status CoordinatorControl::OneTimeWatch(const std::string& watch_key, uint64_t start_revision, bool no_put_event,
-                                               bool no_delete_event, bool need_prev_kv, bool wait_on_not_exist_key,
+butil::Status CoordinatorControl::OneTimeWatch(const std::string& watch_key, const std::string& range_end,
+                                               uint64_t start_revision, bool no_put_event, bool no_delete_event,
+                                               bool need_prev_kv, bool wait_on_not_exist_key,
                                                google::protobuf::Closure* done, pb::version::WatchResponse* response,
                                                [[maybe_unused]] brpc::Controller* cntl) {
   brpc::ClosureGuard done_guard(done);
 
-  DINGO_LOG(INFO) << "OneTimeWatch, watch_key:" << watch_key << ", start_revision:" << start_revision
-                  << ", no_put_event:" << no_put_event << ", no_delete_event:" << no_delete_event
-                  << ", need_prev_kv:" << need_prev_kv << ", wait_on_not_exist_key:" << wait_on_not_exist_key
-                  << ", done:" << done;
+  auto watch_range = WatchRange::Build(watch_key, range_end);
+
+  bool ring_covers = true;
+  if (start_revision > 0) {
+    BAIDU_SCOPED_LOCK(one_time_watch_map_mutex_);
+    ring_covers = watch_event_ring_.Covers(start_revision);
+  }
+
+  if (!ring_covers) {
+    // the events after start_revision may be evicted, check the latest kv in range without holding the watch lock,
+    // the deleted keys and prev kv are lost, see OneTimeWatchRequest.start_revision
+    uint64_t read_revision = GetPresentId(pb::coordinator_internal::IdEpochType::ID_NEXT_REVISION);
+    if (!no_put_event && CollectLatestKvEvents(watch_key, range_end, start_revision,
+                                               FLAGS_watch_max_events_per_response, response) > 0) {
+      return butil::Status::OK();
+    }
+
+    // no kv is changed before the read, the changes during the read are in the ring or triggered later
+    start_revision = std::max(start_revision, read_revision);
+  }
 
   BAIDU_SCOPED_LOCK(one_time_watch_map_mutex_);
 
   if (start_revision == 0) {
     start_revision = GetPresentId(pb::coordinator_internal::IdEpochType::ID_NEXT_REVISION);
-    DINGO_LOG(INFO) << "OneTimeWatch, start_revision is 0, set to next revision, watch_key:" << watch_key
-                    << ", start_revision:" << start_revision;
+  } else if (watch_event_ring_.Covers(start_revision)) {
+    // resume from the recent events in memory, no need to read storage
+    if (watch_event_ring_.Collect(watch_range, start_revision, no_put_event, no_delete_event, need_prev_kv,
+                                  FLAGS_watch_max_events_per_response, response) > 0) {
+      return butil::Status::OK();
+    }
   }
 
-  // check if need to send back immediately
-  std::vector<pb::version::Kv> kvs_temp;
-  uint64_t total_count_in_range = 0;
-  this->KvRange(watch_key, std::string(), 1, false, false, kvs_temp, total_count_in_range);
-
   // if key is not exists, and no wait, send response
-  if (kvs_temp.empty() && !wait_on_not_exist_key) {
-    // not exist, no wait, send response
-    auto* event = response->add_events();
-    event->set_type(::dingodb::pb::version::Event_EventType::Event_EventType_NOT_EXISTS);
-    return butil::Status::OK();
-  }
-
-  if (!kvs_temp.empty()) {
-    // compare start_revision and current revision
-    if (kvs_temp[0].mod_revision() > start_revision) {
+  if (watch_range.IsSingleKey() && !wait_on_not_exist_key) {
+    std::vector<pb::version::Kv> kvs_temp;
+    uint64_t total_count_in_range = 0;
+    bool has_more = false;
+    this->KvRange(watch_key, std::string(), 1, true, true, kvs_temp, total_count_in_range, has_more);
+
+    if (total_count_in_range == 0) {
+      // not exist, no wait, send response
       auto* event = response->add_events();
-      event->set_type(::dingodb::pb::version::Event_EventType::Event_EventType_PUT);
-      *(event->mutable_kv()) = kvs_temp[0];
+      event->set_type(::dingodb::pb::version::Event_EventType::Event_EventType_NOT_EXISTS);
       return butil::Status::OK();
     }
   }
 
   // add to watch
   auto* defer_done = done_guard.release();
-  AddOneTimeWatch(watch_key, start_revision, no_put_event, no_delete_event, need_prev_kv, defer_done, response);
+  AddOneTimeWatch(watch_range, start_revision, no_put_event, no_delete_event, need_prev_kv, defer_done, response);
 
   // add NotifyOnCancel callback
   cntl->NotifyOnCancel(brpc::NewCallback(&WatchCancelCallback, this, defer_done));
@@ -93,31 +111,64 @@ butil::Status CoordinatorControl::OneTimeWatch(const std::string& watch_key, uin
   return butil::Status::OK();
 }
 
+// the range is read by page of max_count kvs, so a large range is not loaded at once
+int CoordinatorControl::CollectLatestKvEvents(const std::string& watch_key, const std::string& range_end,
+                                              uint64_t start_revision, int max_count,
+                                              pb::version::WatchResponse* response) {
+  int count = 0;
+  std::string page_key = watch_key;
+  while (count < max_count) {
+    std::vector<pb::version::Kv> kvs_temp;
+    uint64_t total_count_in_range = 0;
+    bool has_more = false;
+    auto ret = this->KvRange(page_key, range_end, max_count, false, false, kvs_temp, total_count_in_range, has_more);
+    if (!ret.ok()) {
+      DINGO_LOG(ERROR) << "CollectLatestKvEvents KvRange failed, key: " << page_key << ", range_end: " << range_end
+                       << ", error: " << ret.error_str();
+      break;
+    }
+
+    // empty range_end is the single key, no next page
+    if (!has_more || kvs_temp.empty() || range_end.empty()) {
+      page_key.clear();
+    } else {
+      // the next key of the last key
+      page_key = kvs_temp.back().kv().key();
+      page_key.push_back('\0');
+    }
+
+    for (auto& kv : kvs_temp) {
+      if (static_cast<uint64_t>(kv.mod_revision()) >= start_revision && count < max_count) {
+        auto* event = response->add_events();
+        event->set_type(::dingodb::pb::version::Event_EventType::Event_EventType_PUT);
+        event->mutable_kv()->Swap(&kv);
+        ++count;
+      }
+    }
+
+    if (page_key.empty()) {
+      break;
+    }
+  }
+
+  return count;
+}
+
 // caller must hold one_time_watch_map_mutex_
-butil::Status CoordinatorControl::AddOneTimeWatch(const std::string& watch_key, uint64_t start_revision,
+butil::Status CoordinatorControl::AddOneTimeWatch(const WatchRange& watch_range, uint64_t start_revision,
                                                   bool no_put_event, bool no_delete_event, bool need_prev_kv,
                                                   google::protobuf::Closure* done,
                                                   pb::version::WatchResponse* response) {
   // add to watch
   WatchNode watch_node(done, response, start_revision, no_put_event, no_delete_event, need_prev_kv);
 
-  DINGO_LOG(INFO) << "AddOneTimeWatch, watch_key:" << watch_key << ", start_revision:" << start_revision
-                  << ", no_put_event:" << no_put_event << ", no_delete_event:" << no_delete_event
-                  << ", need_prev_kv:" << need_prev_kv << ", done:" << done;
-
-  auto it = one_time_watch_map_.find(watch_key);
-  if (it == one_time_watch_map_.end()) {
-    std::map<google::protobuf::Closure*, WatchNode> watch_node_map;
-    watch_node_map.insert_or_assign(done, watch_node);
-    one_time_watch_map_.insert_or_assign(watch_key, watch_node_map);
-    DINGO_LOG(INFO) << "AddOneTimeWatch, watch_key not found, insert, watch_key:" << watch_key;
+  if (watch_range.IsSingleKey()) {
+    one_time_watch_map_[watch_range.start_key].insert_or_assign(done, watch_node);
   } else {
-    auto& exist_watch_node_map = it->second;
-    exist_watch_node_map.insert_or_assign(done, watch_node);
-    DINGO_LOG(INFO) << "AddOneTimeWatch, watch_key found, insert, watch_key:" << watch_key;
+    one_time_range_watch_map_[watch_range].insert_or_assign(done, watch_node);
   }
 
-  one_time_watch_closure_map_.insert_or_assign(done, watch_key);
+  one_time_watch_closure_map_.insert_or_assign(done, watch_range);
 
   return butil::Status::OK();
 }
@@ -129,34 +180,34 @@ butil::Status CoordinatorControl::RemoveOneTimeWatchWithLock(google::protobuf::C
     return butil::Status(EINVAL, "RemoveOneTimeWatch not found");
   }
 
-  auto& watch_key = it->second;
-  if (watch_key.empty()) {
-    DINGO_LOG(ERROR) << "RemoveOneTimeWatch watch_key is empty, done:" << done
-                     << ", remove from one_time_watch_closure_map_";
-    one_time_watch_closure_map_.erase(it);
-    return butil::Status(EINVAL, "RemoveOneTimeWatch watch_key is empty");
-  }
+  const auto& watch_range = it->second;
 
-  auto it2 = one_time_watch_map_.find(watch_key);
-  if (it2 == one_time_watch_map_.end()) {
-    DINGO_LOG(ERROR) << "RemoveOneTimeWatch watch_key not found, done:" << done << ", watch_key:" << watch_key
-                     << ", remove from one_time_watch_closure_map_";
-    one_time_watch_closure_map_.erase(it);
-    return butil::Status(EINVAL, "RemoveOneTimeWatch watch_key not found");
+  bool found = false;
+  if (watch_range.IsSingleKey()) {
+    auto it2 = one_time_watch_map_.find(watch_range.start_key);
+    if (it2 != one_time_watch_map_.end()) {
+      found = it2->second.erase(done) > 0;
+      if (it2->second.empty()) {
+        one_time_watch_map_.erase(it2);
+      }
+    }
+  } else {
+    auto it2 = one_time_range_watch_map_.find(watch_range);
+    if (it2 != one_time_range_watch_map_.end()) {
+      found = it2->second.erase(done) > 0;
+      if (it2->second.empty()) {
+        one_time_range_watch_map_.erase(it2);
+      }
+    }
   }
 
-  auto& watch_node_map = it2->second;
-  auto it3 = watch_node_map.find(done);
-  if (it3 == watch_node_map.end()) {
-    DINGO_LOG(ERROR) << "RemoveOneTimeWatch done not found, done:" << done << ", watch_key:" << watch_key
-                     << ", remove from one_time_watch_closure_map_";
-    one_time_watch_closure_map_.erase(it);
+  one_time_watch_closure_map_.erase(it);
+
+  if (!found) {
+    DINGO_LOG(ERROR) << "RemoveOneTimeWatch done not found in watch map, done:" << done;
     return butil::Status(EINVAL, "RemoveOneTimeWatch done not found");
   }
 
-  DINGO_LOG(INFO) << "RemoveOneTimeWatch, done:" << done << ", watch_key:" << watch_key;
-  watch_node_map.erase(it3);
-
   return butil::Status::OK();
 }
 
@@ -202,68 +253,70 @@ butil::Status CoordinatorControl::CancelOneTimeWatchClosure(google::protobuf::Cl
   return butil::Status::OK();
 }
 
+// all events are kept in watch_event_ring_, and the matched watches are triggered
 butil::Status CoordinatorControl::TriggerOneWatch(const std::string& key, pb::version::Event::EventType event_type,
                                                   pb::version::Kv& new_kv, pb::version::Kv& prev_kv) {
-  DINGO_LOG(INFO) << "TriggerOneWatch, key:" << key << ", event_type:" << event_type
-                  << ", new_kv:" << new_kv.ShortDebugString() << ", prev_kv:" << prev_kv.ShortDebugString();
-
   BAIDU_SCOPED_LOCK(one_time_watch_map_mutex_);
 
-  auto it = one_time_watch_map_.find(key);
-  if (it == one_time_watch_map_.end()) {
-    DINGO_LOG(INFO) << "TriggerOneWatch not found, key:" << key;
-    return butil::Status::OK();
+  pb::version::Event ring_event;
+  ring_event.set_type(event_type);
+  *ring_event.mutable_kv() = new_kv;
+  if (prev_kv.create_revision() > 0) {
+    *ring_event.mutable_prev_kv() = prev_kv;
   }
-
-  auto& watch_node_map = it->second;
+  watch_event_ring_.Append(ring_event);
 
   std::vector<google::protobuf::Closure*> done_list;
-  for (auto& watch_node : watch_node_map) {
-    if (watch_node.second.no_put_event && event_type == pb::version::Event::EventType::Event_EventType_PUT) {
-      DINGO_LOG(INFO) << "TriggerOneWatch skip, no_put_event, key:" << key;
-      continue;
-    }
 
-    if (watch_node.second.no_delete_event && event_type == pb::version::Event::EventType::Event_EventType_DELETE) {
-      DINGO_LOG(INFO) << "TriggerOneWatch skip, no_delete_event, key:" << key;
-      continue;
-    }
+  auto trigger_watch_nodes = [&](std::map<google::protobuf::Closure*, WatchNode>& watch_node_map) {
+    for (auto& [done, watch_node] : watch_node_map) {
+      if (watch_node.no_put_event && event_type == pb::version::Event::EventType::Event_EventType_PUT) {
+        continue;
+      }
 
-    if (watch_node.second.start_revision > new_kv.mod_revision()) {
-      DINGO_LOG(INFO) << "TriggerOneWatch skip, start_revision > new_kv.mod_revision(), key:" << key
-                      << ", start_revision:" << watch_node.second.start_revision
-                      << ", new_kv.mod_revision:" << new_kv.mod_revision();
-      continue;
-    }
+      if (watch_node.no_delete_event && event_type == pb::version::Event::EventType::Event_EventType_DELETE) {
+        continue;
+      }
 
-    auto* response = watch_node.second.response;
-    auto* event = response->add_events();
-    event->set_type(event_type);
-    auto* kv = event->mutable_kv();
-    *kv = new_kv;
-    if (watch_node.second.need_prev_kv) {
-      auto* old_kv = event->mutable_prev_kv();
-      *old_kv = prev_kv;
+      if (watch_node.start_revision > static_cast<uint64_t>(new_kv.mod_revision())) {
+        continue;
+      }
+
+      auto* event = watch_node.response->add_events();
+      event->set_type(event_type);
+      *event->mutable_kv() = new_kv;
+      if (watch_node.need_prev_kv) {
+        *event->mutable_prev_kv() = prev_kv;
+      }
+
+      done_list.push_back(done);
     }
+  };
 
-    DINGO_LOG(INFO) << "TriggerOneWatch will RemoveOneTimeWatch, key:" << key << ", event_type:" << event_type
-                    << ", watch_node.first:" << watch_node.first
-                    << ", watch_detail: start_revision=" << watch_node.second.start_revision
-                    << ", no_put_event=" << watch_node.second.no_put_event
-                    << ", no_delete_event=" << watch_node.second.no_delete_event
-                    << ", need_prev_kv=" << watch_node.second.need_prev_kv
-                    << ", response:" << response->ShortDebugString();
+  // single key watch
+  auto it = one_time_watch_map_.find(key);
+  if (it != one_time_watch_map_.end()) {
+    trigger_watch_nodes(it->second);
+  }
 
-    auto* done = watch_node.first;
-    done_list.push_back(done);
+  // range watch, only the ranges whose start key <= key may contain the key
+  for (auto& [watch_range, watch_node_map] : one_time_range_watch_map_) {
+    if (watch_range.start_key > key) {
+      break;
+    }
+    if (watch_range.Contains(key)) {
+      trigger_watch_nodes(watch_node_map);
+    }
+  }
 
-    DINGO_LOG(INFO) << "TriggerOneWatch success, key:" << key << ", event_type:" << event_type << ", done:" << done
-                    << ", response:" << response->ShortDebugString();
+  if (!done_list.empty()) {
+    DINGO_LOG(INFO) << "TriggerOneWatch, key:" << key << ", event_type:" << event_type
+                    << ", mod_revision:" << new_kv.mod_revision() << ", triggered watch count:" << done_list.size();
   }
 
   for (auto& done : done_list) {
-    done->Run();
     RemoveOneTimeWatchWithLock(done);
+    done->Run();
   }
 
   return butil::Status::OK();
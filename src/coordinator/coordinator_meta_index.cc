@@ -0,0 +1,229 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coordinator/coordinator_meta_index.h"
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "bthread/mutex.h"
+#include "butil/scoped_lock.h"
+
+namespace dingodb {
+
+CoordinatorMetaIndex::CoordinatorMetaIndex() { bthread_mutex_init(&mutex_, nullptr); }
+
+CoordinatorMetaIndex::~CoordinatorMetaIndex() { bthread_mutex_destroy(&mutex_); }
+
+void CoordinatorMetaIndex::EraseFromSet(std::map<uint64_t, std::set<uint64_t>> &index, uint64_t key,
+                                        uint64_t value) {
+  auto it = index.find(key);
+  if (it == index.end()) {
+    return;
+  }
+
+  it->second.erase(value);
+  if (it->second.empty()) {
+    index.erase(it);
+  }
+}
+
+std::vector<uint64_t> CoordinatorMetaIndex::GetFromSet(const std::map<uint64_t, std::set<uint64_t>> &index,
+                                                       uint64_t key) {
+  auto it = index.find(key);
+  if (it == index.end()) {
+    return {};
+  }
+
+  return std::vector<uint64_t>(it->second.begin(), it->second.end());
+}
+
+void CoordinatorMetaIndex::PutRegion(const pb::coordinator_internal::RegionInternal &region) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  EraseRegionInternal(region.id());
+
+  RegionEntry entry;
+  for (const auto &peer : region.definition().peers()) {
+    entry.store_ids.push_back(peer.store_id());
+    store_regions_[peer.store_id()].insert(region.id());
+  }
+
+  entry.table_id = region.definition().table_id();
+  if (entry.table_id > 0) {
+    table_regions_[entry.table_id].insert(region.id());
+  }
+
+  entry.index_id = region.definition().index_id();
+  if (entry.index_id > 0) {
+    index_regions_[entry.index_id].insert(region.id());
+  }
+
+  regions_[region.id()] = entry;
+}
+
+void CoordinatorMetaIndex::EraseRegion(uint64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  EraseRegionInternal(region_id);
+}
+
+void CoordinatorMetaIndex::EraseRegionInternal(uint64_t region_id) {
+  auto it = regions_.find(region_id);
+  if (it == regions_.end()) {
+    return;
+  }
+
+  for (auto store_id : it->second.store_ids) {
+    EraseFromSet(store_regions_, store_id, region_id);
+  }
+  if (it->second.table_id > 0) {
+    EraseFromSet(table_regions_, it->second.table_id, region_id);
+  }
+  if (it->second.index_id > 0) {
+    EraseFromSet(index_regions_, it->second.index_id, region_id);
+  }
+
+  regions_.erase(it);
+}
+
+void CoordinatorMetaIndex::PutTaskList(uint64_t task_list_id, const pb::coordinator::TaskList &task_list) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  EraseTaskListInternal(task_list_id);
+
+  std::set<uint64_t> region_ids;
+  for (const auto &task : task_list.tasks()) {
+    for (const auto &store_operation : task.store_operations()) {
+      for (const auto &region_cmd : store_operation.region_cmds()) {
+        region_ids.insert(region_cmd.region_id());
+        region_task_lists_[region_cmd.region_id()].insert(task_list_id);
+      }
+    }
+  }
+
+  if (!region_ids.empty()) {
+    task_list_regions_[task_list_id] = region_ids;
+  }
+}
+
+void CoordinatorMetaIndex::EraseTaskList(uint64_t task_list_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  EraseTaskListInternal(task_list_id);
+}
+
+void CoordinatorMetaIndex::EraseTaskListInternal(uint64_t task_list_id) {
+  auto it = task_list_regions_.find(task_list_id);
+  if (it == task_list_regions_.end()) {
+    return;
+  }
+
+  for (auto region_id : it->second) {
+    EraseFromSet(region_task_lists_, region_id, task_list_id);
+  }
+
+  task_list_regions_.erase(it);
+}
+
+void CoordinatorMetaIndex::PutRegionCmd(uint64_t region_cmd_id, uint64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = region_cmds_.find(region_cmd_id);
+  if (it != region_cmds_.end()) {
+    EraseFromSet(region_region_cmds_, it->second, region_cmd_id);
+  }
+
+  region_cmds_[region_cmd_id] = region_id;
+  region_region_cmds_[region_id].insert(region_cmd_id);
+}
+
+void CoordinatorMetaIndex::EraseRegionCmd(uint64_t region_cmd_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = region_cmds_.find(region_cmd_id);
+  if (it == region_cmds_.end()) {
+    return;
+  }
+
+  EraseFromSet(region_region_cmds_, it->second, region_cmd_id);
+  region_cmds_.erase(it);
+}
+
+void CoordinatorMetaIndex::PutStoreOperation(const pb::coordinator_internal::StoreOperationInternal &store_operation) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = store_operation_cmds_.find(store_operation.id());
+  if (it != store_operation_cmds_.end()) {
+    for (auto region_cmd_id : it->second) {
+      EraseFromSet(region_cmd_stores_, region_cmd_id, store_operation.id());
+    }
+    store_operation_cmds_.erase(it);
+  }
+
+  for (auto region_cmd_id : store_operation.region_cmd_ids()) {
+    store_operation_cmds_[store_operation.id()].insert(region_cmd_id);
+    region_cmd_stores_[region_cmd_id].insert(store_operation.id());
+  }
+}
+
+void CoordinatorMetaIndex::Clear() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  regions_.clear();
+  store_regions_.clear();
+  table_regions_.clear();
+  index_regions_.clear();
+  task_list_regions_.clear();
+  region_task_lists_.clear();
+  region_cmds_.clear();
+  region_region_cmds_.clear();
+  store_operation_cmds_.clear();
+  region_cmd_stores_.clear();
+}
+
+uint64_t CoordinatorMetaIndex::GetRegionCountByStore(uint64_t store_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = store_regions_.find(store_id);
+  return it == store_regions_.end() ? 0 : it->second.size();
+}
+
+std::vector<uint64_t> CoordinatorMetaIndex::GetRegionIdsByTable(uint64_t table_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return GetFromSet(table_regions_, table_id);
+}
+
+std::vector<uint64_t> CoordinatorMetaIndex::GetRegionIdsByIndex(uint64_t index_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return GetFromSet(index_regions_, index_id);
+}
+
+std::vector<uint64_t> CoordinatorMetaIndex::GetTaskListIdsByRegion(uint64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return GetFromSet(region_task_lists_, region_id);
+}
+
+std::vector<uint64_t> CoordinatorMetaIndex::GetStoreOperationIdsByRegion(uint64_t region_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto it = region_region_cmds_.find(region_id);
+  if (it == region_region_cmds_.end()) {
+    return {};
+  }
+
+  std::set<uint64_t> store_ids;
+  for (auto region_cmd_id : it->second) {
+    auto store_it = region_cmd_stores_.find(region_cmd_id);
+    if (store_it != region_cmd_stores_.end()) {
+      store_ids.insert(store_it->second.begin(), store_it->second.end());
+    }
+  }
+
+  return std::vector<uint64_t>(store_ids.begin(), store_ids.end());
+}
+
+}  // namespace dingodb
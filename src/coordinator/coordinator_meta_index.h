@@ -0,0 +1,99 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COORDINATOR_COORDINATOR_META_INDEX_H_
+#define DINGODB_COORDINATOR_COORDINATOR_META_INDEX_H_
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "bthread/types.h"
+#include "proto/coordinator.pb.h"
+#include "proto/coordinator_internal.pb.h"
+
+namespace dingodb {
+
+// Secondary indexes of coordinator meta maps, so the lookup of related entities is O(result) instead of scanning
+// the whole map:
+//   store_id -> region count, table_id -> region_ids, index_id -> region_ids,
+//   region_id -> task_list_ids, region_id -> store_ids of pending store operations.
+// The indexes are maintained in ApplyMetaIncrement together with the meta maps, and rebuilt in BuildTempMaps
+// after the meta maps are recovered or loaded from snapshot.
+class CoordinatorMetaIndex {
+ public:
+  CoordinatorMetaIndex();
+  ~CoordinatorMetaIndex();
+
+  CoordinatorMetaIndex(const CoordinatorMetaIndex &) = delete;
+  const CoordinatorMetaIndex &operator=(const CoordinatorMetaIndex &) = delete;
+
+  // Put replaces the old index entries of the same id.
+  void PutRegion(const pb::coordinator_internal::RegionInternal &region);
+  void EraseRegion(uint64_t region_id);
+
+  void PutTaskList(uint64_t task_list_id, const pb::coordinator::TaskList &task_list);
+  void EraseTaskList(uint64_t task_list_id);
+
+  // A region_cmd is pending on store only if it is both in region_cmd_map_ and in the store_operation of the store.
+  void PutRegionCmd(uint64_t region_cmd_id, uint64_t region_id);
+  void EraseRegionCmd(uint64_t region_cmd_id);
+  void PutStoreOperation(const pb::coordinator_internal::StoreOperationInternal &store_operation);
+
+  void Clear();
+
+  uint64_t GetRegionCountByStore(uint64_t store_id);
+  std::vector<uint64_t> GetRegionIdsByTable(uint64_t table_id);
+  std::vector<uint64_t> GetRegionIdsByIndex(uint64_t index_id);
+  std::vector<uint64_t> GetTaskListIdsByRegion(uint64_t region_id);
+  std::vector<uint64_t> GetStoreOperationIdsByRegion(uint64_t region_id);
+
+ private:
+  struct RegionEntry {
+    std::vector<uint64_t> store_ids;
+    uint64_t table_id{0};
+    uint64_t index_id{0};
+  };
+
+  // Must hold mutex_.
+  void EraseRegionInternal(uint64_t region_id);
+  void EraseTaskListInternal(uint64_t task_list_id);
+
+  static void EraseFromSet(std::map<uint64_t, std::set<uint64_t>> &index, uint64_t key, uint64_t value);
+  static std::vector<uint64_t> GetFromSet(const std::map<uint64_t, std::set<uint64_t>> &index, uint64_t key);
+
+  bthread_mutex_t mutex_;
+
+  // region_id -> the keys indexed by this region
+  std::map<uint64_t, RegionEntry> regions_;
+  std::map<uint64_t, std::set<uint64_t>> store_regions_;
+  std::map<uint64_t, std::set<uint64_t>> table_regions_;
+  std::map<uint64_t, std::set<uint64_t>> index_regions_;
+
+  // task_list_id -> region_ids of its region_cmds
+  std::map<uint64_t, std::set<uint64_t>> task_list_regions_;
+  std::map<uint64_t, std::set<uint64_t>> region_task_lists_;
+
+  // region_cmd_id -> region_id
+  std::map<uint64_t, uint64_t> region_cmds_;
+  std::map<uint64_t, std::set<uint64_t>> region_region_cmds_;
+  // store_id -> region_cmd_ids of store_operation
+  std::map<uint64_t, std::set<uint64_t>> store_operation_cmds_;
+  std::map<uint64_t, std::set<uint64_t>> region_cmd_stores_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COORDINATOR_COORDINATOR_META_INDEX_H_
@@ -0,0 +1,242 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coordinator/kv_rev_storage.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/mutex.h"
+#include "butil/scoped_lock.h"
+#include "common/logging.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_uint64(kv_rev_cache_capacity, 100000, "max cached revision count of version kv");
+BRPC_VALIDATE_GFLAG(kv_rev_cache_capacity, brpc::PassValidate);
+
+KvRevStorage::KvRevStorage(std::shared_ptr<MetaReader> meta_reader, const std::string &prefix)
+    : internal_prefix_(std::string("meta_stdmap_safe_string") + prefix), meta_reader_(meta_reader) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+KvRevStorage::~KvRevStorage() { bthread_mutex_destroy(&mutex_); }
+
+pb::common::KeyValue KvRevStorage::TransformToKvValue(const pb::coordinator_internal::KvRevInternal &kv_rev) {
+  pb::common::KeyValue kv;
+  kv.set_key(GenKey(kv_rev.id()));
+  kv.set_value(kv_rev.SerializeAsString());
+
+  return kv;
+}
+
+bool KvRevStorage::GetFromMemory(const std::string &id, pb::coordinator_internal::KvRevInternal &kv_rev,
+                                 bool &is_deleted) {
+  is_deleted = false;
+
+  auto pending_it = pending_write_.find(id);
+  if (pending_it != pending_write_.end()) {
+    if (pending_it->second == nullptr) {
+      is_deleted = true;
+      return false;
+    }
+    kv_rev = *pending_it->second;
+    return true;
+  }
+
+  auto cache_it = cache_map_.find(id);
+  if (cache_it != cache_map_.end()) {
+    cache_list_.splice(cache_list_.begin(), cache_list_, cache_it->second);
+    kv_rev = cache_it->second->second;
+    return true;
+  }
+
+  return false;
+}
+
+void KvRevStorage::PutCache(const std::string &id, const pb::coordinator_internal::KvRevInternal &kv_rev) {
+  EraseCache(id);
+
+  if (FLAGS_kv_rev_cache_capacity == 0) {
+    return;
+  }
+
+  cache_list_.emplace_front(id, kv_rev);
+  cache_map_[id] = cache_list_.begin();
+  cache_memory_size_ += kv_rev.ByteSizeLong();
+
+  while (cache_map_.size() > FLAGS_kv_rev_cache_capacity) {
+    auto &last = cache_list_.back();
+    cache_memory_size_ -= last.second.ByteSizeLong();
+    cache_map_.erase(last.first);
+    cache_list_.pop_back();
+  }
+}
+
+void KvRevStorage::EraseCache(const std::string &id) {
+  auto cache_it = cache_map_.find(id);
+  if (cache_it == cache_map_.end()) {
+    return;
+  }
+
+  cache_memory_size_ -= cache_it->second->second.ByteSizeLong();
+  cache_list_.erase(cache_it->second);
+  cache_map_.erase(cache_it);
+}
+
+int KvRevStorage::Get(const std::string &id, pb::coordinator_internal::KvRevInternal &kv_rev) {
+  uint64_t erase_seq = 0;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    bool is_deleted = false;
+    if (GetFromMemory(id, kv_rev, is_deleted)) {
+      return 1;
+    }
+    if (is_deleted) {
+      return -1;
+    }
+    erase_seq = erase_seq_;
+  }
+
+  auto kv = meta_reader_->Get(GenKey(id));
+  if (kv == nullptr || kv->value().empty()) {
+    return -1;
+  }
+
+  if (!kv_rev.ParseFromString(kv->value())) {
+    DINGO_LOG(ERROR) << "Parse kv_rev failed, id: " << id;
+    return -1;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (erase_seq == erase_seq_) {
+    PutCache(id, kv_rev);
+  }
+
+  return 1;
+}
+
+int KvRevStorage::MultiGet(const std::vector<std::string> &ids,
+                           std::vector<pb::coordinator_internal::KvRevInternal> &kv_revs, std::vector<bool> &exists) {
+  kv_revs.resize(ids.size());
+  exists.resize(ids.size(), false);
+
+  // read the missed ids from meta cf in one batch
+  std::vector<size_t> miss_indexes;
+  std::vector<std::string> miss_keys;
+  uint64_t erase_seq = 0;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    for (size_t i = 0; i < ids.size(); ++i) {
+      bool is_deleted = false;
+      exists[i] = GetFromMemory(ids[i], kv_revs[i], is_deleted);
+      if (!exists[i] && !is_deleted) {
+        miss_indexes.push_back(i);
+        miss_keys.push_back(GenKey(ids[i]));
+      }
+    }
+    erase_seq = erase_seq_;
+  }
+
+  if (miss_keys.empty()) {
+    return 1;
+  }
+
+  std::vector<pb::common::KeyValue> kvs;
+  if (!meta_reader_->MultiGet(miss_keys, kvs)) {
+    return -1;
+  }
+
+  for (size_t i = 0; i < miss_indexes.size(); ++i) {
+    auto index = miss_indexes[i];
+    if (kvs[i].value().empty()) {
+      continue;
+    }
+    if (!kv_revs[index].ParseFromString(kvs[i].value())) {
+      DINGO_LOG(ERROR) << "Parse kv_rev failed, id: " << ids[index];
+      continue;
+    }
+    exists[index] = true;
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (erase_seq == erase_seq_) {
+    for (auto index : miss_indexes) {
+      if (exists[index]) {
+        PutCache(ids[index], kv_revs[index]);
+      }
+    }
+  }
+
+  return 1;
+}
+
+void KvRevStorage::Put(const pb::coordinator_internal::KvRevInternal &kv_rev) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  pending_write_[kv_rev.id()] = std::make_shared<pb::coordinator_internal::KvRevInternal>(kv_rev);
+  // the new revision is the latest revision of the key, it's hot
+  PutCache(kv_rev.id(), kv_rev);
+}
+
+void KvRevStorage::Erase(const std::string &id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  pending_write_[id] = nullptr;
+  EraseCache(id);
+  ++erase_seq_;
+}
+
+void KvRevStorage::AppendPendingWrite(std::vector<pb::common::KeyValue> &kvs_put,
+                                      std::vector<pb::common::KeyValue> &kvs_delete) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  for (const auto &[id, kv_rev] : pending_write_) {
+    if (kv_rev != nullptr) {
+      kvs_put.push_back(TransformToKvValue(*kv_rev));
+    } else {
+      pb::common::KeyValue kv;
+      kv.set_key(GenKey(id));
+      kvs_delete.push_back(kv);
+    }
+  }
+}
+
+void KvRevStorage::ClearPendingWrite() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  pending_write_.clear();
+}
+
+void KvRevStorage::Clear() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  pending_write_.clear();
+  cache_list_.clear();
+  cache_map_.clear();
+  cache_memory_size_ = 0;
+  ++erase_seq_;
+}
+
+uint64_t KvRevStorage::CacheSize() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return cache_map_.size();
+}
+
+uint64_t KvRevStorage::CacheMemorySize() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return cache_memory_size_;
+}
+
+}  // namespace dingodb
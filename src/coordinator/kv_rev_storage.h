@@ -0,0 +1,99 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COORDINATOR_KV_REV_STORAGE_H_
+#define DINGODB_COORDINATOR_KV_REV_STORAGE_H_
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "bthread/types.h"
+#include "meta/meta_reader.h"
+#include "proto/common.pb.h"
+#include "proto/coordinator_internal.pb.h"
+
+namespace dingodb {
+
+// Version kv revision storage, all revisions are stored in meta cf of raw engine,
+// only the hot revisions (mostly the latest revision of keys) are cached in memory with bounded capacity,
+// so the memory not grow with the write history.
+// The revision id is big endian encoded main_sub, so the revisions are ordered by revision in meta cf.
+// The write is pending in memory until the caller persist it with the raft apply index in one write batch.
+// Get() and MultiGet() return 1 if success, return -1 if failed or not found.
+class KvRevStorage {
+ public:
+  KvRevStorage(std::shared_ptr<MetaReader> meta_reader, const std::string &prefix);
+  ~KvRevStorage();
+
+  KvRevStorage(const KvRevStorage &) = delete;
+  const KvRevStorage &operator=(const KvRevStorage &) = delete;
+
+  // Keep the same key format with MetaSafeStringStdMapStorage, so the data of old version can be read.
+  std::string Prefix() { return internal_prefix_; }
+  std::string GenKey(const std::string &id) { return internal_prefix_ + "_" + id; }
+  pb::common::KeyValue TransformToKvValue(const pb::coordinator_internal::KvRevInternal &kv_rev);
+
+  int Get(const std::string &id, pb::coordinator_internal::KvRevInternal &kv_rev);
+  int MultiGet(const std::vector<std::string> &ids, std::vector<pb::coordinator_internal::KvRevInternal> &kv_revs,
+               std::vector<bool> &exists);
+
+  // Only called in state machine apply.
+  void Put(const pb::coordinator_internal::KvRevInternal &kv_rev);
+  void Erase(const std::string &id);
+
+  // Append the pending write to the write batch of apply, and clear pending after the write batch is persisted.
+  void AppendPendingWrite(std::vector<pb::common::KeyValue> &kvs_put, std::vector<pb::common::KeyValue> &kvs_delete);
+  void ClearPendingWrite();
+
+  // Clear the cache and pending write, used when load snapshot.
+  void Clear();
+
+  // Count and memory size of cached revisions.
+  uint64_t CacheSize();
+  uint64_t CacheMemorySize();
+
+ private:
+  using CacheList = std::list<std::pair<std::string, pb::coordinator_internal::KvRevInternal>>;
+
+  // Must hold mutex_.
+  bool GetFromMemory(const std::string &id, pb::coordinator_internal::KvRevInternal &kv_rev, bool &is_deleted);
+  void PutCache(const std::string &id, const pb::coordinator_internal::KvRevInternal &kv_rev);
+  void EraseCache(const std::string &id);
+
+  const std::string internal_prefix_;
+  std::shared_ptr<MetaReader> meta_reader_;
+
+  bthread_mutex_t mutex_;
+
+  // LRU cache, the front is the most recently used.
+  CacheList cache_list_;
+  std::unordered_map<std::string, CacheList::iterator> cache_map_;
+  uint64_t cache_memory_size_{0};
+
+  // Write not persisted yet, nullptr means deleted.
+  std::map<std::string, std::shared_ptr<pb::coordinator_internal::KvRevInternal>> pending_write_;
+
+  // Increase when erase, the read from meta cf is not put into cache if erase happened during the read.
+  uint64_t erase_seq_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COORDINATOR_KV_REV_STORAGE_H_
@@ -70,8 +70,9 @@ void TsoControl::UpdateTimestamp() {
   int64_t last_save = 0;
   {
     BAIDU_SCOPED_LOCK(tso_mutex_);
-    prev_physical = tso_obj_.current_timestamp.physical();
-    prev_logical = tso_obj_.current_timestamp.logical();
+    auto prev = UnpackTimestamp(tso_obj_.current_timestamp.load(std::memory_order_acquire));
+    prev_physical = prev.physical();
+    prev_logical = prev.logical();
     last_save = tso_obj_.last_save_physical;
   }
   int64_t delta = now - prev_physical;
@@ -84,8 +85,8 @@ void TsoControl::UpdateTimestamp() {
   } else if (prev_logical > kMaxLogical / 2) {
     next = prev_physical + kUpdateTimestampGuardMs;
   } else {
-    DINGO_LOG(WARNING) << "don't need update timestamp prev: " << prev_physical << ", now: " << now
-                       << ", save: " << last_save;
+    DINGO_LOG(DEBUG) << "don't need update timestamp prev: " << prev_physical << ", now: " << now
+                     << ", save: " << last_save;
     return;
   }
   int64_t save = last_save;
@@ -137,7 +138,7 @@ int TsoControl::SyncTimestamp(const pb::meta::TsoTimestamp& current_timestamp, i
 void TsoControl::GenTso(const pb::meta::TsoRequest* request, pb::meta::TsoResponse* response) {
   int64_t count = request->count();
   response->set_op_type(request->op_type());
-  if (count == 0) {
+  if (count <= 0) {
     response->mutable_error()->set_errcode(pb::error::Errno::EILLEGAL_PARAMTETERS);
     response->mutable_error()->set_errmsg("tso count should be positive");
     return;
@@ -148,25 +149,25 @@ void TsoControl::GenTso(const pb::meta::TsoRequest* request, pb::meta::TsoRespon
     response->mutable_error()->set_errmsg("timestamp not ok, retry later");
     return;
   }
-  pb::meta::TsoTimestamp current;
+  // allocate [current, current + count) with CAS, the logical part must not overflow
+  int64_t current = 0;
   bool need_retry = false;
   for (size_t i = 0; i < 50; i++) {
-    {
-      BAIDU_SCOPED_LOCK(tso_mutex_);
-      int64_t physical = tso_obj_.current_timestamp.physical();
-      if (physical != 0) {
-        int64_t new_logical = tso_obj_.current_timestamp.logical() + count;
-        if (new_logical < kMaxLogical) {
-          current = tso_obj_.current_timestamp;
-          tso_obj_.current_timestamp.set_logical(new_logical);
-          need_retry = false;
-        } else {
-          DINGO_LOG(WARNING) << "logical part outside of max logical interval, retry later, please check ntp time";
-          need_retry = true;
-        }
-      } else {
+    current = tso_obj_.current_timestamp.load(std::memory_order_acquire);
+    while (true) {
+      if ((current >> kLogicalBits) == 0) {
         DINGO_LOG(WARNING) << "timestamp not ok physical == 0, retry later";
         need_retry = true;
+        break;
+      }
+      if ((current & (kMaxLogical - 1)) + count >= kMaxLogical) {
+        DINGO_LOG(WARNING) << "logical part outside of max logical interval, retry later, please check ntp time";
+        need_retry = true;
+        break;
+      }
+      if (tso_obj_.current_timestamp.compare_exchange_weak(current, current + count, std::memory_order_acq_rel)) {
+        need_retry = false;
+        break;
       }
     }
     if (!need_retry) {
@@ -181,9 +182,7 @@ void TsoControl::GenTso(const pb::meta::TsoRequest* request, pb::meta::TsoRespon
     DINGO_LOG(ERROR) << "gen tso failed";
     return;
   }
-  DINGO_LOG(WARNING) << "gen tso current: (" << current.physical() << ", " << current.logical() << ")";
-  auto* timestamp = response->mutable_start_timestamp();
-  *timestamp = current;
+  *response->mutable_start_timestamp() = UnpackTimestamp(current);
   response->set_count(count);
 }
 
@@ -201,8 +200,7 @@ void TsoControl::Process(google::protobuf::RpcController* controller, const pb::
     // response->set_leader(butil::endpoint2str(_node.leader_id().addr).c_str());
     response->set_system_time(ClockRealtimeMs());
     response->set_save_physical(tso_obj_.last_save_physical);
-    auto* timestamp = response->mutable_start_timestamp();
-    *timestamp = tso_obj_.current_timestamp;
+    *response->mutable_start_timestamp() = UnpackTimestamp(tso_obj_.current_timestamp.load(std::memory_order_acquire));
     return;
   }
   brpc::Controller* cntl = (brpc::Controller*)controller;
@@ -250,16 +248,16 @@ void TsoControl::ResetTso(const pb::meta::TsoRequest& request, pb::meta::TsoResp
   if (request.has_current_timestamp() && request.save_physical() > 0) {
     int64_t physical = request.save_physical();
     const pb::meta::TsoTimestamp& current = request.current_timestamp();
-    if (physical < tso_obj_.last_save_physical || current.physical() < tso_obj_.current_timestamp.physical()) {
+    auto prev = UnpackTimestamp(tso_obj_.current_timestamp.load(std::memory_order_acquire));
+    if (physical < tso_obj_.last_save_physical || current.physical() < prev.physical()) {
       if (!request.force()) {
         DINGO_LOG(WARNING) << "time fallback save_physical:(" << physical << ", " << tso_obj_.last_save_physical
-                           << ") current:(" << current.physical() << ", " << tso_obj_.current_timestamp.physical()
-                           << ", " << current.logical() << ", " << tso_obj_.current_timestamp.logical() << ")";
+                           << ") current:(" << current.physical() << ", " << prev.physical() << ", "
+                           << current.logical() << ", " << prev.logical() << ")";
         if (response) {
           response->mutable_error()->set_errcode(pb::error::Errno::EINTERNAL);
           response->mutable_error()->set_errmsg("time can't fallback");
-          auto* timestamp = response->mutable_start_timestamp();
-          *timestamp = tso_obj_.current_timestamp;
+          *response->mutable_start_timestamp() = prev;
           response->set_save_physical(tso_obj_.last_save_physical);
         }
         return;
@@ -271,7 +269,7 @@ void TsoControl::ResetTso(const pb::meta::TsoRequest& request, pb::meta::TsoResp
     {
       BAIDU_SCOPED_LOCK(tso_mutex_);
       tso_obj_.last_save_physical = physical;
-      tso_obj_.current_timestamp = current;
+      tso_obj_.current_timestamp.store(PackTimestamp(current), std::memory_order_release);
     }
     if (response) {
       response->set_save_physical(physical);
@@ -286,11 +284,12 @@ void TsoControl::ResetTso(const pb::meta::TsoRequest& request, pb::meta::TsoResp
 void TsoControl::UpdateTso(const pb::meta::TsoRequest& request, pb::meta::TsoResponse* response) {
   int64_t physical = request.save_physical();
   const pb::meta::TsoTimestamp& current = request.current_timestamp();
+  auto prev = UnpackTimestamp(tso_obj_.current_timestamp.load(std::memory_order_acquire));
   // can't rollback
-  if (physical < tso_obj_.last_save_physical || current.physical() < tso_obj_.current_timestamp.physical()) {
+  if (physical < tso_obj_.last_save_physical || current.physical() < prev.physical()) {
     DINGO_LOG(WARNING) << "time fallback save_physical:(" << physical << ", " << tso_obj_.last_save_physical
-                       << ") current:(" << current.physical() << ", " << tso_obj_.current_timestamp.physical() << ", "
-                       << current.logical() << ", " << tso_obj_.current_timestamp.logical() << ")";
+                       << ") current:(" << current.physical() << ", " << prev.physical() << ", " << current.logical()
+                       << ", " << prev.logical() << ")";
     if (response) {
       response->mutable_error()->set_errcode(pb::error::Errno::EINTERNAL);
       response->mutable_error()->set_errmsg("time can't fallback");
@@ -300,7 +299,8 @@ void TsoControl::UpdateTso(const pb::meta::TsoRequest& request, pb::meta::TsoRes
   {
     BAIDU_SCOPED_LOCK(tso_mutex_);
     tso_obj_.last_save_physical = physical;
-    tso_obj_.current_timestamp = current;
+    // the timestamps allocated by GenTso before this store are all less than the new physical
+    tso_obj_.current_timestamp.store(PackTimestamp(current), std::memory_order_release);
   }
 
   if (response) {
@@ -322,8 +322,7 @@ TsoControl::TsoControl() {
 bool TsoControl::Init() {
   DINGO_LOG(INFO) << "init";
   tso_update_timer_.init(this, kUpdateTimestampIntervalMs);
-  tso_obj_.current_timestamp.set_physical(0);
-  tso_obj_.current_timestamp.set_logical(0);
+  tso_obj_.current_timestamp.store(0, std::memory_order_release);
   tso_obj_.last_save_physical = 0;
 
   return true;
@@ -17,6 +17,7 @@
 
 #include <braft/repeated_timer_task.h>
 
+#include <atomic>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -45,6 +46,18 @@ inline int64_t ClockRealtimeMs() {
 
 inline uint32_t GetTimestampInternal(int64_t offset) { return ((offset >> 18) + kBaseTimestampMs) / 1000; }
 
+// The timestamp is packed as (physical << kLogicalBits) + logical, so it can be updated with one atomic.
+inline int64_t PackTimestamp(int64_t physical, int64_t logical) { return (physical << kLogicalBits) + logical; }
+inline int64_t PackTimestamp(const pb::meta::TsoTimestamp &timestamp) {
+  return PackTimestamp(timestamp.physical(), timestamp.logical());
+}
+inline pb::meta::TsoTimestamp UnpackTimestamp(int64_t value) {
+  pb::meta::TsoTimestamp timestamp;
+  timestamp.set_physical(value >> kLogicalBits);
+  timestamp.set_logical(value & (kMaxLogical - 1));
+  return timestamp;
+}
+
 class TimeCost {
  public:
   TimeCost() { start_ = butil::gettimeofday_us(); }
@@ -89,7 +102,8 @@ class TsoTimer : public braft::RepeatedTimerTask {
 };
 
 struct TsoObj {
-  pb::meta::TsoTimestamp current_timestamp;
+  // packed current timestamp, GenTso allocates from it with CAS without tso_mutex_
+  std::atomic<int64_t> current_timestamp{0};
   int64_t last_save_physical;
 };
 
@@ -166,7 +180,7 @@ class TsoControl : public MetaControl {
  private:
   TsoTimer tso_update_timer_;
   TsoObj tso_obj_;
-  bthread_mutex_t tso_mutex_;  // for tso_obj_
+  bthread_mutex_t tso_mutex_;  // for update of tso_obj_
   bool is_healty_ = true;
 
   // node is leader or not
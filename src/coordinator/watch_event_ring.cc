@@ -0,0 +1,110 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "coordinator/watch_event_ring.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+
+#include "brpc/reloadable_flags.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_uint64(watch_event_ring_capacity, 10000, "max event count of version kv watch event ring");
+BRPC_VALIDATE_GFLAG(watch_event_ring_capacity, brpc::PositiveInteger);
+
+WatchRange WatchRange::Build(const std::string &key, const std::string &range_end) {
+  WatchRange range;
+  range.start_key = key;
+  if (range_end.empty()) {
+    // the next key of the key is key + '\0'
+    range.end_key = key;
+    range.end_key.push_back('\0');
+  } else if (range_end != std::string(1, '\0')) {
+    range.end_key = range_end;
+  }
+
+  return range;
+}
+
+bool WatchRange::IsSingleKey() const {
+  return end_key.size() == start_key.size() + 1 && end_key.back() == '\0' &&
+         end_key.compare(0, start_key.size(), start_key) == 0;
+}
+
+void WatchEventRing::Append(const pb::version::Event &event) {
+  if (covered_revision_ == 0) {
+    covered_revision_ = event.kv().mod_revision();
+  }
+
+  events_.push_back(event);
+
+  while (events_.size() > FLAGS_watch_event_ring_capacity) {
+    // the events of the same revision may be partially evicted, so only the next revision is covered
+    covered_revision_ = std::max(covered_revision_, static_cast<uint64_t>(events_.front().kv().mod_revision()) + 1);
+    events_.pop_front();
+  }
+}
+
+bool WatchEventRing::Covers(uint64_t start_revision) const {
+  return covered_revision_ > 0 && start_revision >= covered_revision_;
+}
+
+int WatchEventRing::Collect(const WatchRange &range, uint64_t start_revision, bool no_put_event, bool no_delete_event,
+                            bool need_prev_kv, int max_count, pb::version::WatchResponse *response) const {
+  auto it = std::lower_bound(events_.begin(), events_.end(), start_revision,
+                             [](const pb::version::Event &event, uint64_t revision) {
+                               return static_cast<uint64_t>(event.kv().mod_revision()) < revision;
+                             });
+
+  int count = 0;
+  int64_t last_revision = 0;
+  for (; it != events_.end(); ++it) {
+    const auto &event = *it;
+    // not split the events of the same revision, so the watcher can resume from the next revision
+    if (count >= max_count && event.kv().mod_revision() != last_revision) {
+      break;
+    }
+
+    if (no_put_event && event.type() == pb::version::Event::EventType::Event_EventType_PUT) {
+      continue;
+    }
+    if (no_delete_event && event.type() == pb::version::Event::EventType::Event_EventType_DELETE) {
+      continue;
+    }
+    if (!range.Contains(event.kv().kv().key())) {
+      continue;
+    }
+
+    auto *response_event = response->add_events();
+    response_event->set_type(event.type());
+    *response_event->mutable_kv() = event.kv();
+    if (need_prev_kv) {
+      *response_event->mutable_prev_kv() = event.prev_kv();
+    }
+    last_revision = event.kv().mod_revision();
+    ++count;
+  }
+
+  return count;
+}
+
+void WatchEventRing::Clear() {
+  events_.clear();
+  covered_revision_ = 0;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,77 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_COORDINATOR_WATCH_EVENT_RING_H_
+#define DINGODB_COORDINATOR_WATCH_EVENT_RING_H_
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <tuple>
+
+#include "proto/version.pb.h"
+
+namespace dingodb {
+
+// The key range [start_key, end_key) of watch, empty end_key means no upper bound.
+struct WatchRange {
+  std::string start_key;
+  std::string end_key;
+
+  // Same as KvRange, empty range_end means the key itself, '\0' means all keys >= key.
+  static WatchRange Build(const std::string &key, const std::string &range_end);
+
+  bool IsSingleKey() const;
+  bool Contains(const std::string &key) const { return key >= start_key && (end_key.empty() || key < end_key); }
+
+  bool operator<(const WatchRange &other) const {
+    return std::tie(start_key, end_key) < std::tie(other.start_key, other.end_key);
+  }
+};
+
+// Bounded in-memory ring of version kv events ordered by revision, so watch can resume from start_revision
+// without reading storage. The oldest events are evicted when the count exceeds watch_event_ring_capacity.
+// Not thread safe, the caller must hold the lock.
+class WatchEventRing {
+ public:
+  WatchEventRing() = default;
+  ~WatchEventRing() = default;
+
+  WatchEventRing(const WatchEventRing &) = delete;
+  const WatchEventRing &operator=(const WatchEventRing &) = delete;
+
+  // The revision of event must not be less than the revision of the last event.
+  void Append(const pb::version::Event &event);
+
+  // Whether all events with revision >= start_revision are in the ring.
+  bool Covers(uint64_t start_revision) const;
+
+  // Add the events in range with revision >= start_revision to response, at most max_count events
+  // except the events of the same revision are not split. Return the count of added events.
+  int Collect(const WatchRange &range, uint64_t start_revision, bool no_put_event, bool no_delete_event,
+              bool need_prev_kv, int max_count, pb::version::WatchResponse *response) const;
+
+  void Clear();
+
+  uint64_t Size() const { return events_.size(); }
+
+ private:
+  std::deque<pb::version::Event> events_;
+  // All events with revision >= covered_revision_ are in the ring, 0 means the ring is not started.
+  uint64_t covered_revision_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_COORDINATOR_WATCH_EVENT_RING_H_
@@ -14,13 +14,26 @@
 
 #include "crontab/crontab.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+#include "brpc/reloadable_flags.h"
 #include "bthread/bthread.h"
+#include "butil/fast_rand.h"
+#include "butil/time.h"
 #include "common/logging.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "server/server.h"
 
 namespace dingodb {
 
+DEFINE_uint32(crontab_jitter_percent, 10, "random jitter percent of crontab interval, keep crontabs from aligning");
+BRPC_VALIDATE_GFLAG(crontab_jitter_percent, brpc::PassValidate);
+DEFINE_uint32(crontab_max_backoff_times, 8, "max backoff times of crontab interval when crontab overrun the interval");
+BRPC_VALIDATE_GFLAG(crontab_max_backoff_times, brpc::PositiveInteger);
+
 CrontabManager::CrontabManager() { bthread_mutex_init(&mutex_, nullptr); }
 
 CrontabManager::~CrontabManager() { bthread_mutex_destroy(&mutex_); }
@@ -31,20 +44,77 @@ void CrontabManager::Run(void* arg) {
     return;
   }
   if (crontab->immediately) {
-    try {
-      crontab->func(crontab->arg);
-    } catch (...) {
-      DINGO_LOG(ERROR) << fmt::format("[crontab.run][id({}).name({})] crontab happen exception", crontab->id,
-                                      crontab->name);
+    if (crontab->is_running.exchange(true)) {
+      // Last run is not finished, skip this tick instead of piling up.
+      crontab->skip_count << 1;
+      DINGO_LOG(WARNING) << fmt::format("[crontab.run][id({}).name({})] last run not finished, skip.", crontab->id,
+                                        crontab->name);
+    } else {
+      ++crontab->run_count;
+      if (crontab->async) {
+        // Hold the crontab in the bthread, it may be deleted by DeleteCrontab or Destroy while running.
+        auto* crontab_holder = new std::shared_ptr<Crontab>(crontab->shared_from_this());
+        bthread_t tid;
+        const bthread_attr_t attr = BTHREAD_ATTR_NORMAL;
+        int ret = bthread_start_background(
+            &tid, &attr,
+            [](void* arg) -> void* {
+              std::unique_ptr<std::shared_ptr<Crontab>> crontab_holder(static_cast<std::shared_ptr<Crontab>*>(arg));
+              CrontabManager::Execute(crontab_holder->get());
+              return nullptr;
+            },
+            crontab_holder);
+        if (ret != 0) {
+          DINGO_LOG(ERROR) << fmt::format("[crontab.run][id({}).name({})] start bthread failed, ret: {}", crontab->id,
+                                          crontab->name, ret);
+          delete crontab_holder;
+          crontab->is_running = false;
+        }
+      } else {
+        Execute(crontab);
+      }
     }
-    ++crontab->run_count;
   } else {
     crontab->immediately = true;
   }
 
   if (crontab->max_times == 0 || crontab->run_count < crontab->max_times) {
-    bthread_timer_add(&crontab->timer_id, butil::milliseconds_from_now(crontab->interval), &Run, crontab);
+    bthread_timer_add(&crontab->timer_id, butil::milliseconds_from_now(NextInterval(crontab)), &Run, crontab);
+  }
+}
+
+void CrontabManager::Execute(Crontab* crontab) {
+  int64_t start_time = butil::gettimeofday_us();
+  try {
+    crontab->func(crontab->arg);
+  } catch (...) {
+    DINGO_LOG(ERROR) << fmt::format("[crontab.run][id({}).name({})] crontab happen exception", crontab->id,
+                                    crontab->name);
+  }
+  int64_t elapsed_us = butil::gettimeofday_us() - start_time;
+  crontab->latency << elapsed_us;
+
+  // Back off when overrun the interval, so the ticks not pile up.
+  if (elapsed_us > static_cast<int64_t>(crontab->interval * 1000)) {
+    uint32_t backoff_times = std::min(crontab->backoff_times.load() * 2, FLAGS_crontab_max_backoff_times);
+    DINGO_LOG(WARNING) << fmt::format("[crontab.run][id({}).name({})] overrun interval({}ms), elapsed({}us), backoff {}",
+                                      crontab->id, crontab->name, crontab->interval, elapsed_us, backoff_times);
+    crontab->backoff_times = backoff_times;
+  } else {
+    crontab->backoff_times = 1;
   }
+
+  crontab->is_running = false;
+}
+
+uint64_t CrontabManager::NextInterval(Crontab* crontab) {
+  uint64_t interval = crontab->interval * std::max(crontab->backoff_times.load(), static_cast<uint32_t>(1));
+  uint64_t jitter = interval * FLAGS_crontab_jitter_percent / 100;
+  if (jitter == 0) {
+    return interval;
+  }
+
+  return interval - jitter + butil::fast_rand_less_than(jitter * 2 + 1);
 }
 
 uint32_t CrontabManager::AllocCrontabId() { return auinc_crontab_id_.fetch_add(1); }
@@ -68,23 +138,8 @@ void CrontabManager::AddCrontab(std::vector<CrontabConfig>& crontab_configs) {
     auto crontab = std::make_shared<Crontab>();
     crontab->name = crontab_config.name;
     crontab->interval = crontab_config.interval;
-    if (crontab_config.async) {
-      crontab->func = [&](void*) {
-        bthread_t tid;
-        const bthread_attr_t attr = BTHREAD_ATTR_NORMAL;
-        bthread_start_background(
-            &tid, &attr,
-            [](void* arg) -> void* {
-              CrontabConfig* crontab_config = static_cast<CrontabConfig*>(arg);
-              crontab_config->funcer(nullptr);
-              return nullptr;
-            },
-            &crontab_config);
-      };
-    } else {
-      crontab->func = crontab_config.funcer;
-    }
-
+    crontab->async = crontab_config.async;
+    crontab->func = crontab_config.funcer;
     crontab->arg = nullptr;
 
     this->AddAndRunCrontab(crontab);
@@ -103,6 +158,10 @@ uint32_t CrontabManager::AddCrontab(std::shared_ptr<Crontab> crontab) {
 
   uint32_t crontab_id = AllocCrontabId();
   crontab->id = crontab_id;
+  if (!crontab->name.empty()) {
+    crontab->latency.expose("dingo_crontab", crontab->name);
+    crontab->skip_count.expose_as("dingo_crontab", crontab->name + "_skip_count");
+  }
 
   crontabs_[crontab_id] = crontab;
   return crontab_id;
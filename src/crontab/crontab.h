@@ -25,6 +25,8 @@
 #include <vector>
 
 #include "bthread/unstable.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
 #include "proto/common.pb.h"
 
 namespace dingodb {
@@ -37,7 +39,8 @@ struct CrontabConfig {
   std::function<void(void*)> funcer;
 };
 
-class Crontab {
+// Crontab is always owned by shared_ptr, so the async run can hold it after the crontab is deleted.
+class Crontab : public std::enable_shared_from_this<Crontab> {
  public:
   Crontab()
       : id(0),
@@ -48,7 +51,10 @@ class Crontab {
         pause(false),
         timer_id(0),
         func(nullptr),
-        arg(nullptr) {}
+        arg(nullptr),
+        async(false),
+        is_running(false),
+        backoff_times(1) {}
 
   uint32_t id;
   std::string name;
@@ -68,6 +74,15 @@ class Crontab {
   std::function<void(void*)> func;
   // Delivery to func_'s argument
   void* arg;
+  // Run func in background bthread, not block the timer thread
+  bool async;
+  // Is func running, the tick is skipped if last run is not finished
+  std::atomic<bool> is_running;
+  // The next run is delayed interval * backoff_times, doubled when func overrun the interval
+  std::atomic<uint32_t> backoff_times;
+  // Metrics of func, exposed as dingo_crontab_{name}_*
+  bvar::LatencyRecorder latency;
+  bvar::Adder<uint64_t> skip_count;
 };
 
 // Manage crontab use brpc::bthread_timer_add
@@ -95,6 +110,11 @@ class CrontabManager {
   // Allocate crontab id by auto incremental.
   uint32_t AllocCrontabId();
 
+  // Execute func and update backoff and metrics, is_running must be set before call.
+  static void Execute(Crontab* crontab);
+  // The delay of next run with backoff and jitter.
+  static uint64_t NextInterval(Crontab* crontab);
+
   void InnerPauseCrontab(uint32_t crontab_id);
 
   // Atomic auto incremental variable
@@ -0,0 +1,99 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "engine/checkpoint_manager.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "butil/memory/singleton.h"
+#include "butil/time.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+
+namespace dingodb {
+
+SharedCheckpoint::~SharedCheckpoint() {
+  DINGO_LOG(INFO) << fmt::format("[checkpoint] release shared checkpoint, path: {}", path_);
+  Helper::RemoveAllFileOrDirectory(path_);
+}
+
+CheckpointManager::CheckpointManager()
+    : create_latency_metrics_("raft_snapshot_checkpoint_create"),
+      create_count_metrics_("raft_snapshot_checkpoint_create_count"),
+      reuse_count_metrics_("raft_snapshot_checkpoint_reuse_count") {}
+
+CheckpointManager* CheckpointManager::GetInstance() { return Singleton<CheckpointManager>::get(); }
+
+butil::Status CheckpointManager::Acquire(std::shared_ptr<RawRocksEngine> raw_engine,
+                                         const std::string& checkpoint_root_path, SharedCheckpointPtr& checkpoint) {
+  int64_t request_time_us = butil::gettimeofday_us();
+
+  int64_t create_time_us = 0;
+  {
+    std::unique_lock<bthread::Mutex> lock(mutex_);
+    for (;;) {
+      // The checkpoint start create after request, include all data before request.
+      checkpoint = current_checkpoint_.lock();
+      if (checkpoint != nullptr && checkpoint->CreateTimeUs() >= request_time_us) {
+        reuse_count_metrics_ << 1;
+        return butil::Status();
+      }
+
+      if (!is_creating_) {
+        break;
+      }
+      cond_.wait(lock);
+    }
+
+    is_creating_ = true;
+    // Make sure the create time is after every request time which wait for this checkpoint.
+    create_time_us = butil::gettimeofday_us();
+  }
+
+  std::string path = fmt::format("{}/shared_{}", checkpoint_root_path, create_time_us);
+  std::vector<pb::store_internal::SstFileInfo> sst_files;
+  auto status = raw_engine->NewCheckpoint()->Create(path, raw_engine->GetColumnFamilies(), sst_files);
+  int64_t elapsed_us = butil::gettimeofday_us() - create_time_us;
+
+  checkpoint = nullptr;
+  if (status.ok()) {
+    checkpoint = std::make_shared<SharedCheckpoint>(path, create_time_us, std::move(sst_files));
+    create_latency_metrics_ << elapsed_us;
+    create_count_metrics_ << 1;
+    DINGO_LOG(INFO) << fmt::format("[checkpoint] create shared checkpoint, path: {} elapsed time: {}us", path,
+                                   elapsed_us);
+  } else {
+    DINGO_LOG(ERROR) << fmt::format("[checkpoint] create shared checkpoint failed, path: {} error: {} {}", path,
+                                    status.error_code(), status.error_str());
+    Helper::RemoveAllFileOrDirectory(path);
+  }
+
+  {
+    std::unique_lock<bthread::Mutex> lock(mutex_);
+    is_creating_ = false;
+    if (checkpoint != nullptr) {
+      current_checkpoint_ = checkpoint;
+    }
+  }
+  cond_.notify_all();
+
+  return status;
+}
+
+}  // namespace dingodb
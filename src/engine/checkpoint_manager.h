@@ -0,0 +1,96 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_ENGINE_CHECKPOINT_MANAGER_H_
+#define DINGODB_ENGINE_CHECKPOINT_MANAGER_H_
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "butil/status.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
+#include "engine/raw_rocks_engine.h"
+#include "proto/store_internal.pb.h"
+
+template <typename T>
+struct DefaultSingletonTraits;
+
+namespace dingodb {
+
+// Checkpoint of all column families shared by the raft snapshot of multiple regions,
+// the checkpoint directory is removed when the last user release it.
+class SharedCheckpoint {
+ public:
+  SharedCheckpoint(const std::string& path, int64_t create_time_us,
+                   std::vector<pb::store_internal::SstFileInfo> sst_files)
+      : path_(path), create_time_us_(create_time_us), sst_files_(std::move(sst_files)) {}
+  ~SharedCheckpoint();
+
+  SharedCheckpoint(const SharedCheckpoint&) = delete;
+  const SharedCheckpoint& operator=(const SharedCheckpoint&) = delete;
+
+  const std::string& Path() const { return path_; }
+  // The time of start create checkpoint, all writes before this time are in checkpoint.
+  int64_t CreateTimeUs() const { return create_time_us_; }
+  const std::vector<pb::store_internal::SstFileInfo>& SstFiles() const { return sst_files_; }
+
+ private:
+  std::string path_;
+  int64_t create_time_us_;
+  std::vector<pb::store_internal::SstFileInfo> sst_files_;
+};
+
+using SharedCheckpointPtr = std::shared_ptr<SharedCheckpoint>;
+
+// Create checkpoint for raft snapshot, the concurrent snapshots of many regions share one checkpoint,
+// avoid every region snapshot flush memtable and hard link all sst files.
+// A checkpoint is only shared by the snapshots which request before the checkpoint start create,
+// so the snapshot always include all the applied data of region.
+class CheckpointManager {
+ public:
+  static CheckpointManager* GetInstance();
+
+  CheckpointManager(const CheckpointManager&) = delete;
+  const CheckpointManager& operator=(const CheckpointManager&) = delete;
+
+  // Get a checkpoint which start create after this call, wait if another checkpoint is creating.
+  butil::Status Acquire(std::shared_ptr<RawRocksEngine> raw_engine, const std::string& checkpoint_root_path,
+                        SharedCheckpointPtr& checkpoint);
+
+ private:
+  CheckpointManager();
+  ~CheckpointManager() = default;
+
+  friend struct DefaultSingletonTraits<CheckpointManager>;
+
+  bthread::Mutex mutex_;
+  bthread::ConditionVariable cond_;
+  bool is_creating_{false};
+  // Not hold the checkpoint, it is released by the last user.
+  std::weak_ptr<SharedCheckpoint> current_checkpoint_;
+
+  // the cost of flush memtable and hard link sst files
+  bvar::LatencyRecorder create_latency_metrics_;
+  bvar::Adder<uint64_t> create_count_metrics_;
+  bvar::Adder<uint64_t> reuse_count_metrics_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_ENGINE_CHECKPOINT_MANAGER_H_
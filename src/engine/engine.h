@@ -130,7 +130,7 @@ class Engine {
   };
 
   virtual std::shared_ptr<Reader> NewReader(const std::string& cf_name) = 0;
-  virtual std::shared_ptr<VectorReader> NewVectorReader(const std::string&) {
+  virtual std::shared_ptr<VectorReader> NewVectorReader() {
     DINGO_LOG(ERROR) << "Not support NewVectorReader.";
     return nullptr;
   }
@@ -365,7 +365,7 @@ butil::Status RaftStoreEngine::AsyncWrite(std::shared_ptr<Context> ctx, std::sha
   }
 
   ctx->SetWriteCb(cb);
-  return node->Commit(ctx, GenRaftCmdRequest(ctx, write_data));
+  return node->AsyncCommit(ctx, GenRaftCmdRequest(ctx, write_data));
 }
 
 butil::Status RaftStoreEngine::Reader::KvGet(std::shared_ptr<Context> /*ctx*/, const std::string& key,
@@ -389,25 +389,25 @@ std::shared_ptr<Engine::Reader> RaftStoreEngine::NewReader(const std::string& cf
 
 butil::Status RaftStoreEngine::VectorReader::VectorBatchSearch(
     std::shared_ptr<VectorReader::Context> ctx, std::vector<pb::index::VectorWithDistanceResult>& results) {
-  auto vector_reader = dingodb::VectorReader::New(reader_);
+  auto vector_reader = dingodb::VectorReader::New(vector_data_reader_, scalar_data_reader_, table_data_reader_);
   return vector_reader->VectorBatchSearch(ctx, results);
 }
 
 butil::Status RaftStoreEngine::VectorReader::VectorBatchQuery(std::shared_ptr<VectorReader::Context> ctx,
                                                               std::vector<pb::common::VectorWithId>& vector_with_ids) {
-  auto vector_reader = dingodb::VectorReader::New(reader_);
+  auto vector_reader = dingodb::VectorReader::New(vector_data_reader_, scalar_data_reader_, table_data_reader_);
   return vector_reader->VectorBatchQuery(ctx, vector_with_ids);
 }
 
 butil::Status RaftStoreEngine::VectorReader::VectorGetBorderId(const pb::common::Range& region_range, bool get_min,
                                                                uint64_t& vector_id) {
-  auto vector_reader = dingodb::VectorReader::New(reader_);
+  auto vector_reader = dingodb::VectorReader::New(vector_data_reader_, scalar_data_reader_, table_data_reader_);
   return vector_reader->VectorGetBorderId(region_range, get_min, vector_id);
 }
 
 butil::Status RaftStoreEngine::VectorReader::VectorScanQuery(std::shared_ptr<VectorReader::Context> ctx,
                                                              std::vector<pb::common::VectorWithId>& vector_with_ids) {
-  auto vector_reader = dingodb::VectorReader::New(reader_);
+  auto vector_reader = dingodb::VectorReader::New(vector_data_reader_, scalar_data_reader_, table_data_reader_);
   return vector_reader->VectorScanQuery(ctx, vector_with_ids);
 }
 
@@ -415,12 +415,12 @@ butil::Status RaftStoreEngine::VectorReader::VectorGetRegionMetrics(uint64_t reg
                                                                     const pb::common::Range& region_range,
                                                                     VectorIndexWrapperPtr vector_index,
                                                                     pb::common::VectorIndexMetrics& region_metrics) {
-  auto vector_reader = dingodb::VectorReader::New(reader_);
+  auto vector_reader = dingodb::VectorReader::New(vector_data_reader_, scalar_data_reader_, table_data_reader_);
   return vector_reader->VectorGetRegionMetrics(region_id, region_range, vector_index, region_metrics);
 }
 
 butil::Status RaftStoreEngine::VectorReader::VectorCount(const pb::common::Range& range, uint64_t& count) {
-  auto vector_reader = dingodb::VectorReader::New(reader_);
+  auto vector_reader = dingodb::VectorReader::New(vector_data_reader_, scalar_data_reader_, table_data_reader_);
   return vector_reader->VectorCount(range, count);
 }
 
@@ -428,13 +428,15 @@ butil::Status RaftStoreEngine::VectorReader::VectorBatchSearchDebug(
     std::shared_ptr<VectorReader::Context> ctx,  // NOLINT
     std::vector<pb::index::VectorWithDistanceResult>& results, int64_t& deserialization_id_time_us,
     int64_t& scan_scalar_time_us, int64_t& search_time_us) {
-  auto vector_reader = dingodb::VectorReader::New(reader_);
+  auto vector_reader = dingodb::VectorReader::New(vector_data_reader_, scalar_data_reader_, table_data_reader_);
   return vector_reader->VectorBatchSearchDebug(ctx, results, deserialization_id_time_us, scan_scalar_time_us,
                                                search_time_us);
 }
 
-std::shared_ptr<Engine::VectorReader> RaftStoreEngine::NewVectorReader(const std::string& cf_name) {
-  return std::make_shared<RaftStoreEngine::VectorReader>(engine_->NewReader(cf_name));
+std::shared_ptr<Engine::VectorReader> RaftStoreEngine::NewVectorReader() {
+  return std::make_shared<RaftStoreEngine::VectorReader>(engine_->NewReader(Constant::kVectorDataCF),
+                                                         engine_->NewReader(Constant::kVectorScalarCF),
+                                                         engine_->NewReader(Constant::kVectorTableCF));
 }
 
 }  // namespace dingodb
@@ -123,7 +123,12 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
   // Vector reader
   class VectorReader : public Engine::VectorReader {
    public:
-    VectorReader(std::shared_ptr<RawEngine::Reader> reader) : reader_(reader) {}
+    VectorReader(std::shared_ptr<RawEngine::Reader> vector_data_reader,
+                 std::shared_ptr<RawEngine::Reader> scalar_data_reader,
+                 std::shared_ptr<RawEngine::Reader> table_data_reader)
+        : vector_data_reader_(vector_data_reader),
+          scalar_data_reader_(scalar_data_reader),
+          table_data_reader_(table_data_reader) {}
 
     butil::Status VectorBatchSearch(std::shared_ptr<VectorReader::Context> ctx,                           // NOLINT
                                     std::vector<pb::index::VectorWithDistanceResult>& results) override;  // NOLINT
@@ -145,10 +150,12 @@ class RaftStoreEngine : public Engine, public RaftControlAble {
                                          int64_t& search_time_us) override;  // NOLINT
 
    private:
-    std::shared_ptr<RawEngine::Reader> reader_;
+    std::shared_ptr<RawEngine::Reader> vector_data_reader_;
+    std::shared_ptr<RawEngine::Reader> scalar_data_reader_;
+    std::shared_ptr<RawEngine::Reader> table_data_reader_;
   };
 
-  std::shared_ptr<Engine::VectorReader> NewVectorReader(const std::string& cf_name) override;
+  std::shared_ptr<Engine::VectorReader> NewVectorReader() override;
 
  protected:
   std::shared_ptr<RawEngine> engine_;                   // NOLINT
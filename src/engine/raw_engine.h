@@ -18,6 +18,7 @@
 #include <sys/types.h>
 
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -74,6 +75,10 @@ class RawEngine {
     virtual butil::Status KvGet(const std::string& key, std::string& value) = 0;
     virtual butil::Status KvGet(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& key,
                                 std::string& value) = 0;
+    // Get multiple keys in one batch, values[i] and statuses[i] is the result of keys[i],
+    // statuses[i] is EKEY_NOT_FOUND if keys[i] not exist. The sorted keys is faster.
+    virtual butil::Status KvBatchGet(const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                     std::vector<butil::Status>& statuses) = 0;
 
     virtual butil::Status KvScan(const std::string& start_key, const std::string& end_key,
                                  std::vector<pb::common::KeyValue>& kvs) = 0;
@@ -138,13 +143,19 @@ class RawEngine {
   virtual std::shared_ptr<Reader> NewReader(const std::string& cf_name) = 0;
   virtual std::shared_ptr<RawEngine::Writer> NewWriter(const std::string& cf_name) = 0;
   virtual std::shared_ptr<Iterator> NewIterator(const std::string& cf_name, IteratorOptions options) = 0;
+  // cf_names[i] is the column family of ranges[i].
   virtual std::shared_ptr<MultipleRangeIterator> NewMultipleRangeIterator(
-      std::shared_ptr<RawEngine> raw_engine, const std::string& cf_name,
+      std::shared_ptr<RawEngine> raw_engine, const std::vector<std::string>& cf_names,
       std::vector<dingodb::pb::common::Range> ranges) = 0;
 
   virtual std::vector<uint64_t> GetApproximateSizes(const std::string& cf_name,
                                                     std::vector<pb::common::Range>& ranges) = 0;
 
+  // Put and delete on multiple column families in one atomic batch.
+  virtual butil::Status MultiCfPutAndDelete(
+      const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
+      const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) = 0;
+
  protected:
   RawEngine() = default;
 };
@@ -51,6 +51,8 @@
 #include "rocksdb/table.h"
 #include "rocksdb/write_batch.h"
 #include "server/server.h"
+#include "store/background_task_scheduler.h"
+#include "store/memory_governor.h"
 
 namespace dingodb {
 
@@ -222,6 +224,8 @@ bool RawRocksEngine::Init(std::shared_ptr<Config> config) {
 
   SetDefaultIfNotExist(column_families);
 
+  SetVectorCfIfNotExist(column_families);
+
   InitCfConfig(column_families);
 
   SetColumnFamilyFromConfig(config, column_families);
@@ -249,15 +253,31 @@ std::shared_ptr<Snapshot> RawRocksEngine::GetSnapshot() {
 }
 
 butil::Status RawRocksEngine::MergeCheckpointFile(const std::string& path, const pb::common::Range& range,
-                                                  std::string& merge_sst_path) {
+                                                  const std::string& cf_name, std::string& merge_sst_path) {
   rocksdb::Options options;
   options.create_if_missing = false;
 
+  // The checkpoint of old version maybe not contain the column family.
+  std::vector<std::string> cf_names;
+  auto status = rocksdb::DB::ListColumnFamilies(options, path, &cf_names);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("Rocksdb list column families failed, {}", status.ToString())
+                       << ", path: " << path;
+    return butil::Status(pb::error::EINTERNAL,
+                         fmt::format("Rocksdb list column families failed, {}", status.ToString()));
+  }
+  if (std::find(cf_names.begin(), cf_names.end(), cf_name) == cf_names.end()) {
+    return butil::Status(pb::error::ENO_ENTRIES, "Not found column family %s", cf_name.c_str());
+  }
+
   std::vector<rocksdb::ColumnFamilyDescriptor> column_families = {
       rocksdb::ColumnFamilyDescriptor(Constant::kStoreDataCF, rocksdb::ColumnFamilyOptions())};
+  if (cf_name != Constant::kStoreDataCF) {
+    column_families.push_back(rocksdb::ColumnFamilyDescriptor(cf_name, rocksdb::ColumnFamilyOptions()));
+  }
 
   // Due to delete other region sst file, so need repair db, or rocksdb::DB::Open will fail.
-  auto status = rocksdb::RepairDB(path, options, column_families);
+  status = rocksdb::RepairDB(path, options, column_families, rocksdb::ColumnFamilyOptions());
   if (!status.ok()) {
     DINGO_LOG(WARNING) << fmt::format("Rocksdb Repair db failed, {}", status.ToString()) << ", path: " << path;
     return butil::Status(pb::error::EINTERNAL, fmt::format("Rocksdb Repair db failed, {}", status.ToString()));
@@ -279,8 +299,8 @@ butil::Status RawRocksEngine::MergeCheckpointFile(const std::string& path, const
   rocksdb::ReadOptions read_options;
   read_options.auto_prefix_mode = true;
 
-  auto iter =
-      std::make_shared<RawRocksEngine::Iterator>(iter_options, snapshot_db->NewIterator(read_options, handles[0]));
+  auto iter = std::make_shared<RawRocksEngine::Iterator>(
+      iter_options, snapshot_db->NewIterator(read_options, handles[column_families.size() - 1]));
   iter->Seek(range.start_key());
 
   // Create sst writer
@@ -355,8 +375,9 @@ std::shared_ptr<dingodb::Iterator> RawRocksEngine::NewIterator(const std::string
 }
 
 std::shared_ptr<dingodb::MultipleRangeIterator> RawRocksEngine::NewMultipleRangeIterator(
-    std::shared_ptr<RawEngine> raw_engine, const std::string& cf_name, std::vector<dingodb::pb::common::Range> ranges) {
-  return std::make_shared<MultipleRangeIterator>(raw_engine, cf_name, ranges);
+    std::shared_ptr<RawEngine> raw_engine, const std::vector<std::string>& cf_names,
+    std::vector<dingodb::pb::common::Range> ranges) {
+  return std::make_shared<MultipleRangeIterator>(raw_engine, cf_names, ranges);
 }
 
 std::shared_ptr<RawRocksEngine::SstFileWriter> RawRocksEngine::NewSstFileWriter() {
@@ -387,6 +408,16 @@ std::shared_ptr<RawRocksEngine::ColumnFamily> RawRocksEngine::GetColumnFamily(co
   return iter->second;
 }
 
+std::vector<std::shared_ptr<RawRocksEngine::ColumnFamily>> RawRocksEngine::GetColumnFamilies() {
+  std::vector<std::shared_ptr<ColumnFamily>> column_families;
+  column_families.reserve(column_families_.size());
+  for (const auto& [_, column_family] : column_families_) {
+    column_families.push_back(column_family);
+  }
+
+  return column_families;
+}
+
 std::vector<uint64_t> RawRocksEngine::GetApproximateSizes(const std::string& cf_name,
                                                           std::vector<pb::common::Range>& ranges) {
   rocksdb::SizeApproximationOptions options;
@@ -409,6 +440,103 @@ std::vector<uint64_t> RawRocksEngine::GetApproximateSizes(const std::string& cf_
   return result;
 }
 
+std::vector<pb::common::Range> RawRocksEngine::SplitRangeBySstFile(const std::string& cf_name,
+                                                                  const pb::common::Range& range,
+                                                                  uint64_t target_size) {
+  std::vector<rocksdb::LiveFileMetaData> files;
+  db_->GetLiveFilesMetaData(&files);
+
+  // start key of sst file in range -> size of sst files, the data of sst file is regarded as all in range.
+  std::map<std::string, uint64_t> boundaries;
+  for (const auto& file : files) {
+    if (file.column_family_name != cf_name || file.largestkey < range.start_key() ||
+        file.smallestkey >= range.end_key()) {
+      continue;
+    }
+
+    boundaries[std::max(file.smallestkey, range.start_key())] += file.size;
+  }
+
+  std::vector<pb::common::Range> sub_ranges;
+  std::string start_key = range.start_key();
+  uint64_t size = 0;
+  for (const auto& [key, file_size] : boundaries) {
+    if (size >= target_size && key > start_key) {
+      pb::common::Range sub_range;
+      sub_range.set_start_key(start_key);
+      sub_range.set_end_key(key);
+      sub_ranges.push_back(sub_range);
+
+      start_key = key;
+      size = 0;
+    }
+    size += file_size;
+  }
+
+  pb::common::Range sub_range;
+  sub_range.set_start_key(start_key);
+  sub_range.set_end_key(range.end_key());
+  sub_ranges.push_back(sub_range);
+
+  return sub_ranges;
+}
+
+butil::Status RawRocksEngine::MultiCfPutAndDelete(
+    const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
+    const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) {
+  rocksdb::WriteBatch batch;
+  for (const auto& [cf_name, kv_puts] : kv_puts_with_cf) {
+    auto column_family = GetColumnFamily(cf_name);
+    if (BAIDU_UNLIKELY(column_family == nullptr)) {
+      DINGO_LOG(ERROR) << fmt::format("column family {} not found", cf_name);
+      return butil::Status(pb::error::EINTERNAL, "Not found column family %s", cf_name.c_str());
+    }
+
+    for (const auto& kv : kv_puts) {
+      if (BAIDU_UNLIKELY(kv.key().empty())) {
+        DINGO_LOG(ERROR) << fmt::format("key empty not support");
+        return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+      }
+
+      rocksdb::Status s = batch.Put(column_family->GetHandle(), kv.key(), kv.value());
+      if (BAIDU_UNLIKELY(!s.ok())) {
+        DINGO_LOG(ERROR) << fmt::format("rocksdb::WriteBatch::Put failed : {}", s.ToString());
+        return butil::Status(pb::error::EINTERNAL, "Internal put error");
+      }
+    }
+  }
+
+  for (const auto& [cf_name, keys] : kv_deletes_with_cf) {
+    auto column_family = GetColumnFamily(cf_name);
+    if (BAIDU_UNLIKELY(column_family == nullptr)) {
+      DINGO_LOG(ERROR) << fmt::format("column family {} not found", cf_name);
+      return butil::Status(pb::error::EINTERNAL, "Not found column family %s", cf_name.c_str());
+    }
+
+    for (const auto& key : keys) {
+      if (BAIDU_UNLIKELY(key.empty())) {
+        DINGO_LOG(ERROR) << fmt::format("key empty not support");
+        return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+      }
+
+      rocksdb::Status s = batch.Delete(column_family->GetHandle(), key);
+      if (BAIDU_UNLIKELY(!s.ok())) {
+        DINGO_LOG(ERROR) << fmt::format("rocksdb::WriteBatch::Delete failed : {}", s.ToString());
+        return butil::Status(pb::error::EINTERNAL, "Internal delete error");
+      }
+    }
+  }
+
+  rocksdb::WriteOptions write_options;
+  rocksdb::Status s = db_->Write(write_options, &batch);
+  if (!s.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("rocksdb::DB::Write failed : {}", s.ToString());
+    return butil::Status(pb::error::EINTERNAL, "Internal write error");
+  }
+
+  return butil::Status();
+}
+
 template <typename T>
 void SetCfConfigurationElement(const std::map<std::string, std::string>& cf_configuration, const char* name,
                                const T& default_value, T& value) {  // NOLINT
@@ -483,8 +611,21 @@ bool RawRocksEngine::InitCfConfig(const std::vector<std::string>& column_familie
   dcf_default_conf.emplace(Constant::kMaxBytesForLevelMultiplier, std::make_optional(static_cast<int64_t>(10)));
 
   for (const auto& cf_name : column_families) {
+    auto cf_default_conf = dcf_default_conf;
+    if (cf_name == Constant::kVectorDataCF) {
+      // vector data is large and mostly read by bulk scan, e.g. build index.
+      cf_default_conf[Constant::kBlockSize] = std::make_optional(static_cast<int64_t>(262144));
+    } else if (cf_name == Constant::kVectorScalarCF) {
+      // scalar data is small and mostly read by point lookup, e.g. scalar filter.
+      cf_default_conf[Constant::kBlockSize] = std::make_optional(static_cast<int64_t>(16384));
+    } else if (cf_name == Constant::kVectorTableCF) {
+      // table data is rarely read.
+      cf_default_conf[Constant::kBlockSize] = std::make_optional(static_cast<int64_t>(65536));
+      cf_default_conf[Constant::kWriteBufferSize] = std::make_optional(static_cast<int64_t>(33554432));
+    }
+
     std::map<std::string, std::string> conf;
-    column_families_.emplace(cf_name, std::make_shared<ColumnFamily>(cf_name, dcf_default_conf, conf));
+    column_families_.emplace(cf_name, std::make_shared<ColumnFamily>(cf_name, cf_default_conf, conf));
   }
 
   return true;
@@ -502,8 +643,14 @@ bool RawRocksEngine::SetCfConfiguration(const CfDefaultConf& default_conf,
   SetCfConfigurationElementWrapper(default_conf, cf_configuration, Constant::kBlockSize.c_str(),
                                    table_options.block_size);
 
-  // block_cache
-  {
+  // block_cache, all column families share the block cache of memory governor if exist.
+  auto block_cache = MemoryGovernor::GetInstance()->GetBlockCache();
+  if (block_cache != nullptr) {
+    table_options.block_cache = block_cache;
+    table_options.cache_index_and_filter_blocks = MemoryGovernor::GetInstance()->IsCacheIndexAndFilterBlocks();
+    table_options.cache_index_and_filter_blocks_with_high_priority = true;
+    table_options.pin_l0_filter_and_index_blocks_in_cache = true;
+  } else {
     size_t value = 0;
 
     SetCfConfigurationElementWrapper(default_conf, cf_configuration, Constant::kBlockCache.c_str(), value);
@@ -565,10 +712,6 @@ bool RawRocksEngine::SetCfConfiguration(const CfDefaultConf& default_conf,
 
   cf_options.prefix_extractor.reset(rocksdb::NewCappedPrefixTransform(8));
 
-  auto compressed_block_cache = rocksdb::NewLRUCache(1024 * 1024 * 1024);  // LRUcache
-
-  // table_options.block_cache_compressed.reset(compressed_block_cache);
-
   rocksdb::TableFactory* table_factory = NewBlockBasedTableFactory(table_options);
   cf_options.table_factory.reset(table_factory);
 
@@ -596,6 +739,26 @@ void RawRocksEngine::SetDefaultIfNotExist(std::vector<std::string>& column_famil
   }
 }
 
+void RawRocksEngine::SetVectorCfIfNotExist(std::vector<std::string>& column_families) {
+  for (const auto& cf_name : {Constant::kVectorDataCF, Constant::kVectorScalarCF, Constant::kVectorTableCF}) {
+    if (std::find(column_families.begin(), column_families.end(), cf_name) == column_families.end()) {
+      column_families.push_back(cf_name);
+    }
+  }
+}
+
+void RawRocksEngine::SetCfCompression(const std::string& cf_name, rocksdb::ColumnFamilyOptions* family_options) {
+  if (cf_name == Constant::kVectorDataCF) {
+    // float vector is almost incompressible, compression only waste cpu.
+    family_options->compression_per_level.assign(family_options->compression_per_level.size(),
+                                                 rocksdb::CompressionType::kNoCompression);
+  } else if (cf_name == Constant::kVectorTableCF) {
+    // table data is cold, trade cpu for disk space.
+    family_options->compression_per_level.assign(family_options->compression_per_level.size(),
+                                                 rocksdb::CompressionType::kZSTD);
+  }
+}
+
 void RawRocksEngine::CreateNewMap(const std::map<std::string, std::string>& base,
                                   const std::map<std::string, std::string>& cf,
                                   std::map<std::string, std::string>& new_cf) {
@@ -632,6 +795,7 @@ bool RawRocksEngine::RocksdbInit(std::shared_ptr<Config> config, const std::stri
     rocksdb::ColumnFamilyOptions family_options;
     SetCfConfiguration(column_families_[column_family]->GetDefaultConf(), column_families_[column_family]->GetConf(),
                        &family_options);
+    SetCfCompression(column_family, &family_options);
 
     column_families.push_back(rocksdb::ColumnFamilyDescriptor(column_family, family_options));
   }
@@ -642,6 +806,10 @@ bool RawRocksEngine::RocksdbInit(std::shared_ptr<Config> config, const std::stri
   db_options.max_background_jobs = GetBackgroundThreadNum(config);
   db_options.max_subcompactions = db_options.max_background_jobs / 4 * 3;
   db_options.stats_dump_period_sec = GetStatsDumpPeriodSec(config);
+  // memtable of all column families is limited by memory governor.
+  db_options.write_buffer_manager = MemoryGovernor::GetInstance()->GetWriteBufferManager();
+  // flush and compaction io is limited by background task scheduler.
+  db_options.rate_limiter = BackgroundTaskScheduler::GetInstance()->GetRocksdbRateLimiter();
 
   rocksdb::DB* db;
   rocksdb::Status s = rocksdb::DB::Open(db_options, db_path, column_families, &family_handles, &db);
@@ -767,6 +935,42 @@ butil::Status RawRocksEngine::Reader::KvGet(std::shared_ptr<dingodb::Snapshot> s
   return butil::Status();
 }
 
+butil::Status RawRocksEngine::Reader::KvBatchGet(const std::vector<std::string>& keys, std::vector<std::string>& values,
+                                                 std::vector<butil::Status>& statuses) {
+  std::vector<rocksdb::Slice> key_slices;
+  key_slices.reserve(keys.size());
+  for (const auto& key : keys) {
+    if (BAIDU_UNLIKELY(key.empty())) {
+      DINGO_LOG(ERROR) << fmt::format("key empty not support");
+      return butil::Status(pb::error::EKEY_EMPTY, "Key is empty");
+    }
+    key_slices.emplace_back(key);
+  }
+
+  // MultiGet with the same snapshot, batch the block lookup of all keys.
+  std::vector<rocksdb::PinnableSlice> pinnable_values(keys.size());
+  std::vector<rocksdb::Status> rocks_statuses(keys.size());
+  rocksdb::ReadOptions read_option;
+  db_->MultiGet(read_option, column_family_->GetHandle(), key_slices.size(), key_slices.data(), pinnable_values.data(),
+                rocks_statuses.data(), std::is_sorted(keys.begin(), keys.end()));
+
+  values.resize(keys.size());
+  statuses.resize(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (rocks_statuses[i].ok()) {
+      values[i].assign(pinnable_values[i].data(), pinnable_values[i].size());
+      statuses[i] = butil::Status();
+    } else if (rocks_statuses[i].IsNotFound()) {
+      statuses[i] = butil::Status(pb::error::EKEY_NOT_FOUND, "Not found");
+    } else {
+      DINGO_LOG(ERROR) << fmt::format("rocksdb::DB::MultiGet failed : {}", rocks_statuses[i].ToString());
+      statuses[i] = butil::Status(pb::error::EINTERNAL, "Internal get error");
+    }
+  }
+
+  return butil::Status();
+}
+
 butil::Status RawRocksEngine::Reader::KvScan(const std::string& start_key, const std::string& end_key,
                                              std::vector<pb::common::KeyValue>& kvs) {
   auto snapshot = std::make_shared<RocksSnapshot>(db_->GetSnapshot(), db_);
@@ -1346,7 +1550,7 @@ butil::Status RawRocksEngine::Checkpoint::Create(const std::string& dirpath) {
 }
 
 butil::Status RawRocksEngine::Checkpoint::Create(const std::string& dirpath,
-                                                 std::shared_ptr<ColumnFamily> column_family,
+                                                 const std::vector<std::shared_ptr<ColumnFamily>>& column_families,
                                                  std::vector<pb::store_internal::SstFileInfo>& sst_files) {
   rocksdb::Checkpoint* checkpoint = nullptr;
   auto status = rocksdb::Checkpoint::Create(db_.get(), &checkpoint);
@@ -1370,8 +1574,10 @@ butil::Status RawRocksEngine::Checkpoint::Create(const std::string& dirpath,
     delete checkpoint;
     return butil::Status(status.code(), status.ToString());
   }
-  rocksdb::ColumnFamilyMetaData meta_data;
-  db_->GetColumnFamilyMetaData(column_family->GetHandle(), &meta_data);
+  std::vector<rocksdb::ColumnFamilyMetaData> meta_datas(column_families.size());
+  for (size_t i = 0; i < column_families.size(); ++i) {
+    db_->GetColumnFamilyMetaData(column_families[i]->GetHandle(), &meta_datas[i]);
+  }
 
   status = db_->EnableFileDeletions(false);
   if (!status.ok()) {
@@ -1379,21 +1585,24 @@ butil::Status RawRocksEngine::Checkpoint::Create(const std::string& dirpath,
     return butil::Status(status.code(), status.ToString());
   }
 
-  for (auto& level : meta_data.levels) {
-    for (const auto& file : level.files) {
-      std::string filepath = dirpath + file.name;
-      if (!Helper::IsExistPath(filepath)) {
-        DINGO_LOG(INFO) << fmt::format("checkpoint not contain sst file: {}", filepath);
-        continue;
-      }
+  for (size_t i = 0; i < column_families.size(); ++i) {
+    for (auto& level : meta_datas[i].levels) {
+      for (const auto& file : level.files) {
+        std::string filepath = dirpath + file.name;
+        if (!Helper::IsExistPath(filepath)) {
+          DINGO_LOG(INFO) << fmt::format("checkpoint not contain sst file: {}", filepath);
+          continue;
+        }
 
-      pb::store_internal::SstFileInfo sst_file;
-      sst_file.set_level(level.level);
-      sst_file.set_name(file.name);
-      sst_file.set_path(filepath);
-      sst_file.set_start_key(file.smallestkey);
-      sst_file.set_end_key(file.largestkey);
-      sst_files.emplace_back(std::move(sst_file));
+        pb::store_internal::SstFileInfo sst_file;
+        sst_file.set_level(level.level);
+        sst_file.set_name(file.name);
+        sst_file.set_path(filepath);
+        sst_file.set_start_key(file.smallestkey);
+        sst_file.set_end_key(file.largestkey);
+        sst_file.set_cf_name(column_families[i]->Name());
+        sst_files.emplace_back(std::move(sst_file));
+      }
     }
   }
 
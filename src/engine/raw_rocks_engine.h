@@ -163,16 +163,21 @@ class RawRocksEngine : public RawEngine {
 
   class MultipleRangeIterator : public dingodb::MultipleRangeIterator {
    public:
-    MultipleRangeIterator(std::shared_ptr<RawEngine> raw_engine, const std::string& cf_name,
+    MultipleRangeIterator(std::shared_ptr<RawEngine> raw_engine, const std::vector<std::string>& cf_names,
                           std::vector<dingodb::pb::common::Range> ranges)
-        : raw_engine_(raw_engine), cf_name_(cf_name), ranges_(ranges){};
+        : raw_engine_(raw_engine), cf_names_(cf_names), ranges_(ranges){};
     ~MultipleRangeIterator() override = default;
 
     bool Init() override {
-      for (auto& range : ranges_) {
+      if (cf_names_.size() != ranges_.size()) {
+        return false;
+      }
+
+      for (size_t i = 0; i < ranges_.size(); ++i) {
+        const auto& range = ranges_[i];
         IteratorOptions options;
         options.upper_bound = range.end_key();
-        auto iter = raw_engine_->NewIterator(cf_name_, options);
+        auto iter = raw_engine_->NewIterator(cf_names_[i], options);
         iter->Seek(range.start_key());
 
         iters_.push_back(iter);
@@ -216,7 +221,7 @@ class RawRocksEngine : public RawEngine {
     }
 
    private:
-    const std::string& cf_name_;
+    std::vector<std::string> cf_names_;
     std::vector<dingodb::pb::common::Range> ranges_;
     std::shared_ptr<RawEngine> raw_engine_;
     std::vector<std::shared_ptr<dingodb::Iterator>> iters_;
@@ -230,6 +235,8 @@ class RawRocksEngine : public RawEngine {
     butil::Status KvGet(const std::string& key, std::string& value) override;
     butil::Status KvGet(std::shared_ptr<dingodb::Snapshot> snapshot, const std::string& key,
                         std::string& value) override;
+    butil::Status KvBatchGet(const std::vector<std::string>& keys, std::vector<std::string>& values,
+                             std::vector<butil::Status>& statuses) override;
 
     butil::Status KvScan(const std::string& start_key, const std::string& end_key,
                          std::vector<pb::common::KeyValue>& kvs) override;
@@ -326,7 +333,8 @@ class RawRocksEngine : public RawEngine {
     Checkpoint& operator=(Checkpoint&& rhs) = delete;
 
     butil::Status Create(const std::string& dirpath);
-    butil::Status Create(const std::string& dirpath, std::shared_ptr<ColumnFamily> column_family,
+    // Create checkpoint and get the sst files of the column families.
+    butil::Status Create(const std::string& dirpath, const std::vector<std::shared_ptr<ColumnFamily>>& column_families,
                          std::vector<pb::store_internal::SstFileInfo>& sst_files);
 
    private:
@@ -344,7 +352,7 @@ class RawRocksEngine : public RawEngine {
   std::shared_ptr<Snapshot> GetSnapshot() override;
 
   static butil::Status MergeCheckpointFile(const std::string& path, const pb::common::Range& range,
-                                           std::string& merge_sst_path);
+                                           const std::string& cf_name, std::string& merge_sst_path);
   butil::Status IngestExternalFile(const std::string& cf_name, const std::vector<std::string>& files);
 
   void Flush(const std::string& cf_name) override;
@@ -358,17 +366,25 @@ class RawRocksEngine : public RawEngine {
   std::shared_ptr<dingodb::Iterator> NewIterator(const std::string& cf_name, std::shared_ptr<Snapshot> snapshot,
                                                  IteratorOptions options);
   std::shared_ptr<dingodb::MultipleRangeIterator> NewMultipleRangeIterator(
-      std::shared_ptr<RawEngine> raw_engine, const std::string& cf_name,
+      std::shared_ptr<RawEngine> raw_engine, const std::vector<std::string>& cf_names,
       std::vector<dingodb::pb::common::Range> ranges) override;
 
   static std::shared_ptr<SstFileWriter> NewSstFileWriter();
   std::shared_ptr<Checkpoint> NewCheckpoint();
 
   std::shared_ptr<ColumnFamily> GetColumnFamily(const std::string& cf_name);
+  std::vector<std::shared_ptr<ColumnFamily>> GetColumnFamilies();
+
+  butil::Status MultiCfPutAndDelete(const std::map<std::string, std::vector<pb::common::KeyValue>>& kv_puts_with_cf,
+                                    const std::map<std::string, std::vector<std::string>>& kv_deletes_with_cf) override;
 
   std::vector<uint64_t> GetApproximateSizes(const std::string& cf_name,
                                             std::vector<pb::common::Range>& ranges) override;
 
+  // Split range to continuous sub ranges at the boundary of sst files, every sub range is about target_size bytes.
+  std::vector<pb::common::Range> SplitRangeBySstFile(const std::string& cf_name, const pb::common::Range& range,
+                                                     uint64_t target_size);
+
  private:
   bool InitCfConfig(const std::vector<std::string>& column_families);
 
@@ -380,6 +396,8 @@ class RawRocksEngine : public RawEngine {
   // set default column family if not exist. rocksdb not allow no default
   // column family we will move default to first
   static void SetDefaultIfNotExist(std::vector<std::string>& column_families);
+  static void SetVectorCfIfNotExist(std::vector<std::string>& column_families);
+  static void SetCfCompression(const std::string& cf_name, rocksdb::ColumnFamilyOptions* family_options);
 
   // new_cf = base + cf . cf will overwrite base value if exists.
   static void CreateNewMap(const std::map<std::string, std::string>& base, const std::map<std::string, std::string>& cf,
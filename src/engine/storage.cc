@@ -253,7 +253,7 @@ butil::Status Storage::VectorBatchQuery(std::shared_ptr<Engine::VectorReader::Co
     return status;
   }
 
-  auto reader = engine_->NewVectorReader(Constant::kStoreDataCF);
+  auto reader = engine_->NewVectorReader();
   status = reader->VectorBatchQuery(ctx, vector_with_ids);
   if (!status.ok()) {
     if (pb::error::EKEY_NOT_FOUND == status.error_code()) {
@@ -274,7 +274,7 @@ butil::Status Storage::VectorBatchSearch(std::shared_ptr<Engine::VectorReader::C
     return status;
   }
 
-  auto reader = engine_->NewVectorReader(Constant::kStoreDataCF);
+  auto reader = engine_->NewVectorReader();
   status = reader->VectorBatchSearch(ctx, results);
   if (!status.ok()) {
     if (pb::error::EKEY_NOT_FOUND == status.error_code()) {
@@ -295,7 +295,7 @@ butil::Status Storage::VectorGetBorderId(uint64_t region_id, const pb::common::R
     return status;
   }
 
-  auto reader = engine_->NewVectorReader(Constant::kStoreDataCF);
+  auto reader = engine_->NewVectorReader();
   status = reader->VectorGetBorderId(region_range, get_min, vector_id);
   if (!status.ok()) {
     return status;
@@ -311,7 +311,7 @@ butil::Status Storage::VectorScanQuery(std::shared_ptr<Engine::VectorReader::Con
     return status;
   }
 
-  auto reader = engine_->NewVectorReader(Constant::kStoreDataCF);
+  auto reader = engine_->NewVectorReader();
   status = reader->VectorScanQuery(ctx, vector_with_ids);
   if (!status.ok()) {
     return status;
@@ -328,7 +328,7 @@ butil::Status Storage::VectorGetRegionMetrics(uint64_t region_id, const pb::comm
     return status;
   }
 
-  auto reader = engine_->NewVectorReader(Constant::kStoreDataCF);
+  auto reader = engine_->NewVectorReader();
   status = reader->VectorGetRegionMetrics(region_id, region_range, vector_index_wrapper, region_metrics);
   if (!status.ok()) {
     return status;
@@ -343,7 +343,7 @@ butil::Status Storage::VectorCount(uint64_t region_id, const pb::common::Range&
     return status;
   }
 
-  auto reader = engine_->NewVectorReader(Constant::kStoreDataCF);
+  auto reader = engine_->NewVectorReader();
   status = reader->VectorCount(range, count);
   if (!status.ok()) {
     return status;
@@ -438,7 +438,7 @@ butil::Status Storage::VectorBatchSearchDebug(std::shared_ptr<Engine::VectorRead
     return status;
   }
 
-  auto reader = engine_->NewVectorReader(Constant::kStoreDataCF);
+  auto reader = engine_->NewVectorReader();
   status =
       reader->VectorBatchSearchDebug(ctx, results, deserialization_id_time_us, scan_scalar_time_us, search_time_us);
   if (!status.ok()) {
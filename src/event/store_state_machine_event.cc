@@ -40,8 +40,10 @@ int SmApplyEventListener::OnEvent(std::shared_ptr<Event> event) {
 
   // Dispatch
   auto* done = dynamic_cast<StoreClosure*>(the_event->done);
-  auto ctx = done ? done->GetCtx() : nullptr;
-  for (const auto& req : the_event->raft_cmd->requests()) {
+  for (int i = 0; i < the_event->raft_cmd->requests_size(); ++i) {
+    const auto& req = the_event->raft_cmd->requests(i);
+    // batched proposal carry the requests of different ctx
+    auto ctx = done ? done->GetCtx(i) : nullptr;
     auto handler = handler_collection_->GetHandler(static_cast<HandlerType>(req.cmd_type()));
     if (handler) {
       handler->Handle(ctx, the_event->region, the_event->engine, req, the_event->region_metrics, the_event->term_id,
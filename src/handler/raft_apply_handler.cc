@@ -16,12 +16,14 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "bthread/bthread.h"
 #include "butil/status.h"
+#include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
 #include "common/synchronization.h"
@@ -784,35 +786,29 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
     }
   }
 
-  // Transform vector to kv
-  std::vector<pb::common::KeyValue> kvs;
+  // Transform vector to kv, vector data, scalar data and table data is stored in separate column family.
+  std::map<std::string, std::vector<pb::common::KeyValue>> kvs_with_cf;
+  auto &vector_data_kvs = kvs_with_cf[Constant::kVectorDataCF];
+  auto &scalar_data_kvs = kvs_with_cf[Constant::kVectorScalarCF];
+  auto &table_data_kvs = kvs_with_cf[Constant::kVectorTableCF];
   for (const auto &vector : request.vectors()) {
     // vector data
     {
-      pb::common::KeyValue kv;
-      std::string key;
-      VectorCodec::EncodeVectorData(region->PartitionId(), vector.id(), key);
-      kv.mutable_key()->swap(key);
-      kv.set_value(vector.vector().SerializeAsString());
-      kvs.push_back(kv);
+      auto &kv = vector_data_kvs.emplace_back();
+      VectorCodec::EncodeVectorData(region->PartitionId(), vector.id(), *kv.mutable_key());
+      VectorCodec::EncodeVectorValue(vector.vector(), *kv.mutable_value());
     }
     // vector scalar data
     {
-      pb::common::KeyValue kv;
-      std::string key;
-      VectorCodec::EncodeVectorScalar(region->PartitionId(), vector.id(), key);
-      kv.mutable_key()->swap(key);
+      auto &kv = scalar_data_kvs.emplace_back();
+      VectorCodec::EncodeVectorScalar(region->PartitionId(), vector.id(), *kv.mutable_key());
       kv.set_value(vector.scalar_data().SerializeAsString());
-      kvs.push_back(kv);
     }
     // vector table data
     {
-      pb::common::KeyValue kv;
-      std::string key;
-      VectorCodec::EncodeVectorTable(region->PartitionId(), vector.id(), key);
-      kv.mutable_key()->swap(key);
+      auto &kv = table_data_kvs.emplace_back();
+      VectorCodec::EncodeVectorTable(region->PartitionId(), vector.id(), *kv.mutable_key());
       kv.set_value(vector.table_data().SerializeAsString());
-      kvs.push_back(kv);
     }
   }
 
@@ -875,16 +871,11 @@ int VectorAddHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr regi
   }
 
   // Store vector
-  if (!kvs.empty() && status.ok()) {
-    auto writer = engine->NewWriter(request.cf_name());
-    if (!writer) {
-      DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id() << ")][cf_name(" << request.cf_name()
-                       << ")] NewWriter failed";
-    }
-    status = writer->KvBatchPut(kvs);
+  if (!vector_data_kvs.empty() && status.ok()) {
+    status = engine->MultiCfPutAndDelete(kvs_with_cf, {});
     if (status.error_code() == pb::error::Errno::EINTERNAL) {
-      DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id() << ")][cf_name(" << request.cf_name()
-                       << ")] VectorAdd->KvBatchPut failed, error: " << status.error_str();
+      DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id()
+                       << ")] VectorAdd->MultiCfPutAndDelete failed, error: " << status.error_str();
     }
 
     if (is_ready) {
@@ -939,14 +930,14 @@ int VectorDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr r
     }
   }
 
-  auto reader = engine->NewReader(request.cf_name());
+  auto reader = engine->NewReader(Constant::kVectorDataCF);
   if (!reader) {
-    DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id() << ")][cf_name(" << request.cf_name()
+    DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id() << ")][cf_name(" << Constant::kVectorDataCF
                      << ")] NewReader failed";
   }
   auto snapshot = engine->GetSnapshot();
   if (!snapshot) {
-    DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id() << ")][cf_name(" << request.cf_name()
+    DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id() << ")][cf_name(" << Constant::kVectorDataCF
                      << ")] GetSnapshot failed";
   }
 
@@ -959,7 +950,10 @@ int VectorDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr r
 
   // Transform vector to kv
   std::vector<bool> key_states(request.ids_size(), false);
-  std::vector<std::string> keys;
+  std::map<std::string, std::vector<std::string>> keys_with_cf;
+  auto &vector_data_keys = keys_with_cf[Constant::kVectorDataCF];
+  auto &scalar_data_keys = keys_with_cf[Constant::kVectorScalarCF];
+  auto &table_data_keys = keys_with_cf[Constant::kVectorTableCF];
   std::vector<uint64_t> delete_ids;
 
   for (int i = 0; i < request.ids_size(); i++) {
@@ -971,25 +965,13 @@ int VectorDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr r
     auto ret = reader->KvGet(snapshot, key, value);
     if (ret.ok()) {
       // delete vector data
-      {
-        std::string key;
-        VectorCodec::EncodeVectorData(region->PartitionId(), request.ids(i), key);
-        keys.push_back(key);
-      }
+      vector_data_keys.push_back(key);
 
       // delete scalar data
-      {
-        std::string key;
-        VectorCodec::EncodeVectorScalar(region->PartitionId(), request.ids(i), key);
-        keys.push_back(key);
-      }
+      VectorCodec::EncodeVectorScalar(region->PartitionId(), request.ids(i), scalar_data_keys.emplace_back());
 
       // delete table data
-      {
-        std::string key;
-        VectorCodec::EncodeVectorTable(region->PartitionId(), request.ids(i), key);
-        keys.push_back(key);
-      }
+      VectorCodec::EncodeVectorTable(region->PartitionId(), request.ids(i), table_data_keys.emplace_back());
 
       key_states[i] = true;
       delete_ids.push_back(request.ids(i));
@@ -1037,16 +1019,11 @@ int VectorDeleteHandler::Handle(std::shared_ptr<Context> ctx, store::RegionPtr r
   }
 
   // Delete vector and write wal
-  if (!keys.empty() && status.ok()) {
-    auto writer = engine->NewWriter(request.cf_name());
-    if (!writer) {
-      DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id() << ")][cf_name(" << request.cf_name()
-                       << ")] NewWriter failed";
-    }
-    status = writer->KvBatchDelete(keys);
+  if (!vector_data_keys.empty() && status.ok()) {
+    status = engine->MultiCfPutAndDelete({}, keys_with_cf);
     if (status.error_code() == pb::error::Errno::EINTERNAL) {
-      DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id() << ")][cf_name(" << request.cf_name()
-                       << ")] VectorDelete->KvBatchDelete failed, error: " << status.error_str();
+      DINGO_LOG(FATAL) << "[raft.apply][region(" << region->Id()
+                       << ")] VectorDelete->MultiCfPutAndDelete failed, error: " << status.error_str();
     }
 
     if (is_ready) {
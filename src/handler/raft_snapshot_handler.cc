@@ -14,28 +14,39 @@
 
 #include "handler/raft_snapshot_handler.h"
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "butil/status.h"
+#include "butil/time.h"
+#include "bvar/latency_recorder.h"
 #include "common/constant.h"
 #include "common/failpoint.h"
 #include "common/helper.h"
+#include "engine/checkpoint_manager.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "google/protobuf/message.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/store_internal.pb.h"
 #include "server/server.h"
+#include "store/background_task_scheduler.h"
 #include "vector/codec.h"
+#include "vector/vector_index_manager.h"
 
 namespace dingodb {
 
+static bvar::LatencyRecorder g_raft_snapshot_link_file_latency("raft_snapshot_link_file");
+
 struct SaveRaftSnapshotArg {
   store::RegionPtr region;
   braft::SnapshotWriter* writer;
@@ -43,7 +54,21 @@ struct SaveRaftSnapshotArg {
   RaftSnapshot* raft_snapshot;
 };
 
-// Scan region, generate sst snapshot file
+DEFINE_int32(raft_snapshot_scan_concurrency, 4, "concurrency of generate sst file for scan raft snapshot");
+DEFINE_uint64(raft_snapshot_sst_target_size, 64 * 1024 * 1024, "target size of sst file for scan raft snapshot");
+
+// Generate one sst file of the sub range.
+struct GenSstFileTask {
+  std::string cf_name;
+  pb::common::Range range;
+  std::string sst_name;
+  std::string sst_path;
+  butil::Status status;
+};
+
+// Scan region, generate sst snapshot file.
+// The sst file only include the data of region, and split by the sst file boundary of rocksdb,
+// every sub range is written by parallel, so the follower can ingest the sst files directly.
 butil::Status RaftSnapshot::GenSnapshotFileByScan(const std::string& checkpoint_path, store::RegionPtr region,
                                                   std::vector<pb::store_internal::SstFileInfo>& sst_files) {
   if (!std::filesystem::create_directories(checkpoint_path)) {
@@ -53,36 +78,84 @@ butil::Status RaftSnapshot::GenSnapshotFileByScan(const std::string& checkpoint_
   }
   auto raw_engine = std::dynamic_pointer_cast<RawRocksEngine>(engine_);
   auto raw_range = region->RawRange();
-  // Build Iterator
-  IteratorOptions options;
-  options.upper_bound = raw_range.end_key();
 
-  auto iter = raw_engine->NewIterator(Constant::kStoreDataCF, engine_snapshot_, options);
-  iter->Seek(raw_range.start_key());
+  struct Parameter {
+    std::shared_ptr<RawRocksEngine> raw_engine;
+    std::shared_ptr<Snapshot> engine_snapshot;
+    std::vector<GenSstFileTask> tasks;
+    std::atomic<int> offset;
+  };
+
+  auto param = std::make_shared<Parameter>();
+  param->raw_engine = raw_engine;
+  param->engine_snapshot = engine_snapshot_;
+  param->offset = 0;
+
+  for (const auto& cf_name : Helper::GetColumnFamilyNames(region->Type())) {
+    auto sub_ranges = raw_engine->SplitRangeBySstFile(cf_name, raw_range, FLAGS_raft_snapshot_sst_target_size);
+    for (int i = 0; i < sub_ranges.size(); ++i) {
+      GenSstFileTask task;
+      task.cf_name = cf_name;
+      task.range = sub_ranges[i];
+      task.sst_name = cf_name == Constant::kStoreDataCF ? fmt::format("{}_{}.sst", region->Id(), i)
+                                                        : fmt::format("{}_{}_{}.sst", region->Id(), cf_name, i);
+      task.sst_path = checkpoint_path + "/" + task.sst_name;
+      param->tasks.push_back(task);
+    }
+  }
+
+  auto task_func = [](void* arg) -> void* {
+    auto* param = static_cast<Parameter*>(arg);
+
+    for (;;) {
+      int offset = param->offset.fetch_add(1, std::memory_order_relaxed);
+      if (offset >= param->tasks.size()) {
+        break;
+      }
 
-  // Build sst name and path
-  std::string sst_name = std::to_string(region->Id()) + ".sst";
-  const std::string sst_path = checkpoint_path + "/" + sst_name;
+      auto& task = param->tasks[offset];
+      IteratorOptions options;
+      options.upper_bound = task.range.end_key();
+      auto iter = param->raw_engine->NewIterator(task.cf_name, param->engine_snapshot, options);
+      iter->Seek(task.range.start_key());
 
-  auto status = RawRocksEngine::NewSstFileWriter()->SaveFile(iter, sst_path);
-  if (!status.ok()) {
-    if (status.error_code() != pb::error::ENO_ENTRIES) {
-      DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] save file failed, path: {} error: {} {}",
-                                      region->Id(), sst_path, status.error_code(), status.error_str());
+      task.status = RawRocksEngine::NewSstFileWriter()->SaveFile(iter, task.sst_path);
     }
-    return status;
+
+    return nullptr;
+  };
+
+  int concurrency = std::min(static_cast<int>(param->tasks.size()), FLAGS_raft_snapshot_scan_concurrency);
+  if (!Helper::ParallelRunTask(task_func, param.get(), std::max(concurrency, 1))) {
+    return butil::Status(pb::error::EINTERNAL, "Create bthread failed.");
   }
 
-  // Set sst file info
-  pb::store_internal::SstFileInfo sst_file;
-  sst_file.set_level(0);
-  sst_file.set_name(sst_name);
-  sst_file.set_path(sst_path);
-  sst_file.set_start_key(raw_range.start_key());
-  sst_file.set_end_key(raw_range.end_key());
+  for (const auto& task : param->tasks) {
+    if (task.status.error_code() == pb::error::ENO_ENTRIES) {
+      continue;
+    }
+    if (!task.status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] save file failed, path: {} error: {} {}",
+                                      region->Id(), task.sst_path, task.status.error_code(), task.status.error_str());
+      return task.status;
+    }
 
-  DINGO_LOG(INFO) << "sst file info: " << sst_file.ShortDebugString();
-  sst_files.push_back(sst_file);
+    // Set sst file info
+    pb::store_internal::SstFileInfo sst_file;
+    sst_file.set_level(0);
+    sst_file.set_name(task.sst_name);
+    sst_file.set_path(task.sst_path);
+    sst_file.set_start_key(task.range.start_key());
+    sst_file.set_end_key(task.range.end_key());
+    sst_file.set_cf_name(task.cf_name);
+
+    DINGO_LOG(INFO) << "sst file info: " << sst_file.ShortDebugString();
+    sst_files.push_back(sst_file);
+  }
+
+  if (sst_files.empty()) {
+    return butil::Status(pb::error::ENO_ENTRIES, "Not found entries");
+  }
 
   return butil::Status();
 }
@@ -107,20 +180,30 @@ std::vector<pb::store_internal::SstFileInfo> FilterSstFile(  // NOLINT
   return filter_sst_files;
 }
 
-// Do Checkpoint and hard link, generate sst snapshot file
-butil::Status RaftSnapshot::GenSnapshotFileByCheckpoint(const std::string& checkpoint_path, store::RegionPtr region,
+// Do Checkpoint and hard link, generate sst snapshot file.
+// The checkpoint is shared with the concurrent snapshot of other regions, released when this snapshot is done.
+butil::Status RaftSnapshot::GenSnapshotFileByCheckpoint(const std::string& /*checkpoint_path*/,
+                                                        store::RegionPtr region,
                                                         std::vector<pb::store_internal::SstFileInfo>& sst_files) {
   auto raw_engine = std::dynamic_pointer_cast<RawRocksEngine>(engine_);
 
-  std::vector<pb::store_internal::SstFileInfo> tmp_sst_files;
-  auto checkpoint = raw_engine->NewCheckpoint();
-  auto status = checkpoint->Create(checkpoint_path, raw_engine->GetColumnFamily(Constant::kStoreDataCF), tmp_sst_files);
+  auto status = CheckpointManager::GetInstance()->Acquire(raw_engine, Server::GetInstance()->GetCheckpointPath(),
+                                                          shared_checkpoint_);
   if (!status.ok()) {
-    DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] Create checkpoint failed, path: {} error: {} {}",
-                                    region->Id(), checkpoint_path, status.error_code(), status.error_str());
+    DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] Create checkpoint failed, error: {} {}", region->Id(),
+                                    status.error_code(), status.error_str());
     return butil::Status();
   }
 
+  // Get the sst file of region column family
+  auto cf_names = Helper::GetColumnFamilyNames(region->Type());
+  std::vector<pb::store_internal::SstFileInfo> tmp_sst_files;
+  for (const auto& sst_file : shared_checkpoint_->SstFiles()) {
+    if (sst_file.level() == -1 || std::find(cf_names.begin(), cf_names.end(), sst_file.cf_name()) != cf_names.end()) {
+      tmp_sst_files.push_back(sst_file);
+    }
+  }
+
   // Get region actual range
   sst_files = FilterSstFile(tmp_sst_files, region->PhysicsRange());
   for (const auto& sst_file : sst_files) {
@@ -201,6 +284,7 @@ bool RaftSnapshot::SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr
     return false;
   }
 
+  int64_t start_time_us = butil::gettimeofday_us();
   for (auto& sst_file : sst_files) {
     std::string filename = Helper::CleanFirstSlash(sst_file.name());
     std::string snapshot_path = writer->get_path() + "/" + filename;
@@ -218,6 +302,7 @@ bool RaftSnapshot::SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr
     filemeta->set_source(braft::FileSource::FILE_SOURCE_LOCAL);
     writer->add_file(filename, static_cast<google::protobuf::Message*>(filemeta.get()));
   }
+  g_raft_snapshot_link_file_latency << (butil::gettimeofday_us() - start_time_us);
 
   // Clean temp checkpoint file
   Helper::RemoveAllFileOrDirectory(region_checkpoint_path);
@@ -227,7 +312,7 @@ bool RaftSnapshot::SaveSnapshot(braft::SnapshotWriter* writer, store::RegionPtr
 
 // Merge multiple sst file to one sst
 static butil::Status MergeCheckpointFile(std::string path, std::string merge_file_path,
-                                         const pb::common::Range& range) {
+                                         const pb::common::Range& range, const std::string& cf_name) {
   // Already exist merge.sst file, remove it.
   if (std::filesystem::exists(merge_file_path)) {
     Helper::RemoveFileOrDirectory(merge_file_path);
@@ -236,7 +321,7 @@ static butil::Status MergeCheckpointFile(std::string path, std::string merge_fil
   // Merge multiple file to one sst.
   // Origin checkpoint sst file cant't ingest rocksdb,
   // Just use rocksdb::SstFileWriter generate sst file can ingest rocksdb.
-  auto status = RawRocksEngine::MergeCheckpointFile(path, range, merge_file_path);
+  auto status = RawRocksEngine::MergeCheckpointFile(path, range, cf_name, merge_file_path);
   if (!status.ok()) {
     // Clean temp file
     if (std::filesystem::exists(merge_file_path)) {
@@ -284,9 +369,11 @@ butil::Status RaftSnapshot::HandleRaftSnapshotRegionMeta(braft::SnapshotReader*
   }
 
   // Delete old region data
-  status = engine_->NewWriter(Constant::kStoreDataCF)->KvBatchDeleteRange(region->PhysicsRange());
-  if (!status.ok()) {
-    return status;
+  for (const auto& cf_name : Helper::GetColumnFamilyNames(region->Type())) {
+    status = engine_->NewWriter(cf_name)->KvBatchDeleteRange(region->PhysicsRange());
+    if (!status.ok()) {
+      return status;
+    }
   }
 
   return butil::Status();
@@ -319,23 +406,39 @@ bool RaftSnapshot::LoadSnapshot(braft::SnapshotReader* reader, store::RegionPtr
   }
 
   auto raw_engine = std::dynamic_pointer_cast<RawRocksEngine>(engine_);
-  std::vector<std::string> sst_files;
+  // column family name -> sst files
+  std::map<std::string, std::vector<std::string>> cf_sst_files;
   std::string current_path = reader->get_path() + "/" + "CURRENT";
   // The snapshot is generated by use checkpoint.
   if (Helper::IsExistPath(current_path)) {
+    // Each physics range only live in its own column family.
+    // The checkpoint of old version leader keep the vector data in default column family,
+    // merge it too and migrate after ingest.
+    std::vector<std::pair<std::string, pb::common::Range>> cf_ranges;
+    auto ranges = region->PhysicsRange();
+    auto cf_names = Helper::GetPhysicsRangeColumnFamilyNames(region->Type());
+    for (size_t i = 0; i < ranges.size() && i < cf_names.size(); ++i) {
+      cf_ranges.emplace_back(cf_names[i], ranges[i]);
+      if (cf_names[i] != Constant::kStoreDataCF) {
+        cf_ranges.emplace_back(Constant::kStoreDataCF, ranges[i]);
+      }
+    }
+
     int count = 0;
-    for (auto& range : region->PhysicsRange()) {
+    for (const auto& [cf_name, range] : cf_ranges) {
       std::string merge_sst_path = fmt::format("{}/merge_{}.sst", reader->get_path(), ++count);
 
-      DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] merge sst file: {}", region->Id(), merge_sst_path);
+      DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] merge sst file: {} cf: {}", region->Id(),
+                                     merge_sst_path, cf_name);
 
-      auto ret = MergeCheckpointFile(reader->get_path(), merge_sst_path, range);
+      auto ret = MergeCheckpointFile(reader->get_path(), merge_sst_path, range, cf_name);
 
       if (ret.ok()) {
-        sst_files.push_back(merge_sst_path);
+        cf_sst_files[cf_name].push_back(merge_sst_path);
       } else if (ret.error_code() == pb::error::ENO_ENTRIES) {
-        DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] merge sst file success with ENO_ENTRIES, error: {}",
-                                       region->Id(), ret.error_str())
+        DINGO_LOG(INFO) << fmt::format(
+                               "[raft.snapshot][region({})] merge sst file success with ENO_ENTRIES, error: {}",
+                               region->Id(), ret.error_str())
                         << ", path: " << reader->get_path() << ", merge_sst_path: " << merge_sst_path;
       } else {
         DINGO_LOG(ERROR) << "[raft.snapshot][region(" << region->Id()
@@ -348,15 +451,29 @@ bool RaftSnapshot::LoadSnapshot(braft::SnapshotReader* reader, store::RegionPtr
       if (file == Constant::kRaftSnapshotRegionMetaFileName) {
         continue;
       }
+
+      // The column family of sst file is in file meta, snapshot of old version is default column family.
+      std::string cf_name = Constant::kStoreDataCF;
+      braft::LocalFileMeta file_meta;
+      pb::store_internal::SstFileInfo sst_file;
+      if (reader->get_file_meta(file, &file_meta) == 0 && sst_file.ParseFromString(file_meta.user_meta()) &&
+          !sst_file.cf_name().empty()) {
+        cf_name = sst_file.cf_name();
+      }
+
       std::string filepath = reader->get_path() + "/" + file;
-      sst_files.push_back(filepath);
+      cf_sst_files[cf_name].push_back(filepath);
     }
   }
 
   FAIL_POINT("load_snapshot_suspend");
 
-  if (!sst_files.empty()) {
-    auto status = raw_engine->IngestExternalFile(Constant::kStoreDataCF, sst_files);
+  if (cf_sst_files.empty()) {
+    DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] no sst file need to ingest", region->Id());
+  }
+
+  for (auto& [cf_name, sst_files] : cf_sst_files) {
+    auto status = raw_engine->IngestExternalFile(cf_name, sst_files);
     for (auto& sst_file : sst_files) {
       if (sst_file.find("merge") != std::string::npos) {
         // Clean merge temp file
@@ -364,7 +481,8 @@ bool RaftSnapshot::LoadSnapshot(braft::SnapshotReader* reader, store::RegionPtr
       }
     }
 
-    DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] ingest sst file: {}", region->Id(), sst_files.size());
+    DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] ingest sst file: {} cf: {}", region->Id(),
+                                   sst_files.size(), cf_name);
 
     if (!status.ok()) {
       DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] ingest sst file failed, error: {} {}", region->Id(),
@@ -375,9 +493,17 @@ bool RaftSnapshot::LoadSnapshot(braft::SnapshotReader* reader, store::RegionPtr
       }
       return false;
     }
-  } else {
-    DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] no sst file need to ingest, sst_files_count: {}",
-                                   region->Id(), sst_files.size());
+  }
+
+  // The snapshot of old version leader put vector data in default column family, move it to the vector column
+  // families, otherwise it is invisible to vector reader and index build.
+  if (region->Type() == pb::common::INDEX_REGION && cf_sst_files.count(Constant::kStoreDataCF) > 0) {
+    auto status = VectorIndexManager::MigrateVectorColumnFamily(region);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.snapshot][region({})] migrate vector column family failed, error: {}",
+                                      region->Id(), status.error_str());
+      return false;
+    }
   }
 
   DINGO_LOG(INFO) << fmt::format("[raft.snapshot][region({})] load snapshot success", region->Id());
@@ -403,6 +529,8 @@ void AsyncSaveSnapshotByScan(store::RegionPtr region, std::shared_ptr<RawEngine>
         brpc::ClosureGuard done_guard(snapshot_arg->done);
         auto region = snapshot_arg->region;
 
+        BackgroundTaskGuard background_task_guard(BackgroundTaskType::kRaftSnapshot);
+
         auto gen_snapshot_file_func =
             std::bind(&RaftSnapshot::GenSnapshotFileByScan, snapshot_arg->raft_snapshot,  // NOLINT
                       std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
@@ -427,6 +555,8 @@ void SaveSnapshotByCheckpoint(store::RegionPtr region, std::shared_ptr<RawEngine
                               braft::Closure* done) {
   brpc::ClosureGuard done_guard(done);
 
+  // Not take background task slot, it run in on_snapshot_save and wait slot would stall the apply,
+  // and the checkpoint is cheap, the sst files are hard linked and shared by the regions.
   auto raft_snapshot = std::make_shared<RaftSnapshot>(engine, false);
   auto gen_snapshot_file_func = std::bind(&RaftSnapshot::GenSnapshotFileByCheckpoint, raft_snapshot,  // NOLINT
                                           std::placeholders::_1, std::placeholders::_2, std::placeholders::_3);
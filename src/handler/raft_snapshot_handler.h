@@ -17,6 +17,7 @@
 
 #include "braft/snapshot.h"
 #include "butil/status.h"
+#include "engine/checkpoint_manager.h"
 #include "engine/raw_engine.h"
 #include "engine/raw_rocks_engine.h"
 #include "handler/handler.h"
@@ -60,6 +61,8 @@ class RaftSnapshot {
  private:
   std::shared_ptr<RawEngine> engine_;
   std::shared_ptr<Snapshot> engine_snapshot_;
+  // Hold the shared checkpoint until the snapshot files are linked.
+  SharedCheckpointPtr shared_checkpoint_;
 };
 
 class RaftSaveSnapshotHanler : public BaseHandler {
@@ -15,6 +15,7 @@
 #include "meta/meta_reader.h"
 
 #include <cstddef>
+#include <utility>
 
 #include "butil/status.h"
 #include "common/constant.h"
@@ -31,6 +32,32 @@ bool MetaReader::Scan(const std::string& prefix, std::vector<pb::common::KeyValu
   return Scan(nullptr, prefix, kvs);
 }
 
+bool MetaReader::MultiGet(const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs) {
+  auto reader = engine_->NewReader(Constant::kStoreMetaCF);
+  std::vector<std::string> values;
+  std::vector<butil::Status> statuses;
+  auto status = reader->KvBatchGet(keys, values, statuses);
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("Meta multi get failed, errcode: {} {}", status.error_code(), status.error_str());
+    return false;
+  }
+
+  kvs.reserve(kvs.size() + keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    if (!statuses[i].ok() && statuses[i].error_code() != pb::error::EKEY_NOT_FOUND) {
+      DINGO_LOG(ERROR) << fmt::format("Meta multi get key {} failed, errcode: {} {}", keys[i],
+                                      statuses[i].error_code(), statuses[i].error_str());
+      return false;
+    }
+
+    auto& kv = kvs.emplace_back();
+    kv.set_key(keys[i]);
+    kv.set_value(std::move(values[i]));
+  }
+
+  return true;
+}
+
 // Get with specific snapshot
 std::shared_ptr<pb::common::KeyValue> MetaReader::Get(std::shared_ptr<Snapshot> snapshot, const std::string& key) {
   auto reader = engine_->NewReader(Constant::kStoreMetaCF);
@@ -33,6 +33,8 @@ class MetaReader {
 
   std::shared_ptr<pb::common::KeyValue> Get(const std::string& key);
   bool Scan(const std::string& prefix, std::vector<pb::common::KeyValue>& kvs);
+  // the value of not found key is empty
+  bool MultiGet(const std::vector<std::string>& keys, std::vector<pb::common::KeyValue>& kvs);
 
   // with Snapshot
   std::shared_ptr<pb::common::KeyValue> Get(std::shared_ptr<Snapshot> snapshot, const std::string& key);
@@ -19,7 +19,10 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "common/helper.h"
 #include "common/logging.h"
@@ -267,6 +270,11 @@ uint64_t Region::PartitionId() {
   return inner_region_.definition().part_id();
 }
 
+uint64_t Region::IndexId() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return inner_region_.definition().index_id();
+}
+
 }  // namespace store
 
 bool StoreServerMeta::Init() {
@@ -708,18 +716,60 @@ void StoreRaftMeta::AddRaftMeta(RaftMetaPtr raft_meta) {
 }
 
 void StoreRaftMeta::UpdateRaftMeta(RaftMetaPtr raft_meta) {
+  BAIDU_SCOPED_LOCK(flush_mutex_);
   {
     BAIDU_SCOPED_LOCK(mutex_);
     raft_metas_.insert_or_assign(raft_meta->region_id(), raft_meta);
+    dirty_raft_metas_.erase(raft_meta->region_id());
   }
 
   meta_writer_->Put(TransformToKv(raft_meta));
 }
 
+void StoreRaftMeta::AsyncUpdateRaftMeta(RaftMetaPtr raft_meta) {
+  auto dirty_raft_meta = std::make_shared<pb::store_internal::RaftMeta>(*raft_meta);
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  raft_metas_.insert_or_assign(raft_meta->region_id(), raft_meta);
+  dirty_raft_metas_.insert_or_assign(raft_meta->region_id(), dirty_raft_meta);
+}
+
+void StoreRaftMeta::FlushRaftMeta() {
+  BAIDU_SCOPED_LOCK(flush_mutex_);
+  RaftMetaMap dirty_raft_metas;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    dirty_raft_metas.swap(dirty_raft_metas_);
+  }
+  if (dirty_raft_metas.empty()) {
+    return;
+  }
+
+  // Serialize out of mutex_, the copies are not shared with the apply thread.
+  std::vector<pb::common::KeyValue> kvs;
+  kvs.reserve(dirty_raft_metas.size());
+  for (auto& [_, raft_meta] : dirty_raft_metas) {
+    kvs.push_back(*TransformToKv(raft_meta));
+  }
+
+  if (!meta_writer_->Put(kvs)) {
+    DINGO_LOG(ERROR) << fmt::format("Flush raft meta failed, count: {}", kvs.size());
+    // Retry in next flush, keep the newer dirty raft meta and skip the deleted raft meta.
+    BAIDU_SCOPED_LOCK(mutex_);
+    for (auto& [region_id, raft_meta] : dirty_raft_metas) {
+      if (raft_metas_.find(region_id) != raft_metas_.end()) {
+        dirty_raft_metas_.insert({region_id, raft_meta});
+      }
+    }
+  }
+}
+
 void StoreRaftMeta::DeleteRaftMeta(uint64_t region_id) {
+  BAIDU_SCOPED_LOCK(flush_mutex_);
   {
     BAIDU_SCOPED_LOCK(mutex_);
     raft_metas_.erase(region_id);
+    dirty_raft_metas_.erase(region_id);
   }
 
   meta_writer_->Delete(GenKey(region_id));
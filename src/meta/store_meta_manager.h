@@ -112,6 +112,7 @@ class Region {
   void AddChild(pb::store_internal::RegionSplitRecord& record);
 
   uint64_t PartitionId();
+  uint64_t IndexId();
 
   const pb::store_internal::Region& InnerRegion() const { return inner_region_; }
 
@@ -229,8 +230,12 @@ class StoreRaftMeta : public TransformKvAble {
   StoreRaftMeta(std::shared_ptr<MetaReader> meta_reader, std::shared_ptr<MetaWriter> meta_writer)
       : TransformKvAble(Constant::kStoreRaftMetaPrefix), meta_reader_(meta_reader), meta_writer_(meta_writer) {
     bthread_mutex_init(&mutex_, nullptr);
+    bthread_mutex_init(&flush_mutex_, nullptr);
+  }
+  ~StoreRaftMeta() override {
+    bthread_mutex_destroy(&mutex_);
+    bthread_mutex_destroy(&flush_mutex_);
   }
-  ~StoreRaftMeta() override { bthread_mutex_destroy(&mutex_); }
 
   StoreRaftMeta(const StoreRaftMeta&) = delete;
   void operator=(const StoreRaftMeta&) = delete;
@@ -243,6 +248,11 @@ class StoreRaftMeta : public TransformKvAble {
 
   void AddRaftMeta(RaftMetaPtr raft_meta);
   void UpdateRaftMeta(RaftMetaPtr raft_meta);
+  // Only keep a copy of the raft meta as dirty, the copy is persisted with other dirty raft metas in one write batch
+  // by FlushRaftMeta. The persisted applied index may fall behind, the log after it will be applied again.
+  // The raft meta is mutated by the apply thread, so it must be called in the thread which mutates it.
+  void AsyncUpdateRaftMeta(RaftMetaPtr raft_meta);
+  void FlushRaftMeta();
   void DeleteRaftMeta(uint64_t region_id);
   RaftMetaPtr GetRaftMeta(uint64_t region_id);
   std::vector<RaftMetaPtr> GetAllRaftMeta();
@@ -260,6 +270,12 @@ class StoreRaftMeta : public TransformKvAble {
 
   using RaftMetaMap = std::map<uint64_t, RaftMetaPtr>;
   RaftMetaMap raft_metas_;
+
+  // Copy of the raft metas which are not persisted yet, protected by mutex_.
+  // Term and applied index are captured together at AsyncUpdateRaftMeta, so a torn pair is never persisted.
+  RaftMetaMap dirty_raft_metas_;
+  // Serialize the write of raft meta, so a flushed raft meta never overwrite a newer one.
+  bthread_mutex_t flush_mutex_;
 };
 
 // Manage store server meta data, like store and region.
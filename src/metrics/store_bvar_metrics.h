@@ -61,6 +61,14 @@ class StoreBvarMetrics {
     }
   }
 
+  uint64_t GetCommitCountPerSecond(std::string region_id) {
+    if (!commit_count_per_second_.has_stats({region_id})) {
+      return 0;
+    }
+    auto* region_stat = commit_count_per_second_.get_stats({region_id});
+    return region_stat != nullptr ? region_stat->get_value() : 0;
+  }
+
   void IncApplyCountPerSecond(std::string region_id) {
     auto* region_stat = apply_count_per_second_.get_stats({region_id});
     if (region_stat != nullptr) {
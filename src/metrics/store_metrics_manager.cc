@@ -28,6 +28,7 @@
 #include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "server/server.h"
+#include "store/memory_governor.h"
 #include "vector/vector_index_manager.h"
 
 namespace dingodb {
@@ -220,12 +221,21 @@ uint64_t StoreRegionMetrics::GetRegionKeyCount(store::RegionPtr region) {
 std::vector<std::pair<uint64_t, uint64_t>> StoreRegionMetrics::GetRegionApproximateSize(
     std::vector<store::RegionPtr> regions) {
   std::vector<store::RegionPtr> valid_regions;
-  std::vector<pb::common::Range> ranges;
-  ranges.reserve(regions.size());
+  // store region data is in default column family, vector data/scalar data/table data of index region is in separate
+  // column family.
+  std::vector<pb::common::Range> store_ranges;
+  std::vector<std::vector<pb::common::Range>> vector_ranges(Constant::kVectorDataCategoryNum);
+  store_ranges.reserve(regions.size());
   for (const auto& region : regions) {
     auto tmp_ranges = region->PhysicsRange();
     if (!tmp_ranges.empty() && tmp_ranges[0].start_key() < tmp_ranges[0].end_key()) {
-      ranges.insert(ranges.end(), tmp_ranges.begin(), tmp_ranges.end());
+      if (region->Type() == pb::common::INDEX_REGION) {
+        for (int j = 0; j < Constant::kVectorDataCategoryNum; ++j) {
+          vector_ranges[j].push_back(tmp_ranges[j]);
+        }
+      } else {
+        store_ranges.push_back(tmp_ranges[0]);
+      }
       valid_regions.push_back(region);
     } else {
       DINGO_LOG(ERROR) << fmt::format(
@@ -234,19 +244,32 @@ std::vector<std::pair<uint64_t, uint64_t>> StoreRegionMetrics::GetRegionApproxim
     }
   }
 
+  const std::vector<std::string> vector_cf_names = {Constant::kVectorDataCF, Constant::kVectorScalarCF,
+                                                    Constant::kVectorTableCF};
+  std::vector<uint64_t> store_sizes;
+  if (!store_ranges.empty()) {
+    store_sizes = raw_engine_->GetApproximateSizes(Constant::kStoreDataCF, store_ranges);
+  }
+  std::vector<std::vector<uint64_t>> vector_sizes(Constant::kVectorDataCategoryNum);
+  for (int j = 0; j < Constant::kVectorDataCategoryNum; ++j) {
+    if (!vector_ranges[j].empty()) {
+      vector_sizes[j] = raw_engine_->GetApproximateSizes(vector_cf_names[j], vector_ranges[j]);
+    }
+  }
+
   std::vector<std::pair<uint64_t, uint64_t>> region_sizes;
-  auto sizes = raw_engine_->GetApproximateSizes(Constant::kStoreDataCF, ranges);
-  int i = 0;
+  int store_pos = 0;
+  int vector_pos = 0;
   for (const auto& region : valid_regions) {
     uint64_t size = 0;
     if (region->Type() == pb::common::INDEX_REGION) {
       for (int j = 0; j < Constant::kVectorDataCategoryNum; ++j) {
-        size += sizes[i + j];
+        size += vector_sizes[j][vector_pos];
       }
-      i += Constant::kVectorDataCategoryNum;
+      ++vector_pos;
     } else {
-      size = sizes[i];
-      i += 1;
+      size = store_sizes[store_pos];
+      ++store_pos;
     }
 
     region_sizes.push_back(std::make_pair(region->Id(), size));
@@ -388,7 +411,7 @@ bool StoreRegionMetrics::CollectMetrics() {
         vector_index_wrapper->GetDeletedCount(deleted_count);
         region_metrics->SetVectorDeletedCount(deleted_count);
 
-        auto reader = engine_->NewVectorReader(Constant::kStoreDataCF);
+        auto reader = engine_->NewVectorReader();
         uint64_t max_id = 0;
 
         reader->VectorGetBorderId(region->RawRange(), false, max_id);
@@ -401,6 +424,7 @@ bool StoreRegionMetrics::CollectMetrics() {
         uint64_t total_memory_usage = 0;
         vector_index_wrapper->GetMemorySize(total_memory_usage);
         region_metrics->SetVectorMemoryBytes(total_memory_usage);
+        MemoryGovernor::GetInstance()->UpdateVectorIndexMemory(vector_index_wrapper->Id(), total_memory_usage);
 
         vector_index_has_data = true;
       }
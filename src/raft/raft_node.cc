@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "bthread/bthread.h"
 #include "butil/status.h"
@@ -26,6 +27,7 @@
 #include "common/logging.h"
 #include "config/config_manager.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "log/segment_log_storage.h"
 #include "metrics/store_bvar_metrics.h"
 #include "proto/common.pb.h"
@@ -34,6 +36,10 @@
 
 namespace dingodb {
 
+DEFINE_bool(enable_raft_propose_batch, false, "coalesce concurrent async writes of region into one raft log entry");
+DEFINE_uint32(raft_propose_batch_max_count, 64, "max write count of one batched raft log entry");
+DEFINE_uint64(raft_propose_batch_max_bytes, 4 * 1024 * 1024, "max bytes of one batched raft log entry");
+
 RaftNode::RaftNode(uint64_t node_id, const std::string& raft_group_name, braft::PeerId peer_id,
                    std::shared_ptr<braft::StateMachine> fsm, std::shared_ptr<SegmentLogStorage> log_storage)
     : node_id_(node_id),
@@ -72,10 +78,26 @@ int RaftNode::Init(const std::string& init_conf, const std::string& raft_path, i
     return -1;
   }
 
+  bthread::ExecutionQueueOptions options;
+  options.bthread_attr = BTHREAD_ATTR_NORMAL;
+  if (bthread::execution_queue_start(&propose_queue_id_, &options, ExecuteProposeRoutine, this) != 0) {
+    DINGO_LOG(ERROR) << fmt::format("[raft.node][node_id({})] start propose execution queue failed.", node_id_);
+    return -1;
+  }
+  is_propose_queue_available_.store(true, std::memory_order_relaxed);
+
   return 0;
 }
 
 void RaftNode::Stop() {
+  // Propose the queued writes before shutdown.
+  if (is_propose_queue_available_.exchange(false)) {
+    if (bthread::execution_queue_stop(propose_queue_id_) != 0 ||
+        bthread::execution_queue_join(propose_queue_id_) != 0) {
+      DINGO_LOG(ERROR) << fmt::format("[raft.node][node_id({})] stop propose execution queue failed.", node_id_);
+    }
+  }
+
   DINGO_LOG(INFO) << fmt::format("[raft.node][node_id({})] stop raft node shutdown.", node_id_);
   node_->shutdown(nullptr);
   node_->join();
@@ -94,6 +116,15 @@ butil::Status RaftNode::Commit(std::shared_ptr<Context> ctx, std::shared_ptr<pb:
   if (!IsLeader()) {
     return butil::Status(pb::error::ERAFT_NOTLEADER, GetLeaderId().to_string());
   }
+
+  Apply(raft_cmd, new StoreClosure(ctx, raft_cmd));
+
+  StoreBvarMetrics::GetInstance().IncCommitCountPerSecond(str_node_id_);
+
+  return butil::Status();
+}
+
+void RaftNode::Apply(std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd, braft::Closure* done) {
   butil::IOBuf data;
   butil::IOBufAsZeroCopyOutputStream wrapper(&data);
   raft_cmd->SerializeToZeroCopyStream(&wrapper);
@@ -102,16 +133,151 @@ butil::Status RaftNode::Commit(std::shared_ptr<Context> ctx, std::shared_ptr<pb:
 
   braft::Task task;
   task.data = &data;
-  task.done = new StoreClosure(ctx, raft_cmd);
+  task.done = done;
   node_->apply(task);
 
-  StoreBvarMetrics::GetInstance().IncCommitCountPerSecond(str_node_id_);
-
   FAIL_POINT("after_raft_commit");
+}
+
+butil::Status RaftNode::AsyncCommit(std::shared_ptr<Context> ctx, std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd) {
+  if (!FLAGS_enable_raft_propose_batch || !is_propose_queue_available_.load(std::memory_order_relaxed)) {
+    return Commit(ctx, raft_cmd);
+  }
+  if (!IsLeader()) {
+    return butil::Status(pb::error::ERAFT_NOTLEADER, GetLeaderId().to_string());
+  }
+
+  auto* task = new ProposeTask{ctx, raft_cmd};
+  if (bthread::execution_queue_execute(propose_queue_id_, task) != 0) {
+    delete task;
+    return Commit(ctx, raft_cmd);
+  }
 
   return butil::Status();
 }
 
+// Only the data write can be merged with others, admin cmd(split/snapshot...) is proposed alone.
+// Vector write is not merged either, the vector index skips the request whose log_id is not greater than
+// its apply log id, so only the first request of a merged log would reach the vector index.
+static bool IsBatchableRaftCmd(const pb::raft::RaftCmdRequest& raft_cmd) {
+  if (raft_cmd.requests().empty()) {
+    return false;
+  }
+
+  for (const auto& request : raft_cmd.requests()) {
+    switch (request.cmd_type()) {
+      case pb::raft::PUT:
+      case pb::raft::PUTIFABSENT:
+      case pb::raft::DELETEBATCH:
+      case pb::raft::COMPAREANDSET:
+        break;
+      default:
+        return false;
+    }
+  }
+
+  return true;
+}
+
+// The tasks enqueued while the previous round is proposing are drained in one round,
+// so the batch grows with the write concurrency and no extra wait is added to a single write.
+int RaftNode::ExecuteProposeRoutine(void* meta, bthread::TaskIterator<ProposeTask*>& iter) {
+  if (iter.is_queue_stopped()) {
+    return 0;
+  }
+
+  auto* node = static_cast<RaftNode*>(meta);
+  std::vector<std::unique_ptr<ProposeTask>> tasks;
+  for (; iter; ++iter) {
+    tasks.emplace_back(*iter);
+  }
+
+  auto batches = GroupProposeTasks(tasks, FLAGS_raft_propose_batch_max_count, FLAGS_raft_propose_batch_max_bytes);
+  for (auto& batch_tasks : batches) {
+    node->ProposeBatch(batch_tasks);
+  }
+
+  return 0;
+}
+
+std::vector<std::vector<std::unique_ptr<RaftNode::ProposeTask>>> RaftNode::GroupProposeTasks(
+    std::vector<std::unique_ptr<ProposeTask>>& tasks, uint32_t max_count, uint64_t max_bytes) {
+  std::vector<std::vector<std::unique_ptr<ProposeTask>>> batches;
+  std::vector<std::unique_ptr<ProposeTask>> batch_tasks;
+  uint64_t batch_bytes = 0;
+  auto flush = [&]() {
+    if (!batch_tasks.empty()) {
+      batches.push_back(std::move(batch_tasks));
+      batch_tasks.clear();
+    }
+    batch_bytes = 0;
+  };
+
+  for (auto& task : tasks) {
+    if (!IsBatchableRaftCmd(*task->raft_cmd)) {
+      flush();
+      batch_tasks.push_back(std::move(task));
+      flush();
+      continue;
+    }
+
+    batch_bytes += task->raft_cmd->ByteSizeLong();
+    batch_tasks.push_back(std::move(task));
+    if (batch_tasks.size() >= max_count || batch_bytes >= max_bytes) {
+      flush();
+    }
+  }
+  flush();
+  tasks.clear();
+
+  return batches;
+}
+
+std::shared_ptr<pb::raft::RaftCmdRequest> RaftNode::MergeProposeTasks(
+    std::vector<std::unique_ptr<ProposeTask>>& tasks, std::vector<std::shared_ptr<Context>>& request_ctxs) {
+  if (tasks.size() == 1) {
+    return tasks[0]->raft_cmd;
+  }
+
+  auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
+  *raft_cmd->mutable_header() = tasks[0]->raft_cmd->header();
+  for (auto& task : tasks) {
+    for (auto& request : *task->raft_cmd->mutable_requests()) {
+      raft_cmd->add_requests()->Swap(&request);
+      request_ctxs.push_back(task->ctx);
+    }
+  }
+
+  return raft_cmd;
+}
+
+// Propose tasks as one raft log entry, and clear tasks.
+void RaftNode::ProposeBatch(std::vector<std::unique_ptr<ProposeTask>>& tasks) {
+  if (tasks.empty()) {
+    return;
+  }
+
+  std::vector<std::shared_ptr<Context>> request_ctxs;
+  auto raft_cmd = MergeProposeTasks(tasks, request_ctxs);
+  auto* done = request_ctxs.empty() ? new StoreClosure(tasks[0]->ctx, raft_cmd)
+                                    : new StoreClosure(std::move(request_ctxs), raft_cmd);
+
+  if (!IsLeader()) {
+    // Writes already returned ok to caller, so notify not leader by write callback.
+    done->status().set_error(pb::error::ERAFT_NOTLEADER, "%s", GetLeaderId().to_string().c_str());
+    done->Run();
+  } else {
+    Apply(raft_cmd, done);
+
+    // Count every write, keep write qps of region metrics same as unbatched.
+    for (size_t i = 0; i < tasks.size(); ++i) {
+      StoreBvarMetrics::GetInstance().IncCommitCountPerSecond(str_node_id_);
+    }
+  }
+
+  tasks.clear();
+}
+
 bool RaftNode::IsLeader() { return node_->is_leader(); }
 
 bool RaftNode::IsLeaderLeaseValid() { return node_->is_leader_lease_valid(); }
@@ -18,10 +18,13 @@
 #include <braft/raft.h>
 #include <braft/util.h>
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "bthread/execution_queue.h"
 #include "common/context.h"
 #include "config/config.h"
 #include "log/segment_log_storage.h"
@@ -47,6 +50,9 @@ class RaftNode {
   uint64_t GetNodeId() const { return node_id_; }
 
   butil::Status Commit(std::shared_ptr<Context> ctx, std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd);
+  // Commit async write, when enable_raft_propose_batch the concurrent writes are coalesced into one raft log entry,
+  // the result is notified by ctx write callback, include not leader after enqueue.
+  butil::Status AsyncCommit(std::shared_ptr<Context> ctx, std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd);
 
   bool IsLeader();
   bool IsLeaderLeaseValid();
@@ -72,7 +78,25 @@ class RaftNode {
 
   std::shared_ptr<pb::common::BRaftStatus> GetStatus();
 
+  struct ProposeTask {
+    std::shared_ptr<Context> ctx;
+    std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd;
+  };
+
+  // Group the queued tasks into proposals in queue order, data writes are merged until max_count or max_bytes is
+  // reached, admin cmd is proposed alone. tasks is moved into the result.
+  static std::vector<std::vector<std::unique_ptr<ProposeTask>>> GroupProposeTasks(
+      std::vector<std::unique_ptr<ProposeTask>>& tasks, uint32_t max_count, uint64_t max_bytes);
+  // Merge the requests of tasks into one raft cmd, request_ctxs[i] is the ctx of raft_cmd->requests(i).
+  // A single task is proposed as it is and request_ctxs is empty.
+  static std::shared_ptr<pb::raft::RaftCmdRequest> MergeProposeTasks(std::vector<std::unique_ptr<ProposeTask>>& tasks,
+                                                                     std::vector<std::shared_ptr<Context>>& request_ctxs);
+
  private:
+  static int ExecuteProposeRoutine(void* meta, bthread::TaskIterator<ProposeTask*>& iter);
+  void ProposeBatch(std::vector<std::unique_ptr<ProposeTask>>& tasks);
+  void Apply(std::shared_ptr<pb::raft::RaftCmdRequest> raft_cmd, braft::Closure* done);
+
   std::string path_;
   uint64_t node_id_;
   std::string str_node_id_;
@@ -83,6 +107,10 @@ class RaftNode {
   std::shared_ptr<braft::StateMachine> fsm_;
   std::shared_ptr<SegmentLogStorage> log_storage_;
   std::unique_ptr<braft::Node> node_;
+
+  // Propose queue is available.
+  std::atomic<bool> is_propose_queue_available_{false};
+  bthread::ExecutionQueueId<ProposeTask*> propose_queue_id_;  // NOLINT
 };
 
 }  // namespace dingodb
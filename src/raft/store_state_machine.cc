@@ -31,26 +31,42 @@
 #include "proto/raft.pb.h"
 #include "server/server.h"
 
-const int kSaveAppliedIndexStep = 10;
-
 namespace dingodb {
 
 void StoreClosure::Run() {
   // Delete self after run
   std::unique_ptr<StoreClosure> self_guard(this);
-  brpc::ClosureGuard const done_guard(ctx_->IsSyncMode() ? nullptr : ctx_->Done());
-  if (!status().ok()) {
-    DINGO_LOG(ERROR) << fmt::format("raft log commit failed, region[{}] {}:{}", ctx_->RegionId(), status().error_code(),
-                                    status().error_str());
+  if (request_ctxs_.empty()) {
+    Finish(ctx_, status());
+    return;
+  }
 
-    ctx_->SetStatus(butil::Status(pb::error::ERAFT_COMMITLOG, status().error_str()));
+  // The requests of one ctx are adjacent.
+  std::shared_ptr<Context> prev_ctx;
+  for (auto& ctx : request_ctxs_) {
+    if (ctx != prev_ctx) {
+      Finish(ctx, status());
+      prev_ctx = ctx;
+    }
   }
+}
+
+void StoreClosure::Finish(std::shared_ptr<Context> ctx, const butil::Status& status) {
+  brpc::ClosureGuard const done_guard(ctx->IsSyncMode() ? nullptr : ctx->Done());
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("raft log commit failed, region[{}] {}:{}", ctx->RegionId(), status.error_code(),
+                                    status.error_str());
 
-  if (ctx_->IsSyncMode()) {
-    ctx_->Cond()->DecreaseSignal();
+    auto error_code =
+        status.error_code() == pb::error::ERAFT_NOTLEADER ? pb::error::ERAFT_NOTLEADER : pb::error::ERAFT_COMMITLOG;
+    ctx->SetStatus(butil::Status(error_code, status.error_str()));
+  }
+
+  if (ctx->IsSyncMode()) {
+    ctx->Cond()->DecreaseSignal();
   } else {
-    if (ctx_->WriteCb()) {
-      ctx_->WriteCb()(ctx_, ctx_->Status());
+    if (ctx->WriteCb()) {
+      ctx->WriteCb()(ctx, ctx->Status());
     }
   }
 }
@@ -140,9 +156,8 @@ void StoreStateMachine::on_apply(braft::Iterator& iter) {
   // Persistence applied index
   // If operation is idempotent, it's ok.
   // If not, must be stored with the data.
-  if (applied_index_ % kSaveAppliedIndexStep == 0) {
-    Server::GetInstance()->GetStoreMetaManager()->GetStoreRaftMeta()->UpdateRaftMeta(raft_meta_);
-  }
+  // Not write in apply path, the dirty raft metas of all regions are flushed in one write batch by crontab.
+  Server::GetInstance()->GetStoreMetaManager()->GetStoreRaftMeta()->AsyncUpdateRaftMeta(raft_meta_);
 }
 
 void StoreStateMachine::on_shutdown() {
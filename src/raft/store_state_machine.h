@@ -18,6 +18,7 @@
 #include <atomic>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "braft/raft.h"
 #include "brpc/controller.h"
@@ -35,15 +36,24 @@ class StoreClosure : public braft::Closure {
  public:
   StoreClosure(std::shared_ptr<Context> ctx, std::shared_ptr<pb::raft::RaftCmdRequest> request)
       : ctx_(ctx), request_(request) {}
+  // Batched proposal, request_ctxs[i] is the ctx of request->requests(i).
+  StoreClosure(std::vector<std::shared_ptr<Context>> request_ctxs, std::shared_ptr<pb::raft::RaftCmdRequest> request)
+      : ctx_(request_ctxs.front()), request_ctxs_(std::move(request_ctxs)), request_(request) {}
   ~StoreClosure() override = default;
 
   void Run() override;
 
   std::shared_ptr<Context> GetCtx() { return ctx_; }
+  std::shared_ptr<Context> GetCtx(int request_index) {
+    return request_ctxs_.empty() ? ctx_ : request_ctxs_[request_index];
+  }
   std::shared_ptr<pb::raft::RaftCmdRequest> GetRequest() { return request_; }
 
  private:
+  static void Finish(std::shared_ptr<Context> ctx, const butil::Status& status);
+
   std::shared_ptr<Context> ctx_;
+  std::vector<std::shared_ptr<Context>> request_ctxs_;
   std::shared_ptr<pb::raft::RaftCmdRequest> request_;
 };
 
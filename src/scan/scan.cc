@@ -142,30 +142,23 @@ butil::Status ScanContext::GetKeyValue(std::vector<pb::common::KeyValue>& kvs) {
     return status;
   }
 
-  ScanFilter scan_filter = ScanFilter(key_only_, std::min(max_fetch_cnt_, max_fetch_cnt_by_server_), max_bytes_rpc_);
+  uint64_t max_fetch_cnt = std::min(max_fetch_cnt_, max_fetch_cnt_by_server_);
+  ScanFilter scan_filter = ScanFilter(key_only_, max_fetch_cnt, max_bytes_rpc_);
+  kvs.reserve(kvs.size() + max_fetch_cnt);
 
+  // build kv in place, avoid the temporary kv and copy
   while (iter_->HasNext()) {
-    pb::common::KeyValue kv;
-    std::string key;
-    std::string value;
+    auto& kv = kvs.emplace_back();
     if (key_only_) {
-      iter_->GetKey(key);
-
+      iter_->GetKey(*kv.mutable_key());
     } else {
-      iter_->GetKV(key, value);
-    }
-
-    kv.set_key(std::move(key));
-    if (!key_only_) {
-      kv.set_value(std::move(value));
+      iter_->GetKV(*kv.mutable_key(), *kv.mutable_value());
     }
 
-    kvs.emplace_back(kv);
     if (scan_filter.UptoLimit(kv)) {
       iter_->Next();
       break;
     }
-    kv.Clear();
 
     iter_->Next();
   }
@@ -565,6 +565,12 @@ void CoordinatorServiceImpl::StoreHeartbeat(google::protobuf::RpcController *con
     if (is_read_only_from_store) {
       Server::GetInstance()->SetReadOnly(true);
     }
+
+    // delta heartbeat is lost, ask store to send full region metrics
+    if (request->store_metrics().is_delta_region_metrics() &&
+        this->coordinator_control_->NeedFullRegionMetrics(request->store().id())) {
+      response->set_need_full_region_metrics(true);
+    }
   }
 
   // response cluster state
@@ -16,10 +16,13 @@
 
 #include <cstdint>
 #include <memory>
+#include <set>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
+#include "bthread/bthread.h"
 #include "common/constant.h"
 #include "common/context.h"
 #include "common/failpoint.h"
@@ -37,6 +40,7 @@
 #include "server/server.h"
 #include "server/service_helper.h"
 #include "vector/codec.h"
+#include "vector/vector_index_utils.h"
 
 using dingodb::pb::error::Errno;
 
@@ -44,6 +48,7 @@ namespace dingodb {
 
 DEFINE_uint64(vector_max_batch_count, 1024, "vector max batch count in one request");
 DEFINE_uint64(vector_max_request_size, 8388608, "vector max batch count in one request");
+DEFINE_uint64(vector_max_search_region_count, 64, "vector max region count in one multi region search request");
 
 IndexServiceImpl::IndexServiceImpl() = default;
 
@@ -175,11 +180,16 @@ butil::Status IndexServiceImpl::ValidateVectorSearchRequest(const dingodb::pb::i
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param top_n is error");
   }
 
-  if (request->vector_with_ids_size() > 0 && request->vector_with_ids().empty()) {
+  if (request->vector_with_ids().empty()) {
     return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param vector_with_ids is empty");
   }
 
-  auto status = storage_->ValidateLeader(request->context().region_id());
+  return ValidateVectorSearchRegion(region, request->vector_with_ids());
+}
+
+butil::Status IndexServiceImpl::ValidateVectorSearchRegion(
+    store::RegionPtr region, const google::protobuf::RepeatedPtrField<pb::common::VectorWithId>& vector_with_ids) {
+  auto status = storage_->ValidateLeader(region->Id());
   if (!status.ok()) {
     return status;
   }
@@ -194,13 +204,9 @@ butil::Status IndexServiceImpl::ValidateVectorSearchRequest(const dingodb::pb::i
   }
 
   std::vector<uint64_t> vector_ids;
-  if (request->vector_with_ids_size() <= 0) {
-    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param vector_with_ids is empty");
-  } else {
-    for (const auto& vector : request->vector_with_ids()) {
-      if (vector.id() > 0) {
-        vector_ids.push_back(vector.id());
-      }
+  for (const auto& vector : vector_with_ids) {
+    if (vector.id() > 0) {
+      vector_ids.push_back(vector.id());
     }
   }
 
@@ -289,9 +295,182 @@ void IndexServiceImpl::VectorSearch(google::protobuf::RpcController* controller,
     return;
   }
 
-  for (auto& vector_result : vector_results) {
-    *(response->add_batch_results()) = vector_result;
+  Helper::VectorToPbRepeated(std::move(vector_results), response->mutable_batch_results());
+}
+
+butil::Status IndexServiceImpl::ValidateVectorMultiRegionSearchRequest(
+    const dingodb::pb::index::VectorMultiRegionSearchRequest* request) {
+  if (request->contexts().empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param contexts is empty");
+  }
+
+  if (request->contexts_size() > FLAGS_vector_max_search_region_count) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                         fmt::format("Param contexts size {} is exceed max region count {}", request->contexts_size(),
+                                     FLAGS_vector_max_search_region_count));
+  }
+
+  std::set<uint64_t> region_ids;
+  for (const auto& context : request->contexts()) {
+    if (context.region_id() == 0) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param region_id is error");
+    }
+    if (!region_ids.insert(context.region_id()).second) {
+      return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                           fmt::format("Param region_id {} is duplicated", context.region_id()));
+    }
+  }
+
+  if (request->parameter().top_n() > FLAGS_vector_max_batch_count) {
+    return butil::Status(pb::error::EVECTOR_EXCEED_MAX_BATCH_COUNT,
+                         fmt::format("Param top_n {} is exceed max batch count {}", request->parameter().top_n(),
+                                     FLAGS_vector_max_batch_count));
+  }
+
+  // same as single region search, the merged response is not larger than the response of one region
+  if (request->parameter().top_n() * request->vector_with_ids_size() > FLAGS_vector_max_batch_count * 10) {
+    return butil::Status(pb::error::EVECTOR_EXCEED_MAX_BATCH_COUNT,
+                         fmt::format("Param top_n {} is exceed max batch count {}", request->parameter().top_n(),
+                                     FLAGS_vector_max_batch_count));
+  }
+
+  if (request->vector_with_ids().empty()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS, "Param vector_with_ids is empty");
+  }
+
+  return butil::Status();
+}
+
+// Search one region of multi region search, run in bthread.
+struct VectorRegionSearchTask {
+  std::shared_ptr<Storage> storage;
+  std::shared_ptr<Engine::VectorReader::Context> ctx;
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  butil::Status status;
+};
+
+static void* RunVectorRegionSearchTask(void* arg) {
+  auto* task = static_cast<VectorRegionSearchTask*>(arg);
+  task->status = task->storage->VectorBatchSearch(task->ctx, task->results);
+  return nullptr;
+}
+
+void IndexServiceImpl::VectorMultiRegionSearch(google::protobuf::RpcController* controller,
+                                               const dingodb::pb::index::VectorMultiRegionSearchRequest* request,
+                                               dingodb::pb::index::VectorMultiRegionSearchResponse* response,
+                                               google::protobuf::Closure* done) {
+  brpc::Controller* cntl = (brpc::Controller*)controller;
+  brpc::ClosureGuard done_guard(done);
+
+  DINGO_LOG(DEBUG) << "VectorMultiRegionSearch request: " << request->ShortDebugString();
+
+  // Validate request parameter.
+  butil::Status status = ValidateVectorMultiRegionSearchRequest(request);
+  if (!status.ok()) {
+    auto* err = response->mutable_error();
+    err->set_errcode(static_cast<Errno>(status.error_code()));
+    err->set_errmsg(status.error_str());
+    DINGO_LOG(WARNING) << fmt::format("ValidateRequest failed request: {} response: {}", request->ShortDebugString(),
+                                      response->ShortDebugString());
+    return;
+  }
+
+  auto set_region_error = [request, response](uint64_t region_id, const butil::Status& status) {
+    auto* err = response->mutable_error();
+    err->set_errcode(static_cast<Errno>(status.error_code()));
+    err->set_errmsg(status.error_str());
+    if (status.error_code() == pb::error::EREGION_VERSION) {
+      ServiceHelper::GetStoreRegionInfo(region_id, *(err->mutable_store_region_info()));
+    } else if (status.error_code() == pb::error::ERAFT_NOTLEADER) {
+      err->set_errmsg("Not leader, please redirect leader.");
+      ServiceHelper::RedirectLeader(status.error_str(), response);
+    }
+    response->set_error_region_id(region_id);
+    DINGO_LOG(WARNING) << fmt::format("VectorMultiRegionSearch region {} failed, request: {} response: {}", region_id,
+                                      request->ShortDebugString(), response->ShortDebugString());
+  };
+
+  // Validate every region, the query vectors are shared by all regions.
+  auto store_region_meta = Server::GetInstance()->GetStoreMetaManager()->GetStoreRegionMeta();
+  std::vector<VectorRegionSearchTask> tasks(request->contexts_size());
+  store::RegionPtr first_region;
+  for (int i = 0; i < request->contexts_size(); ++i) {
+    const auto& context = request->contexts(i);
+    status = ServiceHelper::ValidateRegionEpoch(context.region_epoch(), context.region_id());
+    if (!status.ok()) {
+      set_region_error(context.region_id(), status);
+      return;
+    }
+
+    auto region = store_region_meta->GetRegion(context.region_id());
+    if (region == nullptr) {
+      set_region_error(context.region_id(),
+                       butil::Status(pb::error::EREGION_NOT_FOUND,
+                                     fmt::format("Not found region {} at server {}", context.region_id(),
+                                                 Server::GetInstance()->Id())));
+      return;
+    }
+
+    status = ValidateVectorSearchRegion(region, request->vector_with_ids());
+    if (!status.ok()) {
+      set_region_error(context.region_id(), status);
+      return;
+    }
+
+    // The results are merged by distance, only regions of the same index are comparable.
+    if (first_region == nullptr) {
+      first_region = region;
+    } else {
+      status = ServiceHelper::ValidateSameIndexRegion(region, first_region);
+      if (!status.ok()) {
+        set_region_error(context.region_id(), status);
+        return;
+      }
+    }
+
+    auto ctx = std::make_shared<Engine::VectorReader::Context>();
+    ctx->partition_id = region->PartitionId();
+    ctx->region_id = region->Id();
+    ctx->vector_index = region->VectorIndexWrapper();
+    ctx->region_range = region->RawRange();
+    ctx->parameter = request->parameter();
+    ctx->vector_with_ids.assign(request->vector_with_ids().begin(), request->vector_with_ids().end());
+
+    tasks[i].storage = storage_;
+    tasks[i].ctx = ctx;
+  }
+
+  // Search regions in parallel, the first region is searched in current bthread.
+  std::vector<bthread_t> tids(tasks.size(), 0);
+  for (size_t i = 1; i < tasks.size(); ++i) {
+    if (bthread_start_background(&tids[i], nullptr, RunVectorRegionSearchTask, &tasks[i]) != 0) {
+      DINGO_LOG(ERROR) << fmt::format("VectorMultiRegionSearch start bthread failed, region {}",
+                                      tasks[i].ctx->region_id);
+      tids[i] = 0;
+      RunVectorRegionSearchTask(&tasks[i]);
+    }
+  }
+  RunVectorRegionSearchTask(&tasks[0]);
+  for (auto tid : tids) {
+    if (tid != 0) {
+      bthread_join(tid, nullptr);
+    }
+  }
+
+  std::vector<std::vector<pb::index::VectorWithDistanceResult>> region_results;
+  region_results.reserve(tasks.size());
+  for (auto& task : tasks) {
+    if (!task.status.ok()) {
+      set_region_error(task.ctx->region_id, task.status);
+      return;
+    }
+    region_results.push_back(std::move(task.results));
   }
+
+  std::vector<pb::index::VectorWithDistanceResult> vector_results;
+  VectorIndexUtils::MergeVectorSearchResults(region_results, request->parameter().top_n(), vector_results);
+
+  Helper::VectorToPbRepeated(std::move(vector_results), response->mutable_batch_results());
 }
 
 butil::Status IndexServiceImpl::ValidateVectorAddRequest(const dingodb::pb::index::VectorAddRequest* request,
@@ -1148,9 +1327,7 @@ void IndexServiceImpl::VectorSearchDebug(google::protobuf::RpcController* contro
     return;
   }
 
-  for (auto& vector_result : vector_results) {
-    *(response->add_batch_results()) = vector_result;
-  }
+  Helper::VectorToPbRepeated(std::move(vector_results), response->mutable_batch_results());
   response->set_deserialization_id_time_us(deserialization_id_time_us);
   response->set_scan_scalar_time_us(scan_scalar_time_us);
   response->set_search_time_us(search_time_us);
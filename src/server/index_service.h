@@ -31,6 +31,10 @@ class IndexServiceImpl : public pb::index::IndexService {
                         pb::index::VectorBatchQueryResponse* response, google::protobuf::Closure* done) override;
   void VectorSearch(google::protobuf::RpcController* controller, const pb::index::VectorSearchRequest* request,
                     pb::index::VectorSearchResponse* response, google::protobuf::Closure* done) override;
+  void VectorMultiRegionSearch(google::protobuf::RpcController* controller,
+                               const pb::index::VectorMultiRegionSearchRequest* request,
+                               pb::index::VectorMultiRegionSearchResponse* response,
+                               google::protobuf::Closure* done) override;
   void VectorAdd(google::protobuf::RpcController* controller, const pb::index::VectorAddRequest* request,
                  pb::index::VectorAddResponse* response, google::protobuf::Closure* done) override;
   void VectorDelete(google::protobuf::RpcController* controller, const pb::index::VectorDeleteRequest* request,
@@ -65,6 +69,10 @@ class IndexServiceImpl : public pb::index::IndexService {
                                                 store::RegionPtr region);
   butil::Status ValidateVectorSearchRequest(const dingodb::pb::index::VectorSearchRequest* request,
                                             store::RegionPtr region);
+  butil::Status ValidateVectorSearchRegion(
+      store::RegionPtr region, const google::protobuf::RepeatedPtrField<pb::common::VectorWithId>& vector_with_ids);
+  butil::Status ValidateVectorMultiRegionSearchRequest(
+      const dingodb::pb::index::VectorMultiRegionSearchRequest* request);
   butil::Status ValidateVectorAddRequest(const dingodb::pb::index::VectorAddRequest* request, store::RegionPtr region);
   butil::Status ValidateVectorDeleteRequest(const dingodb::pb::index::VectorDeleteRequest* request,
                                             store::RegionPtr region);
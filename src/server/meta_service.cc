@@ -782,9 +782,21 @@ void MetaServiceImpl::GenerateAutoIncrement(google::protobuf::RpcController *con
     return RedirectAutoIncrementResponse(response);
   }
 
-  DINGO_LOG(INFO) << request->ShortDebugString();
+  DINGO_LOG(DEBUG) << request->ShortDebugString();
 
   uint64_t table_id = request->table_id().entity_id();
+
+  // generate from the preallocated window of leader, no raft needed
+  uint64_t start_id = 0;
+  uint64_t end_id = 0;
+  if (auto_increment_control_->GenerateAutoIncrementFromWindow(table_id, request->count(),
+                                                               request->auto_increment_increment(),
+                                                               request->auto_increment_offset(), start_id, end_id)) {
+    response->set_start_id(start_id);
+    response->set_end_id(end_id);
+    return;
+  }
+
   pb::coordinator_internal::MetaIncrement meta_increment;
   auto ret =
       auto_increment_control_->GenerateAutoIncrement(table_id, request->count(), request->auto_increment_increment(),
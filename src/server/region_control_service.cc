@@ -254,11 +254,12 @@ static pb::common::RegionMetrics GetRegionActualMetrics(uint64_t region_id) {
   int32_t key_count = 0;
   std::string min_key, max_key;
   auto ranges = region->PhysicsRange();
+  auto cf_names = Helper::GetPhysicsRangeColumnFamilyNames(region->Type());
   for (int i = 0; i < ranges.size(); ++i) {
     auto range = ranges[i];
     IteratorOptions options;
     options.upper_bound = range.end_key();
-    auto iter = raw_engine->NewIterator(Constant::kStoreDataCF, options);
+    auto iter = raw_engine->NewIterator(cf_names[i], options);
 
     for (iter->Seek(range.start_key()); iter->Valid(); iter->Next()) {
       size += iter->Key().size() + iter->Value().size();
@@ -45,7 +45,9 @@
 #include "proto/error.pb.h"
 #include "proto/node.pb.h"
 #include "scan/scan_manager.h"
+#include "store/background_task_scheduler.h"
 #include "store/heartbeat.h"
+#include "store/memory_governor.h"
 #include "store/region_controller.h"
 
 DEFINE_string(coor_url, "",
@@ -181,6 +183,16 @@ bool Server::InitDirectory() {
 bool Server::InitRawEngine() {
   auto config = ConfigManager::GetInstance()->GetConfig(role_);
 
+  if (!MemoryGovernor::GetInstance()->Init(config)) {
+    DINGO_LOG(ERROR) << "Init MemoryGovernor Failed";
+    return false;
+  }
+
+  if (!BackgroundTaskScheduler::GetInstance()->Init()) {
+    DINGO_LOG(ERROR) << "Init BackgroundTaskScheduler Failed";
+    return false;
+  }
+
   raw_engine_ = std::make_shared<RawRocksEngine>();
   if (!raw_engine_->Init(config)) {
     DINGO_LOG(ERROR) << "Init RawRocksEngine Failed with Config[" << config->ToString();
@@ -228,6 +240,9 @@ bool Server::InitEngine() {
       return false;
     }
 
+    // set raft_meta_engine to auto_increment_control
+    auto_increment_control_->SetKvEngine(engine_);
+
     // 3.init TsoController
     tso_control_ = std::make_shared<TsoControl>();
     if (!tso_control_->Recover()) {
@@ -374,6 +389,15 @@ bool Server::InitCrontabManager() {
       [](void*) { Server::GetInstance()->GetStoreMetricsManager()->CollectApproximateSizeMetrics(); },
   });
 
+  // Add flush raft meta crontab
+  crontab_configs_.push_back({
+      "FLUSH_RAFT_META",
+      {pb::common::STORE, pb::common::INDEX},
+      GetInterval(config, "server.flush_raft_meta_interval_s", Constant::kFlushRaftMetaIntervalS) * 1000,
+      false,
+      [](void*) { Server::GetInstance()->GetStoreMetaManager()->GetStoreRaftMeta()->FlushRaftMeta(); },
+  });
+
   // Add scan crontab
   if (role_ == pb::common::STORE) {
     ScanManager::GetInstance()->Init(config);
@@ -475,6 +499,15 @@ bool Server::InitCrontabManager() {
       [](void*) { Heartbeat::TriggerCompactionTask(nullptr); },
   });
 
+  // Add balance crontab
+  crontab_configs_.push_back({
+      "BALANCE",
+      {pb::common::COORDINATOR},
+      GetInterval(config, "coordinator.balance_interval_s", Constant::kBalanceIntervalS) * 1000,
+      false,
+      [](void*) { Heartbeat::TriggerBalanceTask(nullptr); },
+  });
+
   // Add scrub vector index crontab
   crontab_configs_.push_back({
       "SCRUB_VECTOR_INDEX",
@@ -558,6 +591,10 @@ void Server::Destroy() {
   region_controller_->Destroy();
   store_controller_->Destroy();
 
+  if (store_meta_manager_ != nullptr) {
+    store_meta_manager_->GetStoreRaftMeta()->FlushRaftMeta();
+  }
+
   google::ShutdownGoogleLogging();
 }
 
@@ -207,6 +207,16 @@ butil::Status ServiceHelper::ValidateIndexRegion(store::RegionPtr region, const
 
 // if one store is set to read-only, all stores are set to read-only
 // this flag is set by coordinator and send to all stores using store heartbeat
+butil::Status ServiceHelper::ValidateSameIndexRegion(store::RegionPtr region, store::RegionPtr first_region) {
+  if (region->IndexId() != first_region->IndexId()) {
+    return butil::Status(pb::error::EILLEGAL_PARAMTETERS,
+                         fmt::format("Region {} index {} is not same as region {} index {}", region->Id(),
+                                     region->IndexId(), first_region->Id(), first_region->IndexId()));
+  }
+
+  return butil::Status();
+}
+
 butil::Status ServiceHelper::ValidateClusterReadOnly() {
   auto is_read_only = Server::GetInstance()->IsReadOnly();
   if (is_read_only) {
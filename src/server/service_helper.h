@@ -48,6 +48,8 @@ class ServiceHelper {
   static butil::Status ValidateRangeInRange(const pb::common::Range& region_range, const pb::common::Range& req_range);
   static butil::Status ValidateRegion(uint64_t region_id, const std::vector<std::string_view>& keys);
   static butil::Status ValidateIndexRegion(store::RegionPtr region, const std::vector<uint64_t>& vector_ids);
+  // Regions of one multi region search must belong to the same index, the partitions may differ.
+  static butil::Status ValidateSameIndexRegion(store::RegionPtr region, store::RegionPtr first_region);
   static butil::Status ValidateClusterReadOnly();
 };
 
@@ -18,6 +18,7 @@
 #include <memory>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 #include "common/constant.h"
@@ -178,7 +179,7 @@ void StoreServiceImpl::KvBatchGet(google::protobuf::RpcController* controller,
     return;
   }
 
-  Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+  Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
 
   DINGO_LOG(DEBUG) << fmt::format("KvBatchGet request: {} response: {}", request->ShortDebugString(),
                                   response->ShortDebugString());
@@ -845,7 +846,7 @@ void StoreServiceImpl::KvScanBegin(google::protobuf::RpcController* controller,
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 
   *response->mutable_scan_id() = scan_id;
@@ -921,7 +922,7 @@ void StoreServiceImpl::KvScanContinue(google::protobuf::RpcController* controlle
   }
 
   if (!kvs.empty()) {
-    Helper::VectorToPbRepeated(kvs, response->mutable_kvs());
+    Helper::VectorToPbRepeated(std::move(kvs), response->mutable_kvs());
   }
 
   DINGO_LOG(DEBUG) << fmt::format("KvScanContinue request: {} response: {}", request->ShortDebugString(),
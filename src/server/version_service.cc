@@ -425,10 +425,7 @@ void VersionServiceProtoImpl::KvRange(google::protobuf::RpcController* /*control
                                       google::protobuf::Closure* done) {
   brpc::ClosureGuard done_guard(done);
 
-  auto is_leader = this->coordinator_control_->IsLeader();
-  DINGO_LOG(WARNING) << "Receive Range Request: IsLeader:" << is_leader << ", Request: " << request->DebugString();
-
-  if (!is_leader) {
+  if (!this->coordinator_control_->IsLeader()) {
     return RedirectResponse(response);
   }
 
@@ -447,24 +444,20 @@ void VersionServiceProtoImpl::KvRange(google::protobuf::RpcController* /*control
 
   std::vector<pb::version::Kv> kvs;
   uint64_t total_count_in_range = 0;
+  bool has_more = false;
   auto ret = coordinator_control_->KvRange(request->key(), request->range_end(), real_limit, request->keys_only(),
-                                           request->count_only(), kvs, total_count_in_range);
+                                           request->count_only(), kvs, total_count_in_range, has_more);
   if (!ret.ok()) {
     response->mutable_error()->set_errcode(static_cast<pb::error::Errno>(ret.error_code()));
     response->mutable_error()->set_errmsg(ret.error_str());
   }
 
-  if (!kvs.empty()) {
-    for (const auto& kv : kvs) {
-      auto* resp_kv = response->add_kvs();
-      *resp_kv = kv;
-    }
-    response->set_count(total_count_in_range);
-    response->set_more(total_count_in_range > real_limit);
+  response->mutable_kvs()->Reserve(kvs.size());
+  for (auto& kv : kvs) {
+    response->add_kvs()->Swap(&kv);
   }
-
-  DINGO_LOG(INFO) << "Range success: key=" << request->key() << ", end_key=" << request->range_end()
-                  << ", limit=" << request->limit();
+  response->set_count(total_count_in_range);
+  response->set_more(has_more);
 }
 
 void VersionServiceProtoImpl::KvPut(google::protobuf::RpcController* controller, const pb::version::PutRequest* request,
@@ -638,10 +631,7 @@ void VersionServiceProtoImpl::Watch(google::protobuf::RpcController* controller,
                                     google::protobuf::Closure* done) {
   brpc::ClosureGuard done_guard(done);
 
-  auto is_leader = this->coordinator_control_->IsLeader();
-  DINGO_LOG(INFO) << "Receive Watch Request: IsLeader:" << is_leader << ", Request: " << request->DebugString();
-
-  if (!is_leader) {
+  if (!this->coordinator_control_->IsLeader()) {
     return RedirectResponse(response);
   }
 
@@ -678,9 +668,10 @@ void VersionServiceProtoImpl::Watch(google::protobuf::RpcController* controller,
     response->mutable_error()->set_errmsg("no put event and no delete event");
   }
 
-  coordinator_control_->OneTimeWatch(one_time_req.key(), one_time_req.start_revision(), no_put_event, no_delete_event,
-                                     one_time_req.need_prev_kv(), one_time_req.wait_on_not_exist_key(),
-                                     done_guard.release(), response, static_cast<brpc::Controller*>(controller));
+  coordinator_control_->OneTimeWatch(one_time_req.key(), one_time_req.range_end(), one_time_req.start_revision(),
+                                     no_put_event, no_delete_event, one_time_req.need_prev_kv(),
+                                     one_time_req.wait_on_not_exist_key(), done_guard.release(), response,
+                                     static_cast<brpc::Controller*>(controller));
 }
 
 }  // namespace dingodb
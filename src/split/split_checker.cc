@@ -36,21 +36,25 @@
 #include "proto/raft.pb.h"
 #include "server/server.h"
 #include "server/service_helper.h"
+#include "store/background_task_scheduler.h"
 #include "vector/codec.h"
 #include "vector/vector_index_manager.h"
 
 namespace dingodb {
 
 std::string HalfSplitChecker::SplitKey(store::RegionPtr region, uint32_t& count) {
-  auto iter = raw_engine_->NewMultipleRangeIterator(raw_engine_, Constant::kStoreDataCF, region->PhysicsRange());
+  auto iter = raw_engine_->NewMultipleRangeIterator(
+      raw_engine_, Helper::GetPhysicsRangeColumnFamilyNames(region->Type()), region->PhysicsRange());
   iter->Init();
 
   uint64_t size = 0;
   uint64_t chunk_size = 0;
   std::vector<std::string> keys;
   bool is_split = false;
+  ScanThrottle scan_throttle;
   for (; iter->IsValid(); iter->Next()) {
     uint64_t key_value_size = iter->KeyValueSize();
+    scan_throttle.Add(key_value_size);
     size += key_value_size;
     chunk_size += key_value_size;
     if (chunk_size >= split_chunk_size_) {
@@ -73,15 +77,19 @@ std::string HalfSplitChecker::SplitKey(store::RegionPtr region, uint32_t& count)
 }
 
 std::string SizeSplitChecker::SplitKey(store::RegionPtr region, uint32_t& count) {
-  auto iter = raw_engine_->NewMultipleRangeIterator(raw_engine_, Constant::kStoreDataCF, region->PhysicsRange());
+  auto iter = raw_engine_->NewMultipleRangeIterator(
+      raw_engine_, Helper::GetPhysicsRangeColumnFamilyNames(region->Type()), region->PhysicsRange());
   iter->Init();
 
   uint64_t size = 0;
   std::string split_key;
   bool is_split = false;
   uint32_t split_pos = split_size_ * split_ratio_;
+  ScanThrottle scan_throttle;
   for (; iter->IsValid(); iter->Next()) {
-    size += iter->KeyValueSize();
+    uint64_t key_value_size = iter->KeyValueSize();
+    scan_throttle.Add(key_value_size);
+    size += key_value_size;
     if (split_key.empty() && size >= split_pos) {
       split_key = iter->FirstRangeKey();
     } else if (size >= split_size_) {
@@ -99,7 +107,8 @@ std::string SizeSplitChecker::SplitKey(store::RegionPtr region, uint32_t& count)
 }
 
 std::string KeysSplitChecker::SplitKey(store::RegionPtr region, uint32_t& count) {
-  auto iter = raw_engine_->NewMultipleRangeIterator(raw_engine_, Constant::kStoreDataCF, region->PhysicsRange());
+  auto iter = raw_engine_->NewMultipleRangeIterator(
+      raw_engine_, Helper::GetPhysicsRangeColumnFamilyNames(region->Type()), region->PhysicsRange());
   iter->Init();
 
   uint64_t size = 0;
@@ -107,9 +116,12 @@ std::string KeysSplitChecker::SplitKey(store::RegionPtr region, uint32_t& count)
   std::string split_key;
   bool is_split = false;
   uint32_t split_key_number = split_keys_number_ * split_keys_ratio_;
+  ScanThrottle scan_throttle;
   for (; iter->IsValid(); iter->Next()) {
     ++split_key_count;
-    size += iter->KeyValueSize();
+    uint64_t key_value_size = iter->KeyValueSize();
+    scan_throttle.Add(key_value_size);
+    size += key_value_size;
 
     if (split_key.empty() && split_key_count >= split_key_number) {
       split_key = iter->FirstRangeKey();
@@ -161,6 +173,8 @@ void SplitCheckTask::SplitCheck() {
     return;
   }
 
+  BackgroundTaskGuard background_task_guard(BackgroundTaskType::kSplitCheck);
+
   uint64_t start_time = Helper::TimestampMs();
   auto epoch = region_->Epoch();
 
@@ -0,0 +1,222 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "store/background_task_scheduler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "brpc/reloadable_flags.h"
+#include "bthread/bthread.h"
+#include "butil/memory/singleton.h"
+#include "butil/time.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+
+namespace dingodb {
+
+DEFINE_int64(background_task_total_concurrency, 8, "total concurrency of store background task");
+BRPC_VALIDATE_GFLAG(background_task_total_concurrency, brpc::PositiveInteger);
+// The sum of the other type concurrency is less than total, so raft snapshot always has reserved slot.
+// Only the scan snapshot take the slot, the checkpoint snapshot is not limited.
+DEFINE_int64(background_raft_snapshot_concurrency, 4, "concurrency of raft snapshot save by scan");
+BRPC_VALIDATE_GFLAG(background_raft_snapshot_concurrency, brpc::PositiveInteger);
+DEFINE_int64(background_vector_index_save_concurrency, 2, "concurrency of vector index snapshot save");
+BRPC_VALIDATE_GFLAG(background_vector_index_save_concurrency, brpc::PositiveInteger);
+DEFINE_int64(background_vector_index_rebuild_concurrency, 2, "concurrency of vector index rebuild and compact");
+BRPC_VALIDATE_GFLAG(background_vector_index_rebuild_concurrency, brpc::PositiveInteger);
+DEFINE_int64(background_split_check_concurrency, 2, "concurrency of split check");
+BRPC_VALIDATE_GFLAG(background_split_check_concurrency, brpc::PositiveInteger);
+
+DEFINE_int64(background_scan_rate_limit_bytes, 0, "bytes per second of background task scan, 0 is unlimited");
+BRPC_VALIDATE_GFLAG(background_scan_rate_limit_bytes, brpc::NonNegativeInteger);
+
+static bool ValidateRocksdbRateLimit(const char*, int64_t value) {
+  if (value < 0) {
+    return false;
+  }
+  BackgroundTaskScheduler::GetInstance()->SetRocksdbRateLimit(value);
+  return true;
+}
+DEFINE_int64(rocksdb_rate_limit_bytes, 0,
+             "bytes per second of rocksdb flush and compaction, 0 is unlimited, only can be changed at runtime when "
+             "set at startup");
+BRPC_VALIDATE_GFLAG(rocksdb_rate_limit_bytes, ValidateRocksdbRateLimit);
+
+// The waiting task recheck the concurrency periodically, so the concurrency raised at runtime take effect.
+// The gflag validator run before the new value is set, notify there is too early.
+static const int64_t kWaitRecheckIntervalUs = 100 * 1000;
+// The idle time of scan can be saved for burst.
+static const int64_t kScanBurstUs = 100 * 1000;
+static const int64_t kRocksdbRateLimitRefillPeriodUs = 100 * 1000;
+static const int32_t kRocksdbRateLimitFairness = 10;
+// 1TB/s, large enough as unlimited and not overflow when compute refill bytes.
+static const int64_t kRocksdbUnlimitedRate = 1LL << 40;
+
+BackgroundTaskScheduler::BackgroundTaskScheduler()
+    : running_nums_(static_cast<int>(BackgroundTaskType::kMax), 0),
+      waiting_nums_(static_cast<int>(BackgroundTaskType::kMax), 0),
+      scan_throttle_metrics_("background_task_scan_throttle") {
+  for (int i = 0; i < static_cast<int>(BackgroundTaskType::kMax); ++i) {
+    std::string name = TypeName(static_cast<BackgroundTaskType>(i));
+    wait_latency_metrics_.push_back(
+        std::make_unique<bvar::LatencyRecorder>(fmt::format("background_task_{}_wait", name)));
+    running_metrics_.push_back(std::make_unique<bvar::Adder<int64_t>>(fmt::format("background_task_{}_running", name)));
+    waiting_metrics_.push_back(std::make_unique<bvar::Adder<int64_t>>(fmt::format("background_task_{}_waiting", name)));
+  }
+}
+
+BackgroundTaskScheduler* BackgroundTaskScheduler::GetInstance() {
+  return Singleton<BackgroundTaskScheduler>::get();
+}
+
+bool BackgroundTaskScheduler::Init() {
+  if (FLAGS_rocksdb_rate_limit_bytes > 0) {
+    rocksdb_rate_limiter_.reset(rocksdb::NewGenericRateLimiter(
+        FLAGS_rocksdb_rate_limit_bytes, kRocksdbRateLimitRefillPeriodUs, kRocksdbRateLimitFairness));
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[background_task] total concurrency({}) raft snapshot({}) vector index save({}) vector index rebuild({}) split "
+      "check({}) scan rate limit({}) rocksdb rate limit({})",
+      FLAGS_background_task_total_concurrency, FLAGS_background_raft_snapshot_concurrency,
+      FLAGS_background_vector_index_save_concurrency, FLAGS_background_vector_index_rebuild_concurrency,
+      FLAGS_background_split_check_concurrency, FLAGS_background_scan_rate_limit_bytes,
+      FLAGS_rocksdb_rate_limit_bytes);
+
+  return true;
+}
+
+const char* BackgroundTaskScheduler::TypeName(BackgroundTaskType type) {
+  switch (type) {
+    case BackgroundTaskType::kRaftSnapshot:
+      return "raft_snapshot";
+    case BackgroundTaskType::kVectorIndexSave:
+      return "vector_index_save";
+    case BackgroundTaskType::kVectorIndexRebuild:
+      return "vector_index_rebuild";
+    case BackgroundTaskType::kSplitCheck:
+      return "split_check";
+    default:
+      return "unknown";
+  }
+}
+
+int64_t BackgroundTaskScheduler::GetConcurrency(BackgroundTaskType type) {
+  switch (type) {
+    case BackgroundTaskType::kRaftSnapshot:
+      return FLAGS_background_raft_snapshot_concurrency;
+    case BackgroundTaskType::kVectorIndexSave:
+      return FLAGS_background_vector_index_save_concurrency;
+    case BackgroundTaskType::kVectorIndexRebuild:
+      return FLAGS_background_vector_index_rebuild_concurrency;
+    case BackgroundTaskType::kSplitCheck:
+      return FLAGS_background_split_check_concurrency;
+    default:
+      return 1;
+  }
+}
+
+// Must hold mutex_.
+bool BackgroundTaskScheduler::CanRun(BackgroundTaskType type) {
+  int index = static_cast<int>(type);
+  if (running_nums_[index] >= GetConcurrency(type) || total_running_num_ >= FLAGS_background_task_total_concurrency) {
+    return false;
+  }
+
+  // Let the waiting task of higher priority go first.
+  for (int i = 0; i < index; ++i) {
+    if (waiting_nums_[i] > 0 && running_nums_[i] < GetConcurrency(static_cast<BackgroundTaskType>(i))) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void BackgroundTaskScheduler::Acquire(BackgroundTaskType type) {
+  int index = static_cast<int>(type);
+  int64_t start_time_us = butil::gettimeofday_us();
+
+  {
+    std::unique_lock<bthread::Mutex> lock(mutex_);
+    ++waiting_nums_[index];
+    *waiting_metrics_[index] << 1;
+    while (!CanRun(type)) {
+      cond_.wait_for(lock, kWaitRecheckIntervalUs);
+    }
+    --waiting_nums_[index];
+    *waiting_metrics_[index] << -1;
+
+    ++running_nums_[index];
+    ++total_running_num_;
+    *running_metrics_[index] << 1;
+  }
+
+  *wait_latency_metrics_[index] << (butil::gettimeofday_us() - start_time_us);
+}
+
+void BackgroundTaskScheduler::Release(BackgroundTaskType type) {
+  int index = static_cast<int>(type);
+
+  {
+    std::unique_lock<bthread::Mutex> lock(mutex_);
+    --running_nums_[index];
+    --total_running_num_;
+    *running_metrics_[index] << -1;
+  }
+
+  // The waiting task of every type recheck, the number of waiting task is small.
+  cond_.notify_all();
+}
+
+void BackgroundTaskScheduler::RequestScanBytes(uint64_t bytes) {
+  int64_t rate = FLAGS_background_scan_rate_limit_bytes;
+  if (rate <= 0 || bytes == 0) {
+    return;
+  }
+
+  int64_t wait_us = 0;
+  {
+    std::unique_lock<bthread::Mutex> lock(scan_mutex_);
+    int64_t now_us = butil::gettimeofday_us();
+    scan_paid_time_us_ = std::max(scan_paid_time_us_, now_us - kScanBurstUs);
+    scan_paid_time_us_ += static_cast<int64_t>(bytes * 1000000 / rate);
+    wait_us = scan_paid_time_us_ - now_us;
+  }
+
+  if (wait_us > 0) {
+    scan_throttle_metrics_ << wait_us;
+    bthread_usleep(wait_us);
+  }
+}
+
+void BackgroundTaskScheduler::SetRocksdbRateLimit(int64_t bytes_per_second) {
+  if (rocksdb_rate_limiter_ == nullptr) {
+    DINGO_LOG(WARNING) << "[background_task] rocksdb rate limiter is not enabled at startup.";
+    return;
+  }
+
+  if (bytes_per_second > 0) {
+    rocksdb_rate_limiter_->SetBytesPerSecond(bytes_per_second);
+  } else {
+    rocksdb_rate_limiter_->SetBytesPerSecond(kRocksdbUnlimitedRate);
+  }
+}
+
+}  // namespace dingodb
@@ -0,0 +1,131 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_STORE_BACKGROUND_TASK_SCHEDULER_H_
+#define DINGODB_STORE_BACKGROUND_TASK_SCHEDULER_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "bthread/condition_variable.h"
+#include "bthread/mutex.h"
+#include "bvar/latency_recorder.h"
+#include "bvar/reducer.h"
+#include "rocksdb/rate_limiter.h"
+
+template <typename T>
+struct DefaultSingletonTraits;
+
+namespace dingodb {
+
+// The smaller value is the higher priority.
+enum class BackgroundTaskType {
+  kRaftSnapshot = 0,
+  kVectorIndexSave = 1,
+  kVectorIndexRebuild = 2,
+  kSplitCheck = 3,
+  kMax = 4,
+};
+
+// Store level scheduler of background task, all background task share the total concurrency,
+// every task type has its own concurrency cap, when a slot is free the waiting task of higher priority go first.
+// The scan of background task is limited by a token bucket, rocksdb flush/compaction is limited by rocksdb RateLimiter.
+// All limits are gflags and can be changed at runtime.
+class BackgroundTaskScheduler {
+ public:
+  static BackgroundTaskScheduler* GetInstance();
+
+  BackgroundTaskScheduler(const BackgroundTaskScheduler&) = delete;
+  const BackgroundTaskScheduler& operator=(const BackgroundTaskScheduler&) = delete;
+
+  bool Init();
+
+  // Wait until the task can run.
+  void Acquire(BackgroundTaskType type);
+  void Release(BackgroundTaskType type);
+
+  // Wait until the scanned bytes is allowed by the scan rate limit.
+  void RequestScanBytes(uint64_t bytes);
+
+  // Only exist when rocksdb rate limit is set at startup.
+  std::shared_ptr<rocksdb::RateLimiter> GetRocksdbRateLimiter() { return rocksdb_rate_limiter_; }
+  void SetRocksdbRateLimit(int64_t bytes_per_second);
+
+  static const char* TypeName(BackgroundTaskType type);
+
+ private:
+  BackgroundTaskScheduler();
+  ~BackgroundTaskScheduler() = default;
+
+  friend struct DefaultSingletonTraits<BackgroundTaskScheduler>;
+
+  static int64_t GetConcurrency(BackgroundTaskType type);
+  bool CanRun(BackgroundTaskType type);
+
+  bthread::Mutex mutex_;
+  bthread::ConditionVariable cond_;
+  std::vector<int64_t> running_nums_;
+  std::vector<int64_t> waiting_nums_;
+  int64_t total_running_num_{0};
+
+  bthread::Mutex scan_mutex_;
+  // The time when the scanned bytes are paid off.
+  int64_t scan_paid_time_us_{0};
+
+  std::shared_ptr<rocksdb::RateLimiter> rocksdb_rate_limiter_;
+
+  std::vector<std::unique_ptr<bvar::LatencyRecorder>> wait_latency_metrics_;
+  std::vector<std::unique_ptr<bvar::Adder<int64_t>>> running_metrics_;
+  std::vector<std::unique_ptr<bvar::Adder<int64_t>>> waiting_metrics_;
+  bvar::LatencyRecorder scan_throttle_metrics_;
+};
+
+// Acquire background task slot at construct and release at destruct.
+class BackgroundTaskGuard {
+ public:
+  explicit BackgroundTaskGuard(BackgroundTaskType type) : type_(type) {
+    BackgroundTaskScheduler::GetInstance()->Acquire(type_);
+  }
+  ~BackgroundTaskGuard() { BackgroundTaskScheduler::GetInstance()->Release(type_); }
+
+  BackgroundTaskGuard(const BackgroundTaskGuard&) = delete;
+  const BackgroundTaskGuard& operator=(const BackgroundTaskGuard&) = delete;
+
+ private:
+  BackgroundTaskType type_;
+};
+
+// Accumulate scanned bytes and request scan rate limit by chunk, avoid lock every key.
+class ScanThrottle {
+ public:
+  ScanThrottle() = default;
+  ~ScanThrottle() = default;
+
+  void Add(uint64_t bytes) {
+    pending_bytes_ += bytes;
+    if (pending_bytes_ >= kChunkBytes) {
+      BackgroundTaskScheduler::GetInstance()->RequestScanBytes(pending_bytes_);
+      pending_bytes_ = 0;
+    }
+  }
+
+ private:
+  static const uint64_t kChunkBytes = 1024 * 1024;
+  uint64_t pending_bytes_{0};
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_STORE_BACKGROUND_TASK_SCHEDULER_H_
@@ -20,6 +20,7 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <map>
 #include <memory>
 #include <set>
@@ -31,6 +32,7 @@
 #include "common/logging.h"
 #include "coordinator/coordinator_control.h"
 #include "fmt/core.h"
+#include "metrics/store_bvar_metrics.h"
 #include "proto/common.pb.h"
 #include "proto/coordinator.pb.h"
 #include "proto/coordinator_internal.pb.h"
@@ -47,6 +49,131 @@ DEFINE_int32(store_heartbeat_timeout, 30, "store heartbeat timeout in seconds");
 DEFINE_int32(region_heartbeat_timeout, 30, "region heartbeat timeout in seconds");
 DEFINE_int32(region_delete_after_deleted_time, 604800, "delete region after deleted time in seconds");
 
+DEFINE_bool(enable_delta_store_heartbeat, false,
+            "store heartbeat only carry changed region metrics, coordinator must support merge delta heartbeat");
+DEFINE_int32(store_heartbeat_full_sync_interval, 6, "every n store heartbeat carry full region metrics");
+DEFINE_double(store_heartbeat_metrics_change_ratio, 0.1,
+              "region metrics(row count/size/vector count/memory) change ratio threshold for delta heartbeat");
+
+RegionHeartbeatTracker& RegionHeartbeatTracker::GetInstance() {
+  static RegionHeartbeatTracker instance;
+  return instance;
+}
+
+RegionHeartbeatTracker::Digest RegionHeartbeatTracker::GenDigest(const pb::common::RegionMetrics& region_metrics) {
+  Digest digest;
+  digest.conf_version = region_metrics.region_definition().epoch().conf_version();
+  digest.version = region_metrics.region_definition().epoch().version();
+  digest.leader_store_id = region_metrics.leader_store_id();
+  digest.store_region_state = region_metrics.store_region_state();
+
+  const auto& braft_status = region_metrics.braft_status();
+  digest.raft_state = braft_status.raft_state();
+  digest.term = braft_status.term();
+  digest.leader_peer_id = braft_status.leader_peer_id();
+  digest.stable_follower_count = braft_status.stable_followers_size();
+  digest.unstable_follower_count = braft_status.unstable_followers_size();
+
+  const auto& vector_index_status = region_metrics.vector_index_status();
+  digest.vector_index_status = (vector_index_status.is_ready() ? 1 : 0) | (vector_index_status.is_stop() ? 1 << 1 : 0) |
+                               (vector_index_status.is_build_error() ? 1 << 2 : 0) |
+                               (vector_index_status.is_rebuild_error() ? 1 << 3 : 0) |
+                               (vector_index_status.is_switching() ? 1 << 4 : 0) |
+                               (vector_index_status.is_hold_vector_index() ? 1 << 5 : 0);
+
+  digest.row_count = region_metrics.row_count();
+  digest.region_size = region_metrics.region_size();
+  digest.vector_index_count = region_metrics.vector_index_metrics().current_count();
+  digest.vector_index_memory_bytes = region_metrics.vector_index_metrics().memory_bytes();
+  digest.write_qps = region_metrics.write_qps();
+
+  return digest;
+}
+
+static bool IsExceedChangeRatio(int64_t old_value, int64_t new_value, double change_ratio) {
+  if (old_value == new_value) {
+    return false;
+  }
+  if (old_value == 0 || new_value == 0) {
+    return true;
+  }
+
+  return static_cast<double>(std::abs(new_value - old_value)) > static_cast<double>(std::abs(old_value)) * change_ratio;
+}
+
+bool RegionHeartbeatTracker::IsChanged(const Digest& old_digest, const Digest& new_digest, double change_ratio) {
+  if (old_digest.conf_version != new_digest.conf_version || old_digest.version != new_digest.version ||
+      old_digest.leader_store_id != new_digest.leader_store_id ||
+      old_digest.store_region_state != new_digest.store_region_state) {
+    return true;
+  }
+
+  if (old_digest.raft_state != new_digest.raft_state || old_digest.term != new_digest.term ||
+      old_digest.leader_peer_id != new_digest.leader_peer_id ||
+      old_digest.stable_follower_count != new_digest.stable_follower_count ||
+      old_digest.unstable_follower_count != new_digest.unstable_follower_count) {
+    return true;
+  }
+
+  if (old_digest.vector_index_status != new_digest.vector_index_status) {
+    return true;
+  }
+
+  return IsExceedChangeRatio(old_digest.row_count, new_digest.row_count, change_ratio) ||
+         IsExceedChangeRatio(old_digest.region_size, new_digest.region_size, change_ratio) ||
+         IsExceedChangeRatio(old_digest.vector_index_count, new_digest.vector_index_count, change_ratio) ||
+         IsExceedChangeRatio(old_digest.vector_index_memory_bytes, new_digest.vector_index_memory_bytes, change_ratio) ||
+         IsExceedChangeRatio(old_digest.write_qps, new_digest.write_qps, change_ratio);
+}
+
+uint64_t RegionHeartbeatTracker::NextVersion(bool& is_full) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  ++heartbeat_count_;
+  is_full = force_full_ || FLAGS_store_heartbeat_full_sync_interval <= 1 ||
+            heartbeat_count_ % FLAGS_store_heartbeat_full_sync_interval == 0;
+  force_full_ = false;
+
+  return ++version_;
+}
+
+void RegionHeartbeatTracker::ForceFull() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  force_full_ = true;
+}
+
+bool RegionHeartbeatTracker::NeedReport(uint64_t region_id, const Digest& digest, double change_ratio) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = digests_.find(region_id);
+  if (it == digests_.end()) {
+    return true;
+  }
+
+  return IsChanged(it->second, digest, change_ratio);
+}
+
+std::vector<uint64_t> RegionHeartbeatTracker::Commit(const std::map<uint64_t, Digest>& reported,
+                                                     const std::set<uint64_t>& alive_region_ids) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  std::vector<uint64_t> removed_region_ids;
+  for (auto it = digests_.begin(); it != digests_.end();) {
+    if (alive_region_ids.find(it->first) == alive_region_ids.end()) {
+      removed_region_ids.push_back(it->first);
+      it = digests_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  for (const auto& [region_id, digest] : reported) {
+    digests_[region_id] = digest;
+  }
+
+  return removed_region_ids;
+}
+
 void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> coordinator_interaction,
                                        std::vector<uint64_t> region_ids, bool is_update_epoch_version) {
   auto start_time = Helper::TimestampMs();
@@ -74,8 +201,20 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
   auto* mut_region_metrics_map = mut_store_metrics->mutable_region_metrics_map();
   auto region_metrics = metrics_manager->GetStoreRegionMetrics();
   std::vector<store::RegionPtr> region_metas;
+
+  // Periodic heartbeat carry all region, in delta mode only carry changed region.
+  bool is_delta = false;
+  auto& tracker = RegionHeartbeatTracker::GetInstance();
+  std::map<uint64_t, RegionHeartbeatTracker::Digest> reported_digests;
+  std::set<uint64_t> alive_region_ids;
   if (region_ids.empty()) {
     region_metas = store_meta_manager->GetStoreRegionMeta()->GetAllRegion();
+    if (FLAGS_enable_delta_store_heartbeat) {
+      bool is_full = true;
+      mut_store_metrics->set_region_metrics_version(tracker.NextVersion(is_full));
+      is_delta = !is_full;
+      mut_store_metrics->set_is_delta_region_metrics(is_delta);
+    }
   } else {
     mut_store_metrics->set_is_partial_region_metrics(true);
     for (auto region_id : region_ids) {
@@ -105,6 +244,10 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
       auto raft_node = raft_store_engine->GetNode(region_meta->Id());
       if (raft_node != nullptr) {
         *(tmp_region_metrics.mutable_braft_status()) = (*raft_node->GetStatus());
+        if (tmp_region_metrics.braft_status().raft_state() == pb::common::RaftNodeState::STATE_LEADER) {
+          tmp_region_metrics.set_write_qps(
+              StoreBvarMetrics::GetInstance().GetCommitCountPerSecond(std::to_string(region_meta->Id())));
+        }
       }
     }
 
@@ -122,24 +265,52 @@ void HeartbeatTask::SendStoreHeartbeat(std::shared_ptr<CoordinatorInteraction> c
       vector_index_status->set_is_hold_vector_index(vector_index_wrapper->IsHoldVectorIndex());
     }
 
+    if (mut_store_metrics->region_metrics_version() > 0) {
+      auto digest = RegionHeartbeatTracker::GenDigest(tmp_region_metrics);
+      alive_region_ids.insert(region_meta->Id());
+      if (is_delta && !tracker.NeedReport(region_meta->Id(), digest, FLAGS_store_heartbeat_metrics_change_ratio)) {
+        continue;
+      }
+      reported_digests.insert({region_meta->Id(), digest});
+    }
+
     mut_region_metrics_map->insert({region_meta->Id(), tmp_region_metrics});
   }
 
-  DINGO_LOG(INFO) << fmt::format("[heartbeat.store] request region count({}) size({}) elapsed time({} ms)",
-                                 mut_region_metrics_map->size(), request.ByteSizeLong(),
-                                 Helper::TimestampMs() - start_time);
+  if (mut_store_metrics->region_metrics_version() > 0) {
+    auto removed_region_ids = tracker.Commit(reported_digests, alive_region_ids);
+    if (is_delta) {
+      for (auto region_id : removed_region_ids) {
+        mut_store_metrics->add_removed_region_ids(region_id);
+      }
+    }
+  }
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[heartbeat.store] request region count({}/{}) delta({}) version({}) size({}) elapsed time({} ms)",
+      mut_region_metrics_map->size(), region_metas.size(), is_delta, mut_store_metrics->region_metrics_version(),
+      request.ByteSizeLong(), Helper::TimestampMs() - start_time);
   start_time = Helper::TimestampMs();
   pb::coordinator::StoreHeartbeatResponse response;
   auto status = coordinator_interaction->SendRequest("StoreHeartbeat", request, response);
   if (!status.ok()) {
     DINGO_LOG(WARNING) << fmt::format("[heartbeat.store] store heartbeat failed, error: {} {}",
                                       pb::error::Errno_Name(status.error_code()), status.error_str());
+    // Coordinator maybe not receive this heartbeat, the delta is lost.
+    if (mut_store_metrics->region_metrics_version() > 0) {
+      tracker.ForceFull();
+    }
     return;
   }
 
   DINGO_LOG(INFO) << fmt::format("[heartbeat.store] response size({}) elapsed time({} ms)", response.ByteSizeLong(),
                                  Helper::TimestampMs() - start_time);
 
+  if (response.need_full_region_metrics()) {
+    DINGO_LOG(INFO) << "[heartbeat.store] coordinator need full region metrics, next heartbeat will be full.";
+    tracker.ForceFull();
+  }
+
   HeartbeatTask::HandleStoreHeartbeatResponse(store_meta_manager, response);
 }
 
@@ -717,6 +888,24 @@ void CompactionTask::ExecCompactionTask(std::shared_ptr<CoordinatorControl> coor
   coordinator_control->CompactionTask();
 }
 
+// this is for coordinator
+static std::atomic<bool> g_coordinator_balance_running(false);
+void BalanceTask::ExecBalanceTask(std::shared_ptr<CoordinatorControl> coordinator_control) {
+  if (!coordinator_control->IsLeader()) {
+    return;
+  }
+  DINGO_LOG(DEBUG) << "ExecBalanceTask... this is leader";
+
+  if (g_coordinator_balance_running.load(std::memory_order_relaxed)) {
+    DINGO_LOG(INFO) << "ExecBalanceTask... g_coordinator_balance_running is true, return";
+    return;
+  }
+
+  AtomicGuard guard(g_coordinator_balance_running);
+
+  coordinator_control->BalanceTask();
+}
+
 // this is for index
 void VectorIndexScrubTask::ScrubVectorIndex() {
   auto status = VectorIndexManager::ScrubVectorIndex();
@@ -831,6 +1020,14 @@ void Heartbeat::TriggerCompactionTask(void*) {
   }
 }
 
+void Heartbeat::TriggerBalanceTask(void*) {
+  // Free at ExecuteRoutine()
+  TaskRunnable* task = new BalanceTask(Server::GetInstance()->GetCoordinatorControl());
+  if (!Server::GetInstance()->GetHeartbeat()->Execute(task)) {
+    delete task;
+  }
+}
+
 void Heartbeat::TriggerScrubVectorIndex(void*) {
   // Free at ExecuteRoutine()
   TaskRunnable* task = new VectorIndexScrubTask();
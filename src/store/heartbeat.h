@@ -17,9 +17,14 @@
 
 #include <atomic>
 #include <cstdint>
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "brpc/channel.h"
+#include "bthread/types.h"
 #include "common/logging.h"
 #include "common/runnable.h"
 #include "coordinator/coordinator_control.h"
@@ -32,6 +37,58 @@
 
 namespace dingodb {
 
+// Remember what the last store heartbeat reported for each region,
+// so the periodic heartbeat only carry the regions which epoch/leader/state/raft status/metrics changed.
+// All method is called in the heartbeat execution queue, but still protect by mutex for safe.
+class RegionHeartbeatTracker {
+ public:
+  struct Digest {
+    uint64_t conf_version{0};
+    uint64_t version{0};
+    uint64_t leader_store_id{0};
+    pb::common::StoreRegionState store_region_state{pb::common::StoreRegionState::NEW};
+    pb::common::RaftNodeState raft_state{pb::common::RaftNodeState::STATE_NONE};
+    int64_t term{0};
+    std::string leader_peer_id;
+    int32_t stable_follower_count{0};
+    int32_t unstable_follower_count{0};
+    uint32_t vector_index_status{0};
+    uint64_t row_count{0};
+    uint64_t region_size{0};
+    int64_t vector_index_count{0};
+    int64_t vector_index_memory_bytes{0};
+    uint64_t write_qps{0};
+  };
+
+  RegionHeartbeatTracker() { bthread_mutex_init(&mutex_, nullptr); }
+  ~RegionHeartbeatTracker() { bthread_mutex_destroy(&mutex_); }
+
+  RegionHeartbeatTracker(const RegionHeartbeatTracker&) = delete;
+  const RegionHeartbeatTracker& operator=(const RegionHeartbeatTracker&) = delete;
+
+  static RegionHeartbeatTracker& GetInstance();
+
+  static Digest GenDigest(const pb::common::RegionMetrics& region_metrics);
+  // Digest is changed beyond threshold, need report to coordinator.
+  static bool IsChanged(const Digest& old_digest, const Digest& new_digest, double change_ratio);
+
+  // Next heartbeat version, and whether this heartbeat should carry all region.
+  uint64_t NextVersion(bool& is_full);
+  // Force next heartbeat carry all region, e.g. coordinator lost delta or rpc failed.
+  void ForceFull();
+
+  bool NeedReport(uint64_t region_id, const Digest& digest, double change_ratio);
+  // Record reported region digest, return region ids which were reported before but not exist now.
+  std::vector<uint64_t> Commit(const std::map<uint64_t, Digest>& reported, const std::set<uint64_t>& alive_region_ids);
+
+ private:
+  bthread_mutex_t mutex_;
+  uint64_t version_{0};
+  uint64_t heartbeat_count_{0};
+  bool force_full_{true};
+  std::map<uint64_t, Digest> digests_;
+};
+
 class HeartbeatTask : public TaskRunnable {
  public:
   HeartbeatTask(std::shared_ptr<CoordinatorInteraction> coordinator_interaction)
@@ -166,6 +223,21 @@ class CompactionTask : public TaskRunnable {
   std::shared_ptr<CoordinatorControl> coordinator_control_;
 };
 
+class BalanceTask : public TaskRunnable {
+ public:
+  BalanceTask(std::shared_ptr<CoordinatorControl> coordinator_control) : coordinator_control_(coordinator_control) {}
+  ~BalanceTask() override = default;
+
+  void Run() override {
+    DINGO_LOG(DEBUG) << "start process BalanceTask";
+    ExecBalanceTask(coordinator_control_);
+  }
+
+ private:
+  static void ExecBalanceTask(std::shared_ptr<CoordinatorControl> coordinator_control);
+  std::shared_ptr<CoordinatorControl> coordinator_control_;
+};
+
 class VectorIndexScrubTask : public TaskRunnable {
  public:
   VectorIndexScrubTask() = default;
@@ -196,6 +268,7 @@ class Heartbeat {
   static void TriggerScrubVectorIndex(void*);
   static void TriggerLeaseTask(void*);
   static void TriggerCompactionTask(void*);
+  static void TriggerBalanceTask(void*);
 
   static butil::Status RpcSendPushStoreOperation(const pb::common::Location& location,
                                                  pb::push::PushStoreOperationRequest& request,
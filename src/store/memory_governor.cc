@@ -0,0 +1,220 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "store/memory_governor.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "bthread/mutex.h"
+#include "butil/memory/singleton.h"
+#include "butil/scoped_lock.h"
+#include "common/constant.h"
+#include "common/helper.h"
+#include "common/logging.h"
+#include "fmt/core.h"
+#include "gflags/gflags.h"
+#include "proto/error.pb.h"
+
+namespace dingodb {
+
+DEFINE_double(memory_governor_limit_ratio, 0.8, "store memory limit ratio of system memory when not config");
+DEFINE_double(memory_governor_block_cache_ratio, 0.25, "block cache ratio of store memory limit");
+DEFINE_double(memory_governor_write_buffer_ratio, 0.15, "memtable ratio of store memory limit");
+DEFINE_double(memory_governor_vector_index_ratio, 0.5, "vector index ratio of store memory limit");
+DEFINE_bool(rocksdb_cache_index_and_filter_blocks, true, "cache index and filter blocks in block cache");
+
+MemoryGovernor::MemoryGovernor()
+    : block_cache_usage_metrics_("memory_governor_block_cache_usage", &MemoryGovernor::GetBlockCacheUsage, this),
+      write_buffer_usage_metrics_("memory_governor_write_buffer_usage", &MemoryGovernor::GetWriteBufferUsage, this),
+      vector_index_usage_metrics_("memory_governor_vector_index_usage", &MemoryGovernor::GetVectorIndexUsage, this) {
+  bthread_mutex_init(&mutex_, nullptr);
+}
+
+MemoryGovernor::~MemoryGovernor() { bthread_mutex_destroy(&mutex_); }
+
+MemoryGovernor* MemoryGovernor::GetInstance() { return Singleton<MemoryGovernor>::get(); }
+
+bool MemoryGovernor::Init(std::shared_ptr<Config> config) {
+  int64_t memory_limit = config->GetInt64(Constant::kStoreMemoryLimitConfigName);
+  if (memory_limit <= 0) {
+    std::map<std::string, uint64_t> output;
+    if (!Helper::GetSystemMemoryInfo(output)) {
+      DINGO_LOG(ERROR) << "[memory_governor] get system memory info failed.";
+      return false;
+    }
+    memory_limit = static_cast<int64_t>(output["system_total_memory"] * FLAGS_memory_governor_limit_ratio);
+  }
+  memory_limit_ = memory_limit;
+
+  uint64_t block_cache_size = memory_limit_ * FLAGS_memory_governor_block_cache_ratio;
+  uint64_t write_buffer_size = memory_limit_ * FLAGS_memory_governor_write_buffer_ratio;
+  vector_index_limit_ = memory_limit_ * FLAGS_memory_governor_vector_index_ratio;
+
+  // memtable memory is charged to block cache, so the cache capacity include the write buffer.
+  block_cache_ = rocksdb::NewLRUCache(block_cache_size + write_buffer_size);
+  write_buffer_manager_ = std::make_shared<rocksdb::WriteBufferManager>(write_buffer_size, block_cache_);
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[memory_governor] memory limit({}) block cache({}) write buffer({}) vector index({}) cache index and filter({})",
+      memory_limit_, block_cache_size, write_buffer_size, vector_index_limit_,
+      FLAGS_rocksdb_cache_index_and_filter_blocks);
+
+  return true;
+}
+
+bool MemoryGovernor::IsCacheIndexAndFilterBlocks() const { return FLAGS_rocksdb_cache_index_and_filter_blocks; }
+
+butil::Status MemoryGovernor::AdmitVectorIndex(uint64_t vector_index_id, uint64_t estimate_size) {
+  if (vector_index_limit_ == 0) {
+    return butil::Status::OK();
+  }
+
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (vector_index_memory_usage_ + vector_index_reserved_memory_ + estimate_size > vector_index_limit_) {
+    std::string s =
+        fmt::format("vector index {} memory not enough, usage({}) reserved({}) estimate({}) limit({})", vector_index_id,
+                    vector_index_memory_usage_, vector_index_reserved_memory_, estimate_size, vector_index_limit_);
+    DINGO_LOG(WARNING) << "[memory_governor] " << s;
+    return butil::Status(pb::error::ESYSTEM_MEMORY_CAPACITY_FULL, s);
+  }
+
+  vector_index_reserves_[vector_index_id] += estimate_size;
+  vector_index_reserved_memory_ += estimate_size;
+
+  return butil::Status::OK();
+}
+
+// Call with mutex_ locked.
+static uint64_t ReleaseReserve(std::map<uint64_t, uint64_t>& reserves, uint64_t vector_index_id, uint64_t size) {
+  auto it = reserves.find(vector_index_id);
+  if (it == reserves.end()) {
+    return 0;
+  }
+
+  uint64_t release_size = std::min(it->second, size);
+  it->second -= release_size;
+  if (it->second == 0) {
+    reserves.erase(it);
+  }
+
+  return release_size;
+}
+
+void MemoryGovernor::ReleaseVectorIndex(uint64_t vector_index_id, uint64_t estimate_size) {
+  BAIDU_SCOPED_LOCK(mutex_);
+  vector_index_reserved_memory_ -= ReleaseReserve(vector_index_reserves_, vector_index_id, estimate_size);
+}
+
+uint64_t MemoryGovernor::EstimateVectorIndexMemory(const pb::common::VectorIndexParameter& parameter,
+                                                   uint64_t element_count) {
+  // vector id map of faiss and hnsw label
+  const uint64_t id_size = sizeof(int64_t);
+
+  switch (parameter.vector_index_type()) {
+    case pb::common::VECTOR_INDEX_TYPE_FLAT: {
+      uint64_t dimension = parameter.flat_parameter().dimension();
+      return element_count * (dimension * sizeof(float) + id_size);
+    }
+    case pb::common::VECTOR_INDEX_TYPE_IVF_FLAT: {
+      uint64_t dimension = parameter.ivf_flat_parameter().dimension();
+      uint64_t ncentroids = std::max(parameter.ivf_flat_parameter().ncentroids(), 0);
+      return element_count * (dimension * sizeof(float) + id_size) + ncentroids * dimension * sizeof(float);
+    }
+    case pb::common::VECTOR_INDEX_TYPE_IVF_PQ: {
+      const auto& ivf_pq_parameter = parameter.ivf_pq_parameter();
+      uint64_t dimension = ivf_pq_parameter.dimension();
+      uint64_t ncentroids = std::max(ivf_pq_parameter.ncentroids(), 0);
+      uint64_t nsubvector = std::max(ivf_pq_parameter.nsubvector(), 0);
+      // 8 bits per sub vector code, the codebook has 256 centroids of dimension / nsubvector for each sub vector
+      uint64_t code_size = nsubvector;
+      uint64_t codebook_size = 256 * dimension * sizeof(float);
+      return element_count * (code_size + id_size) + ncentroids * dimension * sizeof(float) + codebook_size;
+    }
+    case pb::common::VECTOR_INDEX_TYPE_HNSW: {
+      const auto& hnsw_parameter = parameter.hnsw_parameter();
+      uint64_t dimension = hnsw_parameter.dimension();
+      uint64_t max_elements = std::max(static_cast<uint64_t>(hnsw_parameter.max_elements()), element_count);
+      // level 0 data and links (2 * nlinks), label, element level, link list lock and upper level pointer
+      uint64_t nlinks = std::max(hnsw_parameter.nlinks(), 0);
+      uint64_t element_size = dimension * sizeof(float) + (nlinks * 2 + 1) * sizeof(uint32_t) +
+                              id_size + sizeof(int) + sizeof(std::mutex) + sizeof(void*);
+      return max_elements * element_size;
+    }
+    default:
+      return 0;
+  }
+}
+
+void MemoryGovernor::UpdateVectorIndexMemory(uint64_t vector_index_id, uint64_t memory_size) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto& old_memory_size = vector_index_memorys_[vector_index_id];
+  vector_index_memory_usage_ = vector_index_memory_usage_ - old_memory_size + memory_size;
+  old_memory_size = memory_size;
+}
+
+void MemoryGovernor::ChargeVectorIndexMemory(uint64_t vector_index_id, uint64_t memory_size) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  vector_index_memorys_[vector_index_id] += memory_size;
+  vector_index_memory_usage_ += memory_size;
+  vector_index_reserved_memory_ -= ReleaseReserve(vector_index_reserves_, vector_index_id, memory_size);
+}
+
+void MemoryGovernor::RemoveVectorIndexMemory(uint64_t vector_index_id) {
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  auto it = vector_index_memorys_.find(vector_index_id);
+  if (it != vector_index_memorys_.end()) {
+    vector_index_memory_usage_ -= it->second;
+    vector_index_memorys_.erase(it);
+  }
+
+  auto reserve_it = vector_index_reserves_.find(vector_index_id);
+  if (reserve_it != vector_index_reserves_.end()) {
+    vector_index_reserved_memory_ -= reserve_it->second;
+    vector_index_reserves_.erase(reserve_it);
+  }
+}
+
+uint64_t MemoryGovernor::VectorIndexMemoryUsage() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return vector_index_memory_usage_;
+}
+
+uint64_t MemoryGovernor::VectorIndexReservedMemory() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return vector_index_reserved_memory_;
+}
+
+uint64_t MemoryGovernor::GetBlockCacheUsage(void* arg) {
+  auto* governor = static_cast<MemoryGovernor*>(arg);
+  return governor->block_cache_ != nullptr ? governor->block_cache_->GetUsage() : 0;
+}
+
+uint64_t MemoryGovernor::GetWriteBufferUsage(void* arg) {
+  auto* governor = static_cast<MemoryGovernor*>(arg);
+  return governor->write_buffer_manager_ != nullptr ? governor->write_buffer_manager_->memory_usage() : 0;
+}
+
+uint64_t MemoryGovernor::GetVectorIndexUsage(void* arg) {
+  return static_cast<MemoryGovernor*>(arg)->VectorIndexMemoryUsage();
+}
+
+}  // namespace dingodb
@@ -0,0 +1,102 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_STORE_MEMORY_GOVERNOR_H_
+#define DINGODB_STORE_MEMORY_GOVERNOR_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+
+#include "bthread/types.h"
+#include "butil/status.h"
+#include "bvar/passive_status.h"
+#include "config/config.h"
+#include "proto/common.pb.h"
+#include "rocksdb/cache.h"
+#include "rocksdb/write_buffer_manager.h"
+
+template <typename T>
+struct DefaultSingletonTraits;
+
+namespace dingodb {
+
+// Store level memory budget, split into block cache, memtable and vector index.
+// All column families share one block cache, the memtable memory is charged to the same cache
+// by WriteBufferManager, so block cache and memtable never exceed their sum together.
+// Vector index is the biggest consumer, build and load is admitted by the vector index budget.
+class MemoryGovernor {
+ public:
+  static MemoryGovernor* GetInstance();
+
+  MemoryGovernor(const MemoryGovernor&) = delete;
+  const MemoryGovernor& operator=(const MemoryGovernor&) = delete;
+
+  bool Init(std::shared_ptr<Config> config);
+
+  uint64_t MemoryLimit() const { return memory_limit_; }
+
+  std::shared_ptr<rocksdb::Cache> GetBlockCache() { return block_cache_; }
+  std::shared_ptr<rocksdb::WriteBufferManager> GetWriteBufferManager() { return write_buffer_manager_; }
+  bool IsCacheIndexAndFilterBlocks() const;
+
+  // Check whether the vector index can hold estimate_size memory more, used before build, load or grow.
+  // The admitted estimate_size is reserved, so parallel admissions never exceed the limit together.
+  // The reservation is released by ReleaseVectorIndex or consumed by ChargeVectorIndexMemory.
+  butil::Status AdmitVectorIndex(uint64_t vector_index_id, uint64_t estimate_size);
+  void ReleaseVectorIndex(uint64_t vector_index_id, uint64_t estimate_size);
+  // Estimate the vector index memory by parameter, used when the index is not in memory yet.
+  // HNSW preallocate max_elements, other types grow with element_count.
+  static uint64_t EstimateVectorIndexMemory(const pb::common::VectorIndexParameter& parameter,
+                                            uint64_t element_count);
+  void UpdateVectorIndexMemory(uint64_t vector_index_id, uint64_t memory_size);
+  // Add memory_size to the vector index, used when the index grow between metrics collection.
+  // The reservation of the vector index is consumed up to memory_size.
+  void ChargeVectorIndexMemory(uint64_t vector_index_id, uint64_t memory_size);
+  void RemoveVectorIndexMemory(uint64_t vector_index_id);
+  uint64_t VectorIndexMemoryUsage();
+  uint64_t VectorIndexReservedMemory();
+
+ private:
+  MemoryGovernor();
+  ~MemoryGovernor();
+
+  friend struct DefaultSingletonTraits<MemoryGovernor>;
+
+  static uint64_t GetBlockCacheUsage(void* arg);
+  static uint64_t GetWriteBufferUsage(void* arg);
+  static uint64_t GetVectorIndexUsage(void* arg);
+
+  uint64_t memory_limit_{0};
+  uint64_t vector_index_limit_{0};
+
+  std::shared_ptr<rocksdb::Cache> block_cache_;
+  std::shared_ptr<rocksdb::WriteBufferManager> write_buffer_manager_;
+
+  bthread_mutex_t mutex_;
+  // vector_index_id -> memory size
+  std::map<uint64_t, uint64_t> vector_index_memorys_;
+  uint64_t vector_index_memory_usage_{0};
+  // vector_index_id -> reserved size of admitted build, load or grow
+  std::map<uint64_t, uint64_t> vector_index_reserves_;
+  uint64_t vector_index_reserved_memory_{0};
+
+  bvar::PassiveStatus<uint64_t> block_cache_usage_metrics_;
+  bvar::PassiveStatus<uint64_t> write_buffer_usage_metrics_;
+  bvar::PassiveStatus<uint64_t> vector_index_usage_metrics_;
+};
+
+}  // namespace dingodb
+
+#endif  // DINGODB_STORE_MEMORY_GOVERNOR_H_
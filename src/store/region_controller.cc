@@ -191,8 +191,10 @@ butil::Status DeleteRegionTask::DeleteRegion(std::shared_ptr<Context> ctx, uint6
 
   // Delete data
   DINGO_LOG(DEBUG) << fmt::format("[control.region][region({})] delete region, delete data", region_id);
-  auto writer = engine->GetRawEngine()->NewWriter(Constant::kStoreDataCF);
-  writer->KvBatchDeleteRange(region->PhysicsRange());
+  for (const auto& cf_name : Helper::GetColumnFamilyNames(region->Type())) {
+    auto writer = engine->GetRawEngine()->NewWriter(cf_name);
+    writer->KvBatchDeleteRange(region->PhysicsRange());
+  }
 
   // Raft kv engine
   auto raft_store_engine = Server::GetInstance()->GetRaftStoreEngine();
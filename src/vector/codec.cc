@@ -15,15 +15,31 @@
 #include "vector/codec.h"
 
 #include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "common/constant.h"
 #include "common/helper.h"
 #include "common/logging.h"
+#include "gflags/gflags.h"
 #include "serial/buf.h"
 #include "serial/schema/long_schema.h"
 
 namespace dingodb {
 
+// The old version can only decode protobuf, enable it only after all stores of the cluster are upgraded,
+// otherwise the old follower can not apply or rebuild from the raw encoding data.
+DEFINE_bool(enable_vector_raw_encoding, false,
+            "encode vector data with raw float instead of protobuf, only enable after all stores are upgraded");
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "vector raw encoding require little-endian");
+
+static const char kVectorValueMagic = 0x00;
+static const char kVectorValueVersion = 0x01;
+static const size_t kVectorValueHeaderSize = 8;
+
 void VectorCodec::EncodeVectorKey(uint64_t partition_id, uint64_t vector_id, std::string& result) {
   Buf buf(16);
   buf.WriteLong(partition_id);
@@ -139,4 +155,115 @@ bool VectorCodec::IsValidKey(const std::string& key) {
   return (key.size() == 8 || key.size() == 9 || key.size() == 16 || key.size() == 17);
 }
 
-}  // namespace dingodb
\ No newline at end of file
+// Binary vector which element is not one byte can not encode by raw, fallback to protobuf.
+static bool IsRawEncodable(const pb::common::Vector& vector) {
+  if (vector.value_type() == pb::common::ValueType::FLOAT) {
+    return vector.binary_values().empty();
+  }
+
+  for (const auto& value : vector.binary_values()) {
+    if (value.size() != 1) {
+      return false;
+    }
+  }
+
+  return vector.float_values().empty();
+}
+
+void VectorCodec::EncodeVectorValue(const pb::common::Vector& vector, std::string& result) {
+  if (!FLAGS_enable_vector_raw_encoding || !IsRawEncodable(vector)) {
+    vector.SerializeToString(&result);
+    return;
+  }
+
+  bool is_float = vector.value_type() == pb::common::ValueType::FLOAT;
+  uint32_t dimension = is_float ? vector.float_values_size() : vector.binary_values_size();
+  size_t values_size = is_float ? dimension * sizeof(float) : dimension;
+
+  result.resize(kVectorValueHeaderSize + values_size);
+  char* data = result.data();
+  data[0] = kVectorValueMagic;
+  data[1] = kVectorValueVersion;
+  data[2] = static_cast<char>(vector.value_type());
+  data[3] = 0;
+  memcpy(data + 4, &dimension, sizeof(dimension));
+
+  data += kVectorValueHeaderSize;
+  if (is_float) {
+    memcpy(data, vector.float_values().data(), values_size);
+  } else {
+    for (const auto& value : vector.binary_values()) {
+      *data++ = value[0];
+    }
+  }
+}
+
+static bool DecodeVectorValueHeader(std::string_view value, pb::common::ValueType& value_type, uint32_t& dimension) {
+  if (value.size() < kVectorValueHeaderSize || value[1] != kVectorValueVersion) {
+    return false;
+  }
+
+  value_type = static_cast<pb::common::ValueType>(value[2]);
+  memcpy(&dimension, value.data() + 4, sizeof(dimension));
+
+  size_t values_size = value_type == pb::common::ValueType::FLOAT ? dimension * sizeof(float) : dimension;
+  return value.size() == kVectorValueHeaderSize + values_size;
+}
+
+bool VectorCodec::DecodeVectorValue(std::string_view value, pb::common::Vector& vector) {
+  if (value.empty() || value[0] != kVectorValueMagic) {
+    // legacy protobuf encoding
+    return vector.ParseFromArray(value.data(), static_cast<int>(value.size()));
+  }
+
+  pb::common::ValueType value_type;
+  uint32_t dimension = 0;
+  if (!DecodeVectorValueHeader(value, value_type, dimension)) {
+    DINGO_LOG(ERROR) << "Decode vector value failed, value size: " << value.size();
+    return false;
+  }
+
+  vector.set_dimension(dimension);
+  vector.set_value_type(value_type);
+  const char* data = value.data() + kVectorValueHeaderSize;
+  if (value_type == pb::common::ValueType::FLOAT) {
+    auto* float_values = vector.mutable_float_values();
+    float_values->Resize(dimension, 0.0f);
+    memcpy(float_values->mutable_data(), data, dimension * sizeof(float));
+  } else {
+    auto* binary_values = vector.mutable_binary_values();
+    binary_values->Reserve(dimension);
+    for (uint32_t i = 0; i < dimension; ++i) {
+      binary_values->Add()->assign(1, data[i]);
+    }
+  }
+
+  return true;
+}
+
+bool VectorCodec::DecodeVectorFloatValues(std::string_view value, std::vector<float>& float_values) {
+  if (value.empty() || value[0] != kVectorValueMagic) {
+    // legacy protobuf encoding
+    pb::common::Vector vector;
+    if (!vector.ParseFromArray(value.data(), static_cast<int>(value.size())) ||
+        vector.value_type() != pb::common::ValueType::FLOAT) {
+      return false;
+    }
+    float_values.insert(float_values.end(), vector.float_values().begin(), vector.float_values().end());
+    return true;
+  }
+
+  pb::common::ValueType value_type;
+  uint32_t dimension = 0;
+  if (!DecodeVectorValueHeader(value, value_type, dimension) || value_type != pb::common::ValueType::FLOAT) {
+    return false;
+  }
+
+  size_t offset = float_values.size();
+  float_values.resize(offset + dimension);
+  memcpy(float_values.data() + offset, value.data() + kVectorValueHeaderSize, dimension * sizeof(float));
+
+  return true;
+}
+
+}  // namespace dingodb
@@ -17,6 +17,8 @@
 
 #include <cstdint>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "proto/common.pb.h"
 
@@ -40,6 +42,15 @@ class VectorCodec {
   static std::string RemoveVectorPrefix(const std::string& value);
 
   static bool IsValidKey(const std::string& key);
+
+  // Vector data value.
+  // Format: magic(1B, 0x00)/version(1B)/value_type(1B)/reserved(1B)/dimension(4B)/values(little-endian)
+  // The first byte of protobuf encoded pb::common::Vector is never 0x00(field number 0 is invalid),
+  // so the legacy protobuf value can be decoded too.
+  static void EncodeVectorValue(const pb::common::Vector& vector, std::string& result);
+  static bool DecodeVectorValue(std::string_view value, pb::common::Vector& vector);
+  // Append float values to float_values without construct pb::common::Vector, return false if not float vector.
+  static bool DecodeVectorFloatValues(std::string_view value, std::vector<float>& float_values);
 };
 
 }  // namespace dingodb
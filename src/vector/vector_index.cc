@@ -27,6 +27,7 @@
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "server/server.h"
+#include "store/memory_governor.h"
 #include "vector/codec.h"
 #include "vector/vector_index_snapshot_manager.h"
 
@@ -68,7 +69,8 @@ butil::Status VectorIndex::GetMemorySize([[maybe_unused]] uint64_t& memory_size)
 }
 
 VectorIndexWrapper::~VectorIndexWrapper() {
-  ClearVectorIndex();
+  vector_indexs_[0] = nullptr;
+  vector_indexs_[1] = nullptr;
   if (snapshot_set_ != nullptr) {
     snapshot_set_->ClearSnapshot();
   }
@@ -102,6 +104,8 @@ void VectorIndexWrapper::Destroy() {
   DINGO_LOG(INFO) << fmt::format("[vector_index.wrapper][index_id({})] vector index destroy.", Id());
   stop_.store(true);
   worker_->Destroy();
+
+  MemoryGovernor::GetInstance()->RemoveVectorIndexMemory(Id());
 }
 
 bool VectorIndexWrapper::Recover() {
@@ -262,6 +266,10 @@ void VectorIndexWrapper::UpdateVectorIndex(VectorIndexPtr vector_index, const st
 
     SaveMeta();
   }
+
+  uint64_t memory_size = 0;
+  vector_index->GetMemorySize(memory_size);
+  MemoryGovernor::GetInstance()->UpdateVectorIndexMemory(Id(), memory_size);
 }
 
 void VectorIndexWrapper::ClearVectorIndex() {
@@ -272,6 +280,8 @@ void VectorIndexWrapper::ClearVectorIndex() {
   ready_.store(false);
   vector_indexs_[0] = nullptr;
   vector_indexs_[1] = nullptr;
+
+  MemoryGovernor::GetInstance()->RemoveVectorIndexMemory(Id());
 }
 
 VectorIndexPtr VectorIndexWrapper::GetOwnVectorIndex() { return vector_indexs_[active_index_.load()]; }
@@ -365,6 +375,24 @@ bool VectorIndexWrapper::NeedToRebuild() {
   return vector_index->NeedToRebuild();
 }
 
+bool VectorIndexWrapper::NeedToCompact() {
+  auto vector_index = GetOwnVectorIndex();
+  if (vector_index == nullptr) {
+    return false;
+  }
+
+  return vector_index->NeedToCompact();
+}
+
+butil::Status VectorIndexWrapper::Compact() {
+  auto vector_index = GetOwnVectorIndex();
+  if (vector_index == nullptr) {
+    return butil::Status(pb::error::EVECTOR_INDEX_NOT_FOUND, "vector index %lu is not ready.", Id());
+  }
+
+  return vector_index->Compact();
+}
+
 bool VectorIndexWrapper::SupportSave() {
   auto vector_index = GetOwnVectorIndex();
   if (vector_index == nullptr) {
@@ -227,6 +227,8 @@ class VectorIndex {
   virtual butil::Status Train(const std::vector<float>& train_datas) = 0;
   virtual butil::Status Train(const std::vector<pb::common::VectorWithId>& vectors) = 0;
   virtual bool NeedToRebuild() = 0;
+  virtual bool NeedToCompact() { return false; }
+  virtual butil::Status Compact() { return butil::Status::OK(); }
   virtual bool NeedTrain() { return false; }
   virtual bool IsTrained() { return true; }
   virtual bool SupportSave() { return false; }
@@ -327,6 +329,9 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
     return rebuild_error_.load();
   }
 
+  bool IsBuildDeferred() { return build_deferred_.load(); }
+  void SetBuildDeferred(bool deferred) { build_deferred_.store(deferred); }
+
   pb::common::VectorIndexType Type() { return vector_index_type_; }
 
   pb::common::VectorIndexParameter IndexParameter() { return index_parameter_; }
@@ -370,6 +375,8 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
 
   bool NeedToRebuild();
   bool NeedToSave(uint64_t last_save_log_behind);
+  bool NeedToCompact();
+  butil::Status Compact();
   bool SupportSave();
 
   butil::Status Add(const std::vector<pb::common::VectorWithId>& vector_with_ids);
@@ -394,6 +401,8 @@ class VectorIndexWrapper : public std::enable_shared_from_this<VectorIndexWrappe
   std::atomic<bool> build_error_{false};
   // vector index rebuild status
   std::atomic<bool> rebuild_error_{false};
+  // load or build is deferred by memory admission, scrub retry it later
+  std::atomic<bool> build_deferred_{false};
   // status
   std::atomic<pb::common::RegionVectorIndexStatus> status_;
   // vector index type, e.g. hnsw/flat
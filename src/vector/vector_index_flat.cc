@@ -32,6 +32,7 @@
 #include "faiss/Index.h"
 #include "faiss/MetricType.h"
 #include "fmt/core.h"
+#include "gflags/gflags.h"
 #include "hnswlib/space_ip.h"
 #include "hnswlib/space_l2.h"
 #include "proto/common.pb.h"
@@ -42,11 +43,15 @@
 
 namespace dingodb {
 
+DEFINE_double(vector_index_flat_compact_deleted_ratio, 0.2, "compact flat index when deleted slot exceed this ratio");
+DEFINE_uint64(vector_index_flat_compact_min_deleted_count, 10000, "min deleted slot count to compact flat index");
+
 VectorIndexFlat::VectorIndexFlat(uint64_t id, const pb::common::VectorIndexParameter& vector_index_parameter,
                                  const pb::common::Range& range)
     : VectorIndex(id, vector_index_parameter, range) {
   bthread_mutex_init(&mutex_, nullptr);
 
+  deleted_count_ = 0;
   metric_type_ = vector_index_parameter.flat_parameter().metric_type();
   dimension_ = vector_index_parameter.flat_parameter().dimension();
 
@@ -64,12 +69,10 @@ VectorIndexFlat::VectorIndexFlat(uint64_t id, const pb::common::VectorIndexParam
                                       static_cast<int>(metric_type_));
     raw_index_ = std::make_unique<faiss::IndexFlatL2>(dimension_);
   }
-
-  index_id_map2_ = std::make_unique<faiss::IndexIDMap2>(raw_index_.get());
 }
 
 VectorIndexFlat::~VectorIndexFlat() {
-  index_id_map2_->reset();
+  raw_index_->reset();
   bthread_mutex_destroy(&mutex_);
 }
 
@@ -85,8 +88,10 @@ VectorIndexFlat::~VectorIndexFlat() {
 //   }
 // }
 
+// The exist vector is overwritten at its slot and the new vector is appended,
+// so the cost is proportional to the batch size instead of the index size.
 butil::Status VectorIndexFlat::AddOrUpsert(const std::vector<pb::common::VectorWithId>& vector_with_ids,
-                                           bool is_upsert) {
+                                           bool /*is_upsert*/) {
   if (vector_with_ids.empty()) {
     return butil::Status::OK();
   }
@@ -100,26 +105,6 @@ butil::Status VectorIndexFlat::AddOrUpsert(const std::vector<pb::common::VectorW
     return butil::Status(pb::error::Errno::EVECTOR_INVALID, s);
   }
 
-  std::unique_ptr<faiss::idx_t[]> ids;
-  try {
-    ids.reset(new faiss::idx_t[vector_with_ids.size()]);
-  } catch (std::bad_alloc& e) {
-    std::string s = fmt::format("Failed to allocate memory for ids: {}", e.what());
-    DINGO_LOG(ERROR) << s;
-    return butil::Status(pb::error::Errno::EVECTOR_INVALID, "Failed to allocate memory for ids, error: %s", e.what());
-  }
-
-  for (size_t i = 0; i < vector_with_ids.size(); ++i) {
-    ids.get()[i] = static_cast<faiss::idx_t>(vector_with_ids[i].id());
-  }
-
-  BAIDU_SCOPED_LOCK(mutex_);
-
-  if (is_upsert) {
-    faiss::IDSelectorArray sel(vector_with_ids.size(), ids.get());
-    index_id_map2_->remove_ids(sel);
-  }
-
   std::unique_ptr<float[]> vectors;
   try {
     vectors.reset(new float[vector_with_ids.size() * dimension_]);
@@ -139,7 +124,38 @@ butil::Status VectorIndexFlat::AddOrUpsert(const std::vector<pb::common::VectorW
     }
   }
 
-  index_id_map2_->add_with_ids(vector_with_ids.size(), vectors.get(), ids.get());
+  BAIDU_SCOPED_LOCK(mutex_);
+
+  faiss::idx_t ntotal = raw_index_->ntotal;
+  float* xb = raw_index_->get_xb();
+
+  // the new vectors are moved to the front of vectors, then append together
+  size_t new_count = 0;
+  for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+    auto vector_id = static_cast<faiss::idx_t>(vector_with_ids[i].id());
+    const float* vector = vectors.get() + i * dimension_;
+
+    auto it = id_to_slot_.find(vector_id);
+    if (it != id_to_slot_.end()) {
+      // duplicate id in the batch maybe not appended yet
+      float* dst = it->second < ntotal ? xb + it->second * dimension_
+                                       : vectors.get() + (it->second - ntotal) * dimension_;
+      memmove(dst, vector, dimension_ * sizeof(float));
+      continue;
+    }
+
+    if (new_count != i) {
+      memmove(vectors.get() + new_count * dimension_, vector, dimension_ * sizeof(float));
+    }
+    id_to_slot_[vector_id] = ntotal + new_count;
+    slot_ids_.push_back(vector_id);
+    tombstones_.push_back(false);
+    ++new_count;
+  }
+
+  if (new_count > 0) {
+    raw_index_->add(new_count, vectors.get());
+  }
 
   return butil::Status::OK();
 }
@@ -152,31 +168,27 @@ butil::Status VectorIndexFlat::Add(const std::vector<pb::common::VectorWithId>&
   return AddOrUpsert(vector_with_ids, false);
 }
 
+// Mark the slot as tombstone, the slot is reclaimed by Compact.
 butil::Status VectorIndexFlat::Delete(const std::vector<uint64_t>& delete_ids) {
   if (delete_ids.empty()) {
     DINGO_LOG(WARNING) << "delete ids is empty";
     return butil::Status::OK();
   }
 
-  std::unique_ptr<faiss::idx_t[]> ids;
-  try {
-    ids.reset(new faiss::idx_t[delete_ids.size()]);
-  } catch (std::bad_alloc& e) {
-    std::string s = fmt::format("Failed to allocate memory for ids: {}", e.what());
-    DINGO_LOG(ERROR) << s;
-    return butil::Status(pb::error::Errno::EVECTOR_INVALID, "Failed to allocate memory for ids, error: %s", e.what());
-  }
-
-  for (size_t i = 0; i < delete_ids.size(); ++i) {
-    ids.get()[i] = static_cast<faiss::idx_t>(delete_ids[i]);
-  }
-
-  faiss::IDSelectorArray sel(delete_ids.size(), ids.get());
-
   size_t remove_count = 0;
   {
     BAIDU_SCOPED_LOCK(mutex_);
-    remove_count = index_id_map2_->remove_ids(sel);
+    for (auto delete_id : delete_ids) {
+      auto it = id_to_slot_.find(static_cast<faiss::idx_t>(delete_id));
+      if (it == id_to_slot_.end()) {
+        continue;
+      }
+
+      tombstones_[it->second] = true;
+      id_to_slot_.erase(it);
+      ++deleted_count_;
+      ++remove_count;
+    }
   }
 
   if (0 == remove_count) {
@@ -208,20 +220,13 @@ butil::Status VectorIndexFlat::Search(std::vector<pb::common::VectorWithId> vect
     return butil::Status(pb::error::Errno::EINTERNAL, s);
   }
 
-  std::vector<faiss::Index::distance_t> distances;
-  distances.resize(topk * vector_with_ids.size(), 0.0f);
-  std::vector<faiss::idx_t> labels;
-  labels.resize(topk * vector_with_ids.size(), -1);
-
-  std::unique_ptr<float[]> vectors;
-  try {
-    vectors.reset(new float[vector_with_ids.size() * dimension_]);
-  } catch (std::bad_alloc& e) {
-    std::string s = fmt::format("Failed to allocate memory for vectors: {}", e.what());
-    DINGO_LOG(ERROR) << s;
-    return butil::Status(pb::error::Errno::EVECTOR_INVALID, "Failed to allocate memory for vectors, error: %s",
-                         e.what());
-  }
+  VectorSearchScratchGuard scratch;
+  auto& distances = scratch->distances;
+  distances.assign(topk * vector_with_ids.size(), 0.0f);
+  auto& labels = scratch->labels;
+  labels.assign(topk * vector_with_ids.size(), -1);
+  auto& vectors = scratch->vectors;
+  vectors.resize(vector_with_ids.size() * dimension_);
 
   for (size_t i = 0; i < vector_with_ids.size(); ++i) {
     if (vector_with_ids[i].vector().float_values_size() != this->dimension_) {
@@ -236,10 +241,10 @@ butil::Status VectorIndexFlat::Search(std::vector<pb::common::VectorWithId> vect
                       vector_with_ids[i].id(), vector_with_ids[i].vector().float_values_size(), this->dimension_));
     } else {
       const auto& vector = vector_with_ids[i].vector().float_values();
-      memcpy(vectors.get() + i * dimension_, vector.data(), dimension_ * sizeof(float));
+      memcpy(vectors.data() + i * dimension_, vector.data(), dimension_ * sizeof(float));
 
       if (normalize_) {
-        VectorIndexUtils::NormalizeVectorForFaiss(vectors.get() + i * dimension_, dimension_);
+        VectorIndexUtils::NormalizeVectorForFaiss(vectors.data() + i * dimension_, dimension_);
       }
     }
   }
@@ -250,24 +255,22 @@ butil::Status VectorIndexFlat::Search(std::vector<pb::common::VectorWithId> vect
     BAIDU_SCOPED_LOCK(mutex_);
     // use std::thread to call faiss functions
     std::thread t([&]() {
-      if (!filters.empty()) {
-        //   // Build array index list.
-        //   for (auto& filter : filters) {
-        //     filter->Build(index_id_map2_->id_map);
-        //   }
-        //   auto flat_filter = filters.empty() ? nullptr : std::make_shared<FlatIDSelector>(filters);
-        //   SearchWithParam(vector_with_ids.size(), vectors.get(), topk, distances.data(), labels.data(), flat_filter);
-
-        // use faiss's search_param to do pre-filter
-        auto flat_filter = filters.empty() ? nullptr : std::make_shared<FlatIDSelector>(filters);
+      if (!filters.empty() || deleted_count_ > 0) {
+        // use faiss's search_param to do pre-filter, skip the tombstone
+        auto flat_filter = std::make_shared<FlatIDSelector>(slot_ids_, tombstones_, filters);
         flat_search_parameters.sel = flat_filter.get();
-        index_id_map2_->search(vector_with_ids.size(), vectors.get(), topk, distances.data(), labels.data(),
-                               &flat_search_parameters);
+        raw_index_->search(vector_with_ids.size(), vectors.data(), topk, distances.data(), labels.data(),
+                           &flat_search_parameters);
       } else {
-        index_id_map2_->search(vector_with_ids.size(), vectors.get(), topk, distances.data(), labels.data());
+        raw_index_->search(vector_with_ids.size(), vectors.data(), topk, distances.data(), labels.data());
       }
     });
     t.join();
+
+    // slot -> vector id
+    for (auto& label : labels) {
+      label = label < 0 ? label : slot_ids_[label];
+    }
   }
 
   for (size_t row = 0; row < vector_with_ids.size(); ++row) {
@@ -315,43 +318,71 @@ butil::Status VectorIndexFlat::Load(const std::string& /*path*/) {
 int32_t VectorIndexFlat::GetDimension() { return this->dimension_; }
 
 butil::Status VectorIndexFlat::GetCount(uint64_t& count) {
-  count = index_id_map2_->id_map.size();
+  BAIDU_SCOPED_LOCK(mutex_);
+  count = id_to_slot_.size();
   return butil::Status::OK();
 }
 
 butil::Status VectorIndexFlat::GetDeletedCount(uint64_t& deleted_count) {
-  deleted_count = 0;
+  BAIDU_SCOPED_LOCK(mutex_);
+  deleted_count = deleted_count_;
   return butil::Status::OK();
 }
 
 butil::Status VectorIndexFlat::GetMemorySize(uint64_t& memory_size) {
-  auto count = index_id_map2_->ntotal;
+  BAIDU_SCOPED_LOCK(mutex_);
+  auto count = raw_index_->ntotal;
   if (count == 0) {
     memory_size = 0;
     return butil::Status::OK();
   }
 
-  memory_size = count * sizeof(faiss::idx_t) + count * dimension_ * sizeof(faiss::Index::component_t) +
-                (sizeof(faiss::idx_t) + sizeof(faiss::idx_t)) * index_id_map2_->rev_map.size();
+  memory_size = count * sizeof(faiss::idx_t) + count * dimension_ * sizeof(faiss::Index::component_t) + count / 8 +
+                (sizeof(faiss::idx_t) + sizeof(faiss::idx_t)) * id_to_slot_.size();
   return butil::Status::OK();
 }
 
 bool VectorIndexFlat::IsExceedsMaxElements() { return false; }
 
-void VectorIndexFlat::SearchWithParam(faiss::idx_t n, const faiss::Index::component_t* x, faiss::idx_t k,
-                                      faiss::Index::distance_t* distances, faiss::idx_t* labels,
-                                      std::shared_ptr<FlatIDSelector> filters) {
-  faiss::SearchParameters param;
-  param.sel = filters.get();
-  raw_index_->search(n, x, k, distances, labels, &param);
-  faiss::idx_t* li = labels;
-  // TODO: running by regular user may cause abort exception below
-  // libgomp: Thread creation failed: Resource temporarily unavailable
-  // please run by root, or adjust ulimit for regular user, then you can increase FLAGS_omp_num_threads
-#pragma omp parallel for
-  for (faiss::idx_t i = 0; i < n * k; ++i) {
-    li[i] = li[i] < 0 ? li[i] : index_id_map2_->id_map[li[i]];
+bool VectorIndexFlat::NeedToCompact() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  return deleted_count_ >= FLAGS_vector_index_flat_compact_min_deleted_count &&
+         deleted_count_ >= raw_index_->ntotal * FLAGS_vector_index_flat_compact_deleted_ratio;
+}
+
+butil::Status VectorIndexFlat::Compact() {
+  BAIDU_SCOPED_LOCK(mutex_);
+  if (deleted_count_ == 0) {
+    return butil::Status::OK();
+  }
+
+  size_t code_size = raw_index_->code_size;
+  uint8_t* codes = raw_index_->codes.data();
+  faiss::idx_t ntotal = raw_index_->ntotal;
+  faiss::idx_t alive_count = 0;
+  for (faiss::idx_t slot = 0; slot < ntotal; ++slot) {
+    if (tombstones_[slot]) {
+      continue;
+    }
+
+    if (alive_count != slot) {
+      memcpy(codes + alive_count * code_size, codes + slot * code_size, code_size);
+      slot_ids_[alive_count] = slot_ids_[slot];
+      id_to_slot_[slot_ids_[slot]] = alive_count;
+    }
+    ++alive_count;
   }
+
+  raw_index_->codes.resize(alive_count * code_size);
+  raw_index_->ntotal = alive_count;
+  slot_ids_.resize(alive_count);
+  slot_ids_.shrink_to_fit();
+  tombstones_.assign(alive_count, false);
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.flat][index_id({})] compact slot {} -> {}", id, ntotal, alive_count);
+  deleted_count_ = 0;
+
+  return butil::Status::OK();
 }
 
 }  // namespace dingodb
@@ -22,6 +22,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "bthread/mutex.h"
@@ -29,7 +30,6 @@
 #include "common/logging.h"
 #include "faiss/Index.h"
 #include "faiss/IndexFlat.h"
-#include "faiss/IndexIDMap.h"
 #include "faiss/MetricType.h"
 #include "faiss/impl/IDSelector.h"
 #include "faiss/utils/distances.h"
@@ -40,17 +40,19 @@
 
 namespace dingodb {
 
-// Filter vector id
+// Filter slot of flat index, skip the deleted slot and check the vector id of slot.
 class FlatIDSelector : public faiss::IDSelector {
  public:
-  FlatIDSelector(std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters) : filters_(filters) {}
+  FlatIDSelector(const std::vector<faiss::idx_t>& slot_ids, const std::vector<bool>& tombstones,
+                 std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters)
+      : slot_ids_(slot_ids), tombstones_(tombstones), filters_(filters) {}
   ~FlatIDSelector() override = default;
-  bool is_member(faiss::idx_t id) const override {  // NOLINT
-    if (filters_.empty()) {
-      return true;
+  bool is_member(faiss::idx_t slot) const override {  // NOLINT
+    if (tombstones_[slot]) {
+      return false;
     }
     for (const auto& filter : filters_) {
-      if (!filter->Check(id)) {
+      if (!filter->Check(slot_ids_[slot])) {
         return false;
       }
     }
@@ -59,6 +61,8 @@ class FlatIDSelector : public faiss::IDSelector {
   }
 
  private:
+  const std::vector<faiss::idx_t>& slot_ids_;
+  const std::vector<bool>& tombstones_;
   std::vector<std::shared_ptr<VectorIndex::FilterFunctor>> filters_;
 };
 
@@ -77,7 +81,7 @@ class VectorIndexFlat : public VectorIndex {
   butil::Status Save(const std::string& path) override;
   butil::Status Load(const std::string& path) override;
 
-  // in FLAT index, add two vector with same id will cause data conflict
+  // in FLAT index, add a exist vector id will overwrite the vector
   butil::Status Add(const std::vector<pb::common::VectorWithId>& vector_with_ids) override;
 
   butil::Status AddOrUpsert(const std::vector<pb::common::VectorWithId>& vector_with_ids, bool is_upsert);
@@ -107,19 +111,27 @@ class VectorIndexFlat : public VectorIndex {
 
   bool NeedToRebuild() override { return false; }
 
+  bool NeedToCompact() override;
+  // Move the alive vectors over the deleted slots and shrink the storage.
+  butil::Status Compact() override;
+
  private:
-  void SearchWithParam(faiss::idx_t n, const faiss::Index::component_t* x, faiss::idx_t k,
-                       faiss::Index::distance_t* distances, faiss::idx_t* labels,
-                       std::shared_ptr<FlatIDSelector> filters);
   // Dimension of the elements
   faiss::idx_t dimension_;
 
   // only support L2 and IP
   pb::common::MetricType metric_type_;
 
-  std::unique_ptr<faiss::Index> raw_index_;
+  // vectors are stored by slot, the slot of deleted vector is tombstone until compact
+  std::unique_ptr<faiss::IndexFlat> raw_index_;
 
-  std::unique_ptr<faiss::IndexIDMap2> index_id_map2_;
+  // slot -> vector id
+  std::vector<faiss::idx_t> slot_ids_;
+  // slot is deleted
+  std::vector<bool> tombstones_;
+  uint64_t deleted_count_;
+  // vector id -> slot, only contain the alive vector
+  std::unordered_map<faiss::idx_t, faiss::idx_t> id_to_slot_;
 
   bthread_mutex_t mutex_;
 
@@ -22,16 +22,25 @@
 #include <limits>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <queue>
+#include <shared_mutex>
 #include <stdexcept>
 #include <string>
 #include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "bthread/mutex.h"
 #include "bthread/types.h"
 #include "butil/scoped_lock.h"
 #include "butil/status.h"
+#include "butil/time.h"
+#include "bvar/latency_recorder.h"
 #include "common/constant.h"
+#include "common/helper.h"
 #include "common/logging.h"
 #include "fmt/core.h"
 #include "gflags/gflags.h"
@@ -39,12 +48,21 @@
 #include "hnswlib/space_l2.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
+#include "store/memory_governor.h"
 #include "vector/vector_index.h"
 #include "vector/vector_index_utils.h"
 
 namespace dingodb {
 
 DEFINE_uint32(max_hnsw_parallel_thread_num, 0, "max hnsw parallel thread num");
+DEFINE_bool(hnsw_replace_deleted, true, "hnsw new vector reuse the slot of deleted vector instead of rebuild");
+DEFINE_uint64(hnsw_repair_deleted_threshold, 1000, "repair hnsw neighbor lists when deleted count exceed this value");
+DEFINE_uint32(hnsw_repair_batch_size, 4096, "hnsw node count of repair neighbor lists in one lock");
+DEFINE_bool(enable_hnsw_auto_grow, true, "hnsw max elements grow automatically when the index is full");
+DEFINE_double(hnsw_auto_grow_ratio, 0.5, "hnsw max elements grow ratio of current max elements");
+DEFINE_uint64(hnsw_auto_grow_max_memory_size, 0, "hnsw index memory limit of auto grow, 0 means no limit");
+
+static bvar::LatencyRecorder g_hnsw_resize_latency("vector_index_hnsw_resize");
 
 // Filter vecotr id used by region range.
 class HnswRangeFilterFunctor : public hnswlib::BaseFilterFunctor {
@@ -136,6 +154,7 @@ VectorIndexHnsw::VectorIndexHnsw(uint64_t id, const pb::common::VectorIndexParam
                                  const pb::common::Range& range)
     : VectorIndex(id, vector_index_parameter, range), hnsw_space_(nullptr), hnsw_index_(nullptr) {
   bthread_mutex_init(&mutex_, nullptr);
+  replace_deleted_ = FLAGS_hnsw_replace_deleted;
   if (FLAGS_max_hnsw_parallel_thread_num > 0) {
     hnsw_num_threads_ = FLAGS_max_hnsw_parallel_thread_num;
   } else {
@@ -165,15 +184,23 @@ VectorIndexHnsw::VectorIndexHnsw(uint64_t id, const pb::common::VectorIndexParam
 
     // avoid error write vector index failed cause leader and follower data not consistency.
     // let user_max_elements_<actual_max_elements.
+    // when auto grow, max_elements is only the initial capacity, the index grow on apply.
     user_max_elements_ = hnsw_parameter.max_elements();
-    uint32_t actual_max_elements = user_max_elements_ + Constant::kHnswMaxElementsExpandNum;
+    uint32_t actual_max_elements =
+        FLAGS_enable_hnsw_auto_grow ? user_max_elements_ : user_max_elements_ + Constant::kHnswMaxElementsExpandNum;
 
     hnsw_index_ = new hnswlib::HierarchicalNSW<float>(hnsw_space_, actual_max_elements, hnsw_parameter.nlinks(),
-                                                      hnsw_parameter.efconstruction(), 100, false);
+                                                      hnsw_parameter.efconstruction(), 100, replace_deleted_);
   }
 }
 
 VectorIndexHnsw::~VectorIndexHnsw() {
+  // the reserved grow is never applied to this index
+  uint64_t grow_reserved_size = grow_reserved_size_.exchange(0);
+  if (grow_reserved_size > 0) {
+    MemoryGovernor::GetInstance()->ReleaseVectorIndex(Id(), grow_reserved_size);
+  }
+
   delete hnsw_index_;
   delete hnsw_space_;
 
@@ -199,6 +226,22 @@ butil::Status VectorIndexHnsw::Upsert(const std::vector<pb::common::VectorWithId
     return butil::Status(pb::error::Errno::EVECTOR_INVALID, s);
   }
 
+  // The same id in one batch would race on the label lookup in AddPoint, only the last one is added.
+  std::vector<size_t> rows;
+  rows.reserve(vector_with_ids.size());
+  {
+    std::unordered_map<uint64_t, size_t> id_rows;
+    id_rows.reserve(vector_with_ids.size());
+    for (size_t row = 0; row < vector_with_ids.size(); ++row) {
+      id_rows[vector_with_ids[row].id()] = row;
+    }
+    for (size_t row = 0; row < vector_with_ids.size(); ++row) {
+      if (id_rows[vector_with_ids[row].id()] == row) {
+        rows.push_back(row);
+      }
+    }
+  }
+
   BAIDU_SCOPED_LOCK(mutex_);
 
   // Add data to index
@@ -211,20 +254,25 @@ butil::Status VectorIndexHnsw::Upsert(const std::vector<pb::common::VectorWithId
       real_threads = 1;
     }
 
+    if (FLAGS_enable_hnsw_auto_grow) {
+      GrowMaxElements(rows.size());
+    }
+
     if (!normalize_) {
-      ParallelFor(0, vector_with_ids.size(), real_threads, [&](size_t row, size_t /*thread_id*/) {
-        this->hnsw_index_->addPoint((void*)vector_with_ids[row].vector().float_values().data(),
-                                    vector_with_ids[row].id(), false);
+      ParallelFor(0, rows.size(), real_threads, [&](size_t i, size_t /*thread_id*/) {
+        size_t row = rows[i];
+        AddPoint(vector_with_ids[row].vector().float_values().data(), vector_with_ids[row].id());
       });
     } else {
       std::vector<float> norm_array(real_threads * dimension_);
-      ParallelFor(0, vector_with_ids.size(), real_threads, [&](size_t row, size_t thread_id) {
+      ParallelFor(0, rows.size(), real_threads, [&](size_t i, size_t thread_id) {
+        size_t row = rows[i];
         // normalize vector
         size_t start_idx = thread_id * dimension_;
         VectorIndexUtils::NormalizeVectorForHnsw((float*)vector_with_ids[row].vector().float_values().data(),
                                                  dimension_, (norm_array.data() + start_idx));
 
-        this->hnsw_index_->addPoint((void*)(norm_array.data() + start_idx), vector_with_ids[row].id(), false);
+        AddPoint(norm_array.data() + start_idx, vector_with_ids[row].id());
       });
     }
     return butil::Status();
@@ -238,6 +286,33 @@ butil::Status VectorIndexHnsw::Upsert(const std::vector<pb::common::VectorWithId
   }
 }
 
+// The replace deleted path of hnswlib always take a deleted slot for the label, if the label exist already
+// the old slot is orphaned with the same label. So update the exist label in place, revive it if deleted.
+void VectorIndexHnsw::AddPoint(const void* data, uint64_t label) {
+  if (replace_deleted_) {
+    bool exist = false;
+    bool is_deleted = false;
+    {
+      std::unique_lock<std::mutex> lock_table(hnsw_index_->label_lookup_lock);
+      auto it = hnsw_index_->label_lookup_.find(label);
+      if (it != hnsw_index_->label_lookup_.end()) {
+        exist = true;
+        is_deleted = hnsw_index_->isMarkedDeleted(it->second);
+      }
+    }
+
+    if (exist) {
+      if (is_deleted) {
+        hnsw_index_->unmarkDelete(label);
+      }
+      hnsw_index_->addPoint(data, label, false);
+      return;
+    }
+  }
+
+  hnsw_index_->addPoint(data, label, replace_deleted_);
+}
+
 butil::Status VectorIndexHnsw::Delete(const std::vector<uint64_t>& delete_ids) {
   if (delete_ids.empty()) {
     DINGO_LOG(WARNING) << "delete ids is empty";
@@ -252,6 +327,7 @@ butil::Status VectorIndexHnsw::Delete(const std::vector<uint64_t>& delete_ids) {
   try {
     ParallelFor(0, delete_ids.size(), hnsw_num_threads_,
                 [&](size_t row, size_t /*thread_id*/) { hnsw_index_->markDelete(delete_ids[row]); });
+    deleted_since_repair_.fetch_add(delete_ids.size(), std::memory_order_relaxed);
   } catch (std::runtime_error& e) {
     DINGO_LOG(ERROR) << "delete vector failed, error=" << e.what();
     ret = butil::Status(pb::error::Errno::EINTERNAL, "delete vector failed, error=" + std::string(e.what()));
@@ -278,9 +354,12 @@ butil::Status VectorIndexHnsw::Load(const std::string& path) {
   // FIXME: need to prevent SEGV when delete old_hnsw_index
   if (vector_index_type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
     auto* old_hnsw_index = hnsw_index_;
-    uint32_t actual_max_elements =
-        vector_index_parameter.hnsw_parameter().max_elements() + Constant::kHnswMaxElementsExpandNum;
-    hnsw_index_ = new hnswlib::HierarchicalNSW<float>(hnsw_space_, path, false, actual_max_elements, true);
+    uint32_t actual_max_elements = vector_index_parameter.hnsw_parameter().max_elements();
+    if (!FLAGS_enable_hnsw_auto_grow) {
+      actual_max_elements += Constant::kHnswMaxElementsExpandNum;
+    }
+    hnsw_index_ =
+        new hnswlib::HierarchicalNSW<float>(hnsw_space_, path, false, actual_max_elements, replace_deleted_);
     delete old_hnsw_index;
     return butil::Status::OK();
   } else {
@@ -317,23 +396,17 @@ butil::Status VectorIndexHnsw::Search(std::vector<pb::common::VectorWithId> vect
 
   butil::Status ret;
 
-  std::unique_ptr<float[]> data;
-  try {
-    data.reset(new float[this->dimension_ * vector_with_ids.size()]);
-  } catch (std::bad_alloc& e) {
-    DINGO_LOG(ERROR) << "upsert vector failed, error=" << e.what();
-    ret = butil::Status(pb::error::Errno::EINTERNAL, "upsert vector failed, error=" + std::string(e.what()));
-    return ret;
-  }
+  VectorSearchScratchGuard scratch;
+  auto& data = scratch->vectors;
+  data.resize(this->dimension_ * vector_with_ids.size());
 
   for (size_t row = 0; row < vector_with_ids.size(); ++row) {
     if (vector_with_ids[row].vector().float_values_size() != this->dimension_) {
       return butil::Status(pb::error::Errno::EVECTOR_INVALID, "vector dimension is not match, input=%d, index=%d",
                            vector_with_ids[row].vector().float_values_size(), this->dimension_);
     }
-    for (size_t col = 0; col < this->dimension_; ++col) {
-      data.get()[row * this->dimension_ + col] = vector_with_ids[row].vector().float_values().at(col);
-    }
+    memcpy(data.data() + row * this->dimension_, vector_with_ids[row].vector().float_values().data(),
+           this->dimension_ * sizeof(float));
   }
 
   // Query the elements for themselves and measure recall
@@ -348,11 +421,11 @@ butil::Status VectorIndexHnsw::Search(std::vector<pb::common::VectorWithId> vect
   real_topks.resize(vector_with_ids.size(), 0);
 
   auto rows = vector_with_ids.size();
-  std::unique_ptr<hnswlib::labeltype[]> data_label_ptr = std::make_unique<hnswlib::labeltype[]>(rows * topk);
-  hnswlib::labeltype* data_label = data_label_ptr.get();
+  scratch->ids.resize(rows * topk);
+  hnswlib::labeltype* data_label = scratch->ids.data();
 
-  std::unique_ptr<float[]> data_distance_ptr = std::make_unique<float[]>(rows * topk);
-  float* data_distance = data_distance_ptr.get();
+  scratch->distances.resize(rows * topk);
+  float* data_distance = scratch->distances.data();
 
   auto lambda_fill_results_function = [&results, this, data_label, data_distance, &real_topks](size_t row, int topk,
                                                                                                bool reconstruct) {
@@ -411,12 +484,15 @@ butil::Status VectorIndexHnsw::Search(std::vector<pb::common::VectorWithId> vect
 
   auto hnsw_filter = filters.empty() ? nullptr : std::make_shared<HnswRangeFilterFunctor>(filters);
 
+  // prevent resize index while searching
+  std::shared_lock<BthreadRWLock> resize_lock(resize_mutex_);
+
   if (!normalize_) {
     ParallelFor(0, vector_with_ids.size(), hnsw_num_threads_, [&](size_t row, size_t /*thread_id*/) {
       std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
 
       try {
-        result = hnsw_index_->searchKnn(data.get() + dimension_ * row, topk, hnsw_filter.get());
+        result = hnsw_index_->searchKnn(data.data() + dimension_ * row, topk, hnsw_filter.get());
       } catch (std::runtime_error& e) {
         std::string s = fmt::format("parallel search vector failed, error= {}", e.what());
         LOG(ERROR) << s;
@@ -433,7 +509,7 @@ butil::Status VectorIndexHnsw::Search(std::vector<pb::common::VectorWithId> vect
     std::vector<float> norm_array(hnsw_num_threads_ * dimension_);
     ParallelFor(0, vector_with_ids.size(), hnsw_num_threads_, [&](size_t row, size_t thread_id) {
       size_t start_idx = thread_id * dimension_;
-      VectorIndexUtils::NormalizeVectorForHnsw((float*)(data.get() + dimension_ * row), dimension_,  // NOLINT
+      VectorIndexUtils::NormalizeVectorForHnsw((float*)(data.data() + dimension_ * row), dimension_,  // NOLINT
                                                (norm_array.data() + start_idx));
 
       std::priority_queue<std::pair<float, hnswlib::labeltype>> result;
@@ -475,6 +551,7 @@ butil::Status VectorIndexHnsw::ResizeMaxElements(uint64_t new_max_elements) {
   BAIDU_SCOPED_LOCK(mutex_);
 
   if (vector_index_type == pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW) {
+    std::unique_lock<BthreadRWLock> resize_lock(resize_mutex_);
     hnsw_index_->resizeIndex(new_max_elements);
     return butil::Status::OK();
   } else {
@@ -502,7 +579,84 @@ bool VectorIndexHnsw::IsExceedsMaxElements() {
     return true;
   }
 
-  return hnsw_index_->getCurrentElementCount() >= user_max_elements_;
+  uint64_t element_count = hnsw_index_->getCurrentElementCount();
+  if (replace_deleted_) {
+    element_count -= hnsw_index_->getDeletedCount();
+  }
+
+  // Only the leader check this before propose, the apply always grow the index,
+  // so leader and followers are not diverge by the memory limit.
+  if (FLAGS_enable_hnsw_auto_grow) {
+    uint64_t max_elements = hnsw_index_->getMaxElements();
+    if (element_count < max_elements) {
+      return false;
+    }
+
+    // 0 is no limit of single index
+    uint64_t new_memory_size = EstimateMemorySize(CalcGrowMaxElements(max_elements, element_count + 1));
+    if (FLAGS_hnsw_auto_grow_max_memory_size > 0 && new_memory_size > FLAGS_hnsw_auto_grow_max_memory_size) {
+      return true;
+    }
+
+    // The grown memory is reserved in the store vector index budget once, and consumed by the grow at apply.
+    uint64_t grow_memory_size = new_memory_size - EstimateMemorySize(max_elements);
+    uint64_t expected = 0;
+    if (!grow_reserved_size_.compare_exchange_strong(expected, grow_memory_size)) {
+      return false;
+    }
+    if (!MemoryGovernor::GetInstance()->AdmitVectorIndex(Id(), grow_memory_size).ok()) {
+      grow_reserved_size_.store(0);
+      return true;
+    }
+    return false;
+  }
+
+  return element_count >= user_max_elements_;
+}
+
+uint64_t VectorIndexHnsw::CalcGrowMaxElements(uint64_t max_elements, uint64_t need_elements) {
+  // grow by chunk, avoid resize frequently
+  uint64_t grow_elements = std::max(static_cast<uint64_t>(max_elements * FLAGS_hnsw_auto_grow_ratio),
+                                    static_cast<uint64_t>(Constant::kHnswMaxElementsExpandNum));
+  return std::max(max_elements + grow_elements, need_elements);
+}
+
+uint64_t VectorIndexHnsw::EstimateMemorySize(uint64_t max_elements) {
+  // level 0 data and links, the upper level links is small and ignore.
+  return max_elements * (hnsw_index_->size_data_per_element_ + sizeof(void*) + sizeof(int) + sizeof(std::mutex));
+}
+
+// Call with mutex_ locked.
+void VectorIndexHnsw::GrowMaxElements(uint64_t add_count) {
+  uint64_t max_elements = hnsw_index_->getMaxElements();
+  uint64_t need_elements = hnsw_index_->getCurrentElementCount() + add_count;
+  // the deleted slots are reused by the new vectors, same as IsExceedsMaxElements
+  if (replace_deleted_) {
+    need_elements -= std::min(need_elements, static_cast<uint64_t>(hnsw_index_->getDeletedCount()));
+  }
+  if (need_elements <= max_elements) {
+    return;
+  }
+
+  uint64_t new_max_elements = CalcGrowMaxElements(max_elements, need_elements);
+
+  int64_t start_time = butil::gettimeofday_us();
+  std::unique_lock<BthreadRWLock> resize_lock(resize_mutex_);
+  hnsw_index_->resizeIndex(new_max_elements);
+  resize_lock.unlock();
+  int64_t elapsed_time = butil::gettimeofday_us() - start_time;
+  g_hnsw_resize_latency << elapsed_time;
+
+  // charge now and consume the reservation, the next metrics collection replace it with the measured size
+  uint64_t grow_memory_size = EstimateMemorySize(new_max_elements) - EstimateMemorySize(max_elements);
+  MemoryGovernor::GetInstance()->ChargeVectorIndexMemory(Id(), grow_memory_size);
+  uint64_t grow_reserved_size = grow_reserved_size_.exchange(0);
+  if (grow_reserved_size > grow_memory_size) {
+    MemoryGovernor::GetInstance()->ReleaseVectorIndex(Id(), grow_reserved_size - grow_memory_size);
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][index_id({})] grow max elements {} -> {}, pause {}us", Id(),
+                                 max_elements, new_max_elements, elapsed_time);
 }
 
 hnswlib::HierarchicalNSW<float>* VectorIndexHnsw::GetHnswIndex() { return this->hnsw_index_; }
@@ -539,7 +693,129 @@ bool VectorIndexHnsw::NeedToRebuild() {
     return false;
   }
 
+  // the deleted slot is reused and the neighbor lists is repaired, no need to rebuild
+  if (replace_deleted_) {
+    return false;
+  }
+
   return (deleted_count > 0 && deleted_count > element_count / 2);
 }
 
+bool VectorIndexHnsw::NeedToCompact() {
+  return replace_deleted_ &&
+         deleted_since_repair_.load(std::memory_order_relaxed) >= FLAGS_hnsw_repair_deleted_threshold;
+}
+
+// Repair by batch, release the lock between batches so the write is not blocked for long time.
+butil::Status VectorIndexHnsw::Compact() {
+  if (!replace_deleted_) {
+    return butil::Status::OK();
+  }
+
+  deleted_since_repair_.store(0, std::memory_order_relaxed);
+
+  uint64_t start_time = Helper::TimestampMs();
+  size_t element_count = 0;
+  {
+    BAIDU_SCOPED_LOCK(mutex_);
+    element_count = hnsw_index_->getCurrentElementCount();
+  }
+
+  for (size_t start = 0; start < element_count; start += FLAGS_hnsw_repair_batch_size) {
+    BAIDU_SCOPED_LOCK(mutex_);
+    size_t end = std::min(start + FLAGS_hnsw_repair_batch_size, hnsw_index_->getCurrentElementCount());
+    for (size_t internal_id = start; internal_id < end; ++internal_id) {
+      RepairNeighbors(static_cast<hnswlib::tableint>(internal_id));
+    }
+  }
+
+  DINGO_LOG(INFO) << fmt::format("[vector_index.hnsw][index_id({})] repair neighbor lists, element count {} elapsed {}ms",
+                                 Id(), element_count, Helper::TimestampMs() - start_time);
+
+  return butil::Status::OK();
+}
+
+// Replace the deleted neighbors with the alive neighbors of them, then select by heuristic,
+// like hnswlib update point, so the graph keep connected after the deleted node slot is reused.
+void VectorIndexHnsw::RepairNeighbors(hnswlib::tableint internal_id) {
+  using CandidateQueue =
+      std::priority_queue<std::pair<float, hnswlib::tableint>, std::vector<std::pair<float, hnswlib::tableint>>,
+                          hnswlib::HierarchicalNSW<float>::CompareByFirst>;
+
+  auto* index = hnsw_index_;
+  if (index->isMarkedDeleted(internal_id)) {
+    return;
+  }
+
+  for (int level = 0; level <= index->element_levels_[internal_id]; ++level) {
+    // Hold only one link list lock at a time, avoid deadlock with the lock order of hnswlib.
+    // The writers are excluded by mutex_, so the list is not changed between read and write.
+    std::vector<hnswlib::tableint> neighbor_ids;
+    {
+      std::unique_lock<std::mutex> lock(index->link_list_locks_[internal_id]);
+      hnswlib::linklistsizeint* link_list = index->get_linklist_at_level(internal_id, level);
+      auto* neighbors = reinterpret_cast<hnswlib::tableint*>(link_list + 1);
+      neighbor_ids.assign(neighbors, neighbors + index->getListCount(link_list));
+    }
+
+    bool has_deleted = false;
+    for (auto neighbor_id : neighbor_ids) {
+      if (index->isMarkedDeleted(neighbor_id)) {
+        has_deleted = true;
+        break;
+      }
+    }
+    if (!has_deleted) {
+      continue;
+    }
+
+    std::unordered_set<hnswlib::tableint> candidate_ids;
+    for (auto neighbor_id : neighbor_ids) {
+      if (!index->isMarkedDeleted(neighbor_id)) {
+        candidate_ids.insert(neighbor_id);
+        continue;
+      }
+
+      if (level > index->element_levels_[neighbor_id]) {
+        continue;
+      }
+      std::unique_lock<std::mutex> deleted_lock(index->link_list_locks_[neighbor_id]);
+      hnswlib::linklistsizeint* deleted_link_list = index->get_linklist_at_level(neighbor_id, level);
+      int deleted_size = index->getListCount(deleted_link_list);
+      auto* deleted_neighbors = reinterpret_cast<hnswlib::tableint*>(deleted_link_list + 1);
+      for (int j = 0; j < deleted_size; ++j) {
+        if (deleted_neighbors[j] != internal_id && !index->isMarkedDeleted(deleted_neighbors[j])) {
+          candidate_ids.insert(deleted_neighbors[j]);
+        }
+      }
+    }
+
+    const void* data = index->getDataByInternalId(internal_id);
+    CandidateQueue candidates;
+    for (auto candidate_id : candidate_ids) {
+      candidates.emplace(
+          index->fstdistfunc_(data, index->getDataByInternalId(candidate_id), index->dist_func_param_),
+          candidate_id);
+    }
+
+    size_t max_m = level == 0 ? index->maxM0_ : index->maxM_;
+    if (candidates.size() > max_m) {
+      index->getNeighborsByHeuristic2(candidates, max_m);
+    }
+
+    std::unique_lock<std::mutex> lock(index->link_list_locks_[internal_id]);
+    hnswlib::linklistsizeint* link_list = index->get_linklist_at_level(internal_id, level);
+    auto* neighbors = reinterpret_cast<hnswlib::tableint*>(link_list + 1);
+    // searchKnn read the list without lock, write the ids first and the count last,
+    // so the reader never see a count covering the ids not written yet.
+    size_t candidate_count = candidates.size();
+    for (int i = candidate_count - 1; i >= 0; --i) {
+      neighbors[i] = candidates.top().second;
+      candidates.pop();
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    index->setListCount(link_list, candidate_count);
+  }
+}
+
 }  // namespace dingodb
@@ -27,6 +27,7 @@
 #include "bthread/types.h"
 #include "butil/status.h"
 #include "common/logging.h"
+#include "common/synchronization.h"
 #include "hnswlib/space_ip.h"
 #include "hnswlib/space_l2.h"
 #include "proto/common.pb.h"
@@ -80,11 +81,24 @@ class VectorIndexHnsw : public VectorIndex {
   bool NeedToRebuild() override;
   bool SupportSave() override;
 
+  // Repair the neighbor lists which point to deleted nodes, only when replace deleted.
+  bool NeedToCompact() override;
+  butil::Status Compact() override;
+
   hnswlib::HierarchicalNSW<float>* GetHnswIndex();
 
   // void NormalizeVector(const float* data, float* norm_array) const;
 
  private:
+  // Call with mutex_ locked.
+  void AddPoint(const void* data, uint64_t label);
+  void RepairNeighbors(hnswlib::tableint internal_id);
+
+  // auto grow max elements
+  static uint64_t CalcGrowMaxElements(uint64_t max_elements, uint64_t need_elements);
+  uint64_t EstimateMemorySize(uint64_t max_elements);
+  void GrowMaxElements(uint64_t add_count);
+
   // hnsw members
   hnswlib::HierarchicalNSW<float>* hnsw_index_;
   hnswlib::SpaceInterface<float>* hnsw_space_;
@@ -96,9 +110,18 @@ class VectorIndexHnsw : public VectorIndex {
   uint32_t dimension_;
 
   bthread_mutex_t mutex_;
+  // search hold shared, resize index hold unique.
+  BthreadRWLock resize_mutex_;
 
   uint32_t user_max_elements_;
 
+  // new vector reuse the slot of deleted vector, so the deleted vector not count toward capacity
+  bool replace_deleted_;
+  // deleted count since last repair
+  std::atomic<uint64_t> deleted_since_repair_{0};
+  // memory of the next grow reserved in memory governor, 0 is not reserved
+  std::atomic<uint64_t> grow_reserved_size_{0};
+
   // normalize vector
   bool normalize_;
 };
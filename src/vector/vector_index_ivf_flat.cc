@@ -217,20 +217,13 @@ butil::Status VectorIndexIvfFlat::Search(std::vector<pb::common::VectorWithId> v
     nprobe = Constant::kSearchIvfFlatParamNprobe;
   }
 
-  std::vector<faiss::Index::distance_t> distances;
-  distances.resize(topk * vector_with_ids.size(), 0.0f);
-  std::vector<faiss::idx_t> labels;
-  labels.resize(topk * vector_with_ids.size(), -1);
-
-  std::unique_ptr<float[]> vectors;
-  try {
-    vectors = std::make_unique<float[]>(vector_with_ids.size() * dimension_);
-  } catch (std::bad_alloc& e) {
-    std::string s = fmt::format("Failed to allocate memory for vectors: {}", e.what());
-    DINGO_LOG(ERROR) << s;
-    return butil::Status(pb::error::Errno::EVECTOR_INVALID, "Failed to allocate memory for vectors, error: %s",
-                         e.what());
-  }
+  VectorSearchScratchGuard scratch;
+  auto& distances = scratch->distances;
+  distances.assign(topk * vector_with_ids.size(), 0.0f);
+  auto& labels = scratch->labels;
+  labels.assign(topk * vector_with_ids.size(), -1);
+  auto& vectors = scratch->vectors;
+  vectors.resize(vector_with_ids.size() * dimension_);
 
   for (size_t i = 0; i < vector_with_ids.size(); ++i) {
     if (vector_with_ids[i].vector().float_values_size() != this->dimension_) {
@@ -245,10 +238,10 @@ butil::Status VectorIndexIvfFlat::Search(std::vector<pb::common::VectorWithId> v
                       vector_with_ids[i].id(), vector_with_ids[i].vector().float_values_size(), this->dimension_));
     } else {
       const auto& vector = vector_with_ids[i].vector().float_values();
-      memcpy(vectors.get() + i * dimension_, vector.data(), dimension_ * sizeof(float));
+      memcpy(vectors.data() + i * dimension_, vector.data(), dimension_ * sizeof(float));
 
       if (normalize_) {
-        VectorIndexUtils::NormalizeVectorForFaiss(vectors.get() + i * dimension_, dimension_);
+        VectorIndexUtils::NormalizeVectorForFaiss(vectors.data() + i * dimension_, dimension_);
       }
     }
   }
@@ -278,10 +271,10 @@ butil::Status VectorIndexIvfFlat::Search(std::vector<pb::common::VectorWithId> v
       if (!filters.empty()) {
         auto ivf_flat_filter = filters.empty() ? nullptr : std::make_shared<IvfFlatIDSelector>(filters);
         ivf_search_parameters.sel = ivf_flat_filter.get();
-        index_->search(vector_with_ids.size(), vectors.get(), topk, distances.data(), labels.data(),
+        index_->search(vector_with_ids.size(), vectors.data(), topk, distances.data(), labels.data(),
                        &ivf_search_parameters);
       } else {
-        index_->search(vector_with_ids.size(), vectors.get(), topk, distances.data(), labels.data(),
+        index_->search(vector_with_ids.size(), vectors.data(), topk, distances.data(), labels.data(),
                        &ivf_search_parameters);
       }
     });
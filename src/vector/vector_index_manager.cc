@@ -19,6 +19,7 @@
 #include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -33,6 +34,7 @@
 #include "fmt/core.h"
 #include "log/segment_log_storage.h"
 #include "meta/store_meta_manager.h"
+#include "metrics/store_metrics_manager.h"
 #include "proto/common.pb.h"
 #include "proto/error.pb.h"
 #include "proto/file_service.pb.h"
@@ -40,6 +42,8 @@
 #include "proto/raft.pb.h"
 #include "server/file_service.h"
 #include "server/server.h"
+#include "store/background_task_scheduler.h"
+#include "store/memory_governor.h"
 #include "vector/codec.h"
 #include "vector/vector_index.h"
 #include "vector/vector_index_factory.h"
@@ -89,6 +93,8 @@ void RebuildVectorIndexTask::Run() {
     }
   }
 
+  BackgroundTaskGuard background_task_guard(BackgroundTaskType::kVectorIndexRebuild);
+
   auto status = VectorIndexManager::RebuildVectorIndex(vector_index_wrapper_);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[vector_index.rebuild][index_id({}_v{})] rebuild vector index failed, error {}",
@@ -147,6 +153,8 @@ void SaveVectorIndexTask::Run() {
     return;
   }
 
+  BackgroundTaskGuard background_task_guard(BackgroundTaskType::kVectorIndexSave);
+
   auto status = VectorIndexManager::SaveVectorIndex(vector_index_wrapper_);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[vector_index.save][index_id({}_v{})] save vector index failed, error {}",
@@ -155,6 +163,25 @@ void SaveVectorIndexTask::Run() {
   }
 }
 
+void CompactVectorIndexTask::Run() {
+  ON_SCOPE_EXIT([&]() { vector_index_wrapper_->DecPendingTaskNum(); });
+
+  if (vector_index_wrapper_->IsStop() || !vector_index_wrapper_->IsReady()) {
+    DINGO_LOG(INFO) << fmt::format(
+        "[vector_index.compact][index_id({})] vector index is stop or not ready, gave up compact vector index.",
+        vector_index_wrapper_->Id());
+    return;
+  }
+
+  BackgroundTaskGuard background_task_guard(BackgroundTaskType::kVectorIndexRebuild);
+
+  auto status = vector_index_wrapper_->Compact();
+  if (!status.ok()) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.compact][index_id({})] compact vector index failed, error {}",
+                                    vector_index_wrapper_->Id(), status.error_str());
+  }
+}
+
 void LoadOrBuildVectorIndexTask::Run() {
   DINGO_LOG(INFO) << fmt::format("[vector_index.loadorbuild][index_id({})] pending tasks({}) total running({}).",
                                  vector_index_wrapper_->Id(), vector_index_wrapper_->PendingTaskNum(),
@@ -214,7 +241,62 @@ void LoadOrBuildVectorIndexTask::Run() {
 std::atomic<int> VectorIndexManager::vector_index_task_running_num = 0;
 std::atomic<int> VectorIndexManager::vector_index_rebuild_task_running_num = 0;
 std::atomic<int> VectorIndexManager::vector_index_save_task_running_num = 0;
-bool VectorIndexManager::Init(std::vector<store::RegionPtr> regions) { return true; }  // NOLINT
+bool VectorIndexManager::Init(std::vector<store::RegionPtr> regions) {
+  for (auto& region : regions) {
+    if (region->Type() != pb::common::INDEX_REGION) {
+      continue;
+    }
+
+    auto status = MigrateVectorColumnFamily(region);
+    if (!status.ok()) {
+      DINGO_LOG(ERROR) << fmt::format("[vector_index.migrate][region({})] migrate vector column family failed, error: {}",
+                                      region->Id(), status.error_str());
+      return false;
+    }
+  }
+
+  return true;
+}
+
+butil::Status VectorIndexManager::MigrateVectorColumnFamily(store::RegionPtr region) {
+  auto raw_engine = Server::GetInstance()->GetRawEngine();
+  auto ranges = region->PhysicsRange();
+  auto cf_names = Helper::GetPhysicsRangeColumnFamilyNames(region->Type());
+
+  uint64_t count = 0;
+  for (int i = 0; i < ranges.size(); ++i) {
+    IteratorOptions options;
+    options.upper_bound = ranges[i].end_key();
+    auto iter = raw_engine->NewIterator(Constant::kStoreDataCF, options);
+    iter->Seek(ranges[i].start_key());
+
+    while (iter->Valid()) {
+      std::map<std::string, std::vector<pb::common::KeyValue>> kv_puts_with_cf;
+      std::map<std::string, std::vector<std::string>> kv_deletes_with_cf;
+      auto& kvs = kv_puts_with_cf[cf_names[i]];
+      auto& keys = kv_deletes_with_cf[Constant::kStoreDataCF];
+      for (; iter->Valid() && kvs.size() < Constant::kBuildVectorIndexBatchSize; iter->Next()) {
+        auto& kv = kvs.emplace_back();
+        kv.set_key(std::string(iter->Key()));
+        kv.set_value(std::string(iter->Value()));
+        keys.push_back(kv.key());
+      }
+
+      auto status = raw_engine->MultiCfPutAndDelete(kv_puts_with_cf, kv_deletes_with_cf);
+      if (!status.ok()) {
+        return status;
+      }
+      count += kvs.size();
+    }
+  }
+
+  if (count > 0) {
+    DINGO_LOG(INFO) << fmt::format("[vector_index.migrate][region({})] migrate {} keys from default column family",
+                                   region->Id(), count);
+  }
+
+  return butil::Status();
+}
 
 // Check whether need hold vector index
 bool VectorIndexManager::NeedHoldVectorIndex(uint64_t region_id) {
@@ -248,13 +330,28 @@ butil::Status VectorIndexManager::LoadOrBuildVectorIndex(VectorIndexWrapperPtr v
   uint64_t start_time = Helper::TimestampMs();
   uint64_t vector_index_id = vector_index_wrapper->Id();
 
+  // Not enough memory is not a build error, defer it and the scrub retry it later.
+  uint64_t reserve_size = 0;
+  auto status = AdmitVectorIndexMemory(vector_index_wrapper, reserve_size);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.load][index_id({})] defer load or build vector index, error: {}",
+                                      vector_index_id, status.error_str());
+    vector_index_wrapper->SetBuildDeferred(true);
+    return status;
+  }
+  vector_index_wrapper->SetBuildDeferred(false);
+  // The measured size is counted when the new vector index is switched in, the reservation is no longer needed.
+  ON_SCOPE_EXIT([vector_index_id, reserve_size]() {
+    MemoryGovernor::GetInstance()->ReleaseVectorIndex(vector_index_id, reserve_size);
+  });
+
   // try to load vector index from snapshot
   auto new_vector_index = VectorIndexSnapshotManager::LoadVectorIndexSnapshot(vector_index_wrapper);
   if (new_vector_index != nullptr) {
     // replay wal
     DINGO_LOG(INFO) << fmt::format(
         "[vector_index.load][index_id({})] Load vector index from snapshot success, will ReplayWal", vector_index_id);
-    auto status = ReplayWalToVectorIndex(new_vector_index, new_vector_index->ApplyLogId() + 1, UINT64_MAX);
+    status = ReplayWalToVectorIndex(new_vector_index, new_vector_index->ApplyLogId() + 1, UINT64_MAX);
     if (status.ok()) {
       DINGO_LOG(INFO) << fmt::format(
           "[vector_index.load][index_id({})] ReplayWal success, log_id {} elapsed time({}ms)", vector_index_id,
@@ -273,7 +370,7 @@ butil::Status VectorIndexManager::LoadOrBuildVectorIndex(VectorIndexWrapperPtr v
       vector_index_id);
 
   // Build a new vector_index from original data
-  new_vector_index = BuildVectorIndex(vector_index_wrapper);
+  new_vector_index = BuildVectorIndex(vector_index_wrapper, false);
   if (new_vector_index == nullptr) {
     DINGO_LOG(WARNING) << fmt::format(
         "[vector_index.build][index_id({})] Build vector index failed, elapsed time({}ms).", vector_index_id,
@@ -342,6 +439,10 @@ butil::Status VectorIndexManager::ParallelLoadOrBuildVectorIndex(std::vector<sto
       LOG(INFO) << fmt::format("Init load region {} vector index", vector_index_id);
 
       auto status = VectorIndexManager::LoadOrBuildVectorIndex(vector_index_wrapper);
+      if (status.error_code() == pb::error::ESYSTEM_MEMORY_CAPACITY_FULL) {
+        LOG(WARNING) << fmt::format("Load region {} vector index deferred, memory not enough", vector_index_id);
+        continue;
+      }
       if (!status.ok()) {
         LOG(ERROR) << fmt::format("Load region {} vector index failed, ", vector_index_id);
         param->results[offset] = -1;
@@ -464,8 +565,35 @@ butil::Status VectorIndexManager::ReplayWalToVectorIndex(VectorIndexPtr vector_i
   return butil::Status();
 }
 
+// The old vector index is hold until the new one is ready, so estimate the new one by the old one.
+// There is no old one at cold start, estimate by the index parameter and the region key count.
+// The admitted memory is reserved as reserve_size, the caller must release it after the load or build.
+butil::Status VectorIndexManager::AdmitVectorIndexMemory(VectorIndexWrapperPtr vector_index_wrapper,
+                                                        uint64_t& reserve_size) {
+  uint64_t memory_size = 0;
+  vector_index_wrapper->GetMemorySize(memory_size);
+  if (memory_size == 0) {
+    uint64_t element_count = 0;
+    auto store_metrics_manager = Server::GetInstance()->GetStoreMetricsManager();
+    if (store_metrics_manager != nullptr) {
+      auto region_metrics = store_metrics_manager->GetStoreRegionMetrics()->GetMetrics(vector_index_wrapper->Id());
+      if (region_metrics != nullptr) {
+        element_count = region_metrics->KeyCount();
+      }
+    }
+    memory_size = MemoryGovernor::EstimateVectorIndexMemory(vector_index_wrapper->IndexParameter(), element_count);
+  }
+
+  auto status = MemoryGovernor::GetInstance()->AdmitVectorIndex(vector_index_wrapper->Id(), memory_size);
+  if (status.ok()) {
+    reserve_size = memory_size;
+  }
+
+  return status;
+}
+
 // Build vector index with original all data.
-VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper) {
+VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, bool is_background) {
   assert(vector_index_wrapper != nullptr);
   uint64_t vector_index_id = vector_index_wrapper->Id();
 
@@ -511,7 +639,7 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
   options.upper_bound = end_key;
 
   auto raw_engine = Server::GetInstance()->GetRawEngine();
-  auto iter = raw_engine->NewIterator(Constant::kStoreDataCF, options);
+  auto iter = raw_engine->NewIterator(Constant::kVectorDataCF, options);
 
   // Note: This is iterated 2 times for the following reasons:
   // ivf_flat must train first before adding data
@@ -521,7 +649,7 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
   // build if need
   if (BAIDU_UNLIKELY(vector_index->NeedTrain())) {
     if (!vector_index->IsTrained()) {
-      auto status = TrainForBuild(vector_index, iter, start_key, end_key);
+      auto status = TrainForBuild(vector_index, iter, start_key, end_key, is_background);
       if (!status.ok()) {
         DINGO_LOG(ERROR) << fmt::format("TrainForBuild failed error_code : {} error_cstr : {}", status.error_code(),
                                         status.error_cstr());
@@ -531,29 +659,36 @@ VectorIndexPtr VectorIndexManager::BuildVectorIndex(VectorIndexWrapperPtr vector
   }
 
   uint64_t count = 0;
+  ScanThrottle scan_throttle;
   std::vector<pb::common::VectorWithId> vectors;
   vectors.reserve(Constant::kBuildVectorIndexBatchSize);
   for (iter->Seek(start_key); iter->Valid(); iter->Next()) {
-    pb::common::VectorWithId vector;
+    if (is_background) {
+      scan_throttle.Add(iter->Key().size() + iter->Value().size());
+    }
+
+    auto& vector = vectors.emplace_back();
 
     std::string key(iter->Key());
     vector.set_id(VectorCodec::DecodeVectorId(key));
 
-    std::string value(iter->Value());
-    if (!vector.mutable_vector()->ParseFromString(value)) {
-      DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})] vector with id ParseFromString failed.");
+    // decode from iterator value directly, avoid copy value
+    if (!VectorCodec::DecodeVectorValue(iter->Value(), *vector.mutable_vector())) {
+      DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})] decode vector value failed.",
+                                        vector_index_id);
+      vectors.pop_back();
       continue;
     }
 
     if (vector.vector().float_values_size() <= 0) {
       DINGO_LOG(WARNING) << fmt::format("[vector_index.build][index_id({})] vector values_size error.", vector.id());
+      vectors.pop_back();
       continue;
     }
 
     ++count;
 
-    vectors.push_back(vector);
-    if (count + 1 % Constant::kBuildVectorIndexBatchSize == 0) {
+    if (vectors.size() >= Constant::kBuildVectorIndexBatchSize) {
       vector_index->Upsert(vectors);
       vectors.clear();
     }
@@ -600,9 +735,21 @@ butil::Status VectorIndexManager::RebuildVectorIndex(VectorIndexWrapperPtr vecto
   DINGO_LOG(INFO) << fmt::format("[vector_index.rebuild][index_id({}_v{})] Start rebuild vector index.",
                                  vector_index_id, vector_index_wrapper->Version());
 
+  // The old vector index still serve, the scrub launch rebuild again when memory is enough.
+  uint64_t reserve_size = 0;
+  auto status = AdmitVectorIndexMemory(vector_index_wrapper, reserve_size);
+  if (!status.ok()) {
+    DINGO_LOG(WARNING) << fmt::format("[vector_index.rebuild][index_id({})] defer rebuild vector index, error: {}",
+                                      vector_index_id, status.error_str());
+    return status;
+  }
+  ON_SCOPE_EXIT([vector_index_id, reserve_size]() {
+    MemoryGovernor::GetInstance()->ReleaseVectorIndex(vector_index_id, reserve_size);
+  });
+
   uint64_t start_time = Helper::TimestampMs();
   // Build vector index with original data.
-  auto vector_index = BuildVectorIndex(vector_index_wrapper);
+  auto vector_index = BuildVectorIndex(vector_index_wrapper, true);
   if (vector_index == nullptr) {
     DINGO_LOG(WARNING) << fmt::format("[vector_index.rebuild][index_id({})] Build vector index failed.",
                                       vector_index_id);
@@ -626,7 +773,7 @@ butil::Status VectorIndexManager::RebuildVectorIndex(VectorIndexWrapperPtr vecto
 
   start_time = Helper::TimestampMs();
   // first ground replay wal
-  auto status = ReplayWalToVectorIndex(vector_index, vector_index->ApplyLogId() + 1, UINT64_MAX);
+  status = ReplayWalToVectorIndex(vector_index, vector_index->ApplyLogId() + 1, UINT64_MAX);
   if (!status.ok()) {
     DINGO_LOG(ERROR) << fmt::format("[vector_index.rebuild][index_id({})] ReplayWal failed first-round, log_id {}",
                                     vector_index_id, vector_index->ApplyLogId());
@@ -737,6 +884,20 @@ void VectorIndexManager::LaunchSaveVectorIndex(VectorIndexWrapperPtr vector_inde
   }
 }
 
+void VectorIndexManager::LaunchCompactVectorIndex(VectorIndexWrapperPtr vector_index_wrapper) {
+  assert(vector_index_wrapper != nullptr);
+
+  DINGO_LOG(INFO) << fmt::format(
+      "[vector_index.launch][index_id({})] Launch compact vector index, pending tasks({}) total running({}).",
+      vector_index_wrapper->Id(), vector_index_wrapper->PendingTaskNum(), GetVectorIndexTaskRunningNum());
+
+  TaskRunnable* task = new CompactVectorIndexTask(vector_index_wrapper);
+  if (!vector_index_wrapper->ExecuteTask(task)) {
+    DINGO_LOG(ERROR) << fmt::format("[vector_index.launch][index_id({})] Launch compact vector index failed",
+                                    vector_index_wrapper->Id());
+  }
+}
+
 butil::Status VectorIndexManager::ScrubVectorIndex() {
   auto store_meta_manager = Server::GetInstance()->GetStoreMetaManager();
   if (store_meta_manager == nullptr) {
@@ -760,6 +921,14 @@ butil::Status VectorIndexManager::ScrubVectorIndex() {
       continue;
     }
     auto vector_index_wrapper = region->VectorIndexWrapper();
+    if (vector_index_wrapper->IsBuildDeferred() && !vector_index_wrapper->IsStop()) {
+      if (vector_index_wrapper->PendingTaskNum() == 0) {
+        DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] retry deferred load or build vector index.",
+                                       vector_index_id);
+        LaunchLoadOrBuildVectorIndex(vector_index_wrapper);
+      }
+      continue;
+    }
     if (!vector_index_wrapper->IsReady()) {
       DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] vector index is not ready, dont't scrub.",
                                      vector_index_id);
@@ -775,8 +944,9 @@ butil::Status VectorIndexManager::ScrubVectorIndex() {
 
     bool need_rebuild = vector_index_wrapper->NeedToRebuild();
     bool need_save = vector_index_wrapper->NeedToSave(last_save_log_behind);
-    if (need_rebuild || need_save) {
-      auto status = ScrubVectorIndex(region, need_rebuild, need_save);
+    bool need_compact = vector_index_wrapper->NeedToCompact();
+    if (need_rebuild || need_save || need_compact) {
+      auto status = ScrubVectorIndex(region, need_rebuild, need_save, need_compact);
       if (!status.ok()) {
         DINGO_LOG(ERROR) << fmt::format("[vector_index.scrub][index_id({})] scrub vector index failed, error: {}",
                                         vector_index_wrapper->Id(), status.error_str());
@@ -788,7 +958,8 @@ butil::Status VectorIndexManager::ScrubVectorIndex() {
   return butil::Status::OK();
 }
 
-butil::Status VectorIndexManager::ScrubVectorIndex(store::RegionPtr region, bool need_rebuild, bool need_save) {
+butil::Status VectorIndexManager::ScrubVectorIndex(store::RegionPtr region, bool need_rebuild, bool need_save,
+                                                   bool need_compact) {
   assert(region != nullptr);
 
   auto vector_index_wrapper = region->VectorIndexWrapper();
@@ -802,6 +973,10 @@ butil::Status VectorIndexManager::ScrubVectorIndex(store::RegionPtr region, bool
     DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] need save, do save vector index.",
                                    vector_index_id);
     LaunchSaveVectorIndex(vector_index_wrapper);
+  } else if (need_compact) {
+    DINGO_LOG(INFO) << fmt::format("[vector_index.scrub][index_id({})] need compact, do compact vector index.",
+                                   vector_index_id);
+    LaunchCompactVectorIndex(vector_index_wrapper);
   }
 
   return butil::Status::OK();
@@ -809,28 +984,29 @@ butil::Status VectorIndexManager::ScrubVectorIndex(store::RegionPtr region, bool
 
 butil::Status VectorIndexManager::TrainForBuild(std::shared_ptr<VectorIndex> vector_index,
                                                 std::shared_ptr<Iterator> iter, const std::string& start_key,
-                                                [[maybe_unused]] const std::string& end_key) {
+                                                [[maybe_unused]] const std::string& end_key, bool is_background) {
   uint64_t count = 0;
+  ScanThrottle scan_throttle;
   std::vector<float> train_vectors;
   train_vectors.reserve(100000 * vector_index->GetDimension());  // todo opt
   for (iter->Seek(start_key); iter->Valid(); iter->Next()) {
-    pb::common::VectorWithId vector;
+    if (is_background) {
+      scan_throttle.Add(iter->Key().size() + iter->Value().size());
+    }
 
-    std::string value(iter->Value());
-    if (!vector.mutable_vector()->ParseFromString(value)) {
-      std::string s = fmt::format("[vector_index.build][index_id({})] vector with id ParseFromString failed.");
+    // decode to train buffer directly
+    size_t train_size = train_vectors.size();
+    if (!VectorCodec::DecodeVectorFloatValues(iter->Value(), train_vectors)) {
+      std::string s = fmt::format("[vector_index.build][index_id({})] decode vector value failed.", vector_index->Id());
       DINGO_LOG(WARNING) << s;
       continue;
     }
 
-    if (vector.vector().float_values_size() <= 0) {
-      std::string s = fmt::format("[vector_index.build][index_id({})] vector values_size error.", vector.id());
+    if (train_vectors.size() == train_size) {
+      std::string s = fmt::format("[vector_index.build][index_id({})] vector values_size error.", vector_index->Id());
       DINGO_LOG(WARNING) << s;
       continue;
     }
-
-    train_vectors.insert(train_vectors.end(), vector.vector().float_values().begin(),
-                         vector.vector().float_values().end());
   }
 
   // if empty. ignore
@@ -57,6 +57,18 @@ class SaveVectorIndexTask : public TaskRunnable {
   VectorIndexWrapperPtr vector_index_wrapper_;
 };
 
+// Compact vector index task
+class CompactVectorIndexTask : public TaskRunnable {
+ public:
+  CompactVectorIndexTask(VectorIndexWrapperPtr vector_index_wrapper) : vector_index_wrapper_(vector_index_wrapper) {}
+  ~CompactVectorIndexTask() override = default;
+
+  void Run() override;
+
+ private:
+  VectorIndexWrapperPtr vector_index_wrapper_;
+};
+
 // Load or build vector index task
 class LoadOrBuildVectorIndexTask : public TaskRunnable {
  public:
@@ -78,6 +90,7 @@ class VectorIndexManager {
 
   ~VectorIndexManager() = default;
 
+  // Migrate the vector data of old version from default column family, must before load vector index.
   static bool Init(std::vector<store::RegionPtr> regions);
 
   // Check whether should hold vector index.
@@ -100,6 +113,9 @@ class VectorIndexManager {
   // Launch rebuild vector index at execute queue.
   static void LaunchRebuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper, bool force);
 
+  // Launch compact vector index at execute queue, reclaim the deleted slot.
+  static void LaunchCompactVectorIndex(VectorIndexWrapperPtr vector_index_wrapper);
+
   static butil::Status ScrubVectorIndex();
 
   static std::atomic<int> vector_index_task_running_num;
@@ -117,20 +133,31 @@ class VectorIndexManager {
   static void IncVectorIndexSaveTaskRunningNum() { vector_index_save_task_running_num.fetch_add(1); }
   static void DecVectorIndexSaveTaskRunningNum() { vector_index_save_task_running_num.fetch_sub(1); }
 
+  // Move vector data/scalar data/table data of region from default column family to the separate column family.
+  // Every batch put and delete is atomic, so it is safe to redo after crash.
+  // Also used after load the raft snapshot of old version leader.
+  static butil::Status MigrateVectorColumnFamily(store::RegionPtr region);
+
  private:
+  // Check vector index memory budget before build or load.
+  static butil::Status AdmitVectorIndexMemory(VectorIndexWrapperPtr vector_index_wrapper, uint64_t &reserve_size);
+
   // Build vector index with original data(rocksdb).
-  // Invoke when server starting.
-  static std::shared_ptr<VectorIndex> BuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper);
+  // Invoke when server starting or rebuild, the scan of rebuild is limited by background scan rate.
+  static std::shared_ptr<VectorIndex> BuildVectorIndex(VectorIndexWrapperPtr vector_index_wrapper,
+                                                       bool is_background);
 
   // Replay log to vector index.
   static butil::Status ReplayWalToVectorIndex(std::shared_ptr<VectorIndex> vector_index, uint64_t start_log_id,
                                               uint64_t end_log_id);
 
   // Scrub vector index.
-  static butil::Status ScrubVectorIndex(store::RegionPtr region, bool need_rebuild, bool need_save);
+  static butil::Status ScrubVectorIndex(store::RegionPtr region, bool need_rebuild, bool need_save,
+                                       bool need_compact);
 
   static butil::Status TrainForBuild(std::shared_ptr<VectorIndex> vector_index, std::shared_ptr<Iterator> iter,
-                                     const std::string &start_key, [[maybe_unused]] const std::string &end_key);
+                                     const std::string &start_key, [[maybe_unused]] const std::string &end_key,
+                                     bool is_background);
 };
 
 }  // namespace dingodb
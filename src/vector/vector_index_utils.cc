@@ -14,11 +14,13 @@
 
 #include "vector/vector_index_utils.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <queue>
 #include <string>
 #include <utility>
 #include <vector>
@@ -419,4 +421,51 @@ void VectorIndexUtils::NormalizeVectorForHnsw(const float* data, uint32_t dimens
   for (int i = 0; i < dimension; i++) norm_array[i] = data[i] * norm;
 }
 
+void VectorIndexUtils::MergeVectorSearchResults(
+    std::vector<std::vector<pb::index::VectorWithDistanceResult>>& region_results, uint32_t top_n,
+    std::vector<pb::index::VectorWithDistanceResult>& results) {
+  size_t query_count = 0;
+  for (const auto& region_result : region_results) {
+    query_count = std::max(query_count, region_result.size());
+  }
+
+  // The distance is smaller is closer for all metric type, the top of heap is the farthest one.
+  auto farther = [](const pb::common::VectorWithDistance* lhs, const pb::common::VectorWithDistance* rhs) {
+    return lhs->distance() < rhs->distance();
+  };
+
+  results.resize(query_count);
+  for (size_t i = 0; i < query_count; ++i) {
+    std::priority_queue<pb::common::VectorWithDistance*, std::vector<pb::common::VectorWithDistance*>,
+                        decltype(farther)>
+        heap(farther);
+    for (auto& region_result : region_results) {
+      if (i >= region_result.size()) {
+        continue;
+      }
+
+      for (auto& vector_with_distance : *region_result[i].mutable_vector_with_distances()) {
+        if (heap.size() < top_n) {
+          heap.push(&vector_with_distance);
+        } else if (top_n > 0 && vector_with_distance.distance() < heap.top()->distance()) {
+          heap.pop();
+          heap.push(&vector_with_distance);
+        }
+      }
+    }
+
+    std::vector<pb::common::VectorWithDistance*> top_vectors(heap.size());
+    for (auto it = top_vectors.rbegin(); it != top_vectors.rend(); ++it) {
+      *it = heap.top();
+      heap.pop();
+    }
+
+    auto* vector_with_distances = results[i].mutable_vector_with_distances();
+    vector_with_distances->Reserve(top_vectors.size());
+    for (auto* vector_with_distance : top_vectors) {
+      vector_with_distances->Add()->Swap(vector_with_distance);
+    }
+  }
+}
+
 }  // namespace dingodb
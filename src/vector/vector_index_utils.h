@@ -22,12 +22,58 @@
 #include <string>
 #include <vector>
 
+#include "butil/object_pool.h"
 #include "butil/status.h"
 #include "common/logging.h"
 #include "proto/index.pb.h"
 
 namespace dingodb {
 
+// Reusable buffers of one vector search, include query vectors, result distances and labels.
+// Get from butil object pool instead of malloc/free on every search, the pool is lock free per thread
+// and the object can be returned from other thread, so it is safe for bthread.
+struct VectorSearchScratch {
+  // the buffer exceed this bytes is released when return to pool, avoid pool hold too much memory.
+  static constexpr size_t kMaxRetainBytes = 4 * 1024 * 1024;
+
+  std::vector<float> vectors;
+  std::vector<float> distances;
+  std::vector<int64_t> labels;
+  std::vector<uint64_t> ids;
+
+  void Shrink() {
+    if (vectors.capacity() * sizeof(float) > kMaxRetainBytes) {
+      std::vector<float>().swap(vectors);
+    }
+    if (distances.capacity() * sizeof(float) > kMaxRetainBytes) {
+      std::vector<float>().swap(distances);
+    }
+    if (labels.capacity() * sizeof(int64_t) > kMaxRetainBytes) {
+      std::vector<int64_t>().swap(labels);
+    }
+    if (ids.capacity() * sizeof(uint64_t) > kMaxRetainBytes) {
+      std::vector<uint64_t>().swap(ids);
+    }
+  }
+};
+
+class VectorSearchScratchGuard {
+ public:
+  VectorSearchScratchGuard() : scratch_(butil::get_object<VectorSearchScratch>()) {}
+  ~VectorSearchScratchGuard() {
+    scratch_->Shrink();
+    butil::return_object(scratch_);
+  }
+
+  VectorSearchScratchGuard(const VectorSearchScratchGuard& rhs) = delete;
+  VectorSearchScratchGuard& operator=(const VectorSearchScratchGuard& rhs) = delete;
+
+  VectorSearchScratch* operator->() { return scratch_; }
+
+ private:
+  VectorSearchScratch* scratch_;
+};
+
 class VectorIndexUtils {
  public:
   VectorIndexUtils() = delete;
@@ -176,6 +222,12 @@ class VectorIndexUtils {
 
   static void NormalizeVectorForFaiss(float* x, int32_t d);
   static void NormalizeVectorForHnsw(const float* data, uint32_t dimension, float* norm_array);
+
+  // Merge the search results of multiple regions, keep top_n of every query by distance.
+  // region_results[i][j] is the result of query j in region i, the result is moved out of region_results.
+  static void MergeVectorSearchResults(std::vector<std::vector<pb::index::VectorWithDistanceResult>>& region_results,
+                                       uint32_t top_n,
+                                       std::vector<pb::index::VectorWithDistanceResult>& results);  // NOLINT
 };
 
 }  // namespace dingodb
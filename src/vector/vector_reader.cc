@@ -14,6 +14,7 @@
 
 #include "vector/vector_reader.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
 #include <string>
@@ -29,23 +30,64 @@
 
 namespace dingodb {
 
+// Get the value of every vector_with_id from reader by one sorted batch get instead of get one by one,
+// the same vector id in different results is read once. handler(vector_with_id, status, value) is called
+// for every vector_with_id, stop and return the error of handler.
+template <typename EncodeFunc, typename Handler>
+static butil::Status BatchGetVectorValue(std::shared_ptr<RawEngine::Reader> reader, uint64_t partition_id,
+                                         const std::vector<pb::common::VectorWithId*>& vector_with_ids,
+                                         EncodeFunc encode_func, Handler handler) {
+  if (vector_with_ids.empty()) {
+    return butil::Status();
+  }
+
+  std::vector<uint64_t> vector_ids;
+  vector_ids.reserve(vector_with_ids.size());
+  for (const auto* vector_with_id : vector_with_ids) {
+    vector_ids.push_back(vector_with_id->id());
+  }
+  std::sort(vector_ids.begin(), vector_ids.end());
+  vector_ids.erase(std::unique(vector_ids.begin(), vector_ids.end()), vector_ids.end());
+
+  // The key encoding keep the order of vector id, so the keys is sorted.
+  std::vector<std::string> keys(vector_ids.size());
+  for (size_t i = 0; i < vector_ids.size(); ++i) {
+    encode_func(partition_id, vector_ids[i], keys[i]);
+  }
+
+  std::vector<std::string> values;
+  std::vector<butil::Status> statuses;
+  auto status = reader->KvBatchGet(keys, values, statuses);
+  if (!status.ok()) {
+    return status;
+  }
+
+  for (auto* vector_with_id : vector_with_ids) {
+    size_t pos = std::lower_bound(vector_ids.begin(), vector_ids.end(), vector_with_id->id()) - vector_ids.begin();
+    status = handler(*vector_with_id, statuses[pos], values[pos]);
+    if (!status.ok()) {
+      return status;
+    }
+  }
+
+  return butil::Status();
+}
+
 butil::Status VectorReader::QueryVectorWithId(uint64_t partition_id, uint64_t vector_id, bool with_vector_data,
                                               pb::common::VectorWithId& vector_with_id) {
   std::string key;
   VectorCodec::EncodeVectorData(partition_id, vector_id, key);
 
   std::string value;
-  auto status = reader_->KvGet(key, value);
+  auto status = vector_data_reader_->KvGet(key, value);
   if (!status.ok()) {
     return status;
   }
 
   if (with_vector_data) {
-    pb::common::Vector vector;
-    if (!vector.ParseFromString(value)) {
-      return butil::Status(pb::error::EINTERNAL, "Parse proto from string error");
+    if (!VectorCodec::DecodeVectorValue(value, *vector_with_id.mutable_vector())) {
+      return butil::Status(pb::error::EINTERNAL, "Decode vector value error");
     }
-    vector_with_id.mutable_vector()->Swap(&vector);
   }
 
   vector_with_id.set_id(vector_id);
@@ -88,14 +130,15 @@ butil::Status VectorReader::SearchVector(
         DINGO_LOG(ERROR) << fmt::format("vector_index::Search failed ");
         return status;
       }
+      google::protobuf::Arena arena;
       for (auto& vector_with_distance_result : tmp_results) {
         pb::index::VectorWithDistanceResult new_vector_with_distance_result;
 
         for (auto& temp_vector_with_distance : *vector_with_distance_result.mutable_vector_with_distances()) {
           uint64_t temp_id = temp_vector_with_distance.vector_with_id().id();
           bool compare_result = false;
-          butil::Status status =
-              CompareVectorScalarData(partition_id, temp_id, vector_with_ids[0].scalar_data(), compare_result);
+          butil::Status status = CompareVectorScalarData(partition_id, temp_id, vector_with_ids[0].scalar_data(),
+                                                         compare_result, &arena);
           if (!status.ok()) {
             return status;
           }
@@ -141,6 +184,7 @@ butil::Status VectorReader::SearchVector(
 
   // if vector index does not support restruct vector ,we restruct it using RocksDB
   if (with_vector_data) {
+    std::vector<pb::common::VectorWithId*> vector_with_ids_without_data;
     for (auto& result : vector_with_distance_results) {
       for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
         if (vector_with_distance.vector_with_id().vector().float_values_size() > 0 ||
@@ -148,24 +192,95 @@ butil::Status VectorReader::SearchVector(
           continue;
         }
 
-        pb::common::VectorWithId vector_with_id;
-        auto status = QueryVectorWithId(partition_id, vector_with_distance.vector_with_id().id(), true, vector_with_id);
-        if (!status.ok()) {
-          return status;
-        }
-        vector_with_distance.mutable_vector_with_id()->Swap(&vector_with_id);
+        vector_with_ids_without_data.push_back(vector_with_distance.mutable_vector_with_id());
       }
     }
+
+    auto status = BatchQueryVectorData(partition_id, vector_with_ids_without_data);
+    if (!status.ok()) {
+      return status;
+    }
   }
 
   return butil::Status();
 }
 
+butil::Status VectorReader::BatchQueryVectorData(uint64_t partition_id,
+                                                 const std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  return BatchGetVectorValue(
+      vector_data_reader_, partition_id, vector_with_ids, VectorCodec::EncodeVectorData,
+      [](pb::common::VectorWithId& vector_with_id, const butil::Status& status, const std::string& value) {
+        if (!status.ok()) {
+          return status;
+        }
+
+        if (!VectorCodec::DecodeVectorValue(value, *vector_with_id.mutable_vector())) {
+          return butil::Status(pb::error::EINTERNAL, "Decode vector value error");
+        }
+
+        return butil::Status();
+      });
+}
+
+butil::Status VectorReader::BatchQueryVectorTableData(uint64_t partition_id,
+                                                      const std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  // the vector without table data is skipped, same as query one by one.
+  pb::common::VectorTableData vector_table;
+  return BatchGetVectorValue(
+      table_data_reader_, partition_id, vector_with_ids, VectorCodec::EncodeVectorTable,
+      [&](pb::common::VectorWithId& vector_with_id, const butil::Status& status, const std::string& value) {
+        if (!status.ok()) {
+          return butil::Status();
+        }
+
+        vector_table.Clear();
+        if (!vector_table.ParseFromString(value)) {
+          DINGO_LOG(WARNING) << fmt::format("Decode vector table data failed, vector_id: {}", vector_with_id.id());
+          return butil::Status();
+        }
+
+        vector_with_id.mutable_table_data()->Swap(&vector_table);
+        return butil::Status();
+      });
+}
+
+butil::Status VectorReader::BatchQueryVectorScalarData(uint64_t partition_id,
+                                                       const std::vector<std::string>& selected_scalar_keys,
+                                                       const std::vector<pb::common::VectorWithId*>& vector_with_ids) {
+  // the vector without scalar data is skipped, same as query one by one.
+  pb::common::VectorScalardata vector_scalar;
+  return BatchGetVectorValue(
+      scalar_data_reader_, partition_id, vector_with_ids, VectorCodec::EncodeVectorScalar,
+      [&](pb::common::VectorWithId& vector_with_id, const butil::Status& status, const std::string& value) {
+        if (!status.ok()) {
+          return butil::Status();
+        }
+
+        vector_scalar.Clear();
+        if (!vector_scalar.ParseFromString(value)) {
+          DINGO_LOG(WARNING) << fmt::format("Decode vector scalar data failed, vector_id: {}", vector_with_id.id());
+          return butil::Status();
+        }
+
+        auto* scalar = vector_with_id.mutable_scalar_data()->mutable_scalar_data();
+        for (const auto& [key, value] : vector_scalar.scalar_data()) {
+          if (!selected_scalar_keys.empty() &&
+              std::find(selected_scalar_keys.begin(), selected_scalar_keys.end(), key) == selected_scalar_keys.end()) {
+            continue;
+          }
+
+          scalar->insert({key, value});
+        }
+
+        return butil::Status();
+      });
+}
+
 butil::Status VectorReader::QueryVectorTableData(uint64_t partition_id, pb::common::VectorWithId& vector_with_id) {
   std::string key, value;
   VectorCodec::EncodeVectorTable(partition_id, vector_with_id.id(), key);
 
-  auto status = reader_->KvGet(key, value);
+  auto status = table_data_reader_->KvGet(key, value);
   if (!status.ok()) {
     return status;
   }
@@ -183,25 +298,25 @@ butil::Status VectorReader::QueryVectorTableData(uint64_t partition_id, pb::comm
 butil::Status VectorReader::QueryVectorTableData(uint64_t partition_id,
                                                  std::vector<pb::index::VectorWithDistanceResult>& results) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& result : results) {
     for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
-      pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-      QueryVectorTableData(partition_id, vector_with_id);
+      vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
     }
   }
 
-  return butil::Status();
+  return BatchQueryVectorTableData(partition_id, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorTableData(uint64_t partition_id,
                                                  std::vector<pb::common::VectorWithDistance>& vector_with_distances) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& vector_with_distance : vector_with_distances) {
-    pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-    QueryVectorTableData(partition_id, vector_with_id);
+    vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
   }
 
-  return butil::Status();
+  return BatchQueryVectorTableData(partition_id, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorScalarData(uint64_t partition_id, std::vector<std::string> selected_scalar_keys,
@@ -209,7 +324,7 @@ butil::Status VectorReader::QueryVectorScalarData(uint64_t partition_id, std::ve
   std::string key, value;
   VectorCodec::EncodeVectorScalar(partition_id, vector_with_id.id(), key);
 
-  auto status = reader_->KvGet(key, value);
+  auto status = scalar_data_reader_->KvGet(key, value);
   if (!status.ok()) {
     return status;
   }
@@ -235,50 +350,51 @@ butil::Status VectorReader::QueryVectorScalarData(uint64_t partition_id, std::ve
 butil::Status VectorReader::QueryVectorScalarData(uint64_t partition_id, std::vector<std::string> selected_scalar_keys,
                                                   std::vector<pb::index::VectorWithDistanceResult>& results) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& result : results) {
     for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
-      pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-      QueryVectorScalarData(partition_id, selected_scalar_keys, vector_with_id);
+      vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
     }
   }
 
-  return butil::Status();
+  return BatchQueryVectorScalarData(partition_id, selected_scalar_keys, vector_with_ids);
 }
 
 butil::Status VectorReader::QueryVectorScalarData(uint64_t partition_id, std::vector<std::string> selected_scalar_keys,
                                                   std::vector<pb::common::VectorWithDistance>& vector_with_distances) {
   // get metadata by parameter
+  std::vector<pb::common::VectorWithId*> vector_with_ids;
   for (auto& vector_with_distance : vector_with_distances) {
-    pb::common::VectorWithId& vector_with_id = *(vector_with_distance.mutable_vector_with_id());
-    QueryVectorScalarData(partition_id, selected_scalar_keys, vector_with_id);
+    vector_with_ids.push_back(vector_with_distance.mutable_vector_with_id());
   }
 
-  return butil::Status();
+  return BatchQueryVectorScalarData(partition_id, selected_scalar_keys, vector_with_ids);
 }
 
 butil::Status VectorReader::CompareVectorScalarData(uint64_t partition_id, uint64_t vector_id,
                                                     const pb::common::VectorScalardata& source_scalar_data,
-                                                    bool& compare_result) {
+                                                    bool& compare_result, google::protobuf::Arena* arena) {
   compare_result = false;
   std::string key, value;
 
   VectorCodec::EncodeVectorScalar(partition_id, vector_id, key);
 
-  auto status = reader_->KvGet(key, value);
+  auto status = scalar_data_reader_->KvGet(key, value);
   if (!status.ok()) {
     DINGO_LOG(WARNING) << fmt::format("Get vector scalar data failed, vector_id: {} error: {} ", vector_id,
                                       status.error_str());
     return status;
   }
 
-  pb::common::VectorScalardata vector_scalar;
-  if (!vector_scalar.ParseFromString(value)) {
+  auto* vector_scalar = google::protobuf::Arena::CreateMessage<pb::common::VectorScalardata>(arena);
+  std::unique_ptr<pb::common::VectorScalardata> heap_guard(arena == nullptr ? vector_scalar : nullptr);
+  if (!vector_scalar->ParseFromString(value)) {
     return butil::Status(pb::error::EINTERNAL, "Decode vector scalar data failed");
   }
 
   for (const auto& [key, value] : source_scalar_data.scalar_data()) {
-    auto it = vector_scalar.scalar_data().find(key);
-    if (it == vector_scalar.scalar_data().end()) {
+    auto it = vector_scalar->scalar_data().find(key);
+    if (it == vector_scalar->scalar_data().end()) {
       compare_result = false;
       return butil::Status();
     }
@@ -495,7 +611,7 @@ butil::Status VectorReader::VectorCount(const pb::common::Range& range, uint64_t
 
   IteratorOptions options;
   options.upper_bound = end_key;
-  auto iter = reader_->NewIterator(options);
+  auto iter = table_data_reader_->NewIterator(options);
   for (iter->Seek(begin_key); iter->Valid(); iter->Next()) {
     ++count;
   }
@@ -511,7 +627,7 @@ butil::Status VectorReader::GetBorderId(const pb::common::Range& region_range, b
     IteratorOptions options;
     options.lower_bound = start_key;
     options.upper_bound = end_key;
-    auto iter = reader_->NewIterator(options);
+    auto iter = vector_data_reader_->NewIterator(options);
     if (iter == nullptr) {
       DINGO_LOG(ERROR) << fmt::format("New iterator failed, region range [{}-{})",
                                       Helper::StringToHex(region_range.start_key()),
@@ -530,7 +646,7 @@ butil::Status VectorReader::GetBorderId(const pb::common::Range& region_range, b
   } else {
     IteratorOptions options;
     options.lower_bound = start_key;
-    auto iter = reader_->NewIterator(options);
+    auto iter = vector_data_reader_->NewIterator(options);
     if (iter == nullptr) {
       DINGO_LOG(ERROR) << fmt::format("New iterator failed, region range [{}-{})",
                                       Helper::StringToHex(region_range.start_key()),
@@ -577,7 +693,7 @@ butil::Status VectorReader::ScanVectorId(std::shared_ptr<Engine::VectorReader::C
 
     options.lower_bound = range_start_key;
     options.upper_bound = range_end_key;
-    auto iter = reader_->NewIterator(options);
+    auto iter = vector_data_reader_->NewIterator(options);
     if (iter == nullptr) {
       DINGO_LOG(ERROR) << fmt::format("New iterator failed, region range [{}-{})",
                                       Helper::StringToHex(ctx->region_range.start_key()),
@@ -585,8 +701,6 @@ butil::Status VectorReader::ScanVectorId(std::shared_ptr<Engine::VectorReader::C
       return butil::Status(pb::error::Errno::EINTERNAL, "New iterator failed");
     }
     for (iter->Seek(seek_key); iter->Valid(); iter->Next()) {
-      pb::common::VectorWithId vector;
-
       std::string key(iter->Key());
       auto vector_id = VectorCodec::DecodeVectorId(key);
       if (vector_id == 0 || vector_id == UINT64_MAX) {
@@ -626,7 +740,7 @@ butil::Status VectorReader::ScanVectorId(std::shared_ptr<Engine::VectorReader::C
     }
 
     options.lower_bound = range_start_key;
-    auto iter = reader_->NewIterator(options);
+    auto iter = vector_data_reader_->NewIterator(options);
     if (iter == nullptr) {
       DINGO_LOG(ERROR) << fmt::format("New iterator failed, region range [{}-{})",
                                       Helper::StringToHex(ctx->region_range.start_key()),
@@ -639,8 +753,6 @@ butil::Status VectorReader::ScanVectorId(std::shared_ptr<Engine::VectorReader::C
         continue;
       }
 
-      pb::common::VectorWithId vector;
-
       std::string key(iter->Key());
       auto vector_id = VectorCodec::DecodeVectorId(key);
       if (vector_id == 0 || vector_id == UINT64_MAX) {
@@ -731,7 +843,7 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilter(
   IteratorOptions options;
   options.upper_bound = end_key;
 
-  auto iter = reader_->NewIterator(options);
+  auto iter = scalar_data_reader_->NewIterator(options);
   if (iter == nullptr) {
     DINGO_LOG(ERROR) << fmt::format("New iterator failed, region range [{}-{})",
                                     Helper::StringToHex(region_range.start_key()),
@@ -867,14 +979,15 @@ butil::Status VectorReader::SearchVectorDebug(
         return status;
       }
       auto start_kv_get = lambda_time_now_function();
+      google::protobuf::Arena arena;
       for (auto& vector_with_distance_result : tmp_results) {
         pb::index::VectorWithDistanceResult new_vector_with_distance_result;
 
         for (auto& temp_vector_with_distance : *vector_with_distance_result.mutable_vector_with_distances()) {
           uint64_t temp_id = temp_vector_with_distance.vector_with_id().id();
           bool compare_result = false;
-          butil::Status status =
-              CompareVectorScalarData(partition_id, temp_id, vector_with_ids[0].scalar_data(), compare_result);
+          butil::Status status = CompareVectorScalarData(partition_id, temp_id, vector_with_ids[0].scalar_data(),
+                                                         compare_result, &arena);
           if (!status.ok()) {
             return status;
           }
@@ -924,6 +1037,7 @@ butil::Status VectorReader::SearchVectorDebug(
 
   // if vector index does not support restruct vector ,we restruct it using RocksDB
   if (with_vector_data) {
+    std::vector<pb::common::VectorWithId*> vector_with_ids_without_data;
     for (auto& result : vector_with_distance_results) {
       for (auto& vector_with_distance : *result.mutable_vector_with_distances()) {
         if (vector_with_distance.vector_with_id().vector().float_values_size() > 0 ||
@@ -931,14 +1045,14 @@ butil::Status VectorReader::SearchVectorDebug(
           continue;
         }
 
-        pb::common::VectorWithId vector_with_id;
-        auto status = QueryVectorWithId(partition_id, vector_with_distance.vector_with_id().id(), true, vector_with_id);
-        if (!status.ok()) {
-          return status;
-        }
-        vector_with_distance.mutable_vector_with_id()->Swap(&vector_with_id);
+        vector_with_ids_without_data.push_back(vector_with_distance.mutable_vector_with_id());
       }
     }
+
+    auto status = BatchQueryVectorData(partition_id, vector_with_ids_without_data);
+    if (!status.ok()) {
+      return status;
+    }
   }
 
   return butil::Status();
@@ -1020,7 +1134,7 @@ butil::Status VectorReader::DoVectorSearchForScalarPreFilterDebug(
   };
 
   auto start_iter = lambda_time_now_function();
-  auto iter = reader_->NewIterator(options);
+  auto iter = scalar_data_reader_->NewIterator(options);
   if (iter == nullptr) {
     DINGO_LOG(ERROR) << fmt::format("New iterator failed, region range [{}-{})",
                                     Helper::StringToHex(region_range.start_key()),
@@ -23,6 +23,7 @@
 #include "butil/status.h"
 #include "engine/engine.h"
 #include "engine/raw_engine.h"
+#include "google/protobuf/arena.h"
 #include "proto/common.pb.h"
 #include "proto/index.pb.h"
 
@@ -31,10 +32,18 @@ namespace dingodb {
 // Vector reader
 class VectorReader {
  public:
-  VectorReader(std::shared_ptr<RawEngine::Reader> reader) : reader_(reader) {}
-
-  static std::shared_ptr<VectorReader> New(std::shared_ptr<RawEngine::Reader> reader) {
-    return std::make_shared<VectorReader>(reader);
+  // vector data, scalar data and table data is stored in separate column family.
+  VectorReader(std::shared_ptr<RawEngine::Reader> vector_data_reader,
+               std::shared_ptr<RawEngine::Reader> scalar_data_reader,
+               std::shared_ptr<RawEngine::Reader> table_data_reader)
+      : vector_data_reader_(vector_data_reader),
+        scalar_data_reader_(scalar_data_reader),
+        table_data_reader_(table_data_reader) {}
+
+  static std::shared_ptr<VectorReader> New(std::shared_ptr<RawEngine::Reader> vector_data_reader,
+                                           std::shared_ptr<RawEngine::Reader> scalar_data_reader,
+                                           std::shared_ptr<RawEngine::Reader> table_data_reader) {
+    return std::make_shared<VectorReader>(vector_data_reader, scalar_data_reader, table_data_reader);
   }
 
   butil::Status VectorBatchSearch(std::shared_ptr<Engine::VectorReader::Context> ctx,
@@ -75,10 +84,20 @@ class VectorReader {
   butil::Status QueryVectorScalarData(uint64_t partition_id, std::vector<std::string> selected_scalar_keys,
                                       std::vector<pb::index::VectorWithDistanceResult>& results);
 
+  // arena is request scoped, the decoded scalar data of candidates is allocated on it if not null.
   butil::Status CompareVectorScalarData(uint64_t partition_id, uint64_t vector_id,
-                                        const pb::common::VectorScalardata& source_scalar_data, bool& compare_result);
+                                        const pb::common::VectorScalardata& source_scalar_data, bool& compare_result,
+                                        google::protobuf::Arena* arena = nullptr);
 
   butil::Status QueryVectorTableData(uint64_t partition_id, pb::common::VectorWithId& vector_with_id);
+
+  // Query the data of search results by one sorted batch get per column family.
+  butil::Status BatchQueryVectorData(uint64_t partition_id,
+                                     const std::vector<pb::common::VectorWithId*>& vector_with_ids);
+  butil::Status BatchQueryVectorScalarData(uint64_t partition_id, const std::vector<std::string>& selected_scalar_keys,
+                                           const std::vector<pb::common::VectorWithId*>& vector_with_ids);
+  butil::Status BatchQueryVectorTableData(uint64_t partition_id,
+                                          const std::vector<pb::common::VectorWithId*>& vector_with_ids);
   butil::Status QueryVectorTableData(uint64_t partition_id,
                                      std::vector<pb::common::VectorWithDistance>& vector_with_distances);
   butil::Status QueryVectorTableData(uint64_t partition_id, std::vector<pb::index::VectorWithDistanceResult>& results);
@@ -124,7 +143,9 @@ class VectorReader {
       const std::vector<pb::common::VectorWithId>& vector_with_ids, const pb::common::VectorSearchParameter& parameter,
       std::vector<pb::index::VectorWithDistanceResult>& vector_with_distance_results, int64_t& scan_scalar_time_us,
       int64_t& search_time_us);  // NOLINT
-  std::shared_ptr<RawEngine::Reader> reader_;
+  std::shared_ptr<RawEngine::Reader> vector_data_reader_;
+  std::shared_ptr<RawEngine::Reader> scalar_data_reader_;
+  std::shared_ptr<RawEngine::Reader> table_data_reader_;
 };
 
 }  // namespace dingodb
@@ -0,0 +1,125 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "coordinator/auto_increment_control.h"
+#include "proto/coordinator_internal.pb.h"
+
+namespace dingodb {
+
+static void ApplyAutoIncrement(AutoIncrementControl& control, uint64_t table_id,
+                               pb::coordinator_internal::MetaIncrementOpType op_type,
+                               pb::coordinator_internal::AutoIncrementUpdateType update_type, uint64_t start_id,
+                               uint32_t generate_count, bool is_leader, bool preallocate = false) {
+  pb::coordinator_internal::MetaIncrement meta_increment;
+  auto* auto_increment = meta_increment.add_auto_increment();
+  auto_increment->set_id(table_id);
+  auto_increment->set_op_type(op_type);
+  auto* increment = auto_increment->mutable_increment();
+  increment->set_start_id(start_id);
+  increment->set_update_type(update_type);
+  increment->set_generate_count(generate_count);
+  increment->set_increment(1);
+  increment->set_offset(1);
+  increment->set_preallocate(preallocate);
+
+  control.ApplyMetaIncrement(meta_increment, is_leader, 1, 1, nullptr);
+}
+
+TEST(AutoIncrementControlTest, GenerateFromWindow) {
+  AutoIncrementControl control;
+  control.SetLeaderTerm(1);
+
+  const uint64_t table_id = 1;
+  ApplyAutoIncrement(control, table_id, pb::coordinator_internal::CREATE, pb::coordinator_internal::READ_MODIFY_WRITE,
+                     100, 0, true);
+
+  // no window before preallocate is applied
+  uint64_t start_id = 0;
+  uint64_t end_id = 0;
+  EXPECT_FALSE(control.GenerateAutoIncrementFromWindow(table_id, 10, 1, 1, start_id, end_id));
+
+  ApplyAutoIncrement(control, table_id, pb::coordinator_internal::UPDATE,
+                     pb::coordinator_internal::READ_MODIFY_WRITE, 0, 1000, true, true);
+  EXPECT_TRUE(control.GenerateAutoIncrementFromWindow(table_id, 10, 1, 1, start_id, end_id));
+  EXPECT_EQ(start_id, 100);
+  EXPECT_EQ(end_id, 110);
+
+  uint64_t next_id = 0;
+  EXPECT_TRUE(control.GetAutoIncrement(table_id, next_id).ok());
+  EXPECT_EQ(next_id, 110);
+
+  // same as generate through raft with increment and offset
+  EXPECT_TRUE(control.GenerateAutoIncrementFromWindow(table_id, 3, 5, 2, start_id, end_id));
+  EXPECT_EQ(start_id, 110);
+  EXPECT_EQ(end_id, 127);
+
+  // window is not enough
+  EXPECT_FALSE(control.GenerateAutoIncrementFromWindow(table_id, 1000, 1, 1, start_id, end_id));
+
+  // continuous preallocate extends the window
+  ApplyAutoIncrement(control, table_id, pb::coordinator_internal::UPDATE,
+                     pb::coordinator_internal::READ_MODIFY_WRITE, 0, 1000, true, true);
+  EXPECT_TRUE(control.GenerateAutoIncrementFromWindow(table_id, 1000, 1, 1, start_id, end_id));
+  EXPECT_EQ(start_id, 127);
+  EXPECT_EQ(end_id, 1127);
+
+  // update closes the window
+  ApplyAutoIncrement(control, table_id, pb::coordinator_internal::UPDATE, pb::coordinator_internal::UPDATE_ONLY, 5000,
+                     0, true);
+  EXPECT_FALSE(control.GenerateAutoIncrementFromWindow(table_id, 1, 1, 1, start_id, end_id));
+  EXPECT_TRUE(control.GetAutoIncrement(table_id, next_id).ok());
+  EXPECT_EQ(next_id, 5000);
+
+  // illegal parameters are not generated from window
+  EXPECT_FALSE(control.GenerateAutoIncrementFromWindow(table_id, 0, 1, 1, start_id, end_id));
+
+  // no window for not exist table
+  EXPECT_FALSE(control.GenerateAutoIncrementFromWindow(100, 1, 1, 1, start_id, end_id));
+  ApplyAutoIncrement(control, 100, pb::coordinator_internal::UPDATE, pb::coordinator_internal::READ_MODIFY_WRITE, 0,
+                     1000, true, true);
+  EXPECT_FALSE(control.GenerateAutoIncrementFromWindow(100, 1, 1, 1, start_id, end_id));
+  EXPECT_FALSE(control.GetAutoIncrement(100, next_id).ok());
+}
+
+TEST(AutoIncrementControlTest, FollowerHasNoWindow) {
+  AutoIncrementControl control;
+  control.SetLeaderTerm(1);
+
+  const uint64_t table_id = 2;
+  ApplyAutoIncrement(control, table_id, pb::coordinator_internal::CREATE, pb::coordinator_internal::READ_MODIFY_WRITE,
+                     1, 0, false);
+  ApplyAutoIncrement(control, table_id, pb::coordinator_internal::UPDATE,
+                     pb::coordinator_internal::READ_MODIFY_WRITE, 0, 1000, false, true);
+
+  uint64_t start_id = 0;
+  uint64_t end_id = 0;
+  EXPECT_FALSE(control.GenerateAutoIncrementFromWindow(table_id, 1, 1, 1, start_id, end_id));
+
+  // the preallocated ids are never generated again
+  uint64_t next_id = 0;
+  EXPECT_TRUE(control.GetAutoIncrement(table_id, next_id).ok());
+  EXPECT_EQ(next_id, 1001);
+
+  // the version without window ignores preallocate and applies the same generate
+  ApplyAutoIncrement(control, table_id, pb::coordinator_internal::UPDATE, pb::coordinator_internal::READ_MODIFY_WRITE,
+                     0, 1000, false, false);
+  EXPECT_TRUE(control.GetAutoIncrement(table_id, next_id).ok());
+  EXPECT_EQ(next_id, 2001);
+}
+
+}  // namespace dingodb
@@ -0,0 +1,112 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "bthread/bthread.h"
+#include "butil/time.h"
+#include "gflags/gflags.h"
+#include "store/background_task_scheduler.h"
+
+namespace dingodb {
+
+DECLARE_int64(background_split_check_concurrency);
+DECLARE_int64(background_scan_rate_limit_bytes);
+
+class BackgroundTaskSchedulerTest : public testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  inline static std::atomic<int64_t> running_num{0};
+  inline static std::atomic<int64_t> max_running_num{0};
+};
+
+TEST_F(BackgroundTaskSchedulerTest, ConcurrencyCap) {
+  FLAGS_background_split_check_concurrency = 2;
+
+  auto task = [](void*) -> void* {
+    BackgroundTaskGuard guard(BackgroundTaskType::kSplitCheck);
+    int64_t num = ++running_num;
+    int64_t max_num = max_running_num.load();
+    while (num > max_num && !max_running_num.compare_exchange_weak(max_num, num)) {
+    }
+    bthread_usleep(20 * 1000);
+    --running_num;
+    return nullptr;
+  };
+
+  std::vector<bthread_t> tids(8);
+  for (auto& tid : tids) {
+    EXPECT_EQ(bthread_start_background(&tid, nullptr, task, nullptr), 0);
+  }
+  for (auto& tid : tids) {
+    bthread_join(tid, nullptr);
+  }
+
+  EXPECT_EQ(running_num.load(), 0);
+  EXPECT_LE(max_running_num.load(), 2);
+  EXPECT_GE(max_running_num.load(), 1);
+}
+
+TEST_F(BackgroundTaskSchedulerTest, RaiseConcurrency) {
+  FLAGS_background_split_check_concurrency = 1;
+
+  // hold the only slot, the waiting task can not run until the concurrency is raised
+  BackgroundTaskGuard guard(BackgroundTaskType::kSplitCheck);
+
+  static std::atomic<bool> done{false};
+  done = false;
+  auto task = [](void*) -> void* {
+    BackgroundTaskGuard guard(BackgroundTaskType::kSplitCheck);
+    done = true;
+    return nullptr;
+  };
+
+  bthread_t tid;
+  EXPECT_EQ(bthread_start_background(&tid, nullptr, task, nullptr), 0);
+  bthread_usleep(200 * 1000);
+  EXPECT_FALSE(done.load());
+
+  FLAGS_background_split_check_concurrency = 2;
+  int64_t start_us = butil::gettimeofday_us();
+  bthread_join(tid, nullptr);
+  EXPECT_TRUE(done.load());
+  EXPECT_LT(butil::gettimeofday_us() - start_us, 1000 * 1000);
+}
+
+TEST_F(BackgroundTaskSchedulerTest, ScanRateLimit) {
+  // unlimited
+  FLAGS_background_scan_rate_limit_bytes = 0;
+  int64_t start_us = butil::gettimeofday_us();
+  BackgroundTaskScheduler::GetInstance()->RequestScanBytes(1024 * 1024 * 1024);
+  EXPECT_LT(butil::gettimeofday_us() - start_us, 100 * 1000);
+
+  // 10MB/s, 100ms burst is consumed by the first 1MB, the next 2MB wait about 200ms
+  FLAGS_background_scan_rate_limit_bytes = 10 * 1024 * 1024;
+  BackgroundTaskScheduler::GetInstance()->RequestScanBytes(1024 * 1024);
+  start_us = butil::gettimeofday_us();
+  BackgroundTaskScheduler::GetInstance()->RequestScanBytes(2 * 1024 * 1024);
+  int64_t elapsed_us = butil::gettimeofday_us() - start_us;
+  EXPECT_GE(elapsed_us, 150 * 1000);
+  EXPECT_LT(elapsed_us, 1000 * 1000);
+
+  FLAGS_background_scan_rate_limit_bytes = 0;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,145 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "bench/bench_histogram.h"
+
+namespace bench {
+
+TEST(LatencyHistogramTest, Exact) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(0, histogram.Count());
+  EXPECT_EQ(0, histogram.Min());
+  EXPECT_EQ(0, histogram.Percentile(50));
+
+  // small value is recorded exactly
+  for (uint64_t i = 1; i <= 100; ++i) {
+    histogram.Record(i);
+  }
+  EXPECT_EQ(100, histogram.Count());
+  EXPECT_EQ(1, histogram.Min());
+  EXPECT_EQ(100, histogram.Max());
+  EXPECT_DOUBLE_EQ(50.5, histogram.Mean());
+  EXPECT_EQ(50, histogram.Percentile(50));
+  EXPECT_EQ(99, histogram.Percentile(99));
+  EXPECT_EQ(100, histogram.Percentile(100));
+  EXPECT_EQ(1, histogram.Percentile(0));
+}
+
+TEST(LatencyHistogramTest, RelativeError) {
+  LatencyHistogram histogram;
+  std::vector<uint64_t> values = {1000, 12345, 999999, 123456789, 1ULL << 40};
+  for (auto value : values) {
+    histogram.Reset();
+    histogram.Record(value);
+    uint64_t result = histogram.Percentile(50);
+    // clamp to [min, max]
+    EXPECT_EQ(value, result);
+  }
+
+  histogram.Reset();
+  for (uint64_t i = 1; i <= 100000; ++i) {
+    histogram.Record(i);
+  }
+  for (double percentile : {50.0, 90.0, 99.0, 99.9}) {
+    auto expected = static_cast<double>(percentile / 100 * 100000);
+    auto result = static_cast<double>(histogram.Percentile(percentile));
+    EXPECT_GE(result, expected);
+    EXPECT_LE(result, expected * (1 + 1.0 / 64));
+  }
+}
+
+TEST(LatencyHistogramTest, Merge) {
+  LatencyHistogram histogram1;
+  LatencyHistogram histogram2;
+  for (uint64_t i = 1; i <= 50; ++i) {
+    histogram1.Record(i);
+    histogram2.Record(i + 50);
+  }
+
+  LatencyHistogram empty;
+  histogram1.Merge(empty);
+  EXPECT_EQ(50, histogram1.Count());
+
+  histogram1.Merge(histogram2);
+  EXPECT_EQ(100, histogram1.Count());
+  EXPECT_EQ(1, histogram1.Min());
+  EXPECT_EQ(100, histogram1.Max());
+  EXPECT_EQ(50, histogram1.Percentile(50));
+
+  histogram1.Reset();
+  EXPECT_EQ(0, histogram1.Count());
+  EXPECT_EQ(0, histogram1.Max());
+}
+
+TEST(ZipfianGeneratorTest, Next) {
+  const uint64_t item_count = 1000;
+  ZipfianGenerator generator(item_count, 0.99);
+  std::mt19937_64 engine(1);
+
+  std::vector<uint64_t> counts(item_count, 0);
+  for (int i = 0; i < 100000; ++i) {
+    auto item = generator.Next(engine);
+    ASSERT_LT(item, item_count);
+    ++counts[item];
+  }
+
+  // item 0 is the most popular one, and popularity decrease with item
+  EXPECT_GT(counts[0], counts[1]);
+  EXPECT_GT(counts[1], counts[10]);
+  EXPECT_GT(counts[10], counts[500]);
+  // theta 0.99 over 1000 items, item 0 is about 13%
+  EXPECT_GT(counts[0], 100000 / 10);
+  EXPECT_LT(counts[0], 100000 / 5);
+}
+
+TEST(ZipfianGeneratorTest, NextScrambled) {
+  const uint64_t item_count = 1000;
+  ZipfianGenerator generator(item_count, 0.99);
+  std::mt19937_64 engine(1);
+
+  std::vector<uint64_t> counts(item_count, 0);
+  for (int i = 0; i < 100000; ++i) {
+    auto item = generator.NextScrambled(engine);
+    ASSERT_LT(item, item_count);
+    ++counts[item];
+  }
+  // the popular item is not item 0 anymore
+  auto max_it = std::max_element(counts.begin(), counts.end());
+  EXPECT_NE(0, max_it - counts.begin());
+
+  // bounded by the given item count
+  for (uint64_t bound : {static_cast<uint64_t>(1), static_cast<uint64_t>(10), item_count + 100}) {
+    for (int i = 0; i < 10000; ++i) {
+      ASSERT_LT(generator.NextScrambled(engine, bound), bound);
+    }
+  }
+}
+
+TEST(ZipfianGeneratorTest, SingleItem) {
+  ZipfianGenerator generator(1, 0.99);
+  std::mt19937_64 engine(1);
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_EQ(0, generator.Next(engine));
+    EXPECT_EQ(0, generator.NextScrambled(engine));
+  }
+}
+
+}  // namespace bench
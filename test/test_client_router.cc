@@ -0,0 +1,157 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "client/client_router.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+
+// defined by the client main
+DEFINE_bool(log_each_request, false, "Print log for each request");
+DEFINE_uint64(timeout_ms, 500, "Timeout for each request");
+
+namespace client {
+
+// Only query the cached regions which are not dirty, so the router never access coordinator.
+class ClientRouterTest : public testing::Test {
+ protected:
+  static dingodb::pb::common::Region GenRegion(uint64_t region_id, const std::string& start_key,
+                                               const std::string& end_key, uint64_t version) {
+    dingodb::pb::common::Region region;
+    region.set_id(region_id);
+    region.mutable_definition()->set_id(region_id);
+    region.mutable_definition()->set_part_id(1);
+    region.mutable_definition()->mutable_range()->set_start_key(start_key);
+    region.mutable_definition()->mutable_range()->set_end_key(end_key);
+    region.mutable_definition()->mutable_epoch()->set_conf_version(1);
+    region.mutable_definition()->mutable_epoch()->set_version(version);
+    return region;
+  }
+
+  static dingodb::pb::error::StoreRegionInfo GenRegionInfo(uint64_t region_id, const std::string& start_key,
+                                                           const std::string& end_key, uint64_t version) {
+    dingodb::pb::error::StoreRegionInfo region_info;
+    region_info.set_region_id(region_id);
+    region_info.mutable_current_range()->set_start_key(start_key);
+    region_info.mutable_current_range()->set_end_key(end_key);
+    region_info.mutable_current_region_epoch()->set_conf_version(1);
+    region_info.mutable_current_region_epoch()->set_version(version);
+    return region_info;
+  }
+};
+
+TEST_F(ClientRouterTest, QueryByKey) {
+  RegionRouter router;
+  router.AddRegionEntry(GenRegion(1, "a", "c", 1));
+  router.AddRegionEntry(GenRegion(2, "c", "f", 1));
+
+  EXPECT_EQ(1, router.QueryRegionEntry(std::string("a"))->RegionId());
+  EXPECT_EQ(1, router.QueryRegionEntry(std::string("bbb"))->RegionId());
+  EXPECT_EQ(2, router.QueryRegionEntry(std::string("c"))->RegionId());
+  EXPECT_EQ(2, router.QueryRegionEntry(std::string("ezz"))->RegionId());
+  EXPECT_EQ(2, router.QueryRegionEntryByPartition(1).size());
+
+  std::map<uint64_t, std::vector<size_t>> region_key_indexes;
+  EXPECT_TRUE(router.GroupKeysByRegion({"a", "d", "b", "e"}, region_key_indexes).ok());
+  ASSERT_EQ(2, region_key_indexes.size());
+  EXPECT_EQ(std::vector<size_t>({0, 2}), region_key_indexes[1]);
+  EXPECT_EQ(std::vector<size_t>({1, 3}), region_key_indexes[2]);
+}
+
+TEST_F(ClientRouterTest, IsNewerEpoch) {
+  dingodb::pb::common::RegionEpoch old_epoch;
+  old_epoch.set_conf_version(2);
+  old_epoch.set_version(2);
+
+  dingodb::pb::common::RegionEpoch epoch = old_epoch;
+  EXPECT_FALSE(RegionRouter::IsNewerEpoch(epoch, old_epoch));
+  epoch.set_conf_version(3);
+  EXPECT_TRUE(RegionRouter::IsNewerEpoch(epoch, old_epoch));
+  epoch.set_version(1);
+  EXPECT_FALSE(RegionRouter::IsNewerEpoch(epoch, old_epoch));
+  epoch.set_version(3);
+  epoch.set_conf_version(1);
+  EXPECT_TRUE(RegionRouter::IsNewerEpoch(epoch, old_epoch));
+}
+
+TEST_F(ClientRouterTest, UpdateStaleEpoch) {
+  RegionRouter router;
+  router.AddRegionEntry(GenRegion(1, "a", "f", 2));
+  auto old_region_entry = router.QueryRegionEntry(1);
+  ASSERT_NE(nullptr, old_region_entry);
+
+  // older or same epoch is ignored
+  router.UpdateRegionEntry(GenRegionInfo(1, "a", "c", 1));
+  router.UpdateRegionEntry(GenRegionInfo(1, "a", "c", 2));
+  EXPECT_FALSE(old_region_entry->IsDirty());
+  EXPECT_EQ(old_region_entry, router.QueryRegionEntry(1));
+  EXPECT_EQ("f", router.QueryRegionEntry(1)->Range().end_key());
+
+  // region split, the newer epoch replace the entry and re-key the range
+  router.UpdateRegionEntry(GenRegionInfo(1, "a", "c", 3));
+  EXPECT_TRUE(old_region_entry->IsDirty());
+  // copy on write, the old entry is not changed
+  EXPECT_EQ("f", old_region_entry->Range().end_key());
+
+  auto region_entry = router.QueryRegionEntry(1);
+  ASSERT_NE(nullptr, region_entry);
+  EXPECT_NE(old_region_entry, region_entry);
+  EXPECT_FALSE(region_entry->IsDirty());
+  EXPECT_EQ("c", region_entry->Range().end_key());
+  EXPECT_EQ(3, region_entry->Epoch().version());
+  EXPECT_EQ(1, router.QueryRegionEntry(std::string("b"))->RegionId());
+
+  // the new region of split
+  router.AddRegionEntry(GenRegion(2, "c", "f", 3));
+  EXPECT_EQ(2, router.QueryRegionEntry(std::string("d"))->RegionId());
+
+  // region merge, the merged region is removed from route
+  router.UpdateRegionEntry(GenRegionInfo(1, "a", "f", 4));
+  EXPECT_EQ(1, router.QueryRegionEntry(std::string("d"))->RegionId());
+  EXPECT_EQ(1, router.QueryRegionEntryByPartition(1).size());
+}
+
+TEST_F(ClientRouterTest, Invalidate) {
+  RegionRouter router;
+  router.AddRegionEntry(GenRegion(1, "a", "f", 1));
+  auto region_entry = router.QueryRegionEntry(1);
+  ASSERT_NE(nullptr, region_entry);
+
+  // not exist region is ignored
+  router.InvalidateRegionEntry(100);
+  EXPECT_FALSE(region_entry->IsDirty());
+
+  // invalidate only mark dirty, the entry is kept in route until reload
+  router.InvalidateRegionEntry(1);
+  EXPECT_TRUE(region_entry->IsDirty());
+
+  // error without epoch can not be judged, mark dirty too
+  router.AddRegionEntry(GenRegion(2, "f", "h", 1));
+  auto region_entry2 = router.QueryRegionEntry(2);
+  ASSERT_NE(nullptr, region_entry2);
+  dingodb::pb::error::StoreRegionInfo region_info;
+  region_info.set_region_id(2);
+  router.UpdateRegionEntry(region_info);
+  EXPECT_TRUE(region_entry2->IsDirty());
+  EXPECT_EQ(1, region_entry2->Epoch().version());
+}
+
+}  // namespace client
@@ -0,0 +1,239 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "butil/containers/flat_map.h"
+#include "coordinator/coordinator_control.h"
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+class CoordinatorBalanceTest : public testing::Test {
+ protected:
+  static void AddStore(std::map<uint64_t, StoreLoad>& store_loads, uint64_t store_id) {
+    auto& store_load = store_loads[store_id];
+    store_load.store_id = store_id;
+    store_load.store_type = pb::common::StoreType::NODE_TYPE_STORE;
+  }
+
+  static void AddRegion(std::map<uint64_t, StoreLoad>& store_loads, uint64_t region_id, uint64_t leader_store_id,
+                        const std::vector<uint64_t>& store_ids, uint64_t region_size, uint64_t write_qps) {
+    for (auto store_id : store_ids) {
+      RegionLoad region_load;
+      region_load.region_id = region_id;
+      region_load.is_leader = store_id == leader_store_id;
+      region_load.region_size = region_size;
+      region_load.write_qps = write_qps;
+      region_load.peer_store_ids = store_ids;
+
+      auto& store_load = store_loads[store_id];
+      store_load.region_count++;
+      store_load.region_size += region_size;
+      if (region_load.is_leader) {
+        store_load.leader_count++;
+        store_load.write_qps += write_qps;
+      }
+      store_load.regions.insert({region_id, region_load});
+    }
+  }
+};
+
+TEST_F(CoordinatorBalanceTest, CollectStoreLoads) {
+  butil::FlatMap<uint64_t, pb::common::Store> store_map;
+  store_map.init(16);
+  for (uint64_t store_id = 1; store_id <= 3; ++store_id) {
+    pb::common::Store store;
+    store.set_id(store_id);
+    store.set_state(pb::common::StoreState::STORE_NORMAL);
+    store.set_in_state(pb::common::StoreInState::STORE_IN);
+    store.set_store_type(pb::common::StoreType::NODE_TYPE_STORE);
+    store_map.insert(store_id, store);
+  }
+  // offline store is not balanced
+  store_map[3].set_state(pb::common::StoreState::STORE_OFFLINE);
+
+  butil::FlatMap<uint64_t, pb::common::StoreMetrics> store_metrics_map;
+  store_metrics_map.init(16);
+  for (uint64_t store_id = 1; store_id <= 3; ++store_id) {
+    pb::common::StoreMetrics store_metrics;
+    store_metrics.set_id(store_id);
+    for (uint64_t region_id = 100; region_id < 102; ++region_id) {
+      pb::common::RegionMetrics region_metrics;
+      region_metrics.set_id(region_id);
+      region_metrics.set_leader_store_id(region_id == 100 ? 1 : 2);
+      region_metrics.set_region_size(1000);
+      region_metrics.set_write_qps(10);
+      region_metrics.mutable_region_definition()->add_peers()->set_store_id(1);
+      region_metrics.mutable_region_definition()->add_peers()->set_store_id(2);
+      region_metrics.mutable_region_definition()->add_peers()->set_store_id(3);
+      store_metrics.mutable_region_metrics_map()->insert({region_id, region_metrics});
+    }
+    store_metrics_map.insert(store_id, store_metrics);
+  }
+
+  std::map<uint64_t, StoreLoad> store_loads;
+  CoordinatorControl::CollectStoreLoads(store_map, store_metrics_map, store_loads);
+
+  ASSERT_EQ(2, store_loads.size());
+  EXPECT_EQ(0, store_loads.count(3));
+  EXPECT_EQ(2, store_loads[1].region_count);
+  EXPECT_EQ(1, store_loads[1].leader_count);
+  EXPECT_EQ(2000, store_loads[1].region_size);
+  EXPECT_EQ(10, store_loads[1].write_qps);
+  EXPECT_TRUE(store_loads[1].regions[100].is_leader);
+  EXPECT_FALSE(store_loads[1].regions[101].is_leader);
+  EXPECT_EQ(3, store_loads[1].regions[100].peer_store_ids.size());
+}
+
+TEST_F(CoordinatorBalanceTest, PlanBalanceLeader) {
+  std::map<uint64_t, StoreLoad> store_loads;
+  for (uint64_t store_id = 1; store_id <= 3; ++store_id) {
+    AddStore(store_loads, store_id);
+  }
+  // all 6 leaders on store 1, region 105 is the hottest
+  for (uint64_t region_id = 100; region_id < 106; ++region_id) {
+    AddRegion(store_loads, region_id, 1, {1, 2, 3}, 1000, region_id);
+  }
+
+  std::set<uint64_t> scheduled_region_ids;
+  auto operations = CoordinatorControl::PlanBalanceLeader(pb::common::StoreType::NODE_TYPE_STORE, store_loads,
+                                                          scheduled_region_ids, 1);
+  ASSERT_EQ(1, operations.size());
+  EXPECT_EQ(105, operations[0].region_id);
+  EXPECT_EQ(1, operations[0].source_store_id);
+  EXPECT_NE(1, operations[0].target_store_id);
+  EXPECT_EQ(5, store_loads[1].leader_count);
+  EXPECT_EQ(1, store_loads[operations[0].target_store_id].leader_count);
+  EXPECT_TRUE(store_loads[operations[0].target_store_id].regions[105].is_leader);
+
+  // continue until balanced, every region is scheduled at most once
+  operations = CoordinatorControl::PlanBalanceLeader(pb::common::StoreType::NODE_TYPE_STORE, store_loads,
+                                                     scheduled_region_ids, 100);
+  EXPECT_EQ(3, operations.size());
+  for (const auto& operation : operations) {
+    EXPECT_NE(105, operation.region_id);
+  }
+  EXPECT_EQ(2, store_loads[1].leader_count);
+  EXPECT_EQ(2, store_loads[2].leader_count);
+  EXPECT_EQ(2, store_loads[3].leader_count);
+
+  // balanced, nothing to do
+  operations = CoordinatorControl::PlanBalanceLeader(pb::common::StoreType::NODE_TYPE_STORE, store_loads,
+                                                     scheduled_region_ids, 100);
+  EXPECT_TRUE(operations.empty());
+
+  // other store type is not touched
+  operations = CoordinatorControl::PlanBalanceLeader(pb::common::StoreType::NODE_TYPE_INDEX, store_loads,
+                                                     scheduled_region_ids, 100);
+  EXPECT_TRUE(operations.empty());
+}
+
+TEST_F(CoordinatorBalanceTest, PlanBalanceLeaderNoFollower) {
+  std::map<uint64_t, StoreLoad> store_loads;
+  for (uint64_t store_id = 1; store_id <= 3; ++store_id) {
+    AddStore(store_loads, store_id);
+  }
+  // store 3 has no follower of the regions, leader can not transfer to it
+  for (uint64_t region_id = 100; region_id < 104; ++region_id) {
+    AddRegion(store_loads, region_id, 1, {1, 2}, 1000, 10);
+  }
+  for (uint64_t region_id = 104; region_id < 106; ++region_id) {
+    AddRegion(store_loads, region_id, 2, {1, 2}, 1000, 10);
+  }
+
+  std::set<uint64_t> scheduled_region_ids;
+  auto operations = CoordinatorControl::PlanBalanceLeader(pb::common::StoreType::NODE_TYPE_STORE, store_loads,
+                                                          scheduled_region_ids, 100);
+  EXPECT_TRUE(operations.empty());
+}
+
+TEST_F(CoordinatorBalanceTest, PlanBalanceRegion) {
+  std::map<uint64_t, StoreLoad> store_loads;
+  for (uint64_t store_id = 1; store_id <= 4; ++store_id) {
+    AddStore(store_loads, store_id);
+  }
+  // store 4 is new and empty, leaders are on store 1
+  for (uint64_t region_id = 100; region_id < 108; ++region_id) {
+    AddRegion(store_loads, region_id, 1, {1, 2, 3}, 1000, 10);
+  }
+
+  std::set<uint64_t> scheduled_region_ids;
+  auto operations = CoordinatorControl::PlanBalanceRegion(pb::common::StoreType::NODE_TYPE_STORE, store_loads,
+                                                          scheduled_region_ids, 100);
+  ASSERT_FALSE(operations.empty());
+
+  std::set<uint64_t> region_ids;
+  for (const auto& operation : operations) {
+    // only follower is moved, and the target has no peer of the region
+    EXPECT_NE(1, operation.source_store_id);
+    EXPECT_EQ(4, operation.target_store_id);
+    EXPECT_EQ(3, operation.peer_store_ids.size());
+    EXPECT_TRUE(region_ids.insert(operation.region_id).second);
+    EXPECT_EQ(1, scheduled_region_ids.count(operation.region_id));
+  }
+
+  EXPECT_EQ(5, operations.size());
+  EXPECT_EQ(operations.size(), store_loads[4].region_count);
+  EXPECT_EQ(operations.size() * 1000, store_loads[4].region_size);
+  EXPECT_EQ(8, store_loads[1].region_count);
+  EXPECT_EQ(8 * 3, store_loads[1].region_count + store_loads[2].region_count + store_loads[3].region_count +
+                       store_loads[4].region_count);
+  // store 4 does not overshoot the other stores
+  EXPECT_LE(store_loads[4].region_count, store_loads[2].region_count + 1);
+  EXPECT_LE(store_loads[4].region_count, store_loads[3].region_count + 1);
+}
+
+TEST_F(CoordinatorBalanceTest, PlanBalanceRegionMaxOps) {
+  std::map<uint64_t, StoreLoad> store_loads;
+  for (uint64_t store_id = 1; store_id <= 4; ++store_id) {
+    AddStore(store_loads, store_id);
+  }
+  for (uint64_t region_id = 100; region_id < 108; ++region_id) {
+    AddRegion(store_loads, region_id, 1, {1, 2, 3}, 1000, 10);
+  }
+
+  std::set<uint64_t> scheduled_region_ids;
+  auto operations = CoordinatorControl::PlanBalanceRegion(pb::common::StoreType::NODE_TYPE_STORE, store_loads,
+                                                          scheduled_region_ids, 1);
+  EXPECT_EQ(1, operations.size());
+  EXPECT_EQ(1, store_loads[4].region_count);
+}
+
+TEST_F(CoordinatorBalanceTest, SelectTrimPeerStore) {
+  std::map<uint64_t, StoreLoad> store_loads;
+  for (uint64_t store_id = 1; store_id <= 4; ++store_id) {
+    AddStore(store_loads, store_id);
+  }
+  for (uint64_t region_id = 100; region_id < 104; ++region_id) {
+    AddRegion(store_loads, region_id, 1, {1, 2, 3}, 1000, 10);
+  }
+  AddRegion(store_loads, 104, 1, {1, 3, 4}, 1000, 10);
+
+  // the move source is preferred
+  EXPECT_EQ(2, CoordinatorControl::SelectTrimPeerStore({1, 2, 3, 4}, 1, 2, store_loads));
+  // no move source, e.g. the pending move is lost after coordinator leader change, trim the most loaded store
+  EXPECT_EQ(3, CoordinatorControl::SelectTrimPeerStore({1, 2, 3, 4}, 1, 0, store_loads));
+  // the leader peer and the source which is not a peer are never selected
+  EXPECT_EQ(3, CoordinatorControl::SelectTrimPeerStore({1, 2, 3, 4}, 1, 1, store_loads));
+  EXPECT_EQ(3, CoordinatorControl::SelectTrimPeerStore({1, 3, 4}, 1, 2, store_loads));
+  EXPECT_EQ(0, CoordinatorControl::SelectTrimPeerStore({1}, 1, 0, store_loads));
+}
+
+}  // namespace dingodb
@@ -0,0 +1,121 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "coordinator/coordinator_meta_index.h"
+#include "proto/coordinator.pb.h"
+#include "proto/coordinator_internal.pb.h"
+
+namespace dingodb {
+
+static pb::coordinator_internal::RegionInternal GenRegion(uint64_t region_id, uint64_t table_id, uint64_t index_id,
+                                                          const std::vector<uint64_t>& store_ids) {
+  pb::coordinator_internal::RegionInternal region;
+  region.set_id(region_id);
+  region.mutable_definition()->set_id(region_id);
+  region.mutable_definition()->set_table_id(table_id);
+  region.mutable_definition()->set_index_id(index_id);
+  for (auto store_id : store_ids) {
+    region.mutable_definition()->add_peers()->set_store_id(store_id);
+  }
+  return region;
+}
+
+TEST(CoordinatorMetaIndexTest, Region) {
+  CoordinatorMetaIndex meta_index;
+  meta_index.PutRegion(GenRegion(1, 100, 0, {1, 2, 3}));
+  meta_index.PutRegion(GenRegion(2, 100, 0, {1, 2, 4}));
+  meta_index.PutRegion(GenRegion(3, 0, 200, {2, 3, 4}));
+
+  EXPECT_EQ(meta_index.GetRegionCountByStore(1), 2);
+  EXPECT_EQ(meta_index.GetRegionCountByStore(2), 3);
+  EXPECT_EQ(meta_index.GetRegionIdsByTable(100), std::vector<uint64_t>({1, 2}));
+  EXPECT_EQ(meta_index.GetRegionIdsByIndex(200), std::vector<uint64_t>({3}));
+  EXPECT_EQ(meta_index.GetRegionCountByStore(5), 0);
+
+  // change peer replaces the old entries
+  meta_index.PutRegion(GenRegion(1, 100, 0, {2, 3, 5}));
+  EXPECT_EQ(meta_index.GetRegionCountByStore(1), 1);
+  EXPECT_EQ(meta_index.GetRegionCountByStore(5), 1);
+
+  meta_index.EraseRegion(2);
+  EXPECT_EQ(meta_index.GetRegionCountByStore(1), 0);
+  EXPECT_EQ(meta_index.GetRegionIdsByTable(100), std::vector<uint64_t>({1}));
+  EXPECT_EQ(meta_index.GetRegionCountByStore(4), 1);
+
+  meta_index.Clear();
+  EXPECT_TRUE(meta_index.GetRegionIdsByTable(100).empty());
+  EXPECT_EQ(meta_index.GetRegionCountByStore(2), 0);
+}
+
+TEST(CoordinatorMetaIndexTest, TaskList) {
+  CoordinatorMetaIndex meta_index;
+
+  pb::coordinator::TaskList task_list;
+  task_list.set_id(10);
+  auto* store_operation = task_list.add_tasks()->add_store_operations();
+  store_operation->set_id(1);
+  store_operation->add_region_cmds()->set_region_id(1);
+  store_operation->add_region_cmds()->set_region_id(2);
+  meta_index.PutTaskList(10, task_list);
+
+  EXPECT_EQ(meta_index.GetTaskListIdsByRegion(1), std::vector<uint64_t>({10}));
+  EXPECT_EQ(meta_index.GetTaskListIdsByRegion(2), std::vector<uint64_t>({10}));
+  EXPECT_TRUE(meta_index.GetTaskListIdsByRegion(3).empty());
+
+  // update task list
+  task_list.mutable_tasks(0)->mutable_store_operations(0)->mutable_region_cmds(1)->set_region_id(3);
+  meta_index.PutTaskList(10, task_list);
+  EXPECT_TRUE(meta_index.GetTaskListIdsByRegion(2).empty());
+  EXPECT_EQ(meta_index.GetTaskListIdsByRegion(3), std::vector<uint64_t>({10}));
+
+  meta_index.EraseTaskList(10);
+  EXPECT_TRUE(meta_index.GetTaskListIdsByRegion(1).empty());
+  EXPECT_TRUE(meta_index.GetTaskListIdsByRegion(3).empty());
+}
+
+TEST(CoordinatorMetaIndexTest, StoreOperation) {
+  CoordinatorMetaIndex meta_index;
+
+  // the store operation is applied before its region_cmds in one meta increment
+  pb::coordinator_internal::StoreOperationInternal store_operation;
+  store_operation.set_id(1);
+  store_operation.add_region_cmd_ids(100);
+  store_operation.add_region_cmd_ids(101);
+  meta_index.PutStoreOperation(store_operation);
+  EXPECT_TRUE(meta_index.GetStoreOperationIdsByRegion(1).empty());
+
+  meta_index.PutRegionCmd(100, 1);
+  meta_index.PutRegionCmd(101, 2);
+  meta_index.PutRegionCmd(102, 2);
+  EXPECT_EQ(meta_index.GetStoreOperationIdsByRegion(1), std::vector<uint64_t>({1}));
+  EXPECT_EQ(meta_index.GetStoreOperationIdsByRegion(2), std::vector<uint64_t>({1}));
+
+  // region_cmd removed from store operation
+  store_operation.clear_region_cmd_ids();
+  store_operation.add_region_cmd_ids(101);
+  meta_index.PutStoreOperation(store_operation);
+  EXPECT_TRUE(meta_index.GetStoreOperationIdsByRegion(1).empty());
+  EXPECT_EQ(meta_index.GetStoreOperationIdsByRegion(2), std::vector<uint64_t>({1}));
+
+  // region_cmd deleted
+  meta_index.EraseRegionCmd(101);
+  EXPECT_TRUE(meta_index.GetStoreOperationIdsByRegion(2).empty());
+}
+
+}  // namespace dingodb
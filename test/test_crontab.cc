@@ -14,6 +14,7 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <memory>
@@ -92,3 +93,62 @@ TEST(CrontabManagerTest, pause) {
   EXPECT_EQ("", str);
   crontab_manager.Destroy();
 }
+
+TEST(CrontabManagerTest, skip_if_running) {
+  dingodb::CrontabManager crontab_manager;
+
+  std::shared_ptr<dingodb::Crontab> crontab = std::make_shared<dingodb::Crontab>();
+  crontab->name = "test_skip_if_running";
+  crontab->immediately = true;
+  crontab->async = true;
+  crontab->interval = 100;
+  crontab->func = [](void* arg) -> void {
+    std::atomic<int>* count = static_cast<std::atomic<int>*>(arg);
+    count->fetch_add(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+  };
+  std::atomic<int> count(0);
+  crontab->arg = &count;
+
+  crontab_manager.AddAndRunCrontab(crontab);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  crontab_manager.PauseCrontab(crontab->id);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+
+  // the ticks during running are skipped, and the interval is backed off after overrun
+  EXPECT_LE(count.load(), 2);
+  EXPECT_GT(crontab->skip_count.get_value(), 0);
+  EXPECT_GT(crontab->backoff_times.load(), 1);
+  EXPECT_EQ(crontab->latency.count(), count.load());
+  crontab_manager.Destroy();
+}
+
+TEST(CrontabManagerTest, delete_while_async_running) {
+  dingodb::CrontabManager crontab_manager;
+
+  std::shared_ptr<dingodb::Crontab> crontab = std::make_shared<dingodb::Crontab>();
+  crontab->name = "test_delete_while_async_running";
+  crontab->immediately = true;
+  crontab->async = true;
+  crontab->max_times = 1;
+  crontab->interval = 10000;
+  crontab->func = [](void* arg) -> void {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+    static_cast<std::atomic<bool>*>(arg)->store(true);
+  };
+  std::atomic<bool> is_done(false);
+  crontab->arg = &is_done;
+
+  uint32_t crontab_id = crontab_manager.AddAndRunCrontab(crontab);
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  crontab_manager.DeleteCrontab(crontab_id);
+
+  // the running bthread still hold the crontab
+  std::weak_ptr<dingodb::Crontab> weak_crontab = crontab;
+  crontab.reset();
+  EXPECT_FALSE(weak_crontab.expired());
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  EXPECT_TRUE(is_done.load());
+  EXPECT_TRUE(weak_crontab.expired());
+}
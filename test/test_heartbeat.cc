@@ -0,0 +1,128 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "store/heartbeat.h"
+
+namespace dingodb {
+
+DECLARE_int32(store_heartbeat_full_sync_interval);
+
+class RegionHeartbeatTrackerTest : public testing::Test {
+ protected:
+  void SetUp() override {}
+  void TearDown() override {}
+
+  static pb::common::RegionMetrics GenRegionMetrics(uint64_t region_id) {
+    pb::common::RegionMetrics region_metrics;
+    region_metrics.set_id(region_id);
+    region_metrics.set_leader_store_id(1001);
+    region_metrics.set_store_region_state(pb::common::StoreRegionState::NORMAL);
+    region_metrics.mutable_region_definition()->mutable_epoch()->set_conf_version(1);
+    region_metrics.mutable_region_definition()->mutable_epoch()->set_version(1);
+    region_metrics.mutable_braft_status()->set_raft_state(pb::common::RaftNodeState::STATE_LEADER);
+    region_metrics.mutable_braft_status()->set_term(3);
+    region_metrics.set_row_count(1000);
+    region_metrics.set_region_size(1024 * 1024);
+    return region_metrics;
+  }
+};
+
+TEST_F(RegionHeartbeatTrackerTest, IsChanged) {
+  auto region_metrics = GenRegionMetrics(1);
+  auto old_digest = RegionHeartbeatTracker::GenDigest(region_metrics);
+
+  // same metrics
+  EXPECT_FALSE(RegionHeartbeatTracker::IsChanged(old_digest, RegionHeartbeatTracker::GenDigest(region_metrics), 0.1));
+
+  // raft status change
+  region_metrics.mutable_braft_status()->set_committed_index(100);
+  EXPECT_FALSE(RegionHeartbeatTracker::IsChanged(old_digest, RegionHeartbeatTracker::GenDigest(region_metrics), 0.1));
+  region_metrics.mutable_braft_status()->set_term(4);
+  EXPECT_TRUE(RegionHeartbeatTracker::IsChanged(old_digest, RegionHeartbeatTracker::GenDigest(region_metrics), 0.1));
+
+  // epoch change
+  region_metrics = GenRegionMetrics(1);
+  region_metrics.mutable_region_definition()->mutable_epoch()->set_version(2);
+  EXPECT_TRUE(RegionHeartbeatTracker::IsChanged(old_digest, RegionHeartbeatTracker::GenDigest(region_metrics), 0.1));
+
+  // metrics change under threshold
+  region_metrics = GenRegionMetrics(1);
+  region_metrics.set_row_count(1050);
+  EXPECT_FALSE(RegionHeartbeatTracker::IsChanged(old_digest, RegionHeartbeatTracker::GenDigest(region_metrics), 0.1));
+
+  // metrics change beyond threshold
+  region_metrics.set_row_count(1200);
+  EXPECT_TRUE(RegionHeartbeatTracker::IsChanged(old_digest, RegionHeartbeatTracker::GenDigest(region_metrics), 0.1));
+
+  // write qps change, epoch and size are stable
+  region_metrics = GenRegionMetrics(1);
+  region_metrics.set_write_qps(100);
+  old_digest = RegionHeartbeatTracker::GenDigest(region_metrics);
+  region_metrics.set_write_qps(105);
+  EXPECT_FALSE(RegionHeartbeatTracker::IsChanged(old_digest, RegionHeartbeatTracker::GenDigest(region_metrics), 0.1));
+  region_metrics.set_write_qps(300);
+  EXPECT_TRUE(RegionHeartbeatTracker::IsChanged(old_digest, RegionHeartbeatTracker::GenDigest(region_metrics), 0.1));
+  region_metrics.set_write_qps(0);
+  EXPECT_TRUE(RegionHeartbeatTracker::IsChanged(old_digest, RegionHeartbeatTracker::GenDigest(region_metrics), 0.1));
+}
+
+TEST_F(RegionHeartbeatTrackerTest, NextVersion) {
+  FLAGS_store_heartbeat_full_sync_interval = 3;
+  RegionHeartbeatTracker tracker;
+
+  bool is_full = false;
+  // first heartbeat must be full
+  EXPECT_EQ(1, tracker.NextVersion(is_full));
+  EXPECT_TRUE(is_full);
+
+  EXPECT_EQ(2, tracker.NextVersion(is_full));
+  EXPECT_FALSE(is_full);
+  EXPECT_EQ(3, tracker.NextVersion(is_full));
+  EXPECT_TRUE(is_full);
+
+  tracker.ForceFull();
+  EXPECT_EQ(4, tracker.NextVersion(is_full));
+  EXPECT_TRUE(is_full);
+  EXPECT_EQ(5, tracker.NextVersion(is_full));
+  EXPECT_FALSE(is_full);
+}
+
+TEST_F(RegionHeartbeatTrackerTest, Commit) {
+  RegionHeartbeatTracker tracker;
+
+  auto digest1 = RegionHeartbeatTracker::GenDigest(GenRegionMetrics(1));
+  auto digest2 = RegionHeartbeatTracker::GenDigest(GenRegionMetrics(2));
+  EXPECT_TRUE(tracker.NeedReport(1, digest1, 0.1));
+
+  auto removed_region_ids = tracker.Commit({{1, digest1}, {2, digest2}}, {1, 2});
+  EXPECT_TRUE(removed_region_ids.empty());
+  EXPECT_FALSE(tracker.NeedReport(1, digest1, 0.1));
+  EXPECT_FALSE(tracker.NeedReport(2, digest2, 0.1));
+
+  removed_region_ids = tracker.Commit({}, {1});
+  ASSERT_EQ(1, removed_region_ids.size());
+  EXPECT_EQ(2, removed_region_ids[0]);
+  EXPECT_TRUE(tracker.NeedReport(2, digest2, 0.1));
+}
+
+}  // namespace dingodb
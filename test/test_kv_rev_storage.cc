@@ -0,0 +1,193 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "config/config.h"
+#include "config/yaml_config.h"
+#include "coordinator/coordinator_control.h"
+#include "coordinator/kv_rev_storage.h"
+#include "engine/raw_rocks_engine.h"
+#include "gflags/gflags.h"
+#include "meta/meta_reader.h"
+#include "meta/meta_writer.h"
+
+namespace dingodb {
+
+DECLARE_uint64(kv_rev_cache_capacity);
+
+static const std::string kKvRevStorageConfigContent =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 12345\n"
+    "  coordinators: 127.0.0.1:19190,127.0.0.1:19191,127.0.0.1:19192\n"
+    "  keyring: TO_BE_CONTINUED\n"
+    "server:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23000\n"
+    "  heartbeat_interval: 10000 # ms\n"
+    "raft:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23100\n"
+    "  path: /tmp/dingo-store/data/store/raft\n"
+    "  election_timeout: 1000 # ms\n"
+    "  snapshot_interval: 3600 # s\n"
+    "log:\n"
+    "  path: /tmp/dingo-store/log\n"
+    "store:\n"
+    "  path: /tmp/kv_rev_storage_test\n"
+    "  base:\n"
+    "    block_size: 131072\n"
+    "    block_cache: 67108864\n"
+    "    arena_block_size: 67108864\n"
+    "    min_write_buffer_number_to_merge: 4\n"
+    "    max_write_buffer_number: 4\n"
+    "    max_compaction_bytes: 134217728\n"
+    "    write_buffer_size: 67108864\n"
+    "    prefix_extractor: 8\n"
+    "    max_bytes_for_level_base: 41943040\n"
+    "    target_file_size_base: 4194304\n"
+    "  default:\n"
+    "  column_families:\n"
+    "    - default\n"
+    "    - meta\n";
+
+class KvRevStorageTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    std::shared_ptr<Config> config = std::make_shared<YamlConfig>();
+    if (config->Load(kKvRevStorageConfigContent) != 0) {
+      std::cout << "Load config failed" << std::endl;
+      return;
+    }
+
+    engine = std::make_shared<RawRocksEngine>();
+    if (!engine->Init(config)) {
+      std::cout << "RawRocksEngine init failed" << std::endl;
+    }
+
+    meta_reader = std::make_shared<MetaReader>(engine);
+    meta_writer = std::make_shared<MetaWriter>(engine);
+  }
+
+  static void TearDownTestSuite() {
+    meta_reader.reset();
+    meta_writer.reset();
+    engine->Close();
+    engine->Destroy();
+  }
+
+  static pb::coordinator_internal::KvRevInternal GenKvRev(uint64_t main, const std::string& key,
+                                                          const std::string& value) {
+    pb::coordinator_internal::RevisionInternal revision;
+    revision.set_main(main);
+    revision.set_sub(0);
+
+    pb::coordinator_internal::KvRevInternal kv_rev;
+    kv_rev.set_id(CoordinatorControl::RevisionToString(revision));
+    kv_rev.mutable_kv()->set_id(key);
+    kv_rev.mutable_kv()->set_value(value);
+    *kv_rev.mutable_kv()->mutable_mod_revision() = revision;
+
+    return kv_rev;
+  }
+
+  // Persist pending write like ApplyMetaIncrement.
+  static void Flush(KvRevStorage& storage) {
+    std::vector<pb::common::KeyValue> kvs_put;
+    std::vector<pb::common::KeyValue> kvs_delete;
+    storage.AppendPendingWrite(kvs_put, kvs_delete);
+    EXPECT_TRUE(meta_writer->PutAndDelete(kvs_put, kvs_delete));
+    storage.ClearPendingWrite();
+  }
+
+  inline static std::shared_ptr<RawRocksEngine> engine;
+  inline static std::shared_ptr<MetaReader> meta_reader;
+  inline static std::shared_ptr<MetaWriter> meta_writer;
+};
+
+TEST_F(KvRevStorageTest, PutGetErase) {
+  KvRevStorage storage(meta_reader, "kv_rev_storage_test_");
+
+  auto kv_rev = GenKvRev(1, "key1", "value1");
+  storage.Put(kv_rev);
+
+  // pending write is readable before persisted
+  pb::coordinator_internal::KvRevInternal result;
+  EXPECT_EQ(storage.Get(kv_rev.id(), result), 1);
+  EXPECT_EQ(result.kv().value(), "value1");
+  EXPECT_EQ(meta_reader->Get(storage.GenKey(kv_rev.id()))->value(), "");
+
+  Flush(storage);
+  EXPECT_FALSE(meta_reader->Get(storage.GenKey(kv_rev.id()))->value().empty());
+
+  // read from meta cf after cache is cleared
+  storage.Clear();
+  EXPECT_EQ(storage.CacheSize(), 0);
+  EXPECT_EQ(storage.Get(kv_rev.id(), result), 1);
+  EXPECT_EQ(result.kv().id(), "key1");
+  EXPECT_EQ(storage.CacheSize(), 1);
+
+  storage.Erase(kv_rev.id());
+  EXPECT_EQ(storage.Get(kv_rev.id(), result), -1);
+  Flush(storage);
+  EXPECT_EQ(storage.Get(kv_rev.id(), result), -1);
+}
+
+TEST_F(KvRevStorageTest, BoundedCache) {
+  auto old_capacity = FLAGS_kv_rev_cache_capacity;
+  FLAGS_kv_rev_cache_capacity = 10;
+
+  KvRevStorage storage(meta_reader, "kv_rev_storage_test_bounded_");
+
+  std::vector<std::string> ids;
+  for (uint64_t i = 1; i <= 100; ++i) {
+    auto kv_rev = GenKvRev(i, "key" + std::to_string(i), "value" + std::to_string(i));
+    ids.push_back(kv_rev.id());
+    storage.Put(kv_rev);
+  }
+  Flush(storage);
+  EXPECT_EQ(storage.CacheSize(), 10);
+
+  // the evicted revision is read from meta cf
+  std::vector<pb::coordinator_internal::KvRevInternal> kv_revs;
+  std::vector<bool> exists;
+  ids.push_back("not_exist_revision");
+  EXPECT_EQ(storage.MultiGet(ids, kv_revs, exists), 1);
+  ASSERT_EQ(kv_revs.size(), ids.size());
+  for (size_t i = 0; i + 1 < ids.size(); ++i) {
+    EXPECT_TRUE(exists[i]);
+    EXPECT_EQ(kv_revs[i].kv().value(), "value" + std::to_string(i + 1));
+  }
+  EXPECT_FALSE(exists.back());
+  EXPECT_EQ(storage.CacheSize(), 10);
+
+  // revision key is ordered by revision in meta cf
+  std::vector<pb::common::KeyValue> kvs;
+  EXPECT_TRUE(meta_reader->Scan(storage.Prefix(), kvs));
+  ASSERT_EQ(kvs.size(), 100);
+  for (size_t i = 0; i < kvs.size(); ++i) {
+    EXPECT_EQ(kvs[i].key(), storage.GenKey(ids[i]));
+  }
+
+  FLAGS_kv_rev_cache_capacity = old_capacity;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,194 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "config/config.h"
+#include "config/yaml_config.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "store/memory_governor.h"
+
+namespace dingodb {
+
+static const std::string kMemoryGovernorConfigContent =
+    "store:\n"
+    "  path: /tmp/memory_governor_test\n"
+    "  memory_limit: 1073741824\n";
+
+// Default ratio: block cache 0.25, write buffer 0.15, vector index 0.5.
+class MemoryGovernorTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    std::shared_ptr<Config> config = std::make_shared<YamlConfig>();
+    if (config->Load(kMemoryGovernorConfigContent) != 0) {
+      std::cout << "Load config failed" << std::endl;
+      return;
+    }
+
+    init_ok = MemoryGovernor::GetInstance()->Init(config);
+  }
+
+  void SetUp() override { ASSERT_TRUE(init_ok); }
+
+  inline static bool init_ok = false;
+  inline static const uint64_t kMemoryLimit = 1073741824;
+  inline static const uint64_t kVectorIndexLimit = kMemoryLimit / 2;
+};
+
+TEST_F(MemoryGovernorTest, Init) {
+  auto* governor = MemoryGovernor::GetInstance();
+  EXPECT_EQ(kMemoryLimit, governor->MemoryLimit());
+
+  // the block cache capacity include the memtable charged to it
+  uint64_t block_cache_size = kMemoryLimit * 0.25;
+  uint64_t write_buffer_size = kMemoryLimit * 0.15;
+  ASSERT_NE(nullptr, governor->GetBlockCache());
+  ASSERT_NE(nullptr, governor->GetWriteBufferManager());
+  EXPECT_EQ(block_cache_size + write_buffer_size, governor->GetBlockCache()->GetCapacity());
+  EXPECT_EQ(write_buffer_size, governor->GetWriteBufferManager()->buffer_size());
+  EXPECT_TRUE(governor->GetWriteBufferManager()->cost_to_cache());
+}
+
+TEST_F(MemoryGovernorTest, SharedCacheAccounting) {
+  auto* governor = MemoryGovernor::GetInstance();
+  auto block_cache = governor->GetBlockCache();
+  auto write_buffer_manager = governor->GetWriteBufferManager();
+
+  uint64_t cache_usage = block_cache->GetUsage();
+  const uint64_t reserve_size = 8 * 1024 * 1024;
+
+  // memtable memory is charged to the block cache by dummy entries
+  write_buffer_manager->ReserveMem(reserve_size);
+  EXPECT_EQ(reserve_size, write_buffer_manager->memory_usage());
+  EXPECT_GE(block_cache->GetUsage(), cache_usage + reserve_size);
+
+  write_buffer_manager->ScheduleFreeMem(reserve_size);
+  write_buffer_manager->FreeMem(reserve_size);
+  EXPECT_EQ(0, write_buffer_manager->memory_usage());
+}
+
+TEST_F(MemoryGovernorTest, AdmitVectorIndex) {
+  auto* governor = MemoryGovernor::GetInstance();
+  EXPECT_EQ(0, governor->VectorIndexMemoryUsage());
+
+  auto status = governor->AdmitVectorIndex(1, kVectorIndexLimit + 1);
+  EXPECT_EQ(pb::error::ESYSTEM_MEMORY_CAPACITY_FULL, status.error_code());
+  EXPECT_EQ(0, governor->VectorIndexReservedMemory());
+  EXPECT_TRUE(governor->AdmitVectorIndex(1, kVectorIndexLimit).ok());
+  EXPECT_EQ(kVectorIndexLimit, governor->VectorIndexReservedMemory());
+  governor->ReleaseVectorIndex(1, kVectorIndexLimit);
+  EXPECT_EQ(0, governor->VectorIndexReservedMemory());
+
+  // the loaded vector index is counted
+  governor->UpdateVectorIndexMemory(1, 300 * 1024 * 1024);
+  EXPECT_EQ(300 * 1024 * 1024, governor->VectorIndexMemoryUsage());
+  EXPECT_FALSE(governor->AdmitVectorIndex(2, kVectorIndexLimit - 300 * 1024 * 1024 + 1).ok());
+  EXPECT_TRUE(governor->AdmitVectorIndex(2, kVectorIndexLimit - 300 * 1024 * 1024).ok());
+  governor->ReleaseVectorIndex(2, kVectorIndexLimit - 300 * 1024 * 1024);
+
+  // update replace the old size of the same vector index
+  governor->UpdateVectorIndexMemory(1, 100 * 1024 * 1024);
+  governor->UpdateVectorIndexMemory(2, 200 * 1024 * 1024);
+  EXPECT_EQ(300 * 1024 * 1024, governor->VectorIndexMemoryUsage());
+
+  governor->RemoveVectorIndexMemory(1);
+  governor->RemoveVectorIndexMemory(100);
+  EXPECT_EQ(200 * 1024 * 1024, governor->VectorIndexMemoryUsage());
+  EXPECT_TRUE(governor->AdmitVectorIndex(3, kVectorIndexLimit - 200 * 1024 * 1024).ok());
+  governor->ReleaseVectorIndex(3, kVectorIndexLimit - 200 * 1024 * 1024);
+
+  // the growth between metrics collection is added, the next update replace it
+  governor->ChargeVectorIndexMemory(2, 10 * 1024 * 1024);
+  EXPECT_EQ(210 * 1024 * 1024, governor->VectorIndexMemoryUsage());
+  governor->UpdateVectorIndexMemory(2, 200 * 1024 * 1024);
+  EXPECT_EQ(200 * 1024 * 1024, governor->VectorIndexMemoryUsage());
+
+  governor->RemoveVectorIndexMemory(2);
+  EXPECT_EQ(0, governor->VectorIndexMemoryUsage());
+}
+
+TEST_F(MemoryGovernorTest, EstimateVectorIndexMemory) {
+  pb::common::VectorIndexParameter parameter;
+
+  // unknown type
+  EXPECT_EQ(0, MemoryGovernor::EstimateVectorIndexMemory(parameter, 1000));
+
+  // flat grow with element count
+  parameter.set_vector_index_type(pb::common::VECTOR_INDEX_TYPE_FLAT);
+  parameter.mutable_flat_parameter()->set_dimension(8);
+  EXPECT_EQ(0, MemoryGovernor::EstimateVectorIndexMemory(parameter, 0));
+  EXPECT_EQ(1000 * (8 * sizeof(float) + sizeof(int64_t)), MemoryGovernor::EstimateVectorIndexMemory(parameter, 1000));
+
+  // hnsw preallocate max elements even if empty
+  parameter.set_vector_index_type(pb::common::VECTOR_INDEX_TYPE_HNSW);
+  parameter.mutable_hnsw_parameter()->set_dimension(128);
+  parameter.mutable_hnsw_parameter()->set_max_elements(10000);
+  parameter.mutable_hnsw_parameter()->set_nlinks(32);
+  uint64_t element_size = 128 * sizeof(float) + (32 * 2 + 1) * sizeof(uint32_t) + sizeof(int64_t) + sizeof(int) +
+                          sizeof(std::mutex) + sizeof(void*);
+  EXPECT_EQ(10000 * element_size, MemoryGovernor::EstimateVectorIndexMemory(parameter, 0));
+  EXPECT_EQ(10000 * element_size, MemoryGovernor::EstimateVectorIndexMemory(parameter, 5000));
+  // auto grown beyond max elements
+  EXPECT_EQ(20000 * element_size, MemoryGovernor::EstimateVectorIndexMemory(parameter, 20000));
+
+  // a cold start index bigger than the budget is rejected by estimate
+  parameter.mutable_hnsw_parameter()->set_max_elements(1000000);
+  EXPECT_FALSE(MemoryGovernor::GetInstance()
+                   ->AdmitVectorIndex(1, MemoryGovernor::EstimateVectorIndexMemory(parameter, 0))
+                   .ok());
+}
+
+TEST_F(MemoryGovernorTest, ReserveVectorIndex) {
+  auto* governor = MemoryGovernor::GetInstance();
+  EXPECT_EQ(0, governor->VectorIndexMemoryUsage());
+  EXPECT_EQ(0, governor->VectorIndexReservedMemory());
+
+  // parallel loads are admitted against the reservation of each other
+  const uint64_t estimate_size = kVectorIndexLimit / 2;
+  EXPECT_TRUE(governor->AdmitVectorIndex(1, estimate_size).ok());
+  EXPECT_TRUE(governor->AdmitVectorIndex(2, estimate_size).ok());
+  EXPECT_FALSE(governor->AdmitVectorIndex(3, estimate_size).ok());
+  EXPECT_EQ(estimate_size * 2, governor->VectorIndexReservedMemory());
+
+  // failed load release the reservation
+  governor->ReleaseVectorIndex(2, estimate_size);
+  governor->ReleaseVectorIndex(2, estimate_size);
+  EXPECT_EQ(estimate_size, governor->VectorIndexReservedMemory());
+  EXPECT_TRUE(governor->AdmitVectorIndex(3, estimate_size).ok());
+
+  // loaded index is counted by the measured size, then the reservation is released
+  governor->UpdateVectorIndexMemory(1, estimate_size / 2);
+  governor->ReleaseVectorIndex(1, estimate_size);
+  EXPECT_EQ(estimate_size / 2, governor->VectorIndexMemoryUsage());
+  EXPECT_EQ(estimate_size, governor->VectorIndexReservedMemory());
+
+  // grow consume the reservation
+  governor->ChargeVectorIndexMemory(3, estimate_size / 4);
+  EXPECT_EQ(estimate_size - estimate_size / 4, governor->VectorIndexReservedMemory());
+
+  // remove drop both the usage and the reservation
+  governor->RemoveVectorIndexMemory(1);
+  governor->RemoveVectorIndexMemory(3);
+  EXPECT_EQ(0, governor->VectorIndexMemoryUsage());
+  EXPECT_EQ(0, governor->VectorIndexReservedMemory());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,179 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/context.h"
+#include "config/config.h"
+#include "config/yaml_config.h"
+#include "engine/raw_rocks_engine.h"
+#include "handler/raft_apply_handler.h"
+#include "meta/store_meta_manager.h"
+#include "proto/raft.pb.h"
+#include "raft/raft_node.h"
+#include "vector/codec.h"
+#include "vector/vector_index_factory.h"
+#include "vector_index_test_helper.h"
+
+namespace dingodb {
+
+static const std::string kRaftApplyVectorConfigContent =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 12345\n"
+    "  coordinators: 127.0.0.1:19190,127.0.0.1:19191,127.0.0.1:19192\n"
+    "  keyring: TO_BE_CONTINUED\n"
+    "server:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23000\n"
+    "  heartbeat_interval: 10000 # ms\n"
+    "raft:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23100\n"
+    "  path: /tmp/dingo-store/data/store/raft\n"
+    "  election_timeout: 1000 # ms\n"
+    "  snapshot_interval: 3600 # s\n"
+    "log:\n"
+    "  path: /tmp/dingo-store/log\n"
+    "store:\n"
+    "  path: /tmp/raft_apply_vector_test\n"
+    "  base:\n"
+    "    block_size: 131072\n"
+    "    block_cache: 67108864\n"
+    "    arena_block_size: 67108864\n"
+    "    min_write_buffer_number_to_merge: 4\n"
+    "    max_write_buffer_number: 4\n"
+    "    max_compaction_bytes: 134217728\n"
+    "    write_buffer_size: 67108864\n"
+    "    prefix_extractor: 8\n"
+    "    max_bytes_for_level_base: 41943040\n"
+    "    target_file_size_base: 4194304\n"
+    "  default:\n"
+    "  column_families:\n"
+    "    - default\n"
+    "    - meta\n"
+    "    - vector_data\n"
+    "    - vector_scalar\n"
+    "    - vector_table\n";
+
+class RaftApplyVectorTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    std::shared_ptr<Config> config = std::make_shared<YamlConfig>();
+    if (config->Load(kRaftApplyVectorConfigContent) != 0) {
+      std::cout << "Load config failed" << std::endl;
+      return;
+    }
+
+    engine = std::make_shared<RawRocksEngine>();
+    if (!engine->Init(config)) {
+      std::cout << "RawRocksEngine init failed" << std::endl;
+    }
+  }
+
+  static void TearDownTestSuite() {
+    engine->Close();
+    engine->Destroy();
+  }
+
+  static store::RegionPtr NewRegion(uint64_t region_id) {
+    pb::common::RegionDefinition definition;
+    definition.set_id(region_id);
+    definition.set_part_id(1);
+    VectorCodec::EncodeVectorKey(1, 0, *definition.mutable_range()->mutable_start_key());
+    VectorCodec::EncodeVectorKey(1, 10000, *definition.mutable_range()->mutable_end_key());
+    definition.mutable_index_parameter()->set_index_type(pb::common::INDEX_TYPE_VECTOR);
+    auto* vector_index_parameter = definition.mutable_index_parameter()->mutable_vector_index_parameter();
+    vector_index_parameter->set_vector_index_type(pb::common::VECTOR_INDEX_TYPE_FLAT);
+    vector_index_parameter->mutable_flat_parameter()->set_dimension(kDimension);
+    vector_index_parameter->mutable_flat_parameter()->set_metric_type(pb::common::METRIC_TYPE_L2);
+
+    auto region = store::Region::New(definition);
+    if (region == nullptr) {
+      return nullptr;
+    }
+    auto vector_index = VectorIndexFactory::New(region_id, *vector_index_parameter, definition.range());
+    region->VectorIndexWrapper()->UpdateVectorIndex(vector_index, "test");
+    return region;
+  }
+
+  static std::unique_ptr<RaftNode::ProposeTask> GenVectorAddTask(uint64_t region_id,
+                                                                 const pb::common::VectorWithId& vector_with_id) {
+    auto task = std::make_unique<RaftNode::ProposeTask>();
+    task->ctx = std::make_shared<Context>();
+    task->ctx->SetRegionId(region_id);
+    task->raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
+    task->raft_cmd->mutable_header()->set_region_id(region_id);
+    auto* request = task->raft_cmd->add_requests();
+    request->set_cmd_type(pb::raft::VECTOR_ADD);
+    *request->mutable_vector_add()->add_vectors() = vector_with_id;
+    return task;
+  }
+
+  inline static std::shared_ptr<RawRocksEngine> engine;
+  inline static constexpr int kDimension = 8;
+};
+
+// Two concurrent vector adds must both reach the vector index, not only the first request of a merged log.
+TEST_F(RaftApplyVectorTest, ConcurrentVectorAdd) {
+  ASSERT_NE(nullptr, engine);
+  auto region = NewRegion(1001);
+  ASSERT_NE(nullptr, region);
+  ASSERT_TRUE(region->VectorIndexWrapper()->IsReady());
+
+  std::mt19937 engine_rand(1);
+  auto vector_with_ids = GenVectors(1, 2, kDimension, engine_rand);
+
+  std::vector<std::unique_ptr<RaftNode::ProposeTask>> tasks;
+  for (const auto& vector_with_id : vector_with_ids) {
+    tasks.push_back(GenVectorAddTask(region->Id(), vector_with_id));
+  }
+
+  // vector add is proposed alone, each one has its own log id
+  auto batches = RaftNode::GroupProposeTasks(tasks, 64, UINT64_MAX);
+  ASSERT_EQ(2, batches.size());
+
+  uint64_t log_id = 0;
+  VectorAddHandler handler;
+  for (auto& batch_tasks : batches) {
+    std::vector<std::shared_ptr<Context>> request_ctxs;
+    auto raft_cmd = RaftNode::MergeProposeTasks(batch_tasks, request_ctxs);
+    ++log_id;
+    for (const auto& request : raft_cmd->requests()) {
+      handler.Handle(nullptr, region, engine, request, nullptr, 1, log_id);
+    }
+  }
+
+  uint64_t count = 0;
+  ASSERT_TRUE(region->VectorIndexWrapper()->GetCount(count).ok());
+  EXPECT_EQ(2, count);
+
+  for (const auto& vector_with_id : vector_with_ids) {
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    auto status = region->VectorIndexWrapper()->Search({vector_with_id}, 1, region->RawRange(), {}, results);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(1, results.size());
+    ASSERT_EQ(1, results[0].vector_with_distances_size());
+    EXPECT_EQ(vector_with_id.id(), results[0].vector_with_distances(0).vector_with_id().id());
+  }
+}
+
+}  // namespace dingodb
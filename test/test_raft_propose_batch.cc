@@ -0,0 +1,227 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/context.h"
+#include "proto/error.pb.h"
+#include "proto/raft.pb.h"
+#include "raft/raft_node.h"
+#include "raft/store_state_machine.h"
+
+namespace dingodb {
+
+class RaftProposeBatchTest : public testing::Test {
+ protected:
+  // task with request_count put requests, the key is prefix_i
+  static std::unique_ptr<RaftNode::ProposeTask> GenPutTask(const std::string& prefix, int request_count = 1,
+                                                           int value_size = 10) {
+    auto task = std::make_unique<RaftNode::ProposeTask>();
+    task->ctx = std::make_shared<Context>();
+    task->ctx->SetRegionId(1);
+    task->raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
+    task->raft_cmd->mutable_header()->set_region_id(1);
+    for (int i = 0; i < request_count; ++i) {
+      auto* request = task->raft_cmd->add_requests();
+      request->set_cmd_type(pb::raft::PUT);
+      auto* kv = request->mutable_put()->add_kvs();
+      kv->set_key(prefix + "_" + std::to_string(i));
+      kv->set_value(std::string(value_size, 'v'));
+    }
+    return task;
+  }
+
+  static std::unique_ptr<RaftNode::ProposeTask> GenSplitTask() {
+    auto task = std::make_unique<RaftNode::ProposeTask>();
+    task->ctx = std::make_shared<Context>();
+    task->raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
+    task->raft_cmd->mutable_header()->set_region_id(1);
+    task->raft_cmd->add_requests()->set_cmd_type(pb::raft::SPLIT);
+    return task;
+  }
+
+  static std::string FirstKey(const RaftNode::ProposeTask& task) {
+    return task.raft_cmd->requests(0).put().kvs(0).key();
+  }
+};
+
+TEST_F(RaftProposeBatchTest, GroupByCount) {
+  std::vector<std::unique_ptr<RaftNode::ProposeTask>> tasks;
+  for (int i = 0; i < 10; ++i) {
+    tasks.push_back(GenPutTask(std::to_string(i)));
+  }
+
+  auto batches = RaftNode::GroupProposeTasks(tasks, 4, UINT64_MAX);
+  EXPECT_TRUE(tasks.empty());
+  ASSERT_EQ(3, batches.size());
+  EXPECT_EQ(4, batches[0].size());
+  EXPECT_EQ(4, batches[1].size());
+  EXPECT_EQ(2, batches[2].size());
+
+  // keep queue order
+  int i = 0;
+  for (const auto& batch_tasks : batches) {
+    for (const auto& task : batch_tasks) {
+      EXPECT_EQ(std::to_string(i++) + "_0", FirstKey(*task));
+    }
+  }
+}
+
+TEST_F(RaftProposeBatchTest, GroupByBytes) {
+  std::vector<std::unique_ptr<RaftNode::ProposeTask>> tasks;
+  for (int i = 0; i < 7; ++i) {
+    tasks.push_back(GenPutTask(std::to_string(i), 1, 1000));
+  }
+  uint64_t task_bytes = tasks[0]->raft_cmd->ByteSizeLong();
+
+  // flush when the batch reach max bytes
+  auto batches = RaftNode::GroupProposeTasks(tasks, UINT32_MAX, task_bytes * 5 / 2);
+  ASSERT_EQ(3, batches.size());
+  EXPECT_EQ(3, batches[0].size());
+  EXPECT_EQ(3, batches[1].size());
+  EXPECT_EQ(1, batches[2].size());
+
+  // a task bigger than max bytes is proposed alone
+  for (int i = 0; i < 3; ++i) {
+    tasks.push_back(GenPutTask(std::to_string(i), 1, 1000));
+  }
+  batches = RaftNode::GroupProposeTasks(tasks, UINT32_MAX, 100);
+  ASSERT_EQ(3, batches.size());
+  for (const auto& batch_tasks : batches) {
+    EXPECT_EQ(1, batch_tasks.size());
+  }
+}
+
+TEST_F(RaftProposeBatchTest, AdminCmdAlone) {
+  std::vector<std::unique_ptr<RaftNode::ProposeTask>> tasks;
+  tasks.push_back(GenPutTask("a"));
+  tasks.push_back(GenPutTask("b"));
+  tasks.push_back(GenSplitTask());
+  tasks.push_back(GenPutTask("c"));
+  tasks.push_back(GenSplitTask());
+
+  auto batches = RaftNode::GroupProposeTasks(tasks, 64, UINT64_MAX);
+  ASSERT_EQ(4, batches.size());
+  ASSERT_EQ(2, batches[0].size());
+  EXPECT_EQ("a_0", FirstKey(*batches[0][0]));
+  EXPECT_EQ("b_0", FirstKey(*batches[0][1]));
+  ASSERT_EQ(1, batches[1].size());
+  EXPECT_EQ(pb::raft::SPLIT, batches[1][0]->raft_cmd->requests(0).cmd_type());
+  ASSERT_EQ(1, batches[2].size());
+  EXPECT_EQ("c_0", FirstKey(*batches[2][0]));
+  ASSERT_EQ(1, batches[3].size());
+  EXPECT_EQ(pb::raft::SPLIT, batches[3][0]->raft_cmd->requests(0).cmd_type());
+}
+
+TEST_F(RaftProposeBatchTest, Merge) {
+  std::vector<std::unique_ptr<RaftNode::ProposeTask>> tasks;
+  tasks.push_back(GenPutTask("a", 2));
+  tasks.push_back(GenPutTask("b", 1));
+  tasks.push_back(GenPutTask("c", 3));
+  std::vector<std::shared_ptr<Context>> task_ctxs;
+  for (const auto& task : tasks) {
+    task_ctxs.push_back(task->ctx);
+  }
+
+  std::vector<std::shared_ptr<Context>> request_ctxs;
+  auto raft_cmd = RaftNode::MergeProposeTasks(tasks, request_ctxs);
+  EXPECT_EQ(1, raft_cmd->header().region_id());
+  ASSERT_EQ(6, raft_cmd->requests_size());
+  ASSERT_EQ(6, request_ctxs.size());
+
+  std::vector<std::string> expected_keys = {"a_0", "a_1", "b_0", "c_0", "c_1", "c_2"};
+  std::vector<int> expected_ctx_indexes = {0, 0, 1, 2, 2, 2};
+  for (int i = 0; i < raft_cmd->requests_size(); ++i) {
+    EXPECT_EQ(expected_keys[i], raft_cmd->requests(i).put().kvs(0).key());
+    EXPECT_EQ(task_ctxs[expected_ctx_indexes[i]], request_ctxs[i]);
+  }
+
+  // single task is proposed as it is
+  std::vector<std::unique_ptr<RaftNode::ProposeTask>> single_tasks;
+  single_tasks.push_back(GenPutTask("d", 2));
+  auto single_raft_cmd = single_tasks[0]->raft_cmd;
+  request_ctxs.clear();
+  EXPECT_EQ(single_raft_cmd, RaftNode::MergeProposeTasks(single_tasks, request_ctxs));
+  EXPECT_TRUE(request_ctxs.empty());
+}
+
+TEST_F(RaftProposeBatchTest, ClosureFanOut) {
+  std::vector<std::pair<std::shared_ptr<Context>, butil::Status>> results;
+  auto gen_ctx = [&]() {
+    auto ctx = std::make_shared<Context>();
+    ctx->SetWriteCb(
+        [&](std::shared_ptr<Context> write_ctx, butil::Status status) { results.emplace_back(write_ctx, status); });
+    return ctx;
+  };
+
+  std::vector<std::shared_ptr<Context>> ctxs = {gen_ctx(), gen_ctx(), gen_ctx()};
+  auto raft_cmd = std::make_shared<pb::raft::RaftCmdRequest>();
+  for (int i = 0; i < 4; ++i) {
+    raft_cmd->add_requests()->set_cmd_type(pb::raft::PUT);
+  }
+  std::vector<std::shared_ptr<Context>> request_ctxs = {ctxs[0], ctxs[0], ctxs[1], ctxs[2]};
+
+  // success, every ctx is notified once in request order
+  auto* done = new StoreClosure(request_ctxs, raft_cmd);
+  EXPECT_EQ(ctxs[0], done->GetCtx(1));
+  EXPECT_EQ(ctxs[1], done->GetCtx(2));
+  done->Run();
+  ASSERT_EQ(3, results.size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(ctxs[i], results[i].first);
+    EXPECT_TRUE(results[i].second.ok());
+  }
+
+  // not leader, every ctx get not leader
+  results.clear();
+  done = new StoreClosure(request_ctxs, raft_cmd);
+  done->status().set_error(pb::error::ERAFT_NOTLEADER, "not leader");
+  done->Run();
+  ASSERT_EQ(3, results.size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(ctxs[i], results[i].first);
+    EXPECT_EQ(pb::error::ERAFT_NOTLEADER, results[i].second.error_code());
+  }
+
+  // other raft error is commit log failed
+  results.clear();
+  ctxs = {gen_ctx(), gen_ctx(), gen_ctx()};
+  request_ctxs = {ctxs[0], ctxs[0], ctxs[1], ctxs[2]};
+  done = new StoreClosure(request_ctxs, raft_cmd);
+  done->status().set_error(EINVAL, "apply failed");
+  done->Run();
+  ASSERT_EQ(3, results.size());
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(ctxs[i], results[i].first);
+    EXPECT_EQ(pb::error::ERAFT_COMMITLOG, results[i].second.error_code());
+  }
+
+  // unbatched closure
+  results.clear();
+  done = new StoreClosure(ctxs[0], raft_cmd);
+  EXPECT_EQ(ctxs[0], done->GetCtx(3));
+  done->Run();
+  ASSERT_EQ(1, results.size());
+  EXPECT_EQ(ctxs[0], results[0].first);
+}
+
+}  // namespace dingodb
@@ -25,6 +25,7 @@
 #include <filesystem>
 #include <iostream>
 #include <iterator>
+#include <map>
 #include <memory>
 #include <numeric>
 #include <random>
@@ -32,11 +33,15 @@
 #include <vector>
 
 #include "butil/status.h"
+#include "butil/time.h"
+#include "common/constant.h"
 #include "common/context.h"
 #include "common/helper.h"
 #include "config/config.h"
 #include "config/yaml_config.h"
+#include "engine/checkpoint_manager.h"
 #include "engine/raw_rocks_engine.h"
+#include "fmt/core.h"
 #include "proto/common.pb.h"
 #include "proto/store_internal.pb.h"
 #include "server/server.h"
@@ -1049,49 +1054,67 @@ TEST_F(RawRocksEngineTest, KvBatchCompareAndSet) {
   }
 }
 
-#if 0
 TEST_F(RawRocksEngineTest, KvBatchGet) {
-
   const std::string &cf_name = kDefaultCf;
+  std::shared_ptr<RawEngine::Writer> writer = RawRocksEngineTest::engine->NewWriter(cf_name);
   std::shared_ptr<RawEngine::Reader> reader = RawRocksEngineTest::engine->NewReader(cf_name);
 
-  // key all empty
-  {
-    std::vector<std::string> keys;
-    std::vector<pb::common::KeyValue> kvs;
-
-    butil::Status ok = reader->KvBatchGet(keys, kvs);
-    EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_EMPTY);
-  }
+  std::vector<pb::common::KeyValue> kvs(2);
+  kvs[0].set_key("KeyBatchGet1");
+  kvs[0].set_value("ValueBatchGet1");
+  kvs[1].set_key("KeyBatchGet2");
+  kvs[1].set_value("ValueBatchGet2");
+  butil::Status ok = writer->KvBatchPut(kvs);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
 
   // key some empty
   {
-    std::vector<std::string> keys{"key1", "", "key"};
-    std::vector<pb::common::KeyValue> kvs;
+    std::vector<std::string> keys{"KeyBatchGet1", "", "KeyBatchGet"};
+    std::vector<std::string> values;
+    std::vector<butil::Status> statuses;
 
-    butil::Status ok = reader->KvBatchGet(keys, kvs);
+    ok = reader->KvBatchGet(keys, values, statuses);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::EKEY_EMPTY);
   }
 
   // some key not exist
   {
-    std::vector<std::string> keys{"key1", "key2", "key", "key4"};
-    std::vector<pb::common::KeyValue> kvs;
+    std::vector<std::string> keys{"KeyBatchGet", "KeyBatchGet1", "KeyBatchGet2", "KeyBatchGet4"};
+    std::vector<std::string> values;
+    std::vector<butil::Status> statuses;
 
-    butil::Status ok = reader->KvBatchGet(keys, kvs);
-    EXPECT_EQ(ok.error_code(), pb::error::Errno::EINTERNAL);
+    ok = reader->KvBatchGet(keys, values, statuses);
+    EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(values.size(), 4);
+    ASSERT_EQ(statuses.size(), 4);
+    EXPECT_EQ(statuses[0].error_code(), pb::error::Errno::EKEY_NOT_FOUND);
+    EXPECT_EQ(statuses[1].error_code(), pb::error::Errno::OK);
+    EXPECT_EQ(values[1], "ValueBatchGet1");
+    EXPECT_EQ(statuses[2].error_code(), pb::error::Errno::OK);
+    EXPECT_EQ(values[2], "ValueBatchGet2");
+    EXPECT_EQ(statuses[3].error_code(), pb::error::Errno::EKEY_NOT_FOUND);
   }
 
-  // normal
+  // unsorted and duplicate keys
   {
-    std::vector<std::string> keys{"key1", "key"};
-    std::vector<pb::common::KeyValue> kvs;
+    std::vector<std::string> keys{"KeyBatchGet2", "KeyBatchGet1", "KeyBatchGet2"};
+    std::vector<std::string> values;
+    std::vector<butil::Status> statuses;
 
-    butil::Status ok = reader->KvBatchGet(keys, kvs);
+    ok = reader->KvBatchGet(keys, values, statuses);
     EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
+    ASSERT_EQ(values.size(), 3);
+    EXPECT_EQ(values[0], "ValueBatchGet2");
+    EXPECT_EQ(values[1], "ValueBatchGet1");
+    EXPECT_EQ(values[2], "ValueBatchGet2");
   }
+
+  pb::common::Range range;
+  range.set_start_key("KeyBatchGet");
+  range.set_end_key("KeyBatchGeu");
+  ok = writer->KvDeleteRange(range);
+  EXPECT_EQ(ok.error_code(), pb::error::Errno::OK);
 }
-#endif
 
 TEST_F(RawRocksEngineTest, KvPutIfAbsent) {
   const std::string &cf_name = kDefaultCf;
@@ -2777,6 +2800,129 @@ TEST_F(RawRocksEngineTest, Iterator) {
   EXPECT_GE(count, 1);
 }
 
+TEST_F(RawRocksEngineTest, MultiCfPutAndDelete) {
+  // vector column families are created even if not in config
+  std::map<std::string, std::vector<pb::common::KeyValue>> kv_puts_with_cf;
+  for (const auto& cf_name : {Constant::kVectorDataCF, Constant::kVectorScalarCF, Constant::kVectorTableCF}) {
+    pb::common::KeyValue kv;
+    kv.set_key("multi_cf_key");
+    kv.set_value(cf_name);
+    kv_puts_with_cf[cf_name].push_back(kv);
+  }
+
+  auto status = RawRocksEngineTest::engine->MultiCfPutAndDelete(kv_puts_with_cf, {});
+  EXPECT_TRUE(status.ok());
+
+  for (const auto& cf_name : {Constant::kVectorDataCF, Constant::kVectorScalarCF, Constant::kVectorTableCF}) {
+    std::string value;
+    status = RawRocksEngineTest::engine->NewReader(cf_name)->KvGet("multi_cf_key", value);
+    EXPECT_TRUE(status.ok());
+    EXPECT_EQ(value, cf_name);
+  }
+
+  // key of other column family is not visible
+  std::string value;
+  status = RawRocksEngineTest::engine->NewReader(kDefaultCf)->KvGet("multi_cf_key", value);
+  EXPECT_EQ(status.error_code(), pb::error::Errno::EKEY_NOT_FOUND);
+
+  // put and delete in one batch
+  std::map<std::string, std::vector<std::string>> kv_deletes_with_cf;
+  kv_deletes_with_cf[Constant::kVectorDataCF].push_back("multi_cf_key");
+  kv_deletes_with_cf[Constant::kVectorScalarCF].push_back("multi_cf_key");
+  kv_puts_with_cf.clear();
+  pb::common::KeyValue kv;
+  kv.set_key("multi_cf_key");
+  kv.set_value("new_value");
+  kv_puts_with_cf[Constant::kVectorTableCF].push_back(kv);
+
+  status = RawRocksEngineTest::engine->MultiCfPutAndDelete(kv_puts_with_cf, kv_deletes_with_cf);
+  EXPECT_TRUE(status.ok());
+
+  status = RawRocksEngineTest::engine->NewReader(Constant::kVectorDataCF)->KvGet("multi_cf_key", value);
+  EXPECT_EQ(status.error_code(), pb::error::Errno::EKEY_NOT_FOUND);
+  status = RawRocksEngineTest::engine->NewReader(Constant::kVectorScalarCF)->KvGet("multi_cf_key", value);
+  EXPECT_EQ(status.error_code(), pb::error::Errno::EKEY_NOT_FOUND);
+  status = RawRocksEngineTest::engine->NewReader(Constant::kVectorTableCF)->KvGet("multi_cf_key", value);
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ(value, "new_value");
+
+  // empty key
+  kv_deletes_with_cf.clear();
+  kv_deletes_with_cf[Constant::kVectorDataCF].push_back("");
+  status = RawRocksEngineTest::engine->MultiCfPutAndDelete({}, kv_deletes_with_cf);
+  EXPECT_EQ(status.error_code(), pb::error::Errno::EKEY_EMPTY);
+}
+
+TEST_F(RawRocksEngineTest, SplitRangeBySstFile) {
+  const std::string &cf_name = Constant::kVectorScalarCF;
+  auto writer = RawRocksEngineTest::engine->NewWriter(cf_name);
+
+  // 3 sst files
+  for (int i = 0; i < 3; ++i) {
+    std::vector<pb::common::KeyValue> kvs;
+    for (int j = 0; j < 100; ++j) {
+      pb::common::KeyValue kv;
+      kv.set_key(fmt::format("split_sst_{}_{:04}", i, j));
+      kv.set_value(std::string(100, 'v'));
+      kvs.push_back(kv);
+    }
+    auto status = writer->KvBatchPut(kvs);
+    EXPECT_TRUE(status.ok());
+    RawRocksEngineTest::engine->Flush(cf_name);
+  }
+
+  pb::common::Range range;
+  range.set_start_key("split_sst_");
+  range.set_end_key("split_sst`");
+
+  // one sub range if target size is large enough
+  auto sub_ranges = RawRocksEngineTest::engine->SplitRangeBySstFile(cf_name, range, UINT64_MAX);
+  ASSERT_EQ(sub_ranges.size(), 1);
+  EXPECT_EQ(sub_ranges[0].start_key(), range.start_key());
+  EXPECT_EQ(sub_ranges[0].end_key(), range.end_key());
+
+  // sub ranges are continuous and cover the range
+  sub_ranges = RawRocksEngineTest::engine->SplitRangeBySstFile(cf_name, range, 1);
+  ASSERT_GE(sub_ranges.size(), 1);
+  EXPECT_EQ(sub_ranges.front().start_key(), range.start_key());
+  EXPECT_EQ(sub_ranges.back().end_key(), range.end_key());
+  for (int i = 1; i < sub_ranges.size(); ++i) {
+    EXPECT_EQ(sub_ranges[i - 1].end_key(), sub_ranges[i].start_key());
+    EXPECT_LT(sub_ranges[i].start_key(), sub_ranges[i].end_key());
+  }
+
+  auto status = writer->KvDeleteRange(range);
+  EXPECT_TRUE(status.ok());
+}
+
+TEST_F(RawRocksEngineTest, SharedCheckpoint) {
+  const std::string checkpoint_root_path = "./rocks_example_checkpoint";
+  std::filesystem::create_directories(checkpoint_root_path);
+
+  SharedCheckpointPtr checkpoint;
+  auto status = CheckpointManager::GetInstance()->Acquire(RawRocksEngineTest::engine, checkpoint_root_path, checkpoint);
+  ASSERT_TRUE(status.ok());
+  ASSERT_NE(checkpoint, nullptr);
+  EXPECT_TRUE(std::filesystem::exists(checkpoint->Path()));
+  EXPECT_FALSE(checkpoint->SstFiles().empty());
+
+  // the checkpoint created before request is not reused
+  int64_t request_time_us = butil::gettimeofday_us();
+  SharedCheckpointPtr other_checkpoint;
+  status = CheckpointManager::GetInstance()->Acquire(RawRocksEngineTest::engine, checkpoint_root_path, other_checkpoint);
+  ASSERT_TRUE(status.ok());
+  EXPECT_NE(checkpoint->Path(), other_checkpoint->Path());
+  EXPECT_GE(other_checkpoint->CreateTimeUs(), request_time_us);
+
+  // removed when the last user release
+  std::string path = checkpoint->Path();
+  checkpoint.reset();
+  EXPECT_FALSE(std::filesystem::exists(path));
+
+  other_checkpoint.reset();
+  std::filesystem::remove_all(checkpoint_root_path);
+}
+
 // TEST_F(RawRocksEngineTest, Checkpoint) {
 //   auto writer = RawRocksEngineTest::engine->NewWriter(kDefaultCf);
 
@@ -19,12 +19,15 @@
 #include <cstdint>
 #include <iostream>
 #include <memory>
+#include <set>
+#include <string>
 #include <thread>
 #include <vector>
 
 #include "butil/containers/flat_map.h"
 #include "butil/string_printf.h"
 #include "common/safe_map.h"
+#include "proto/common.pb.h"
 
 class DingoSafeMapTest : public testing::Test {
  protected:
@@ -104,6 +107,179 @@ TEST(DingoSafeMapTest, DingoSafeMapCopy) {
   EXPECT_EQ(map3.size(), 3);
 }
 
+TEST(DingoSafeMapTest, DingoSafeMapTraverse) {
+  dingodb::DingoSafeMap<uint64_t, uint64_t> safe_map;
+  safe_map.Init(1000);
+  for (uint64_t i = 0; i < 100; i++) {
+    safe_map.Put(i, i * 2);
+  }
+
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  auto ret = safe_map.Traverse([&count, &sum](const uint64_t& key, const uint64_t& value) -> bool {
+    EXPECT_EQ(value, key * 2);
+    ++count;
+    sum += key;
+    return true;
+  });
+  EXPECT_EQ(ret, 1);
+  EXPECT_EQ(count, 100);
+  EXPECT_EQ(sum, 4950);
+
+  // stop when handler return false
+  count = 0;
+  ret = safe_map.Traverse([&count](const uint64_t&, const uint64_t&) -> bool { return ++count < 10; });
+  EXPECT_EQ(ret, 1);
+  EXPECT_EQ(count, 10);
+}
+
+TEST(DingoSafeMapTest, DingoSafeMapTraverseFilterAndRange) {
+  dingodb::DingoSafeMap<uint64_t, uint64_t> safe_map;
+  safe_map.Init(1000);
+  for (uint64_t i = 0; i < 100; i++) {
+    safe_map.Put(i, i * 2);
+  }
+
+  std::set<uint64_t> keys;
+  auto ret = safe_map.TraverseFilter([](const uint64_t&, const uint64_t& value) -> bool { return value % 4 == 0; },
+                                     [&keys](const uint64_t& key, const uint64_t&) -> bool {
+                                       keys.insert(key);
+                                       return true;
+                                     });
+  EXPECT_EQ(ret, 1);
+  EXPECT_EQ(keys.size(), 50);
+  EXPECT_EQ(*keys.rbegin(), 98);
+
+  keys.clear();
+  ret = safe_map.TraverseRange(10, 20, [&keys](const uint64_t& key, const uint64_t&) -> bool {
+    keys.insert(key);
+    return true;
+  });
+  EXPECT_EQ(ret, 1);
+  EXPECT_EQ(keys.size(), 10);
+  EXPECT_EQ(*keys.begin(), 10);
+  EXPECT_EQ(*keys.rbegin(), 19);
+
+  // range with filter
+  keys.clear();
+  ret = safe_map.TraverseRange(
+      10, 20,
+      [&keys](const uint64_t& key, const uint64_t&) -> bool {
+        keys.insert(key);
+        return true;
+      },
+      [](const uint64_t& key, const uint64_t&) -> bool { return key % 2 == 1; });
+  EXPECT_EQ(ret, 1);
+  EXPECT_EQ(keys.size(), 5);
+  EXPECT_EQ(*keys.begin(), 11);
+}
+
+static dingodb::pb::common::Region GenRegion(uint64_t region_id) {
+  dingodb::pb::common::Region region;
+  region.set_id(region_id);
+  region.set_state(dingodb::pb::common::RegionState::REGION_NORMAL);
+  auto* definition = region.mutable_definition();
+  definition->set_id(region_id);
+  definition->set_name(butil::string_printf("region_%lu", region_id));
+  definition->mutable_epoch()->set_conf_version(1);
+  definition->mutable_epoch()->set_version(1);
+  definition->mutable_range()->set_start_key(butil::string_printf("t%016lu", region_id));
+  definition->mutable_range()->set_end_key(butil::string_printf("t%016lu", region_id + 1));
+  for (uint64_t store_id = 1; store_id <= 3; store_id++) {
+    auto* peer = definition->add_peers();
+    peer->set_store_id(store_id);
+    peer->mutable_server_location()->set_host("127.0.0.1");
+    peer->mutable_server_location()->set_port(20000 + store_id);
+    peer->mutable_raft_location()->set_host("127.0.0.1");
+    peer->mutable_raft_location()->set_port(20100 + store_id);
+  }
+  region.set_leader_store_id(1);
+  return region;
+}
+
+TEST(DingoSafeMapTest, DingoSafeMapTraverseSameAsCopy) {
+  dingodb::DingoSafeMap<uint64_t, dingodb::pb::common::Region> safe_map;
+  safe_map.Init(1000);
+  for (uint64_t i = 1; i <= 100; i++) {
+    safe_map.Put(i, GenRegion(i));
+  }
+
+  butil::FlatMap<uint64_t, dingodb::pb::common::Region> copy_map;
+  copy_map.init(1000);
+  safe_map.GetRawMapCopy(copy_map);
+
+  // traverse visit the same regions as the copy, without copy them
+  uint64_t count = 0;
+  safe_map.Traverse([&](const uint64_t& region_id, const dingodb::pb::common::Region& region) -> bool {
+    auto* copy_region = copy_map.seek(region_id);
+    EXPECT_NE(copy_region, nullptr);
+    if (copy_region != nullptr) {
+      EXPECT_EQ(copy_region->SerializeAsString(), region.SerializeAsString());
+    }
+    ++count;
+    return true;
+  });
+  EXPECT_EQ(count, copy_map.size());
+  EXPECT_EQ(count, 100);
+}
+
+// Benchmark of traverse in place vs copy the map, like the coordinator visit region map.
+// Disabled by default, run with --gtest_also_run_disabled_tests --gtest_filter=*TraverseVsCopyBench.
+TEST(DingoSafeMapTest, DISABLED_DingoSafeMapTraverseVsCopyBench) {
+  const uint64_t region_count = 100000;
+  dingodb::DingoSafeMap<uint64_t, dingodb::pb::common::Region> safe_map;
+  safe_map.Init(region_count);
+  for (uint64_t i = 1; i <= region_count; i++) {
+    safe_map.Put(i, GenRegion(i));
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  uint64_t copy_count = 0;
+  for (int i = 0; i < 10; i++) {
+    butil::FlatMap<uint64_t, dingodb::pb::common::Region> copy_map;
+    copy_map.init(region_count);
+    safe_map.GetRawMapCopy(copy_map);
+    for (const auto& it : copy_map) {
+      copy_count += it.second.leader_store_id() == 1 ? 1 : 0;
+    }
+  }
+  auto copy_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  start = std::chrono::steady_clock::now();
+  uint64_t traverse_count = 0;
+  for (int i = 0; i < 10; i++) {
+    safe_map.Traverse([&traverse_count](const uint64_t&, const dingodb::pb::common::Region& region) -> bool {
+      traverse_count += region.leader_store_id() == 1 ? 1 : 0;
+      return true;
+    });
+  }
+  auto traverse_us =
+      std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+  EXPECT_EQ(copy_count, traverse_count);
+  std::cout << "regions: " << region_count << " GetRawMapCopy: " << copy_us << "us, Traverse: " << traverse_us
+            << "us" << '\n';
+}
+
+TEST(DingoSafeStdMapTest, DingoSafeStdMapTraverse) {
+  dingodb::DingoSafeStdMap<std::string, std::string> safe_map;
+  for (int i = 0; i < 100; i++) {
+    safe_map.Put(butil::string_printf("%03d", i), std::to_string(i));
+  }
+
+  // visit in key order and stop when handler return false
+  std::vector<std::string> keys;
+  auto ret = safe_map.Traverse([&keys](const std::string& key, const std::string&) -> bool {
+    keys.push_back(key);
+    return keys.size() < 3;
+  });
+  EXPECT_EQ(ret, 1);
+  EXPECT_EQ(keys.size(), 3);
+  EXPECT_EQ(keys.front(), "000");
+  EXPECT_EQ(keys.back(), "002");
+}
+
 TEST(DingoSafeStdMapTest, DingoSafeStdMapGetRangeValues) {
   dingodb::DingoSafeStdMap<std::string, std::string> safe_map;
 
@@ -165,3 +341,57 @@ TEST(DingoSafeStdMapTest, DingoSafeStdMapMultiGet) {
   EXPECT_EQ(values.size(), 4);
   EXPECT_EQ(exists.size(), 4);
 }
+
+TEST(DingoSafeStdMapTest, DingoSafeStdMapTraverseRange) {
+  dingodb::DingoSafeStdMap<std::string, std::string> safe_map;
+
+  for (int i = 0; i < 1000; i++) {
+    safe_map.Put(butil::string_printf("%03d", i), std::to_string(i));
+  }
+
+  int count = 0;
+  auto ret = safe_map.TraverseRange("900", "999", [&count](const std::string&, const std::string&) -> bool {
+    ++count;
+    return true;
+  });
+  EXPECT_EQ(ret, 1);
+  EXPECT_EQ(count, 99);
+
+  // stop at limit
+  std::vector<std::string> keys;
+  ret = safe_map.TraverseRange("900", "999", [&keys](const std::string& key, const std::string&) -> bool {
+    if (keys.size() >= 5) {
+      return false;
+    }
+    keys.push_back(key);
+    return true;
+  });
+  EXPECT_EQ(ret, 1);
+  EXPECT_EQ(keys.size(), 5);
+  EXPECT_EQ(keys.front(), "900");
+  EXPECT_EQ(keys.back(), "904");
+
+  // range with filter
+  keys.clear();
+  ret = safe_map.TraverseRange(
+      "900", "999",
+      [&keys](const std::string& key, const std::string&) -> bool {
+        keys.push_back(key);
+        return true;
+      },
+      [](const std::string& key, const std::string&) -> bool { return key.back() == '5'; });
+  EXPECT_EQ(ret, 1);
+  EXPECT_EQ(keys.size(), 10);
+  EXPECT_EQ(keys.front(), "905");
+  EXPECT_EQ(keys.back(), "995");
+
+  // filter the whole map
+  count = 0;
+  ret = safe_map.TraverseFilter([](const std::string& key, const std::string&) -> bool { return key.back() == '0'; },
+                                [&count](const std::string&, const std::string&) -> bool {
+                                  ++count;
+                                  return true;
+                                });
+  EXPECT_EQ(ret, 1);
+  EXPECT_EQ(count, 100);
+}
@@ -18,7 +18,9 @@
 #include <string>
 
 #include "butil/status.h"
+#include "meta/store_meta_manager.h"
 #include "proto/common.pb.h"
+#include "proto/error.pb.h"
 #include "server/service_helper.h"
 
 namespace dingodb {  // NOLINT
@@ -121,4 +123,26 @@ TEST_F(ServiceHelperTest, ValidateRangeInRange) {
                       .ok());
 }
 
+static store::RegionPtr GenIndexRegion(uint64_t region_id, uint64_t index_id, uint64_t part_id) {
+  pb::common::RegionDefinition definition;
+  definition.set_id(region_id);
+  definition.set_index_id(index_id);
+  definition.set_part_id(part_id);
+  return store::Region::New(definition);
+}
+
+TEST_F(ServiceHelperTest, ValidateSameIndexRegion) {
+  auto region1 = GenIndexRegion(1001, 60001, 70001);
+  auto region2 = GenIndexRegion(1002, 60001, 70001);
+  // the other partition of the same index
+  auto region3 = GenIndexRegion(1003, 60001, 70002);
+  auto region4 = GenIndexRegion(1004, 60002, 70001);
+
+  EXPECT_TRUE(dingodb::ServiceHelper::ValidateSameIndexRegion(region2, region1).ok());
+  EXPECT_TRUE(dingodb::ServiceHelper::ValidateSameIndexRegion(region3, region1).ok());
+
+  auto status = dingodb::ServiceHelper::ValidateSameIndexRegion(region4, region1);
+  EXPECT_EQ(pb::error::EILLEGAL_PARAMTETERS, status.error_code());
+}
+
 }  // namespace dingodb
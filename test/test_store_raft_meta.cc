@@ -0,0 +1,160 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "config/config.h"
+#include "config/yaml_config.h"
+#include "engine/raw_rocks_engine.h"
+#include "meta/meta_reader.h"
+#include "meta/meta_writer.h"
+#include "meta/store_meta_manager.h"
+
+namespace dingodb {
+
+static const std::string kStoreRaftMetaConfigContent =
+    "cluster:\n"
+    "  name: dingodb\n"
+    "  instance_id: 12345\n"
+    "  coordinators: 127.0.0.1:19190,127.0.0.1:19191,127.0.0.1:19192\n"
+    "  keyring: TO_BE_CONTINUED\n"
+    "server:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23000\n"
+    "  heartbeat_interval: 10000 # ms\n"
+    "raft:\n"
+    "  host: 127.0.0.1\n"
+    "  port: 23100\n"
+    "  path: /tmp/dingo-store/data/store/raft\n"
+    "  election_timeout: 1000 # ms\n"
+    "  snapshot_interval: 3600 # s\n"
+    "log:\n"
+    "  path: /tmp/dingo-store/log\n"
+    "store:\n"
+    "  path: /tmp/store_raft_meta_test\n"
+    "  base:\n"
+    "    block_size: 131072\n"
+    "    block_cache: 67108864\n"
+    "    arena_block_size: 67108864\n"
+    "    min_write_buffer_number_to_merge: 4\n"
+    "    max_write_buffer_number: 4\n"
+    "    max_compaction_bytes: 134217728\n"
+    "    write_buffer_size: 67108864\n"
+    "    prefix_extractor: 8\n"
+    "    max_bytes_for_level_base: 41943040\n"
+    "    target_file_size_base: 4194304\n"
+    "  default:\n"
+    "  column_families:\n"
+    "    - default\n"
+    "    - meta\n";
+
+class StoreRaftMetaTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    std::shared_ptr<Config> config = std::make_shared<YamlConfig>();
+    if (config->Load(kStoreRaftMetaConfigContent) != 0) {
+      std::cout << "Load config failed" << std::endl;
+      return;
+    }
+
+    engine = std::make_shared<RawRocksEngine>();
+    if (!engine->Init(config)) {
+      std::cout << "RawRocksEngine init failed" << std::endl;
+    }
+
+    meta_reader = std::make_shared<MetaReader>(engine);
+    meta_writer = std::make_shared<MetaWriter>(engine);
+  }
+
+  static void TearDownTestSuite() {
+    meta_reader.reset();
+    meta_writer.reset();
+    engine->Close();
+    engine->Destroy();
+  }
+
+  // Load raft meta from storage with a new StoreRaftMeta, like restart.
+  static StoreRaftMeta::RaftMetaPtr LoadRaftMeta(uint64_t region_id) {
+    StoreRaftMeta store_raft_meta(meta_reader, meta_writer);
+    if (!store_raft_meta.Init()) {
+      return nullptr;
+    }
+    return store_raft_meta.GetRaftMeta(region_id);
+  }
+
+  inline static std::shared_ptr<RawRocksEngine> engine;
+  inline static std::shared_ptr<MetaReader> meta_reader;
+  inline static std::shared_ptr<MetaWriter> meta_writer;
+};
+
+TEST_F(StoreRaftMetaTest, AsyncUpdateAndFlush) {
+  StoreRaftMeta store_raft_meta(meta_reader, meta_writer);
+
+  auto raft_meta1 = StoreRaftMeta::NewRaftMeta(1001);
+  auto raft_meta2 = StoreRaftMeta::NewRaftMeta(1002);
+  store_raft_meta.AddRaftMeta(raft_meta1);
+  store_raft_meta.AddRaftMeta(raft_meta2);
+
+  // only the last update before flush is persisted
+  for (int64_t index = 1; index <= 100; ++index) {
+    raft_meta1->set_applied_index(index);
+    store_raft_meta.AsyncUpdateRaftMeta(raft_meta1);
+  }
+  raft_meta2->set_applied_index(50);
+  store_raft_meta.AsyncUpdateRaftMeta(raft_meta2);
+
+  EXPECT_EQ(store_raft_meta.GetRaftMeta(1001)->applied_index(), 100);
+  EXPECT_EQ(LoadRaftMeta(1001)->applied_index(), 0);
+
+  store_raft_meta.FlushRaftMeta();
+  EXPECT_EQ(LoadRaftMeta(1001)->applied_index(), 100);
+  EXPECT_EQ(LoadRaftMeta(1002)->applied_index(), 50);
+
+  // the raft meta is captured at async update, the change after it is not persisted until next async update
+  raft_meta2->set_term(2);
+  raft_meta2->set_applied_index(51);
+  store_raft_meta.AsyncUpdateRaftMeta(raft_meta2);
+  raft_meta2->set_term(3);
+  raft_meta2->set_applied_index(52);
+  store_raft_meta.FlushRaftMeta();
+  EXPECT_EQ(LoadRaftMeta(1002)->term(), 2);
+  EXPECT_EQ(LoadRaftMeta(1002)->applied_index(), 51);
+  store_raft_meta.AsyncUpdateRaftMeta(raft_meta2);
+  store_raft_meta.FlushRaftMeta();
+  EXPECT_EQ(LoadRaftMeta(1002)->term(), 3);
+  EXPECT_EQ(LoadRaftMeta(1002)->applied_index(), 52);
+
+  // sync update is not overwritten by the older dirty raft meta
+  auto old_raft_meta = std::make_shared<pb::store_internal::RaftMeta>(*raft_meta1);
+  old_raft_meta->set_applied_index(101);
+  store_raft_meta.AsyncUpdateRaftMeta(old_raft_meta);
+  raft_meta1->set_applied_index(200);
+  store_raft_meta.UpdateRaftMeta(raft_meta1);
+  store_raft_meta.FlushRaftMeta();
+  EXPECT_EQ(LoadRaftMeta(1001)->applied_index(), 200);
+
+  // deleted raft meta is not flushed again
+  raft_meta2->set_applied_index(60);
+  store_raft_meta.AsyncUpdateRaftMeta(raft_meta2);
+  store_raft_meta.DeleteRaftMeta(1002);
+  store_raft_meta.FlushRaftMeta();
+  EXPECT_EQ(LoadRaftMeta(1002), nullptr);
+}
+
+}  // namespace dingodb
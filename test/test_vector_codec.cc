@@ -0,0 +1,191 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "vector/codec.h"
+#include "vector/vector_index_factory.h"
+
+namespace dingodb {
+
+DECLARE_bool(enable_vector_raw_encoding);
+
+class VectorCodecTest : public testing::Test {
+ protected:
+  // the raw encoding is disabled by default, the flag is global, restore it so other tests are not affected
+  void SetUp() override {
+    enable_vector_raw_encoding_ = FLAGS_enable_vector_raw_encoding;
+    FLAGS_enable_vector_raw_encoding = true;
+  }
+
+  void TearDown() override { FLAGS_enable_vector_raw_encoding = enable_vector_raw_encoding_; }
+
+  static pb::common::Vector GenFloatVector(int dimension, std::mt19937& engine) {
+    std::uniform_real_distribution<float> distribution(-1, 1);
+    pb::common::Vector vector;
+    vector.set_dimension(dimension);
+    vector.set_value_type(pb::common::ValueType::FLOAT);
+    for (int i = 0; i < dimension; ++i) {
+      vector.add_float_values(distribution(engine));
+    }
+
+    return vector;
+  }
+
+  bool enable_vector_raw_encoding_;
+};
+
+TEST_F(VectorCodecTest, FloatVector) {
+  std::mt19937 engine(1);
+  auto vector = GenFloatVector(128, engine);
+
+  std::string value;
+  VectorCodec::EncodeVectorValue(vector, value);
+  EXPECT_EQ(value.size(), 8 + 128 * sizeof(float));
+
+  pb::common::Vector decode_vector;
+  ASSERT_TRUE(VectorCodec::DecodeVectorValue(value, decode_vector));
+  EXPECT_EQ(decode_vector.dimension(), 128);
+  EXPECT_EQ(decode_vector.value_type(), pb::common::ValueType::FLOAT);
+  ASSERT_EQ(decode_vector.float_values_size(), 128);
+  for (int i = 0; i < 128; ++i) {
+    EXPECT_EQ(decode_vector.float_values(i), vector.float_values(i));
+  }
+
+  std::vector<float> float_values{1.0f};
+  ASSERT_TRUE(VectorCodec::DecodeVectorFloatValues(value, float_values));
+  ASSERT_EQ(float_values.size(), 129);
+  EXPECT_EQ(float_values[1], vector.float_values(0));
+  EXPECT_EQ(float_values[128], vector.float_values(127));
+}
+
+TEST_F(VectorCodecTest, BinaryVector) {
+  pb::common::Vector vector;
+  vector.set_dimension(4);
+  vector.set_value_type(pb::common::ValueType::UINT8);
+  for (int i = 0; i < 4; ++i) {
+    vector.add_binary_values(std::string(1, static_cast<char>(i + 250)));
+  }
+
+  std::string value;
+  VectorCodec::EncodeVectorValue(vector, value);
+  EXPECT_EQ(value.size(), 8 + 4);
+
+  pb::common::Vector decode_vector;
+  ASSERT_TRUE(VectorCodec::DecodeVectorValue(value, decode_vector));
+  EXPECT_EQ(decode_vector.value_type(), pb::common::ValueType::UINT8);
+  EXPECT_EQ(decode_vector.SerializeAsString(), vector.SerializeAsString());
+
+  std::vector<float> float_values;
+  EXPECT_FALSE(VectorCodec::DecodeVectorFloatValues(value, float_values));
+}
+
+// Data written by old version is protobuf encoded.
+TEST_F(VectorCodecTest, LegacyProtobuf) {
+  std::mt19937 engine(1);
+  auto vector = GenFloatVector(16, engine);
+  std::string value = vector.SerializeAsString();
+
+  pb::common::Vector decode_vector;
+  ASSERT_TRUE(VectorCodec::DecodeVectorValue(value, decode_vector));
+  EXPECT_EQ(decode_vector.SerializeAsString(), value);
+
+  std::vector<float> float_values;
+  ASSERT_TRUE(VectorCodec::DecodeVectorFloatValues(value, float_values));
+  EXPECT_EQ(float_values.size(), 16);
+
+  // the raw encoding disabled, encode as protobuf which the old version can decode
+  FLAGS_enable_vector_raw_encoding = false;
+  std::string pb_value;
+  VectorCodec::EncodeVectorValue(vector, pb_value);
+  EXPECT_EQ(pb_value, value);
+  FLAGS_enable_vector_raw_encoding = true;
+
+  // truncated raw value
+  std::string raw_value;
+  VectorCodec::EncodeVectorValue(vector, raw_value);
+  raw_value.pop_back();
+  EXPECT_FALSE(VectorCodec::DecodeVectorValue(raw_value, decode_vector));
+}
+
+// Benchmark of index build, decode raw encoding vs protobuf encoding and add to a flat index,
+// like VectorIndexManager::BuildVectorIndex. Disabled by default,
+// run with --gtest_also_run_disabled_tests --gtest_filter=*BuildBench.
+TEST_F(VectorCodecTest, DISABLED_BuildBench) {
+  std::mt19937 engine(1);
+  int dimension = 768;
+  int count = 20000;
+  std::vector<std::string> raw_values(count);
+  std::vector<std::string> pb_values(count);
+  for (int i = 0; i < count; ++i) {
+    auto vector = GenFloatVector(dimension, engine);
+    VectorCodec::EncodeVectorValue(vector, raw_values[i]);
+    pb_values[i] = vector.SerializeAsString();
+  }
+
+  auto bench = [&](const std::vector<std::string>& values, int64_t& decode_us, int64_t& build_us) {
+    static const pb::common::Range kRange;
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+    index_parameter.mutable_flat_parameter()->set_dimension(dimension);
+    index_parameter.mutable_flat_parameter()->set_metric_type(pb::common::MetricType::METRIC_TYPE_L2);
+    auto vector_index = VectorIndexFactory::New(1, index_parameter, kRange);
+    ASSERT_NE(nullptr, vector_index);
+
+    decode_us = 0;
+    build_us = 0;
+    const int batch_size = 1000;
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    for (int start = 0; start < count; start += batch_size) {
+      auto decode_start = std::chrono::steady_clock::now();
+      vector_with_ids.resize(batch_size);
+      for (int i = 0; i < batch_size; ++i) {
+        vector_with_ids[i].set_id(start + i + 1);
+        ASSERT_TRUE(VectorCodec::DecodeVectorValue(values[start + i], *vector_with_ids[i].mutable_vector()));
+      }
+      auto add_start = std::chrono::steady_clock::now();
+      ASSERT_TRUE(vector_index->Upsert(vector_with_ids).ok());
+      auto add_end = std::chrono::steady_clock::now();
+
+      decode_us += std::chrono::duration_cast<std::chrono::microseconds>(add_start - decode_start).count();
+      build_us += std::chrono::duration_cast<std::chrono::microseconds>(add_end - decode_start).count();
+    }
+
+    uint64_t vector_count = 0;
+    vector_index->GetCount(vector_count);
+    EXPECT_EQ(count, vector_count);
+  };
+
+  int64_t raw_decode_us = 0;
+  int64_t raw_build_us = 0;
+  bench(raw_values, raw_decode_us, raw_build_us);
+  int64_t pb_decode_us = 0;
+  int64_t pb_build_us = 0;
+  bench(pb_values, pb_decode_us, pb_build_us);
+
+  std::cout << "dimension: " << dimension << " count: " << count << " raw decode/build us: " << raw_decode_us << "/"
+            << raw_build_us << " protobuf decode/build us: " << pb_decode_us << "/" << pb_build_us << std::endl;
+}
+
+}  // namespace dingodb
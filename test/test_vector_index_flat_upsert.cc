@@ -0,0 +1,202 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "butil/status.h"
+#include "faiss/MetricType.h"
+#include "proto/common.pb.h"
+#include "proto/error.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index_factory.h"
+#include "vector/vector_index_flat.h"
+
+namespace dingodb {
+
+class VectorIndexFlatUpsertTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    static const pb::common::Range kRange;
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+    index_parameter.mutable_flat_parameter()->set_dimension(dimension);
+    index_parameter.mutable_flat_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+    vector_index_flat = VectorIndexFactory::New(1, index_parameter, kRange);
+  }
+
+  static void TearDownTestSuite() { vector_index_flat.reset(); }
+
+  void SetUp() override {}
+
+  void TearDown() override {}
+
+  static std::vector<pb::common::VectorWithId> GenVectors(uint64_t start_id, uint64_t count, float value) {
+    std::vector<pb::common::VectorWithId> vector_with_ids;
+    vector_with_ids.reserve(count);
+    for (uint64_t id = start_id; id < start_id + count; ++id) {
+      auto& vector_with_id = vector_with_ids.emplace_back();
+      vector_with_id.set_id(id);
+      vector_with_id.mutable_vector()->set_dimension(dimension);
+      vector_with_id.mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+      for (int i = 0; i < dimension; ++i) {
+        vector_with_id.mutable_vector()->add_float_values(value + static_cast<float>(id));
+      }
+    }
+
+    return vector_with_ids;
+  }
+
+  static uint64_t SearchNearestId(float value) {
+    auto query = GenVectors(0, 1, value);
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    auto status = vector_index_flat->Search(query, 1, {}, results, false);
+    EXPECT_TRUE(status.ok());
+    if (results.empty() || results[0].vector_with_distances().empty()) {
+      return 0;
+    }
+
+    return results[0].vector_with_distances(0).vector_with_id().id();
+  }
+
+  inline static std::shared_ptr<VectorIndex> vector_index_flat;
+  inline static constexpr faiss::idx_t dimension = 16;
+  inline static uint64_t data_base_size = 100000;
+  inline static uint64_t batch_size = 1000;
+};
+
+TEST_F(VectorIndexFlatUpsertTest, UpsertInPlace) {
+  ASSERT_NE(vector_index_flat.get(), nullptr);
+
+  auto status = vector_index_flat->Add(GenVectors(1, 100, 0));
+  EXPECT_TRUE(status.ok());
+
+  // move vector 50 to far away
+  status = vector_index_flat->Upsert(GenVectors(50, 1, 10000));
+  EXPECT_TRUE(status.ok());
+
+  uint64_t count = 0;
+  vector_index_flat->GetCount(count);
+  EXPECT_EQ(count, 100);
+  EXPECT_EQ(SearchNearestId(10050), 50);
+  EXPECT_EQ(SearchNearestId(49.9), 49);
+
+  // duplicate id in one batch, the last one win
+  auto vector_with_ids = GenVectors(200, 1, 0);
+  auto duplicate = GenVectors(200, 1, 20000);
+  vector_with_ids.push_back(duplicate[0]);
+  status = vector_index_flat->Upsert(vector_with_ids);
+  EXPECT_TRUE(status.ok());
+  vector_index_flat->GetCount(count);
+  EXPECT_EQ(count, 101);
+  EXPECT_EQ(SearchNearestId(20200), 200);
+}
+
+TEST_F(VectorIndexFlatUpsertTest, DeleteAndCompact) {
+  std::vector<uint64_t> delete_ids;
+  for (uint64_t id = 1; id <= 100; id += 2) {
+    delete_ids.push_back(id);
+  }
+  auto status = vector_index_flat->Delete(delete_ids);
+  EXPECT_TRUE(status.ok());
+
+  // deleted vector is skipped by search
+  EXPECT_EQ(SearchNearestId(1), 2);
+
+  uint64_t count = 0;
+  uint64_t deleted_count = 0;
+  vector_index_flat->GetCount(count);
+  vector_index_flat->GetDeletedCount(deleted_count);
+  EXPECT_EQ(count, 51);
+  EXPECT_EQ(deleted_count, 50);
+
+  status = vector_index_flat->Compact();
+  EXPECT_TRUE(status.ok());
+  vector_index_flat->GetCount(count);
+  vector_index_flat->GetDeletedCount(deleted_count);
+  EXPECT_EQ(count, 51);
+  EXPECT_EQ(deleted_count, 0);
+  EXPECT_EQ(SearchNearestId(1), 2);
+  EXPECT_EQ(SearchNearestId(20200), 200);
+
+  // re-add deleted id
+  status = vector_index_flat->Upsert(GenVectors(1, 1, 0));
+  EXPECT_TRUE(status.ok());
+  EXPECT_EQ(SearchNearestId(1), 1);
+}
+
+// Mixed upsert and search on large index, upsert cost should be proportional to the batch size.
+TEST_F(VectorIndexFlatUpsertTest, MixedUpsertSearchBench) {
+  for (uint64_t start_id = 1000; start_id < 1000 + data_base_size; start_id += batch_size) {
+    auto status = vector_index_flat->Add(GenVectors(start_id, batch_size, 0));
+    EXPECT_TRUE(status.ok());
+  }
+
+  std::mt19937_64 engine(1);
+  std::uniform_int_distribution<uint64_t> distribution(1000, 1000 + data_base_size - batch_size);
+
+  uint64_t upsert_us = 0;
+  uint64_t search_us = 0;
+  int round = 20;
+  for (int i = 0; i < round; ++i) {
+    auto upsert_vectors = GenVectors(distribution(engine), batch_size, static_cast<float>(i));
+    std::vector<uint64_t> delete_ids;
+    for (size_t j = 0; j < upsert_vectors.size(); j += 10) {
+      delete_ids.push_back(upsert_vectors[j].id());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto status = vector_index_flat->Upsert(upsert_vectors);
+    EXPECT_TRUE(status.ok());
+    status = vector_index_flat->Delete(delete_ids);
+    EXPECT_TRUE(status.ok());
+    auto end = std::chrono::steady_clock::now();
+    upsert_us += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    start = std::chrono::steady_clock::now();
+    auto query = GenVectors(0, 8, static_cast<float>(distribution(engine)));
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    status = vector_index_flat->Search(query, 10, {}, results, false);
+    EXPECT_TRUE(status.ok());
+    end = std::chrono::steady_clock::now();
+    search_us += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+    // deleted vector must not be returned
+    for (const auto& result : results) {
+      for (const auto& vector_with_distance : result.vector_with_distances()) {
+        auto id = vector_with_distance.vector_with_id().id();
+        EXPECT_TRUE(std::find(delete_ids.begin(), delete_ids.end(), id) == delete_ids.end());
+      }
+    }
+  }
+
+  std::cout << "index size: " << data_base_size << " batch size: " << batch_size
+            << " avg upsert+delete us: " << upsert_us / round << " avg search us: " << search_us / round << std::endl;
+
+  auto status = vector_index_flat->Compact();
+  EXPECT_TRUE(status.ok());
+  uint64_t deleted_count = 0;
+  vector_index_flat->GetDeletedCount(deleted_count);
+  EXPECT_EQ(deleted_count, 0);
+}
+
+}  // namespace dingodb
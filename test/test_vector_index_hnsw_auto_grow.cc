@@ -0,0 +1,148 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "butil/status.h"
+#include "faiss/MetricType.h"
+#include "gflags/gflags.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index_factory.h"
+#include "vector/vector_index_hnsw.h"
+#include "vector_index_test_helper.h"
+
+namespace dingodb {
+
+DECLARE_bool(enable_hnsw_auto_grow);
+DECLARE_uint64(hnsw_auto_grow_max_memory_size);
+
+class VectorIndexHnswAutoGrowTest : public testing::Test {
+ protected:
+  // the flags are global, restore them so other tests are not affected
+  void SetUp() override {
+    enable_hnsw_auto_grow_ = FLAGS_enable_hnsw_auto_grow;
+    hnsw_auto_grow_max_memory_size_ = FLAGS_hnsw_auto_grow_max_memory_size;
+  }
+
+  void TearDown() override {
+    FLAGS_enable_hnsw_auto_grow = enable_hnsw_auto_grow_;
+    FLAGS_hnsw_auto_grow_max_memory_size = hnsw_auto_grow_max_memory_size_;
+  }
+
+  static std::shared_ptr<VectorIndex> NewIndex(uint32_t max_elements) {
+    static const pb::common::Range kRange;
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+    index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+    index_parameter.mutable_hnsw_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+    index_parameter.mutable_hnsw_parameter()->set_efconstruction(40);
+    index_parameter.mutable_hnsw_parameter()->set_max_elements(max_elements);
+    index_parameter.mutable_hnsw_parameter()->set_nlinks(16);
+    return VectorIndexFactory::New(1, index_parameter, kRange);
+  }
+
+  static std::vector<pb::common::VectorWithId> GenVectors(uint64_t start_id, uint64_t count, std::mt19937& engine) {
+    return dingodb::GenVectors(start_id, count, dimension, engine);
+  }
+
+  inline static constexpr faiss::idx_t dimension = 8;
+
+  bool enable_hnsw_auto_grow_;
+  uint64_t hnsw_auto_grow_max_memory_size_;
+};
+
+TEST_F(VectorIndexHnswAutoGrowTest, GrowOnUpsert) {
+  FLAGS_enable_hnsw_auto_grow = true;
+  FLAGS_hnsw_auto_grow_max_memory_size = 0;
+
+  auto vector_index = NewIndex(100);
+  ASSERT_NE(vector_index.get(), nullptr);
+  auto hnsw_index = std::dynamic_pointer_cast<VectorIndexHnsw>(vector_index);
+  ASSERT_NE(hnsw_index.get(), nullptr);
+
+  std::mt19937 engine(1);
+  uint64_t total_count = 25000;
+  for (uint64_t start_id = 1; start_id <= total_count; start_id += 1000) {
+    auto status = vector_index->Upsert(GenVectors(start_id, 1000, engine));
+    ASSERT_TRUE(status.ok()) << status.error_str();
+    EXPECT_FALSE(vector_index->IsExceedsMaxElements());
+  }
+
+  uint64_t count = 0;
+  vector_index->GetCount(count);
+  EXPECT_EQ(count, total_count);
+
+  uint64_t max_elements = 0;
+  hnsw_index->GetMaxElements(max_elements);
+  EXPECT_GE(max_elements, total_count);
+}
+
+TEST_F(VectorIndexHnswAutoGrowTest, ReuseDeletedWithoutGrow) {
+  FLAGS_enable_hnsw_auto_grow = true;
+  FLAGS_hnsw_auto_grow_max_memory_size = 0;
+
+  auto vector_index = NewIndex(100);
+  ASSERT_NE(vector_index.get(), nullptr);
+  auto hnsw_index = std::dynamic_pointer_cast<VectorIndexHnsw>(vector_index);
+  ASSERT_NE(hnsw_index.get(), nullptr);
+
+  std::mt19937 engine(1);
+  auto status = vector_index->Upsert(GenVectors(1, 100, engine));
+  ASSERT_TRUE(status.ok()) << status.error_str();
+
+  std::vector<uint64_t> delete_ids;
+  for (uint64_t id = 1; id <= 50; ++id) {
+    delete_ids.push_back(id);
+  }
+  status = vector_index->Delete(delete_ids);
+  ASSERT_TRUE(status.ok()) << status.error_str();
+
+  // the new vectors take the deleted slots, the index is not grown
+  status = vector_index->Upsert(GenVectors(101, 50, engine));
+  ASSERT_TRUE(status.ok()) << status.error_str();
+
+  uint64_t max_elements = 0;
+  hnsw_index->GetMaxElements(max_elements);
+  EXPECT_EQ(100, max_elements);
+
+  uint64_t count = 0;
+  vector_index->GetCount(count);
+  EXPECT_EQ(100, count);
+}
+
+TEST_F(VectorIndexHnswAutoGrowTest, MemoryLimit) {
+  FLAGS_enable_hnsw_auto_grow = true;
+  FLAGS_hnsw_auto_grow_max_memory_size = 1024;
+
+  auto vector_index = NewIndex(100);
+  ASSERT_NE(vector_index.get(), nullptr);
+
+  std::mt19937 engine(1);
+  auto status = vector_index->Upsert(GenVectors(1, 100, engine));
+  ASSERT_TRUE(status.ok());
+
+  // full and can not grow over the memory limit
+  EXPECT_TRUE(vector_index->IsExceedsMaxElements());
+
+  FLAGS_hnsw_auto_grow_max_memory_size = 0;
+  EXPECT_FALSE(vector_index->IsExceedsMaxElements());
+}
+
+}  // namespace dingodb
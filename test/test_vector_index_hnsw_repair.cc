@@ -0,0 +1,230 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+
+#include "butil/status.h"
+#include "faiss/MetricType.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index_factory.h"
+#include "vector/vector_index_hnsw.h"
+#include "vector_index_test_helper.h"
+
+namespace dingodb {
+
+class VectorIndexHnswRepairTest : public testing::Test {
+ protected:
+  static void SetUpTestSuite() { vector_index_hnsw = NewHnsw(); }
+
+  static void TearDownTestSuite() { vector_index_hnsw.reset(); }
+
+  static std::shared_ptr<VectorIndex> NewHnsw() {
+    static const pb::common::Range kRange;
+    pb::common::VectorIndexParameter index_parameter;
+    index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+    index_parameter.mutable_hnsw_parameter()->set_dimension(dimension);
+    index_parameter.mutable_hnsw_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+    index_parameter.mutable_hnsw_parameter()->set_efconstruction(200);
+    index_parameter.mutable_hnsw_parameter()->set_max_elements(max_elements);
+    index_parameter.mutable_hnsw_parameter()->set_nlinks(16);
+    return VectorIndexFactory::New(1, index_parameter, kRange);
+  }
+
+  static std::vector<pb::common::VectorWithId> GenVectors(uint64_t start_id, uint64_t count, std::mt19937& engine) {
+    return dingodb::GenVectors(start_id, count, dimension, engine);
+  }
+
+  inline static std::shared_ptr<VectorIndex> vector_index_hnsw;
+  inline static constexpr faiss::idx_t dimension = 16;
+  inline static uint32_t max_elements = 2000;
+};
+
+// Delete and re-add repeatedly, the deleted slot is reused and the index never need to rebuild.
+TEST_F(VectorIndexHnswRepairTest, ReplaceDeletedAndRepair) {
+  ASSERT_NE(vector_index_hnsw.get(), nullptr);
+
+  std::mt19937 engine(1);
+  auto vector_with_ids = GenVectors(1, max_elements, engine);
+  auto status = vector_index_hnsw->Add(vector_with_ids);
+  ASSERT_TRUE(status.ok());
+
+  uint64_t next_id = max_elements + 1;
+  for (int round = 0; round < 5; ++round) {
+    // delete 60%, more than the old rebuild threshold
+    std::vector<uint64_t> delete_ids;
+    for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+      if (i % 5 < 3) {
+        delete_ids.push_back(vector_with_ids[i].id());
+      }
+    }
+    status = vector_index_hnsw->Delete(delete_ids);
+    ASSERT_TRUE(status.ok());
+    EXPECT_FALSE(vector_index_hnsw->NeedToRebuild());
+
+    if (vector_index_hnsw->NeedToCompact()) {
+      status = vector_index_hnsw->Compact();
+      EXPECT_TRUE(status.ok());
+    }
+    EXPECT_FALSE(vector_index_hnsw->NeedToCompact());
+
+    auto new_vector_with_ids = GenVectors(next_id, delete_ids.size(), engine);
+    next_id += delete_ids.size();
+    status = vector_index_hnsw->Upsert(new_vector_with_ids);
+    ASSERT_TRUE(status.ok());
+
+    // keep the alive vectors for next round
+    std::vector<pb::common::VectorWithId> alive_vector_with_ids;
+    for (size_t i = 0; i < vector_with_ids.size(); ++i) {
+      if (i % 5 >= 3) {
+        alive_vector_with_ids.push_back(vector_with_ids[i]);
+      }
+    }
+    alive_vector_with_ids.insert(alive_vector_with_ids.end(), new_vector_with_ids.begin(), new_vector_with_ids.end());
+    vector_with_ids.swap(alive_vector_with_ids);
+  }
+
+  uint64_t count = 0;
+  vector_index_hnsw->GetCount(count);
+  EXPECT_EQ(count, max_elements);
+
+  // every alive vector can be found by itself
+  std::vector<pb::common::VectorWithId> queries(vector_with_ids.begin(), vector_with_ids.begin() + 100);
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  status = vector_index_hnsw->Search(queries, 1, {}, results, false);
+  ASSERT_TRUE(status.ok());
+  ASSERT_EQ(results.size(), queries.size());
+  int hit_count = 0;
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (!results[i].vector_with_distances().empty() &&
+        results[i].vector_with_distances(0).vector_with_id().id() == queries[i].id()) {
+      ++hit_count;
+    }
+  }
+  EXPECT_GE(hit_count, 95);
+}
+
+// Upsert the exist id must update it in place, not take a deleted slot and leave the old one with same id.
+TEST_F(VectorIndexHnswRepairTest, UpsertExistWithDeletedSlot) {
+  auto vector_index = NewHnsw();
+  ASSERT_NE(vector_index.get(), nullptr);
+
+  std::mt19937 engine(2);
+  auto status = vector_index->Add(GenVectors(1, 100, engine));
+  ASSERT_TRUE(status.ok());
+  status = vector_index->Delete({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+  ASSERT_TRUE(status.ok());
+
+  auto check_count = [&](uint64_t expect_count, uint64_t expect_deleted_count) {
+    uint64_t count = 0;
+    uint64_t deleted_count = 0;
+    vector_index->GetCount(count);
+    vector_index->GetDeletedCount(deleted_count);
+    EXPECT_EQ(expect_count, count);
+    EXPECT_EQ(expect_deleted_count, deleted_count);
+  };
+
+  auto check_search = [&](const pb::common::VectorWithId& vector_with_id, std::set<uint64_t>& ids) {
+    ids.clear();
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    auto status = vector_index->Search({vector_with_id}, 100, {}, results, false);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(1, results.size());
+    ASSERT_FALSE(results[0].vector_with_distances().empty());
+    EXPECT_EQ(vector_with_id.id(), results[0].vector_with_distances(0).vector_with_id().id());
+    EXPECT_FLOAT_EQ(0.0f, results[0].vector_with_distances(0).distance());
+
+    // no duplicate id
+    for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+      EXPECT_TRUE(ids.insert(vector_with_distance.vector_with_id().id()).second);
+    }
+  };
+
+  // exist id is updated in place, the deleted slots are kept
+  auto updated = GenVectors(50, 1, engine);
+  status = vector_index->Upsert(updated);
+  ASSERT_TRUE(status.ok());
+  check_count(100, 10);
+  std::set<uint64_t> ids;
+  check_search(updated[0], ids);
+  EXPECT_EQ(90, ids.size());
+  EXPECT_EQ(0, ids.count(1));
+
+  // deleted id is revived in its own slot
+  auto revived = GenVectors(5, 1, engine);
+  status = vector_index->Upsert(revived);
+  ASSERT_TRUE(status.ok());
+  check_count(100, 9);
+  check_search(revived[0], ids);
+  EXPECT_EQ(91, ids.size());
+
+  // new id take a deleted slot
+  auto added = GenVectors(1000, 1, engine);
+  status = vector_index->Upsert(added);
+  ASSERT_TRUE(status.ok());
+  check_count(100, 8);
+  check_search(added[0], ids);
+  EXPECT_EQ(92, ids.size());
+  EXPECT_EQ(1, ids.count(50));
+  EXPECT_EQ(1, ids.count(5));
+}
+
+// The same new id repeated in one batch take only one deleted slot, the last vector win.
+TEST_F(VectorIndexHnswRepairTest, UpsertDuplicateIdInBatch) {
+  auto vector_index = NewHnsw();
+  ASSERT_NE(vector_index.get(), nullptr);
+
+  std::mt19937 engine(3);
+  auto status = vector_index->Add(GenVectors(1, 100, engine));
+  ASSERT_TRUE(status.ok());
+  status = vector_index->Delete({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+  ASSERT_TRUE(status.ok());
+
+  // the same id in every row, the add run in parallel
+  auto vector_with_ids = GenVectors(1000, 8, engine);
+  for (auto& vector_with_id : vector_with_ids) {
+    vector_with_id.set_id(1000);
+  }
+  status = vector_index->Upsert(vector_with_ids);
+  ASSERT_TRUE(status.ok());
+
+  uint64_t count = 0;
+  uint64_t deleted_count = 0;
+  vector_index->GetCount(count);
+  vector_index->GetDeletedCount(deleted_count);
+  EXPECT_EQ(100, count);
+  EXPECT_EQ(9, deleted_count);
+
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  status = vector_index->Search({vector_with_ids.back()}, 100, {}, results, false);
+  ASSERT_TRUE(status.ok());
+  ASSERT_EQ(1, results.size());
+  ASSERT_FALSE(results[0].vector_with_distances().empty());
+  EXPECT_EQ(1000, results[0].vector_with_distances(0).vector_with_id().id());
+  EXPECT_FLOAT_EQ(0.0f, results[0].vector_with_distances(0).distance());
+
+  std::set<uint64_t> ids;
+  for (const auto& vector_with_distance : results[0].vector_with_distances()) {
+    EXPECT_TRUE(ids.insert(vector_with_distance.vector_with_id().id()).second);
+  }
+  EXPECT_EQ(91, ids.size());
+}
+
+}  // namespace dingodb
@@ -0,0 +1,254 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "butil/status.h"
+#include "common/helper.h"
+#include "faiss/MetricType.h"
+#include "fmt/core.h"
+#include "proto/common.pb.h"
+#include "proto/index.pb.h"
+#include "vector/vector_index_factory.h"
+#include "vector/vector_index_utils.h"
+#include "vector_index_test_helper.h"
+
+// Count the allocations of this test binary for the benchmark, every test file is linked to its own binary.
+static std::atomic<bool> g_count_alloc{false};
+static std::atomic<uint64_t> g_alloc_count{0};
+// keep the benchmark buffers from being optimized out
+static const void* volatile g_sink = nullptr;
+
+void* operator new(size_t size) {
+  if (g_count_alloc.load(std::memory_order_relaxed)) {
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+  }
+  void* ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t /*size*/) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, size_t /*size*/) noexcept { std::free(ptr); }
+
+namespace dingodb {
+
+// The search buffers are reused from object pool, the stale content of a bigger previous search
+// must not leak into the result of a smaller one.
+class VectorIndexSearchScratchTest : public testing::Test {
+ protected:
+  static std::vector<pb::common::VectorWithId> GenVectors(uint64_t start_id, uint64_t count, std::mt19937& engine) {
+    return dingodb::GenVectors(start_id, count, kDimension, engine);
+  }
+
+  static void ExpectSameResults(const std::vector<pb::index::VectorWithDistanceResult>& expected,
+                                const std::vector<pb::index::VectorWithDistanceResult>& results) {
+    ASSERT_EQ(expected.size(), results.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      EXPECT_EQ(expected[i].ShortDebugString(), results[i].ShortDebugString());
+    }
+  }
+
+  // Search the queries in a fresh scratch, then dirty the scratch with a bigger search and search again.
+  static void CheckReuse(std::shared_ptr<VectorIndex> vector_index) {
+    ASSERT_NE(vector_index.get(), nullptr);
+    std::mt19937 engine(1);
+    auto status = vector_index->Add(GenVectors(1, 1000, engine));
+    ASSERT_TRUE(status.ok());
+
+    auto queries = GenVectors(10001, 3, engine);
+    std::vector<pb::index::VectorWithDistanceResult> expected;
+    status = vector_index->Search(queries, 5, {}, expected, true);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(3, expected.size());
+    EXPECT_EQ(5, expected[0].vector_with_distances_size());
+
+    // bigger batch and topk grow the buffers and leave stale labels and distances in them
+    std::vector<pb::index::VectorWithDistanceResult> big_results;
+    status = vector_index->Search(GenVectors(20001, 64, engine), 50, {}, big_results, false);
+    ASSERT_TRUE(status.ok());
+    ASSERT_EQ(64, big_results.size());
+
+    std::vector<pb::index::VectorWithDistanceResult> results;
+    status = vector_index->Search(queries, 5, {}, results, true);
+    ASSERT_TRUE(status.ok());
+    ExpectSameResults(expected, results);
+
+    // a single query in reused buffers is the same as the row in batch
+    for (size_t i = 0; i < queries.size(); ++i) {
+      results.clear();
+      status = vector_index->Search({queries[i]}, 5, {}, results, true);
+      ASSERT_TRUE(status.ok());
+      ExpectSameResults({expected[i]}, results);
+    }
+  }
+
+  inline static constexpr int kDimension = 16;
+};
+
+TEST_F(VectorIndexSearchScratchTest, ReuseObject) {
+  VectorSearchScratch* first = nullptr;
+  {
+    VectorSearchScratchGuard scratch;
+    first = scratch.operator->();
+    scratch->distances.resize(1024);
+  }
+
+  // the object returned to pool is reused by the next search in the same thread, the capacity is kept
+  {
+    VectorSearchScratchGuard scratch;
+    ASSERT_EQ(first, scratch.operator->());
+    EXPECT_GE(scratch->distances.capacity(), 1024);
+
+    // oversized buffer is released when return to pool
+    scratch->vectors.resize(VectorSearchScratch::kMaxRetainBytes / sizeof(float) + 1);
+  }
+
+  {
+    VectorSearchScratchGuard scratch;
+    ASSERT_EQ(first, scratch.operator->());
+    EXPECT_EQ(0, scratch->vectors.capacity());
+    EXPECT_GE(scratch->distances.capacity(), 1024);
+  }
+}
+
+TEST_F(VectorIndexSearchScratchTest, Flat) {
+  static const pb::common::Range kRange;
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+  index_parameter.mutable_flat_parameter()->set_dimension(kDimension);
+  index_parameter.mutable_flat_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  CheckReuse(VectorIndexFactory::New(1, index_parameter, kRange));
+}
+
+TEST_F(VectorIndexSearchScratchTest, Hnsw) {
+  static const pb::common::Range kRange;
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_HNSW);
+  index_parameter.mutable_hnsw_parameter()->set_dimension(kDimension);
+  index_parameter.mutable_hnsw_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  index_parameter.mutable_hnsw_parameter()->set_efconstruction(200);
+  index_parameter.mutable_hnsw_parameter()->set_max_elements(2000);
+  index_parameter.mutable_hnsw_parameter()->set_nlinks(16);
+  CheckReuse(VectorIndexFactory::New(1, index_parameter, kRange));
+}
+
+// Benchmark of allocations and latency per search, before is allocate the buffers and copy the results into
+// the response per request, after is the pooled buffers and the results swapped into the response.
+// Disabled by default, run with --gtest_also_run_disabled_tests --gtest_filter=*AllocBench.
+TEST_F(VectorIndexSearchScratchTest, DISABLED_AllocBench) {
+  const int count = 10000;
+  const int batch_size = 4;
+  const int topk = 10;
+
+  auto measure = [&](const char* name, const std::function<void()>& func) {
+    // warm up the object pool
+    func();
+
+    g_alloc_count = 0;
+    g_count_alloc = true;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+      func();
+    }
+    auto end = std::chrono::steady_clock::now();
+    g_count_alloc = false;
+
+    std::cout << fmt::format("{}: alloc/request({:.2f}) latency({:.2f}us)", name,
+                             static_cast<double>(g_alloc_count.load()) / count,
+                             std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1000.0 / count)
+              << '\n';
+  };
+
+  // search buffers
+  measure("buffer before", [&]() {
+    std::vector<float> vectors(batch_size * kDimension);
+    std::vector<float> distances(batch_size * topk, 0.0f);
+    std::vector<int64_t> labels(batch_size * topk, -1);
+    g_sink = vectors.data();
+    g_sink = distances.data();
+    g_sink = labels.data();
+  });
+  measure("buffer after", [&]() {
+    VectorSearchScratchGuard scratch;
+    scratch->vectors.resize(batch_size * kDimension);
+    scratch->distances.assign(batch_size * topk, 0.0f);
+    scratch->labels.assign(batch_size * topk, -1);
+    g_sink = scratch->vectors.data();
+    g_sink = scratch->distances.data();
+    g_sink = scratch->labels.data();
+  });
+
+  // response construction
+  std::mt19937 engine(1);
+  std::vector<pb::index::VectorWithDistanceResult> results(batch_size);
+  for (auto& result : results) {
+    for (const auto& vector_with_id : GenVectors(1, topk, engine)) {
+      auto* vector_with_distance = result.add_vector_with_distances();
+      *vector_with_distance->mutable_vector_with_id() = vector_with_id;
+      vector_with_distance->set_distance(1.0f);
+    }
+  }
+  // the search results are copied in both, only the response construction is counted
+  auto copy_results = [&]() {
+    g_count_alloc = false;
+    auto copied_results = results;
+    g_count_alloc = true;
+    return copied_results;
+  };
+  measure("response before", [&]() {
+    auto search_results = copy_results();
+    pb::index::VectorSearchResponse response;
+    Helper::VectorToPbRepeated(search_results, response.mutable_batch_results());
+  });
+  measure("response after", [&]() {
+    auto search_results = copy_results();
+    pb::index::VectorSearchResponse response;
+    Helper::VectorToPbRepeated(std::move(search_results), response.mutable_batch_results());
+  });
+
+  // whole search of flat index, after only
+  static const pb::common::Range kRange;
+  pb::common::VectorIndexParameter index_parameter;
+  index_parameter.set_vector_index_type(::dingodb::pb::common::VectorIndexType::VECTOR_INDEX_TYPE_FLAT);
+  index_parameter.mutable_flat_parameter()->set_dimension(kDimension);
+  index_parameter.mutable_flat_parameter()->set_metric_type(::dingodb::pb::common::MetricType::METRIC_TYPE_L2);
+  auto vector_index = VectorIndexFactory::New(1, index_parameter, kRange);
+  ASSERT_NE(vector_index.get(), nullptr);
+  ASSERT_TRUE(vector_index->Add(GenVectors(1, 10000, engine)).ok());
+  auto queries = GenVectors(100001, batch_size, engine);
+  measure("flat search", [&]() {
+    std::vector<pb::index::VectorWithDistanceResult> search_results;
+    vector_index->Search(queries, topk, {}, search_results, false);
+  });
+}
+
+}  // namespace dingodb
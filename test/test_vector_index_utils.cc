@@ -4107,4 +4107,38 @@ TEST_F(VectorIndexUtilsTest, NormalizeVectorForHnsw) {
   }
 }
 
+TEST_F(VectorIndexUtilsTest, MergeVectorSearchResults) {
+  auto add_result = [](pb::index::VectorWithDistanceResult& result, uint64_t id, float distance) {
+    auto* vector_with_distance = result.add_vector_with_distances();
+    vector_with_distance->mutable_vector_with_id()->set_id(id);
+    vector_with_distance->set_distance(distance);
+  };
+
+  // 3 regions, 2 queries
+  std::vector<std::vector<pb::index::VectorWithDistanceResult>> region_results(3);
+  for (auto& region_result : region_results) {
+    region_result.resize(2);
+  }
+  add_result(region_results[0][0], 1, 0.1);
+  add_result(region_results[0][0], 2, 0.5);
+  add_result(region_results[1][0], 11, 0.2);
+  add_result(region_results[1][0], 12, 0.3);
+  add_result(region_results[2][0], 21, 0.05);
+  add_result(region_results[0][1], 3, 1.0);
+  add_result(region_results[2][1], 22, 2.0);
+
+  std::vector<pb::index::VectorWithDistanceResult> results;
+  VectorIndexUtils::MergeVectorSearchResults(region_results, 3, results);
+
+  ASSERT_EQ(results.size(), 2);
+  ASSERT_EQ(results[0].vector_with_distances_size(), 3);
+  EXPECT_EQ(results[0].vector_with_distances(0).vector_with_id().id(), 21);
+  EXPECT_EQ(results[0].vector_with_distances(1).vector_with_id().id(), 1);
+  EXPECT_EQ(results[0].vector_with_distances(2).vector_with_id().id(), 11);
+
+  ASSERT_EQ(results[1].vector_with_distances_size(), 2);
+  EXPECT_EQ(results[1].vector_with_distances(0).vector_with_id().id(), 3);
+  EXPECT_EQ(results[1].vector_with_distances(1).vector_with_id().id(), 22);
+}
+
 }  // namespace dingodb
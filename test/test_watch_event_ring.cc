@@ -0,0 +1,115 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include "coordinator/watch_event_ring.h"
+#include "gflags/gflags.h"
+#include "proto/version.pb.h"
+
+namespace dingodb {
+
+DECLARE_uint64(watch_event_ring_capacity);
+
+static pb::version::Event GenEvent(int64_t revision, const std::string& key, pb::version::Event::EventType type) {
+  pb::version::Event event;
+  event.set_type(type);
+  event.mutable_kv()->set_mod_revision(revision);
+  event.mutable_kv()->mutable_kv()->set_key(key);
+  event.mutable_prev_kv()->set_mod_revision(revision - 1);
+  return event;
+}
+
+TEST(WatchEventRingTest, WatchRange) {
+  auto single_key = WatchRange::Build("abc", "");
+  EXPECT_TRUE(single_key.IsSingleKey());
+  EXPECT_TRUE(single_key.Contains("abc"));
+  EXPECT_FALSE(single_key.Contains("abcd"));
+  EXPECT_FALSE(single_key.Contains("ab"));
+
+  auto prefix = WatchRange::Build("abc", "abd");
+  EXPECT_FALSE(prefix.IsSingleKey());
+  EXPECT_TRUE(prefix.Contains("abc"));
+  EXPECT_TRUE(prefix.Contains("abcd"));
+  EXPECT_FALSE(prefix.Contains("abd"));
+
+  auto no_upper_bound = WatchRange::Build("abc", std::string(1, '\0'));
+  EXPECT_FALSE(no_upper_bound.IsSingleKey());
+  EXPECT_TRUE(no_upper_bound.Contains("zzz"));
+  EXPECT_FALSE(no_upper_bound.Contains("abb"));
+}
+
+TEST(WatchEventRingTest, ResumeFromRevision) {
+  WatchEventRing ring;
+  EXPECT_FALSE(ring.Covers(1));
+
+  for (int64_t revision = 10; revision < 20; ++revision) {
+    ring.Append(GenEvent(revision, "/service/" + std::to_string(revision % 2), pb::version::Event::PUT));
+  }
+  ring.Append(GenEvent(20, "/other", pb::version::Event::DELETE));
+
+  EXPECT_FALSE(ring.Covers(9));
+  EXPECT_TRUE(ring.Covers(10));
+  EXPECT_TRUE(ring.Covers(100));
+
+  // prefix watch resume from revision 15
+  pb::version::WatchResponse response;
+  EXPECT_EQ(ring.Collect(WatchRange::Build("/service/", "/service0"), 15, false, false, false, 100, &response), 5);
+  EXPECT_EQ(response.events(0).kv().mod_revision(), 15);
+  EXPECT_FALSE(response.events(0).has_prev_kv());
+
+  // single key with prev_kv
+  response.Clear();
+  EXPECT_EQ(ring.Collect(WatchRange::Build("/service/0", ""), 0, false, false, true, 100, &response), 5);
+  EXPECT_TRUE(response.events(0).has_prev_kv());
+
+  // filter and limit
+  response.Clear();
+  EXPECT_EQ(ring.Collect(WatchRange::Build("/", std::string(1, '\0')), 0, true, false, false, 100, &response), 1);
+  EXPECT_EQ(response.events(0).type(), pb::version::Event::DELETE);
+
+  response.Clear();
+  EXPECT_EQ(ring.Collect(WatchRange::Build("/", std::string(1, '\0')), 0, false, false, false, 3, &response), 3);
+  EXPECT_EQ(response.events(2).kv().mod_revision(), 12);
+}
+
+TEST(WatchEventRingTest, BoundedCapacity) {
+  auto old_capacity = FLAGS_watch_event_ring_capacity;
+  FLAGS_watch_event_ring_capacity = 10;
+
+  WatchEventRing ring;
+  for (int64_t revision = 1; revision <= 100; ++revision) {
+    ring.Append(GenEvent(revision, "key", pb::version::Event::PUT));
+  }
+  // the same revision is not split in one response
+  ring.Append(GenEvent(101, "key1", pb::version::Event::PUT));
+  ring.Append(GenEvent(101, "key2", pb::version::Event::DELETE));
+
+  EXPECT_EQ(ring.Size(), 10);
+  EXPECT_FALSE(ring.Covers(92));
+  EXPECT_TRUE(ring.Covers(94));
+
+  pb::version::WatchResponse response;
+  EXPECT_EQ(ring.Collect(WatchRange::Build("key", "kez"), 100, false, false, false, 2, &response), 3);
+
+  ring.Clear();
+  EXPECT_FALSE(ring.Covers(94));
+
+  FLAGS_watch_event_ring_capacity = old_capacity;
+}
+
+}  // namespace dingodb
@@ -0,0 +1,47 @@
+// Copyright (c) 2023 dingodb.com, Inc. All Rights Reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DINGODB_TEST_VECTOR_INDEX_TEST_HELPER_H_
+#define DINGODB_TEST_VECTOR_INDEX_TEST_HELPER_H_
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "proto/common.pb.h"
+
+namespace dingodb {
+
+// Generate count random float vectors with id [start_id, start_id + count).
+inline std::vector<pb::common::VectorWithId> GenVectors(uint64_t start_id, uint64_t count, int dimension,
+                                                        std::mt19937& engine) {
+  std::uniform_real_distribution<float> distribution(0, 1);
+  std::vector<pb::common::VectorWithId> vector_with_ids;
+  vector_with_ids.reserve(count);
+  for (uint64_t id = start_id; id < start_id + count; ++id) {
+    auto& vector_with_id = vector_with_ids.emplace_back();
+    vector_with_id.set_id(id);
+    vector_with_id.mutable_vector()->set_dimension(dimension);
+    vector_with_id.mutable_vector()->set_value_type(::dingodb::pb::common::ValueType::FLOAT);
+    for (int i = 0; i < dimension; ++i) {
+      vector_with_id.mutable_vector()->add_float_values(distribution(engine));
+    }
+  }
+
+  return vector_with_ids;
+}
+
+}  // namespace dingodb
+
+#endif  // DINGODB_TEST_VECTOR_INDEX_TEST_HELPER_H_